@@ -0,0 +1,124 @@
+/**
+ * @file lllatencyhistogram.cpp
+ * @brief Lock-free log-linear histogram for latency percentiles
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+#include "linden_common.h"
+
+#include "lllatencyhistogram.h"
+
+LLLatencyHistogram::LLLatencyHistogram()
+{
+    reset();
+}
+
+void LLLatencyHistogram::record(U64 microseconds)
+{
+    mBuckets[getBucket(microseconds)].fetch_add(1, std::memory_order_relaxed);
+}
+
+U64 LLLatencyHistogram::getCount() const
+{
+    U64 count = 0;
+    for (const std::atomic<U32>& bucket : mBuckets)
+    {
+        count += bucket.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+U64 LLLatencyHistogram::getPercentile(F32 fraction) const
+{
+    U32 counts[NUM_BUCKETS];
+    U64 total = 0;
+    for (U32 i = 0; i < NUM_BUCKETS; ++i)
+    {
+        counts[i] = mBuckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (!total)
+    {
+        return 0;
+    }
+
+    fraction = llclamp(fraction, 0.f, 1.f);
+    U64 rank = llmax((U64)1, (U64)ceil((F64)fraction * (F64)total));
+    U64 seen = 0;
+    for (U32 i = 0; i < NUM_BUCKETS; ++i)
+    {
+        seen += counts[i];
+        if (seen >= rank)
+        {
+            return getBucketMidpoint(i);
+        }
+    }
+    return getBucketMidpoint(NUM_BUCKETS - 1);
+}
+
+void LLLatencyHistogram::reset()
+{
+    for (std::atomic<U32>& bucket : mBuckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+//static
+U32 LLLatencyHistogram::getBucket(U64 microseconds)
+{
+    if (microseconds < SUB_BUCKETS)
+    {
+        // One bucket per microsecond below the first full octave
+        return (U32)microseconds;
+    }
+
+    U32 exponent = 0;
+    for (U64 v = microseconds; v > 1; v >>= 1)
+    {
+        ++exponent;
+    }
+    if (exponent >= MAX_EXPONENT)
+    {
+        return NUM_BUCKETS - 1;
+    }
+    U32 sub = (U32)(microseconds >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+}
+
+//static
+U64 LLLatencyHistogram::getBucketMidpoint(U32 bucket)
+{
+    if (bucket < SUB_BUCKETS)
+    {
+        return bucket;
+    }
+    U32 exponent = bucket / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+    U32 sub = bucket % SUB_BUCKETS;
+    U64 width = (U64)1 << (exponent - SUB_BUCKET_BITS);
+    U64 lower = (U64)(SUB_BUCKETS + sub) << (exponent - SUB_BUCKET_BITS);
+    return lower + width / 2;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file lllatencyhistogram.h
+ * @brief Lock-free log-linear histogram for latency percentiles
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+#ifndef LL_LLLATENCYHISTOGRAM_H
+#define LL_LLLATENCYHISTOGRAM_H
+
+#include <atomic>
+
+/**
+ * Fixed size histogram of durations in microseconds, from which approximate
+ * percentiles can be read. LLTrace event stats only keep min, mean and max,
+ * which hide the tail that makes a cache or a network request feel slow.
+ *
+ * Buckets are log-linear: each power of two is split in eight, so a
+ * percentile is reported within about 6% of the true value, from 1us up to
+ * over an hour. record() is a single relaxed atomic increment, so it can be
+ * called from any thread; readers get a consistent-enough snapshot.
+ */
+class LL_COMMON_API LLLatencyHistogram
+{
+public:
+    LLLatencyHistogram();
+
+    void record(U64 microseconds);
+
+    // Number of durations recorded since construction or the last reset()
+    U64 getCount() const;
+
+    /**
+     * Approximate duration below which the given fraction (0 to 1) of the
+     * recorded durations fall, in microseconds. Returns 0 if nothing was
+     * recorded.
+     */
+    U64 getPercentile(F32 fraction) const;
+
+    void reset();
+
+private:
+    static constexpr U32 SUB_BUCKET_BITS = 3;
+    static constexpr U32 SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    // Values up to 2^32us; anything larger lands in the last bucket
+    static constexpr U32 MAX_EXPONENT = 32;
+    static constexpr U32 NUM_BUCKETS = (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    static U32 getBucket(U64 microseconds);
+    static U64 getBucketMidpoint(U32 bucket);
+
+    std::atomic<U32> mBuckets[NUM_BUCKETS];
+};
+
+#endif // LL_LLLATENCYHISTOGRAM_H
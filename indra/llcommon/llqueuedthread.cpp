@@ -403,6 +403,147 @@ bool LLQueuedThread::check()
 //============================================================================
 // Runs on its OWN thread
 
+// <AS:Chanayane> Let subclasses process requests asynchronously
+// Split into beginRequest() and endRequest() below
+//void LLQueuedThread::processRequest(LLQueuedThread::QueuedRequest* req)
+//{
+//    LL_PROFILE_ZONE_SCOPED_CATEGORY_THREAD;
+//
+//    mIdleThread = false;
+//    //threadedUpdate();
+//
+//    // Get next request from pool
+//    lockData();
+//
+//    if ((req->getFlags() & FLAG_ABORT) || (mStatus == QUITTING))
+//    {
+//        LL_PROFILE_ZONE_NAMED_CATEGORY_THREAD("qtpr - abort");
+//        req->setStatus(STATUS_ABORTED);
+//        req->finishRequest(false);
+//        if (req->getFlags() & FLAG_AUTO_COMPLETE)
+//        {
+//            mRequestHash.erase(req);
+//            req->deleteRequest();
+////              check();
+//        }
+//        unlockData();
+//    }
+//    else
+//    {
+//        llassert_always(req->getStatus() == STATUS_QUEUED);
+//
+//        if (req)
+//        {
+//            req->setStatus(STATUS_INPROGRESS);
+//        }
+//        unlockData();
+//
+//        // This is the only place we will call req->setStatus() after
+//        // it has initially been seet to STATUS_QUEUED, so it is
+//        // safe to access req.
+//        if (req)
+//        {
+//            // <FS:Beq> Deferred retry requests
+//            // Avoid loop when idle by restoring a sleep
+//            // note that when there is nothing to do the thread still sleeps normally.
+//            using namespace std::chrono_literals;
+//
+//            const auto throttle_time = 2ms;
+//            if (req->mDeferUntil > LL::WorkQueue::TimePoint::clock::now())
+//            {
+//                ms_sleep((U32)throttle_time.count());
+//            }
+//            // if we're still not ready to retry then requeue
+//            if (req->mDeferUntil > LL::WorkQueue::TimePoint::clock::now())
+//            {
+//                LL_PROFILE_ZONE_NAMED("qtpr - defer requeue");
+//
+//                lockData();
+//                req->setStatus(STATUS_QUEUED);
+//                mRequestQueue.post([this, req]() { processRequest(req); });
+//                unlockData();
+//                mIdleThread = true;
+//                return;
+//            }
+//            // </FS:Beq>
+//            // process request
+//            bool complete = req->processRequest();
+//
+//            if (complete)
+//            {
+//                LL_PROFILE_ZONE_NAMED_CATEGORY_THREAD("qtpr - complete");
+//                lockData();
+//                req->setStatus(STATUS_COMPLETE);
+//                req->finishRequest(true);
+//                if (req->getFlags() & FLAG_AUTO_COMPLETE)
+//                {
+//                    mRequestHash.erase(req);
+//                    req->deleteRequest();
+//                    //              check();
+//                }
+//                unlockData();
+//            }
+//            else
+//            {
+//                LL_PROFILE_ZONE_NAMED_CATEGORY_THREAD("qtpr - retry");
+//                //put back on queue and try again in 0.1ms
+//                lockData();
+//                req->setStatus(STATUS_QUEUED);
+//
+//                unlockData();
+//
+//                llassert(!mDataLock->isSelfLocked());
+//
+//#if 0
+//                // try again on next frame
+//                // NOTE: tried using "post" with a time in the future, but this
+//                // would invariably cause this thread to wait for a long time (10+ ms)
+//                // while work is pending
+//                bool ret = LL::WorkQueue::postMaybe(
+//                    mMainQueue,
+//                    [=]()
+//                    {
+//                        LL_PROFILE_ZONE_NAMED("processRequest - retry");
+//                        mRequestQueue.post([=]()
+//                            {
+//                                LL_PROFILE_ZONE_NAMED("processRequest - retry"); // <-- not redundant, track retry on both queues
+//                                processRequest(req);
+//                            });
+//                    });
+//                llassert(ret);
+//#else
+//                using namespace std::chrono_literals;
+//                // <FS:Beq> improve retry behaviour
+//                // mRequestQueue.post([=, this]
+//                //     {
+//                //         LL_PROFILE_ZONE_NAMED("processRequest - retry");
+//                //         if (LL::WorkQueue::TimePoint::clock::now() < retry_time)
+//                //         {
+//                //             auto sleep_time = std::chrono::duration_cast<std::chrono::milliseconds>(retry_time - LL::WorkQueue::TimePoint::clock::now());
+//
+//                //             if (sleep_time.count() > 0)
+//                //             {
+//                //                 ms_sleep((U32)sleep_time.count());
+//                //             }
+//                //         }
+//                //         processRequest(req);
+//                //     });
+//                const auto retry_backoff = 16ms;
+//                auto retry_time = LL::WorkQueue::TimePoint::clock::now() + retry_backoff; 
+//                req->defer_until(retry_time);
+//                LL_PROFILE_ZONE_NAMED("processRequest - post deferred");
+//                mRequestQueue.post([this, req]() { processRequest(req); });
+//                // </FS:Beq>
+//#endif
+//
+//            }
+//        }
+//    }
+//
+//    mIdleThread = true;
+//}
+
+// virtual
 void LLQueuedThread::processRequest(LLQueuedThread::QueuedRequest* req)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_THREAD;
@@ -410,6 +551,18 @@ void LLQueuedThread::processRequest(LLQueuedThread::QueuedRequest* req)
     mIdleThread = false;
     //threadedUpdate();
 
+    if (beginRequest(req))
+    {
+        // process request
+        bool complete = req->processRequest();
+        endRequest(req, complete);
+    }
+
+    mIdleThread = true;
+}
+
+bool LLQueuedThread::beginRequest(LLQueuedThread::QueuedRequest* req)
+{
     // Get next request from pool
     lockData();
 
@@ -425,121 +578,114 @@ void LLQueuedThread::processRequest(LLQueuedThread::QueuedRequest* req)
 //              check();
         }
         unlockData();
+        return false;
     }
-    else
+
+    llassert_always(req->getStatus() == STATUS_QUEUED);
+
+    req->setStatus(STATUS_INPROGRESS);
+    unlockData();
+
+    // This is the only place we will call req->setStatus() after
+    // it has initially been seet to STATUS_QUEUED, so it is
+    // safe to access req.
+
+    // <FS:Beq> Deferred retry requests
+    // Avoid loop when idle by restoring a sleep
+    // note that when there is nothing to do the thread still sleeps normally.
+    using namespace std::chrono_literals;
+
+    const auto throttle_time = 2ms;
+    if (req->mDeferUntil > LL::WorkQueue::TimePoint::clock::now())
     {
-        llassert_always(req->getStatus() == STATUS_QUEUED);
+        ms_sleep((U32)throttle_time.count());
+    }
+    // if we're still not ready to retry then requeue
+    if (req->mDeferUntil > LL::WorkQueue::TimePoint::clock::now())
+    {
+        LL_PROFILE_ZONE_NAMED("qtpr - defer requeue");
 
-        if (req)
-        {
-            req->setStatus(STATUS_INPROGRESS);
-        }
+        lockData();
+        req->setStatus(STATUS_QUEUED);
+        mRequestQueue.post([this, req]() { processRequest(req); });
         unlockData();
+        return false;
+    }
+    // </FS:Beq>
+    return true;
+}
 
-        // This is the only place we will call req->setStatus() after
-        // it has initially been seet to STATUS_QUEUED, so it is
-        // safe to access req.
-        if (req)
+void LLQueuedThread::endRequest(LLQueuedThread::QueuedRequest* req, bool complete)
+{
+    if (complete)
+    {
+        LL_PROFILE_ZONE_NAMED_CATEGORY_THREAD("qtpr - complete");
+        lockData();
+        req->setStatus(STATUS_COMPLETE);
+        req->finishRequest(true);
+        if (req->getFlags() & FLAG_AUTO_COMPLETE)
         {
-            // <FS:Beq> Deferred retry requests
-            // Avoid loop when idle by restoring a sleep
-            // note that when there is nothing to do the thread still sleeps normally.
-            using namespace std::chrono_literals;
-
-            const auto throttle_time = 2ms;
-            if (req->mDeferUntil > LL::WorkQueue::TimePoint::clock::now())
-            {
-                ms_sleep((U32)throttle_time.count());
-            }
-            // if we're still not ready to retry then requeue
-            if (req->mDeferUntil > LL::WorkQueue::TimePoint::clock::now())
-            {
-                LL_PROFILE_ZONE_NAMED("qtpr - defer requeue");
-
-                lockData();
-                req->setStatus(STATUS_QUEUED);
-                mRequestQueue.post([this, req]() { processRequest(req); });
-                unlockData();
-                mIdleThread = true;
-                return;
-            }
-            // </FS:Beq>
-            // process request
-            bool complete = req->processRequest();
-
-            if (complete)
-            {
-                LL_PROFILE_ZONE_NAMED_CATEGORY_THREAD("qtpr - complete");
-                lockData();
-                req->setStatus(STATUS_COMPLETE);
-                req->finishRequest(true);
-                if (req->getFlags() & FLAG_AUTO_COMPLETE)
-                {
-                    mRequestHash.erase(req);
-                    req->deleteRequest();
-                    //              check();
-                }
-                unlockData();
-            }
-            else
-            {
-                LL_PROFILE_ZONE_NAMED_CATEGORY_THREAD("qtpr - retry");
-                //put back on queue and try again in 0.1ms
-                lockData();
-                req->setStatus(STATUS_QUEUED);
+            mRequestHash.erase(req);
+            req->deleteRequest();
+            //              check();
+        }
+        unlockData();
+    }
+    else
+    {
+        LL_PROFILE_ZONE_NAMED_CATEGORY_THREAD("qtpr - retry");
+        //put back on queue and try again in 0.1ms
+        lockData();
+        req->setStatus(STATUS_QUEUED);
 
-                unlockData();
+        unlockData();
 
-                llassert(!mDataLock->isSelfLocked());
+        llassert(!mDataLock->isSelfLocked());
 
 #if 0
-                // try again on next frame
-                // NOTE: tried using "post" with a time in the future, but this
-                // would invariably cause this thread to wait for a long time (10+ ms)
-                // while work is pending
-                bool ret = LL::WorkQueue::postMaybe(
-                    mMainQueue,
-                    [=]()
+        // try again on next frame
+        // NOTE: tried using "post" with a time in the future, but this
+        // would invariably cause this thread to wait for a long time (10+ ms)
+        // while work is pending
+        bool ret = LL::WorkQueue::postMaybe(
+            mMainQueue,
+            [=]()
+            {
+                LL_PROFILE_ZONE_NAMED("processRequest - retry");
+                mRequestQueue.post([=]()
                     {
-                        LL_PROFILE_ZONE_NAMED("processRequest - retry");
-                        mRequestQueue.post([=]()
-                            {
-                                LL_PROFILE_ZONE_NAMED("processRequest - retry"); // <-- not redundant, track retry on both queues
-                                processRequest(req);
-                            });
+                        LL_PROFILE_ZONE_NAMED("processRequest - retry"); // <-- not redundant, track retry on both queues
+                        processRequest(req);
                     });
-                llassert(ret);
+            });
+        llassert(ret);
 #else
-                using namespace std::chrono_literals;
-                // <FS:Beq> improve retry behaviour
-                // mRequestQueue.post([=, this]
-                //     {
-                //         LL_PROFILE_ZONE_NAMED("processRequest - retry");
-                //         if (LL::WorkQueue::TimePoint::clock::now() < retry_time)
-                //         {
-                //             auto sleep_time = std::chrono::duration_cast<std::chrono::milliseconds>(retry_time - LL::WorkQueue::TimePoint::clock::now());
-
-                //             if (sleep_time.count() > 0)
-                //             {
-                //                 ms_sleep((U32)sleep_time.count());
-                //             }
-                //         }
-                //         processRequest(req);
-                //     });
-                const auto retry_backoff = 16ms;
-                auto retry_time = LL::WorkQueue::TimePoint::clock::now() + retry_backoff; 
-                req->defer_until(retry_time);
-                LL_PROFILE_ZONE_NAMED("processRequest - post deferred");
-                mRequestQueue.post([this, req]() { processRequest(req); });
-                // </FS:Beq>
+        using namespace std::chrono_literals;
+        // <FS:Beq> improve retry behaviour
+        // mRequestQueue.post([=, this]
+        //     {
+        //         LL_PROFILE_ZONE_NAMED("processRequest - retry");
+        //         if (LL::WorkQueue::TimePoint::clock::now() < retry_time)
+        //         {
+        //             auto sleep_time = std::chrono::duration_cast<std::chrono::milliseconds>(retry_time - LL::WorkQueue::TimePoint::clock::now());
+
+        //             if (sleep_time.count() > 0)
+        //             {
+        //                 ms_sleep((U32)sleep_time.count());
+        //             }
+        //         }
+        //         processRequest(req);
+        //     });
+        const auto retry_backoff = 16ms;
+        auto retry_time = LL::WorkQueue::TimePoint::clock::now() + retry_backoff;
+        req->defer_until(retry_time);
+        LL_PROFILE_ZONE_NAMED("processRequest - post deferred");
+        mRequestQueue.post([this, req]() { processRequest(req); });
+        // </FS:Beq>
 #endif
-
-            }
-        }
     }
-
-    mIdleThread = true;
 }
+// </AS:Chanayane>
 
 // virtual
 bool LLQueuedThread::runCondition()
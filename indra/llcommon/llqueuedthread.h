@@ -136,7 +136,15 @@ private:
 protected:
     handle_t generateHandle();
     bool addRequest(QueuedRequest* req);
-    void processRequest(QueuedRequest* req);
+    // <AS:Chanayane> Let subclasses process requests asynchronously
+    //void processRequest(QueuedRequest* req);
+    virtual void processRequest(QueuedRequest* req);
+    // Split out of processRequest(): beginRequest() marks req as in progress
+    // and returns false if it was aborted or deferred instead, endRequest()
+    // completes it or schedules a retry.
+    bool beginRequest(QueuedRequest* req);
+    void endRequest(QueuedRequest* req, bool complete);
+    // </AS:Chanayane>
     void incQueue();
 
 public:
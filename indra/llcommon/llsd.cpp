@@ -34,6 +34,7 @@
 #include "llerror.h"
 #include "../llmath/llmath.h"
 #include "llformat.h"
+#include "llsdarena.h" // <AS:Chanayane/> LLSD arena allocation
 #include "llsdserialize.h"
 #include "stringize.h"
 
@@ -98,11 +99,22 @@ protected:
 
     virtual ~Impl();
 
-    bool shared() const                         { return (mUseCount > 1) && (mUseCount != STATIC_USAGE_COUNT); }
+    // <AS:Chanayane> LLSD arena allocation
+    // Static objects are shared too: the interned scalars handed out inside
+    // an LLSDArena::Scope must never be modified in place.
+    //bool shared() const                         { return (mUseCount > 1) && (mUseCount != STATIC_USAGE_COUNT); }
+    bool shared() const                         { return mUseCount > 1; }
+    // </AS:Chanayane>
 
     U32 mUseCount;
 
 public:
+    // <AS:Chanayane> LLSD arena allocation
+    static void* operator new(size_t size)      { return LLSDArena::allocate(size); }
+    static void operator delete(void* ptr)      { LLSDArena::free(ptr); }
+        ///< from the current LLSDArena if there is one, else the heap
+    // </AS:Chanayane>
+
     static void reset(Impl*& var, Impl* impl);
         ///< safely set var to refer to the new impl (possibly shared)
 
@@ -208,6 +220,8 @@ namespace
     public:
         ImplBase(DataRef value) : mValue(value) { }
         ImplBase(DataMove value) : mValue(std::move(value)) { }
+        // <AS:Chanayane/> LLSD arena allocation: interned scalars
+        ImplBase(DataRef value, StaticAllocationMarker marker) : Impl(marker), mValue(value) { }
 
         virtual LLSD::Type type() const { return T; }
 
@@ -240,6 +254,11 @@ namespace
     {
     public:
         ImplBoolean(LLSD::Boolean v) : Base(v) { }
+        // <AS:Chanayane> LLSD arena allocation
+        ImplBoolean(LLSD::Boolean v, StaticAllocationMarker marker) : Base(v, marker) { }
+
+        static ImplBoolean* interned(LLSD::Boolean v);
+        // </AS:Chanayane>
 
         virtual LLSD::Boolean   asBoolean() const   { return mValue; }
         virtual LLSD::Integer   asInteger() const   { return mValue ? 1 : 0; }
@@ -249,6 +268,15 @@ namespace
         virtual LLSD::String asXMLRPCValue() const { return mValue ? "<boolean>1</boolean>" : "<boolean>0</boolean>"; }
     };
 
+    // <AS:Chanayane> LLSD arena allocation
+    ImplBoolean* ImplBoolean::interned(LLSD::Boolean v)
+    {
+        static ImplBoolean sFalse(false, STATIC_USAGE_COUNT);
+        static ImplBoolean sTrue(true, STATIC_USAGE_COUNT);
+        return v ? &sTrue : &sFalse;
+    }
+    // </AS:Chanayane>
+
     LLSD::String ImplBoolean::asString() const
         // *NOTE: The reason that false is not converted to "false" is
         // because that would break roundtripping,
@@ -263,6 +291,15 @@ namespace
     {
     public:
         ImplInteger(LLSD::Integer v) : Base(v) { }
+        // <AS:Chanayane> LLSD arena allocation
+        ImplInteger(LLSD::Integer v, StaticAllocationMarker marker) : Base(v, marker) { }
+
+        static constexpr LLSD::Integer INTERNED_MIN = -128;
+        static constexpr LLSD::Integer INTERNED_MAX = 1023;
+
+        /// Shared immutable value for v, or nullptr if v is out of range.
+        static ImplInteger* interned(LLSD::Integer v);
+        // </AS:Chanayane>
 
         virtual LLSD::Boolean   asBoolean() const   { return mValue != 0; }
         virtual LLSD::Integer   asInteger() const   { return mValue; }
@@ -272,6 +309,28 @@ namespace
         virtual LLSD::String asXMLRPCValue() const { return "<int>" + std::to_string(mValue) + "</int>"; }
     };
 
+    // <AS:Chanayane> LLSD arena allocation
+    ImplInteger* ImplInteger::interned(LLSD::Integer v)
+    {
+        if (v < INTERNED_MIN || v > INTERNED_MAX)
+        {
+            return nullptr;
+        }
+        static ImplInteger* const sTable = []()
+            {
+                // deliberately never freed, like the other static values
+                const size_t count = INTERNED_MAX - INTERNED_MIN + 1;
+                ImplInteger* table = static_cast<ImplInteger*>(::operator new(count * sizeof(ImplInteger)));
+                for (size_t i = 0; i < count; ++i)
+                {
+                    ::new (table + i) ImplInteger(INTERNED_MIN + (LLSD::Integer)i, STATIC_USAGE_COUNT);
+                }
+                return table;
+            }();
+        return sTable + (v - INTERNED_MIN);
+    }
+    // </AS:Chanayane>
+
     LLSD::String ImplInteger::asString() const
         { return llformat("%d", mValue); }
 
@@ -431,7 +490,16 @@ namespace
     class ImplMap final : public LLSD::Impl
     {
     private:
-        typedef std::map<LLSD::String, LLSD, std::less<>> DataMap;
+        // <AS:Chanayane> LLSD arena allocation
+        //typedef std::map<LLSD::String, LLSD, std::less<>> DataMap;
+        typedef std::map<LLSD::String, LLSD, std::less<>,
+                         LLSDArenaAllocator<std::pair<const LLSD::String, LLSD>>> DataMap;
+        // The allocator only decides where the nodes live; iterators are
+        // still handed out as LLSD::map_iterator.
+        static_assert(std::is_same_v<DataMap::iterator, LLSD::map_iterator> &&
+                      std::is_same_v<DataMap::const_iterator, LLSD::map_const_iterator>,
+                      "LLSD map iterators must not depend on the node allocator");
+        // </AS:Chanayane>
 
         DataMap mData;
 
@@ -754,7 +822,12 @@ LLSD::Impl::Impl()
 }
 
 LLSD::Impl::Impl(StaticAllocationMarker)
-    : mUseCount(0)
+    // <AS:Chanayane> LLSD arena allocation
+    // Mark the object as static so that reset() never counts references to
+    // it, which would race between threads sharing the interned scalars.
+    //: mUseCount(0)
+    : mUseCount(STATIC_USAGE_COUNT)
+    // </AS:Chanayane>
 {
 }
 
@@ -826,12 +899,19 @@ void LLSD::Impl::assignUndefined(Impl*& var)
 
 void LLSD::Impl::assign(Impl*& var, LLSD::Boolean v)
 {
-    reset(var, new ImplBoolean(v));
+    // <AS:Chanayane> LLSD arena allocation
+    //reset(var, new ImplBoolean(v));
+    reset(var, LLSDArena::active() ? ImplBoolean::interned(v) : new ImplBoolean(v));
+    // </AS:Chanayane>
 }
 
 void LLSD::Impl::assign(Impl*& var, LLSD::Integer v)
 {
-    reset(var, new ImplInteger(v));
+    // <AS:Chanayane> LLSD arena allocation
+    //reset(var, new ImplInteger(v));
+    ImplInteger* interned = LLSDArena::active() ? ImplInteger::interned(v) : nullptr;
+    reset(var, interned ? interned : new ImplInteger(v));
+    // </AS:Chanayane>
 }
 
 void LLSD::Impl::assign(Impl*& var, LLSD::Real v)
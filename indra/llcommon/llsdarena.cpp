@@ -0,0 +1,157 @@
+/**
+ * @file llsdarena.cpp
+ * @brief Opt-in arena allocation for LLSD documents
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+#include "linden_common.h"
+#include "llsdarena.h"
+
+#include <new>
+
+// Every block starts with a pointer to the pool it was carved from, or
+// nullptr for blocks that came from the heap. Keeping it a single pointer
+// keeps the payload pointer aligned.
+static constexpr size_t BLOCK_HEADER = sizeof(void*);
+
+struct LLSDArena::Pool
+{
+    /// One reference for the owning LLSDArena plus one per live block.
+    std::atomic<size_t> mRefs{ 1 };
+    size_t mChunkSize;
+    char* mCurrent{ nullptr };
+    char* mEnd{ nullptr };
+    size_t mBytes{ 0 };
+    std::vector<void*> mChunks;
+
+    Pool(size_t chunk_size) : mChunkSize(chunk_size) { }
+
+    ~Pool()
+    {
+        for (void* chunk : mChunks)
+        {
+            ::operator delete(chunk);
+        }
+    }
+
+    void* allocate(size_t size)
+    {
+        // keep every block pointer aligned
+        size = (size + BLOCK_HEADER + alignof(void*) - 1) & ~(alignof(void*) - 1);
+        if (size > (size_t)(mEnd - mCurrent))
+        {
+            size_t chunk_size = llmax(mChunkSize, size);
+            char* chunk = static_cast<char*>(::operator new(chunk_size));
+            mChunks.push_back(chunk);
+            mCurrent = chunk;
+            mEnd = chunk + chunk_size;
+        }
+        char* block = mCurrent;
+        mCurrent += size;
+        mBytes += size;
+        mRefs.fetch_add(1, std::memory_order_relaxed);
+        *reinterpret_cast<Pool**>(block) = this;
+        return block + BLOCK_HEADER;
+    }
+
+    void release()
+    {
+        if (mRefs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete this;
+        }
+    }
+};
+
+static thread_local LLSDArena::Pool* sCurrentPool = nullptr;
+
+LLSDArena::LLSDArena(size_t chunk_size)
+    : mPool(new Pool(chunk_size))
+{
+}
+
+LLSDArena::~LLSDArena()
+{
+    llassert(sCurrentPool != mPool);
+    mPool->release();
+}
+
+LLSDArena::Scope::Scope(LLSDArena& arena)
+    : mPrevious(sCurrentPool)
+{
+    sCurrentPool = arena.mPool;
+}
+
+LLSDArena::Scope::~Scope()
+{
+    sCurrentPool = mPrevious;
+}
+
+size_t LLSDArena::getBytesAllocated() const
+{
+    return mPool->mBytes;
+}
+
+size_t LLSDArena::getChunkCount() const
+{
+    return mPool->mChunks.size();
+}
+
+// static
+bool LLSDArena::active()
+{
+    return sCurrentPool != nullptr;
+}
+
+// static
+void* LLSDArena::allocate(size_t size)
+{
+    if (sCurrentPool)
+    {
+        return sCurrentPool->allocate(size);
+    }
+    char* block = static_cast<char*>(::operator new(size + BLOCK_HEADER));
+    *reinterpret_cast<Pool**>(block) = nullptr;
+    return block + BLOCK_HEADER;
+}
+
+// static
+void LLSDArena::free(void* ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+    char* block = static_cast<char*>(ptr) - BLOCK_HEADER;
+    Pool* pool = *reinterpret_cast<Pool**>(block);
+    if (pool)
+    {
+        pool->release();
+    }
+    else
+    {
+        ::operator delete(block);
+    }
+}
@@ -0,0 +1,142 @@
+/**
+ * @file llsdarena.h
+ * @brief Opt-in arena allocation for LLSD documents
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+#ifndef LL_LLSDARENA_H
+#define LL_LLSDARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class LLSDArena
+ * @brief Bump allocator that backs the values of whole LLSD documents.
+ *
+ * Every non-trivial LLSD value is a small heap object, and every map entry
+ * is another node, so parsing a large response turns into hundreds of
+ * thousands of tiny allocations and as many frees when it goes away. While
+ * an LLSDArena::Scope is active on a thread, LLSD values created on that
+ * thread are carved out of the arena's chunks instead, and booleans and
+ * small integers share preallocated immutable values. Freeing such a value
+ * only decrements a counter; the chunks are released together once the
+ * arena object is gone and the last value allocated from it is destroyed.
+ *
+ * Values built in an arena are ordinary LLSD: they can be copied, modified,
+ * kept after the scope ends and released on another thread. The only cost
+ * of keeping one is that it keeps the whole arena alive, so this is meant
+ * for documents that are parsed, consumed and thrown away as a whole.
+ *
+ *    {
+ *        LLSDArena arena;
+ *        LLSDArena::Scope scope(arena);
+ *        LLSDSerialize::fromBinary(sd, data, size);
+ *    }
+ */
+class LL_COMMON_API LLSDArena
+{
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+    struct Pool;    // implementation detail, defined in llsdarena.cpp
+
+    LLSDArena(size_t chunk_size = DEFAULT_CHUNK_SIZE);
+    ~LLSDArena();
+
+    LLSDArena(const LLSDArena&) = delete;
+    LLSDArena& operator=(const LLSDArena&) = delete;
+
+    /**
+     * @brief Routes LLSD allocations made on this thread to an arena for
+     * its lifetime. Scopes nest; the innermost one wins.
+     */
+    class LL_COMMON_API Scope
+    {
+    public:
+        Scope(LLSDArena& arena);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Pool* mPrevious;
+    };
+
+    /// Bytes handed out of this arena's chunks so far.
+    size_t getBytesAllocated() const;
+    /// Number of chunks reserved so far.
+    size_t getChunkCount() const;
+
+    /// True if an arena scope is active on the calling thread.
+    static bool active();
+
+    /**
+     * Allocation entry points used by LLSD for its values and map nodes.
+     * Without an active scope these fall through to the heap; the block
+     * remembers where it came from so that free() can be called from any
+     * thread.
+     */
+    static void* allocate(size_t size);
+    static void free(void* ptr);
+
+private:
+    Pool* mPool;
+};
+
+/**
+ * @brief Standard allocator over LLSDArena::allocate()/free(), used for the
+ * nodes of LLSD maps. It is stateless, so containers using it compare and
+ * swap like containers using std::allocator.
+ */
+template <class T>
+struct LLSDArenaAllocator
+{
+    typedef T value_type;
+
+    LLSDArenaAllocator() noexcept = default;
+    template <class U>
+    LLSDArenaAllocator(const LLSDArenaAllocator<U>&) noexcept { }
+
+    T* allocate(size_t n)
+    {
+        static_assert(alignof(T) <= alignof(void*), "LLSDArena only guarantees pointer alignment");
+        return static_cast<T*>(LLSDArena::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t)
+    {
+        LLSDArena::free(p);
+    }
+
+    template <class U>
+    bool operator==(const LLSDArenaAllocator<U>&) const noexcept { return true; }
+    template <class U>
+    bool operator!=(const LLSDArenaAllocator<U>&) const noexcept { return false; }
+};
+
+#endif // LL_LLSDARENA_H
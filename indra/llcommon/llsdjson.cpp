@@ -37,6 +37,14 @@
 
 #include <boost/json/src.hpp>
 
+// <AS:Chanayane> Streaming JSON conversion
+#include <charconv>
+#include <cmath>
+#include <istream>
+#include <memory>
+#include <ostream>
+// </AS:Chanayane>
+
 //=========================================================================
 LLSD LlsdFromJson(const boost::json::value& val)
 {
@@ -141,3 +149,422 @@ boost::json::value LlsdToJson(const LLSD &val)
 
     return result;
 }
+
+// <AS:Chanayane> Streaming JSON conversion
+namespace
+{
+    // Size of the chunks read from the input stream, and of the output
+    // buffer flushed to the output stream.
+    constexpr size_t JSON_STREAM_CHUNK = 16 * 1024;
+
+    //=====================================================================
+    // boost::json::basic_parser handler building the LLSD in place. mStack
+    // holds the chain of open containers from the root down; each entry
+    // points into its parent's storage, which is not touched again until the
+    // child is closed, so the pointers stay valid.
+    class LLSDJsonHandler
+    {
+    public:
+        static constexpr size_t max_object_size = size_t(-1);
+        static constexpr size_t max_array_size = size_t(-1);
+        static constexpr size_t max_key_size = size_t(-1);
+        static constexpr size_t max_string_size = size_t(-1);
+
+        LLSDJsonHandler(LLSD& root) :
+            mRoot(root)
+        {
+        }
+
+        bool on_document_begin(boost::system::error_code&) { return true; }
+        bool on_document_end(boost::system::error_code&) { return true; }
+
+        bool on_object_begin(boost::system::error_code&)
+        {
+            LLSD& map = insert(LLSD::emptyMap());
+            mStack.push_back(&map);
+            return true;
+        }
+
+        bool on_object_end(size_t, boost::system::error_code&)
+        {
+            mStack.pop_back();
+            return true;
+        }
+
+        bool on_array_begin(boost::system::error_code&)
+        {
+            LLSD& array = insert(LLSD::emptyArray());
+            mStack.push_back(&array);
+            return true;
+        }
+
+        bool on_array_end(size_t, boost::system::error_code&)
+        {
+            mStack.pop_back();
+            return true;
+        }
+
+        bool on_key_part(boost::json::string_view part, size_t, boost::system::error_code&)
+        {
+            mKey.append(part.data(), part.size());
+            return true;
+        }
+
+        bool on_key(boost::json::string_view part, size_t, boost::system::error_code&)
+        {
+            mKey.append(part.data(), part.size());
+            return true;
+        }
+
+        bool on_string_part(boost::json::string_view part, size_t, boost::system::error_code&)
+        {
+            mString.append(part.data(), part.size());
+            return true;
+        }
+
+        bool on_string(boost::json::string_view part, size_t, boost::system::error_code&)
+        {
+            mString.append(part.data(), part.size());
+            insert(LLSD(std::move(mString)));
+            mString.clear();
+            return true;
+        }
+
+        bool on_number_part(boost::json::string_view, boost::system::error_code&) { return true; }
+
+        bool on_int64(int64_t value, boost::json::string_view, boost::system::error_code&)
+        {
+            insert(LLSD(value));
+            return true;
+        }
+
+        bool on_uint64(uint64_t value, boost::json::string_view, boost::system::error_code&)
+        {
+            insert(LLSD(value));
+            return true;
+        }
+
+        bool on_double(double value, boost::json::string_view, boost::system::error_code&)
+        {
+            insert(LLSD(value));
+            return true;
+        }
+
+        bool on_bool(bool value, boost::system::error_code&)
+        {
+            insert(LLSD(value));
+            return true;
+        }
+
+        bool on_null(boost::system::error_code&)
+        {
+            insert(LLSD());
+            return true;
+        }
+
+        bool on_comment_part(boost::json::string_view, boost::system::error_code&) { return true; }
+        bool on_comment(boost::json::string_view, boost::system::error_code&) { return true; }
+
+    private:
+        LLSD& insert(LLSD&& value)
+        {
+            if (mStack.empty())
+            {
+                mRoot = std::move(value);
+                return mRoot;
+            }
+            LLSD& parent = *mStack.back();
+            if (parent.isArray())
+            {
+                return parent.append(value);
+            }
+            LLSD& member = parent[mKey];
+            member = std::move(value);
+            mKey.clear();
+            return member;
+        }
+
+        LLSD&               mRoot;
+        std::vector<LLSD*>  mStack;
+        std::string         mKey;
+        std::string         mString;
+    };
+
+    typedef boost::json::basic_parser<LLSDJsonHandler> llsd_json_parser_t;
+
+    //=====================================================================
+    // Appends JSON text to a string, handing it on to the output stream (if
+    // any) whenever a chunk's worth has accumulated.
+    class LLSDJsonWriter
+    {
+    public:
+        LLSDJsonWriter(std::string& buffer, std::ostream* out) :
+            mBuffer(buffer),
+            mOut(out)
+        {
+        }
+
+        void write(const LLSD& val)
+        {
+            switch (val.type())
+            {
+            case LLSD::TypeUndefined:
+                mBuffer.append("null", 4);
+                break;
+            case LLSD::TypeBoolean:
+                if (val.asBoolean())
+                {
+                    mBuffer.append("true", 4);
+                }
+                else
+                {
+                    mBuffer.append("false", 5);
+                }
+                break;
+            case LLSD::TypeInteger:
+                writeInteger(val.asInteger());
+                break;
+            case LLSD::TypeReal:
+                writeReal(val.asReal());
+                break;
+            case LLSD::TypeURI:
+            case LLSD::TypeDate:
+            case LLSD::TypeUUID:
+                writeString(val.asString());
+                break;
+            case LLSD::TypeString:
+                // No copy for the common case.
+                writeString(val.asStringRef());
+                break;
+            case LLSD::TypeMap:
+            {
+                mBuffer.push_back('{');
+                bool first = true;
+                for (const auto& llsd_dat : llsd::inMap(val))
+                {
+                    if (!first)
+                    {
+                        mBuffer.push_back(',');
+                    }
+                    first = false;
+                    writeString(llsd_dat.first);
+                    mBuffer.push_back(':');
+                    write(llsd_dat.second);
+                }
+                mBuffer.push_back('}');
+                break;
+            }
+            case LLSD::TypeArray:
+            {
+                mBuffer.push_back('[');
+                bool first = true;
+                for (const auto& llsd_dat : llsd::inArray(val))
+                {
+                    if (!first)
+                    {
+                        mBuffer.push_back(',');
+                    }
+                    first = false;
+                    write(llsd_dat);
+                }
+                mBuffer.push_back(']');
+                break;
+            }
+            case LLSD::TypeBinary:
+            default:
+                LL_ERRS("LlsdToJson") << "Unsupported conversion to JSON from LLSD type ("
+                                      << val.type() << ")." << LL_ENDL;
+                break;
+            }
+
+            if (mOut && mBuffer.size() >= JSON_STREAM_CHUNK)
+            {
+                flush();
+            }
+        }
+
+        void flush()
+        {
+            if (mOut && !mBuffer.empty())
+            {
+                mOut->write(mBuffer.data(), mBuffer.size());
+                mBuffer.clear();
+            }
+        }
+
+    private:
+        void writeInteger(LLSD::Integer value)
+        {
+            char digits[16];
+            auto res = std::to_chars(digits, digits + sizeof(digits), value);
+            mBuffer.append(digits, res.ptr - digits);
+        }
+
+        void writeReal(LLSD::Real value)
+        {
+            // Same spelling as boost::json::serialize() for the values JSON
+            // cannot represent.
+            if (std::isnan(value))
+            {
+                mBuffer.append("null", 4);
+                return;
+            }
+            if (std::isinf(value))
+            {
+                mBuffer.append(value < 0 ? "-1e99999" : "1e99999");
+                return;
+            }
+
+            // Shortest of the two precisions that reads back exactly. The C
+            // locale is not guaranteed here, hence the decimal point fixup.
+            char digits[32];
+            int len = snprintf(digits, sizeof(digits), "%.15g", value);
+            if (strtod(digits, nullptr) != value)
+            {
+                len = snprintf(digits, sizeof(digits), "%.17g", value);
+            }
+            bool is_integral = true;
+            for (int i = 0; i < len; ++i)
+            {
+                char c = digits[i];
+                if (c == ',')
+                {
+                    digits[i] = '.';
+                }
+                if (c == '.' || c == ',' || c == 'e')
+                {
+                    is_integral = false;
+                }
+            }
+            mBuffer.append(digits, len);
+            if (is_integral)
+            {
+                // Keep it a real when read back.
+                mBuffer.append(".0", 2);
+            }
+        }
+
+        void writeString(std::string_view str)
+        {
+            static const char hex[] = "0123456789abcdef";
+
+            mBuffer.push_back('"');
+            const char* run = str.data();
+            const char* end = run + str.size();
+            for (const char* p = run; p != end; ++p)
+            {
+                unsigned char c = (unsigned char)*p;
+                if (c >= 0x20 && c != '"' && c != '\\')
+                {
+                    continue;
+                }
+                mBuffer.append(run, p - run);
+                run = p + 1;
+                mBuffer.push_back('\\');
+                switch (c)
+                {
+                case '"':  mBuffer.push_back('"'); break;
+                case '\\': mBuffer.push_back('\\'); break;
+                case '\b': mBuffer.push_back('b'); break;
+                case '\f': mBuffer.push_back('f'); break;
+                case '\n': mBuffer.push_back('n'); break;
+                case '\r': mBuffer.push_back('r'); break;
+                case '\t': mBuffer.push_back('t'); break;
+                default:
+                    mBuffer.append("u00", 3);
+                    mBuffer.push_back(hex[c >> 4]);
+                    mBuffer.push_back(hex[c & 0xf]);
+                    break;
+                }
+            }
+            mBuffer.append(run, end - run);
+            mBuffer.push_back('"');
+        }
+
+        std::string&    mBuffer;
+        std::ostream*   mOut;
+    };
+}
+
+//=========================================================================
+bool LlsdFromJsonString(std::string_view text, LLSD& result, boost::system::error_code& ec)
+{
+    result.clear();
+    llsd_json_parser_t parser(boost::json::parse_options(), result);
+    size_t used = parser.write_some(false, text.data(), text.size(), ec);
+    if (!ec && used < text.size())
+    {
+        ec = boost::json::error::extra_data;
+    }
+    if (ec)
+    {
+        result.clear();
+        return false;
+    }
+    return true;
+}
+
+//=========================================================================
+bool LlsdFromJsonStream(std::istream& in, LLSD& result, boost::system::error_code& ec)
+{
+    result.clear();
+    llsd_json_parser_t parser(boost::json::parse_options(), result);
+    std::unique_ptr<char[]> chunk(new char[JSON_STREAM_CHUNK]);
+    while (!ec && in.good())
+    {
+        in.read(chunk.get(), JSON_STREAM_CHUNK);
+        size_t count = (size_t)in.gcount();
+        if (count && parser.done())
+        {
+            // Only trailing whitespace may follow a complete document.
+            for (size_t i = 0; i < count; ++i)
+            {
+                char c = chunk[i];
+                if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+                {
+                    ec = boost::json::error::extra_data;
+                    break;
+                }
+            }
+        }
+        else if (count)
+        {
+            size_t used = parser.write_some(true, chunk.get(), count, ec);
+            if (!ec && used < count)
+            {
+                ec = boost::json::error::extra_data;
+            }
+        }
+    }
+    if (!ec && !parser.done())
+    {
+        // Flush a trailing number and report a truncated document.
+        parser.write_some(false, nullptr, 0, ec);
+    }
+    if (ec)
+    {
+        result.clear();
+        return false;
+    }
+    return true;
+}
+
+//=========================================================================
+void LlsdToJsonStream(const LLSD& val, std::ostream& out)
+{
+    std::string buffer;
+    buffer.reserve(JSON_STREAM_CHUNK * 2);
+    LLSDJsonWriter writer(buffer, &out);
+    writer.write(val);
+    writer.flush();
+}
+
+//=========================================================================
+std::string LlsdToJsonString(const LLSD& val)
+{
+    std::string buffer;
+    LLSDJsonWriter writer(buffer, nullptr);
+    writer.write(val);
+    return buffer;
+}
+// </AS:Chanayane>
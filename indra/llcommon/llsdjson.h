@@ -27,8 +27,10 @@
 #ifndef LL_LLSDJSON_H
 #define LL_LLSDJSON_H
 
+#include <iosfwd>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "stdtypes.h"
@@ -74,4 +76,20 @@ LLSD LlsdFromJson(const boost::json::value &val);
 /// TypeBinary    | unsupported
 boost::json::value LlsdToJson(const LLSD &val);
 
+// <AS:Chanayane> Streaming JSON conversion
+/// Parse JSON text directly into LLSD, without building a boost::json::value
+/// tree first. The parser is driven from the stream a chunk at a time, so the
+/// whole document never has to be held in memory twice. Types are mapped as
+/// for LlsdFromJson(). Returns false and sets ec if the text is not valid
+/// JSON, in which case result is left undefined.
+bool LlsdFromJsonStream(std::istream& in, LLSD& result, boost::system::error_code& ec);
+bool LlsdFromJsonString(std::string_view text, LLSD& result, boost::system::error_code& ec);
+
+/// Write an LLSD object as JSON text straight from a walk of the LLSD, without
+/// building a boost::json::value tree first. Types are mapped as for
+/// LlsdToJson(), and as there TypeBinary is unsupported.
+void LlsdToJsonStream(const LLSD& val, std::ostream& out);
+std::string LlsdToJsonString(const LLSD& val);
+// </AS:Chanayane>
+
 #endif // LL_LLSDJSON_H
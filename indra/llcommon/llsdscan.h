@@ -0,0 +1,109 @@
+/**
+ * @file llsdscan.h
+ * @brief SSE2 byte scanners used by the LLSD text parsers
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+#ifndef LL_LLSDSCAN_H
+#define LL_LLSDSCAN_H
+
+#include <bit>
+
+#if LL_ARM64
+#include "sse2neon.h"
+#else
+#include <emmintrin.h>
+#endif
+
+// The LLSD text parsers spend most of their time looking for a handful of
+// byte values (string delimiters, escapes, whitespace) in otherwise
+// uninteresting runs of text. These helpers test 16 bytes per iteration and
+// fall back to a plain loop for the tail. They never read outside
+// [begin, end).
+
+/**
+ * @brief Return a pointer to the first occurrence of c in [begin, end), or
+ * end if there is none.
+ */
+inline const char* llsd_find_byte(const char* begin, const char* end, char c)
+{
+    const __m128i needle = _mm_set1_epi8(c);
+    while (end - begin >= 16)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        const unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+        if (mask)
+        {
+            return begin + std::countr_zero(mask);
+        }
+        begin += 16;
+    }
+    while (begin < end && *begin != c)
+    {
+        ++begin;
+    }
+    return begin;
+}
+
+/**
+ * @brief True for the characters matched by "\s" in the C locale: space,
+ * \\t, \\n, \\v, \\f and \\r.
+ */
+inline bool llsd_is_space(char c)
+{
+    return c == ' ' || (unsigned char)(c - '\t') <= (unsigned char)('\r' - '\t');
+}
+
+/**
+ * @brief Return a pointer to the first whitespace character (as defined by
+ * llsd_is_space()) in [begin, end), or end if there is none.
+ */
+inline const char* llsd_find_space(const char* begin, const char* end)
+{
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i range = _mm_set1_epi8('\r' - '\t');
+    const __m128i space = _mm_set1_epi8(' ');
+    while (end - begin >= 16)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        // (c - '\t') <= ('\r' - '\t') as an unsigned compare: min(x, r) == x
+        const __m128i offset = _mm_sub_epi8(block, tab);
+        const __m128i in_range = _mm_cmpeq_epi8(_mm_min_epu8(offset, range), offset);
+        const __m128i is_space = _mm_or_si128(in_range, _mm_cmpeq_epi8(block, space));
+        const unsigned mask = (unsigned)_mm_movemask_epi8(is_space);
+        if (mask)
+        {
+            return begin + std::countr_zero(mask);
+        }
+        begin += 16;
+    }
+    while (begin < end && !llsd_is_space(*begin))
+    {
+        ++begin;
+    }
+    return begin;
+}
+
+#endif // LL_LLSDSCAN_H
@@ -50,6 +50,7 @@
 #include "lldate.h"
 #include "llmemorystream.h"
 #include "llsd.h"
+#include "llsdscan.h" // <AS:Chanayane/> SIMD text parsing
 #include "llstring.h"
 #include "lluri.h"
 
@@ -1297,6 +1298,697 @@ bool LLSDBinaryParser::parseString(
 }
 
 
+// <AS:Chanayane> Zero-copy binary LLSD parsing
+namespace
+{
+// Nesting limit when stepping over values in LLSDBinaryView, which recurses
+const S32 BINARY_VIEW_MAX_DEPTH = 256;
+
+/**
+ * Binary LLSD reader walking a memory buffer. parse() mirrors
+ * LLSDBinaryParser::doParse() but reads with pointer arithmetic and checks
+ * every length against the end of the buffer instead of a byte budget.
+ */
+class LLSDBinarySpanReader
+{
+public:
+    LLSDBinarySpanReader(const U8* data, const U8* end) : mCur(data), mEnd(end) {}
+
+    const U8* getPos() const { return mCur; }
+    size_t remaining() const { return mEnd - mCur; }
+
+    int peek() const { return mCur < mEnd ? *mCur : EOF; }
+    int get() { return mCur < mEnd ? *mCur++ : EOF; }
+
+    bool advance(size_t bytes)
+    {
+        if (bytes > remaining())
+        {
+            return false;
+        }
+        mCur += bytes;
+        return true;
+    }
+
+    bool readRaw(void* out, size_t bytes)
+    {
+        if (bytes > remaining())
+        {
+            return false;
+        }
+        memcpy(out, mCur, bytes);
+        mCur += bytes;
+        return true;
+    }
+
+    // 4 byte size in network byte order
+    bool readSize(S32& size)
+    {
+        U32 value_nbo = 0;
+        if (!readRaw(&value_nbo, sizeof(U32)))
+        {
+            return false;
+        }
+        size = (S32)ntohl(value_nbo);
+        return true;
+    }
+
+    // Size followed by that many bytes, returned in place
+    bool readSized(std::string_view& value)
+    {
+        S32 size = 0;
+        if (!readSize(size) || size < 0 || (size_t)size > remaining())
+        {
+            return false;
+        }
+        value = std::string_view((const char*)mCur, size);
+        mCur += size;
+        return true;
+    }
+
+    // Notation style string, the opening delimiter already read
+    bool readDelimited(char delim, std::string& value)
+    {
+        LLMemoryStream istr(mCur, (S32)llmin(remaining(), (size_t)S32_MAX));
+        llssize count = deserialize_string_delim(istr, value, delim);
+        if (LLSDParser::PARSE_FAILURE == count)
+        {
+            return false;
+        }
+        mCur += count;
+        return true;
+    }
+
+    bool skipDelimited(char delim)
+    {
+        while (mCur < mEnd)
+        {
+            char c = (char)*mCur++;
+            if (c == '\\')
+            {
+                if (mCur >= mEnd)
+                {
+                    return false;
+                }
+                if (*mCur++ == 'x' && !advance(2))
+                {
+                    return false;
+                }
+            }
+            else if (c == delim)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Map key following marker c. Like LLSDBinaryParser::parseMap(), an
+    // unknown marker gives an empty key.
+    bool readKey(int c, std::string_view& key, std::string& storage)
+    {
+        switch (c)
+        {
+        case 'k':
+            return readSized(key);
+        case '\'':
+        case '"':
+            if (!readDelimited((char)c, storage))
+            {
+                return false;
+            }
+            key = storage;
+            return true;
+        default:
+            key = std::string_view();
+            return true;
+        }
+    }
+
+    S32 parse(LLSD& data, S32 max_depth);
+    bool skip(S32 max_depth);
+
+private:
+    S32 parseMap(LLSD& map, S32 max_depth);
+    S32 parseArray(LLSD& array, S32 max_depth);
+
+    const U8* mCur;
+    const U8* mEnd;
+};
+
+S32 LLSDBinarySpanReader::parse(LLSD& data, S32 max_depth)
+{
+    if (mCur >= mEnd)
+    {
+        return 0;
+    }
+    if (max_depth == 0)
+    {
+        return LLSDParser::PARSE_FAILURE;
+    }
+
+    S32 parse_count = 1;
+    char c = (char)*mCur++;
+    switch (c)
+    {
+    case '{':
+    {
+        S32 child_count = parseMap(data, max_depth - 1);
+        if ((child_count == LLSDParser::PARSE_FAILURE) || data.isUndefined())
+        {
+            parse_count = LLSDParser::PARSE_FAILURE;
+        }
+        else
+        {
+            parse_count += child_count;
+        }
+        break;
+    }
+
+    case '[':
+    {
+        S32 child_count = parseArray(data, max_depth - 1);
+        if ((child_count == LLSDParser::PARSE_FAILURE) || data.isUndefined())
+        {
+            parse_count = LLSDParser::PARSE_FAILURE;
+        }
+        else
+        {
+            parse_count += child_count;
+        }
+        break;
+    }
+
+    case '!':
+        data.clear();
+        break;
+
+    case '0':
+        data = false;
+        break;
+
+    case '1':
+        data = true;
+        break;
+
+    case 'i':
+    {
+        U32 value_nbo = 0;
+        if (readRaw(&value_nbo, sizeof(U32)))
+        {
+            data = (S32)ntohl(value_nbo);
+        }
+        else
+        {
+            parse_count = LLSDParser::PARSE_FAILURE;
+        }
+        break;
+    }
+
+    case 'r':
+    {
+        F64 real_nbo = 0.0;
+        if (readRaw(&real_nbo, sizeof(F64)))
+        {
+            data = ll_ntohd(real_nbo);
+        }
+        else
+        {
+            parse_count = LLSDParser::PARSE_FAILURE;
+        }
+        break;
+    }
+
+    case 'u':
+    {
+        LLUUID id;
+        if (readRaw(id.mData, UUID_BYTES))
+        {
+            data = id;
+        }
+        else
+        {
+            parse_count = LLSDParser::PARSE_FAILURE;
+        }
+        break;
+    }
+
+    case '\'':
+    case '"':
+    {
+        std::string value;
+        if (readDelimited(c, value))
+        {
+            data = std::move(value);
+        }
+        else
+        {
+            parse_count = LLSDParser::PARSE_FAILURE;
+        }
+        break;
+    }
+
+    case 's':
+    {
+        std::string_view value;
+        if (readSized(value))
+        {
+            data = std::string(value);
+        }
+        else
+        {
+            parse_count = LLSDParser::PARSE_FAILURE;
+        }
+        break;
+    }
+
+    case 'l':
+    {
+        std::string_view value;
+        if (readSized(value))
+        {
+            data = LLURI(std::string(value));
+        }
+        else
+        {
+            parse_count = LLSDParser::PARSE_FAILURE;
+        }
+        break;
+    }
+
+    case 'd':
+    {
+        F64 real = 0.0;
+        if (readRaw(&real, sizeof(F64)))
+        {
+            data = LLDate(real);
+        }
+        else
+        {
+            parse_count = LLSDParser::PARSE_FAILURE;
+        }
+        break;
+    }
+
+    case 'b':
+    {
+        std::string_view value;
+        if (readSized(value))
+        {
+            const U8* bytes = (const U8*)value.data();
+            data = LLSD::Binary(bytes, bytes + value.size());
+        }
+        else
+        {
+            parse_count = LLSDParser::PARSE_FAILURE;
+        }
+        break;
+    }
+
+    default:
+        parse_count = LLSDParser::PARSE_FAILURE;
+        LL_INFOS() << "Unrecognized character while parsing: int(" << int(c)
+            << ")" << LL_ENDL;
+        break;
+    }
+    if (LLSDParser::PARSE_FAILURE == parse_count)
+    {
+        data.clear();
+    }
+    return parse_count;
+}
+
+S32 LLSDBinarySpanReader::parseMap(LLSD& map, S32 max_depth)
+{
+    map = LLSD::emptyMap();
+    S32 size = 0;
+    if (!readSize(size))
+    {
+        return LLSDParser::PARSE_FAILURE;
+    }
+
+    S32 parse_count = 0;
+    S32 count = 0;
+    std::string storage;
+    int c = get();
+    while ((c != '}') && (count < size) && (c != EOF))
+    {
+        // Keys are inserted straight from the buffer, the map node makes
+        // the only copy.
+        std::string_view name;
+        if (!readKey(c, name, storage))
+        {
+            return LLSDParser::PARSE_FAILURE;
+        }
+        LLSD child;
+        S32 child_count = parse(child, max_depth);
+        if (child_count > 0)
+        {
+            parse_count += child_count;
+            map.insert(name, child);
+        }
+        else
+        {
+            return LLSDParser::PARSE_FAILURE;
+        }
+        ++count;
+        c = get();
+    }
+    if ((c != '}') || (count < size))
+    {
+        return LLSDParser::PARSE_FAILURE;
+    }
+    return parse_count;
+}
+
+S32 LLSDBinarySpanReader::parseArray(LLSD& array, S32 max_depth)
+{
+    array = LLSD::emptyArray();
+    S32 size = 0;
+    if (!readSize(size))
+    {
+        return LLSDParser::PARSE_FAILURE;
+    }
+
+    // Every element takes at least one byte, so a size that fits in what
+    // is left of the buffer is safe to allocate up front.
+    if (size > 0 && (size_t)size <= remaining())
+    {
+        array[size - 1] = LLSD();
+    }
+
+    S32 parse_count = 0;
+    S32 count = 0;
+    int c = peek();
+    while ((c != ']') && (count < size) && (c != EOF))
+    {
+        S32 child_count = parse(array[count], max_depth);
+        if (LLSDParser::PARSE_FAILURE == child_count)
+        {
+            return LLSDParser::PARSE_FAILURE;
+        }
+        parse_count += child_count;
+        ++count;
+        c = peek();
+    }
+    c = get();
+    if ((c != ']') || (count < size))
+    {
+        return LLSDParser::PARSE_FAILURE;
+    }
+    return parse_count;
+}
+
+bool LLSDBinarySpanReader::skip(S32 max_depth)
+{
+    if (mCur >= mEnd || max_depth == 0)
+    {
+        return false;
+    }
+
+    char c = (char)*mCur++;
+    switch (c)
+    {
+    case '!':
+    case '0':
+    case '1':
+        return true;
+    case 'i':
+        return advance(sizeof(U32));
+    case 'r':
+    case 'd':
+        return advance(sizeof(F64));
+    case 'u':
+        return advance(UUID_BYTES);
+    case '\'':
+    case '"':
+        return skipDelimited(c);
+    case 's':
+    case 'l':
+    case 'b':
+    {
+        std::string_view value;
+        return readSized(value);
+    }
+    case '{':
+    {
+        S32 size = 0;
+        if (!readSize(size))
+        {
+            return false;
+        }
+        S32 count = 0;
+        int key_c = get();
+        while ((key_c != '}') && (count < size) && (key_c != EOF))
+        {
+            bool key_ok = true;
+            if (key_c == 'k')
+            {
+                std::string_view key;
+                key_ok = readSized(key);
+            }
+            else if (key_c == '\'' || key_c == '"')
+            {
+                key_ok = skipDelimited((char)key_c);
+            }
+            if (!key_ok || !skip(max_depth - 1))
+            {
+                return false;
+            }
+            ++count;
+            key_c = get();
+        }
+        return (key_c == '}') && (count >= size);
+    }
+    case '[':
+    {
+        S32 size = 0;
+        if (!readSize(size))
+        {
+            return false;
+        }
+        S32 count = 0;
+        while ((peek() != ']') && (count < size) && (peek() != EOF))
+        {
+            if (!skip(max_depth - 1))
+            {
+                return false;
+            }
+            ++count;
+        }
+        return (get() == ']') && (count >= size);
+    }
+    default:
+        return false;
+    }
+}
+} // anonymous namespace
+
+// static
+S32 LLSDSerialize::fromBinary(LLSD& sd, const U8* data, size_t size, S32 max_depth, size_t* bytes_read)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_LLSD;
+    LLSDBinarySpanReader reader(data, data + size);
+    S32 parse_count = reader.parse(sd, max_depth);
+    if (bytes_read)
+    {
+        *bytes_read = reader.getPos() - data;
+    }
+    return parse_count;
+}
+
+/**
+ * LLSDBinaryView
+ */
+LLSDBinaryView::LLSDBinaryView()
+:   mData(nullptr),
+    mEnd(nullptr)
+{
+}
+
+LLSDBinaryView::LLSDBinaryView(const U8* data, size_t size)
+:   mData(data),
+    mEnd(data + size)
+{
+}
+
+LLSD::Type LLSDBinaryView::type() const
+{
+    if (!mData || mData >= mEnd)
+    {
+        return LLSD::TypeUndefined;
+    }
+    switch (*mData)
+    {
+    case '{':   return LLSD::TypeMap;
+    case '[':   return LLSD::TypeArray;
+    case '0':
+    case '1':   return LLSD::TypeBoolean;
+    case 'i':   return LLSD::TypeInteger;
+    case 'r':   return LLSD::TypeReal;
+    case 'u':   return LLSD::TypeUUID;
+    case '\'':
+    case '"':
+    case 's':   return LLSD::TypeString;
+    case 'l':   return LLSD::TypeURI;
+    case 'd':   return LLSD::TypeDate;
+    case 'b':   return LLSD::TypeBinary;
+    default:    return LLSD::TypeUndefined;
+    }
+}
+
+size_t LLSDBinaryView::size() const
+{
+    if (!isMap() && !isArray())
+    {
+        return 0;
+    }
+    LLSDBinarySpanReader reader(mData + 1, mEnd);
+    S32 size = 0;
+    return reader.readSize(size) && size > 0 ? size : 0;
+}
+
+bool LLSDBinaryView::visitMap(const map_visitor_t& visitor) const
+{
+    if (!isMap())
+    {
+        return false;
+    }
+    LLSDBinarySpanReader reader(mData + 1, mEnd);
+    S32 size = 0;
+    if (!reader.readSize(size))
+    {
+        return false;
+    }
+    std::string storage;
+    for (S32 count = 0; count < size; ++count)
+    {
+        int c = reader.get();
+        std::string_view key;
+        if (c == '}' || c == EOF || !reader.readKey(c, key, storage))
+        {
+            return false;
+        }
+        if (!visitor(key, LLSDBinaryView(reader.getPos(), mEnd - reader.getPos())))
+        {
+            return true;
+        }
+        if (!reader.skip(BINARY_VIEW_MAX_DEPTH))
+        {
+            return false;
+        }
+    }
+    return reader.get() == '}';
+}
+
+bool LLSDBinaryView::visitArray(const array_visitor_t& visitor) const
+{
+    if (!isArray())
+    {
+        return false;
+    }
+    LLSDBinarySpanReader reader(mData + 1, mEnd);
+    S32 size = 0;
+    if (!reader.readSize(size))
+    {
+        return false;
+    }
+    for (S32 count = 0; count < size; ++count)
+    {
+        if (reader.peek() == ']' || reader.peek() == EOF)
+        {
+            return false;
+        }
+        if (!visitor(count, LLSDBinaryView(reader.getPos(), mEnd - reader.getPos())))
+        {
+            return true;
+        }
+        if (!reader.skip(BINARY_VIEW_MAX_DEPTH))
+        {
+            return false;
+        }
+    }
+    return reader.get() == ']';
+}
+
+bool LLSDBinaryView::has(std::string_view key) const
+{
+    bool found = false;
+    visitMap([&](std::string_view k, const LLSDBinaryView&)
+             {
+                 found = (k == key);
+                 return !found;
+             });
+    return found;
+}
+
+LLSDBinaryView LLSDBinaryView::operator[](std::string_view key) const
+{
+    // First match, as the parser keeps the first of duplicate keys
+    LLSDBinaryView result;
+    visitMap([&](std::string_view k, const LLSDBinaryView& value)
+             {
+                 if (k != key)
+                 {
+                     return true;
+                 }
+                 result = value;
+                 return false;
+             });
+    return result;
+}
+
+LLSDBinaryView LLSDBinaryView::operator[](size_t index) const
+{
+    LLSDBinaryView result;
+    visitArray([&](size_t i, const LLSDBinaryView& value)
+               {
+                   if (i != index)
+                   {
+                       return true;
+                   }
+                   result = value;
+                   return false;
+               });
+    return result;
+}
+
+LLSD LLSDBinaryView::asLLSD(S32 max_depth) const
+{
+    LLSD sd;
+    if (mData && mData < mEnd)
+    {
+        LLSDSerialize::fromBinary(sd, mData, mEnd - mData, max_depth);
+    }
+    return sd;
+}
+
+std::string_view LLSDBinaryView::asStringView() const
+{
+    std::string_view value;
+    if (mData && mData < mEnd && (*mData == 's' || *mData == 'l'))
+    {
+        LLSDBinarySpanReader reader(mData + 1, mEnd);
+        if (!reader.readSized(value))
+        {
+            value = std::string_view();
+        }
+    }
+    return value;
+}
+
+size_t LLSDBinaryView::getEncodedSize() const
+{
+    if (!mData)
+    {
+        return 0;
+    }
+    LLSDBinarySpanReader reader(mData, mEnd);
+    return reader.skip(BINARY_VIEW_MAX_DEPTH) ? reader.getPos() - mData : 0;
+}
+// </AS:Chanayane>
+
+
 /**
  * LLSDFormatter
  */
@@ -1687,108 +2379,156 @@ llssize deserialize_string(std::istream& istr, std::string& value, llssize max_b
     return rv + 1; // account for the character grabbed at the top.
 }
 
-llssize deserialize_string_delim(
-    std::istream& istr,
-    std::string& value,
-    char delim)
+// <AS:Chanayane> SIMD text parsing
+namespace
 {
-    std::ostringstream write_buffer;
-    bool found_escape = false;
-    bool found_hex = false;
-    bool found_digit = false;
-    U8 byte = 0;
-    llssize count = 0;
-
-    while (true)
+    /**
+     * Decoder for the escape sequences of a delimited string. It is fed
+     * the characters following a backslash one at a time, so a sequence
+     * may be split across several bulk reads.
+     */
+    class LLSDEscapeDecoder
     {
-        int next_byte = istr.get();
-        ++count;
-
-        if(istr.fail())
-        {
-            // If our stream is empty, break out
-            value = write_buffer.str();
-            return LLSDParser::PARSE_FAILURE;
-        }
+    public:
+        bool pending() const { return mFoundEscape; }
 
-        char next_char = (char)next_byte; // Now that we know it's not EOF
+        void start() { mFoundEscape = true; }
 
-        if(found_escape)
+        void feed(char next_char, std::string& out)
         {
             // next character(s) is a special sequence.
-            if(found_hex)
+            if (mFoundHex)
             {
-                if(found_digit)
+                if (mFoundDigit)
                 {
-                    found_digit = false;
-                    found_hex = false;
-                    found_escape = false;
-                    byte = byte << 4;
-                    byte |= hex_as_nybble(next_char);
-                    write_buffer << byte;
-                    byte = 0;
+                    mFoundDigit = false;
+                    mFoundHex = false;
+                    mFoundEscape = false;
+                    mByte = mByte << 4;
+                    mByte |= hex_as_nybble(next_char);
+                    out.push_back((char)mByte);
+                    mByte = 0;
                 }
                 else
                 {
                     // next character is the first nybble of
                     //
-                    found_digit = true;
-                    byte = hex_as_nybble(next_char);
+                    mFoundDigit = true;
+                    mByte = hex_as_nybble(next_char);
                 }
             }
-            else if(next_char == 'x')
+            else if (next_char == 'x')
             {
-                found_hex = true;
+                mFoundHex = true;
             }
             else
             {
-                switch(next_char)
+                switch (next_char)
                 {
                 case 'a':
-                    write_buffer << '\a';
+                    out.push_back('\a');
                     break;
                 case 'b':
-                    write_buffer << '\b';
+                    out.push_back('\b');
                     break;
                 case 'f':
-                    write_buffer << '\f';
+                    out.push_back('\f');
                     break;
                 case 'n':
-                    write_buffer << '\n';
+                    out.push_back('\n');
                     break;
                 case 'r':
-                    write_buffer << '\r';
+                    out.push_back('\r');
                     break;
                 case 't':
-                    write_buffer << '\t';
+                    out.push_back('\t');
                     break;
                 case 'v':
-                    write_buffer << '\v';
+                    out.push_back('\v');
                     break;
                 default:
-                    write_buffer << next_char;
+                    out.push_back(next_char);
                     break;
                 }
-                found_escape = false;
+                mFoundEscape = false;
             }
         }
-        else if(next_char == '\\')
+
+        /// Decode [begin, end), copying the runs between backslashes whole.
+        void decode(const char* begin, const char* end, std::string& out)
         {
-            found_escape = true;
+            while (begin < end)
+            {
+                if (mFoundEscape)
+                {
+                    feed(*begin++, out);
+                    continue;
+                }
+                const char* escape = llsd_find_byte(begin, end, '\\');
+                out.append(begin, escape);
+                if (escape == end)
+                {
+                    break;
+                }
+                mFoundEscape = true;
+                begin = escape + 1;
+            }
         }
-        else if(next_char == delim)
+
+    private:
+        bool mFoundEscape{ false };
+        bool mFoundHex{ false };
+        bool mFoundDigit{ false };
+        U8 mByte{ 0 };
+    };
+}
+
+llssize deserialize_string_delim(
+    std::istream& istr,
+    std::string& value,
+    char delim)
+{
+    // Pull everything up to the next delimiter in one go: std::getline()
+    // searches the stream buffer in bulk rather than taking a sentry per
+    // character. A delimiter that turns out to be the tail of an escape
+    // sequence is fed to the decoder and the search resumes after it.
+    value.clear();
+    LLSDEscapeDecoder decoder;
+    std::string chunk;
+    llssize count = 0;
+
+    while (true)
+    {
+        std::getline(istr, chunk, delim);
+        count += chunk.size();
+        decoder.decode(chunk.data(), chunk.data() + chunk.size(), value);
+
+        if (istr.fail() || istr.eof())
         {
-            break;
+            // If our stream is empty, break out
+            istr.setstate(std::ios::failbit);
+            return LLSDParser::PARSE_FAILURE;
+        }
+
+        ++count;
+        if (decoder.pending())
+        {
+            decoder.feed(delim, value);
+        }
+        else if (delim == '\\')
+        {
+            // a backslash always starts an escape, so it cannot end the string
+            decoder.start();
         }
         else
         {
-            write_buffer << next_char;
+            break;
         }
     }
 
-    value = write_buffer.str();
     return count;
 }
+// </AS:Chanayane>
 
 llssize deserialize_string_raw(
     std::istream& istr,
@@ -2340,9 +3080,12 @@ LLUZipHelper::EZipRresult LLUZipHelper::unzip_llsd(LLSD& data, const U8* in, S32
     {
         char* result_ptr = strip_deprecated_header((char*)result, cur_size);
 
-        boost::iostreams::stream<boost::iostreams::array_source> istrm(result_ptr, cur_size);
+        // <AS:Chanayane> Zero-copy binary LLSD parsing
+        //boost::iostreams::stream<boost::iostreams::array_source> istrm(result_ptr, cur_size);
 
-        if (!LLSDSerialize::fromBinary(data, istrm, cur_size, UNZIP_LLSD_MAX_DEPTH))
+        //if (!LLSDSerialize::fromBinary(data, istrm, cur_size, UNZIP_LLSD_MAX_DEPTH))
+        if (!LLSDSerialize::fromBinary(data, (const U8*)result_ptr, cur_size, UNZIP_LLSD_MAX_DEPTH))
+        // </AS:Chanayane>
         {
             // free(result);
             if( result )
@@ -30,6 +30,8 @@
 #define LL_LLSDSERIALIZE_H
 
 #include <iosfwd>
+#include <functional> // <AS:Chanayane/> Zero-copy binary LLSD parsing
+#include <string_view> // <AS:Chanayane/> Zero-copy binary LLSD parsing
 #include "llpointer.h"
 #include "llrefcount.h"
 #include "llsd.h"
@@ -408,6 +410,91 @@ private:
     bool parseString(std::istream& istr, std::string& value) const;
 };
 
+// <AS:Chanayane> Zero-copy binary LLSD parsing
+/**
+ * @class LLSDBinaryView
+ * @brief Read-only view of one value of binary LLSD held in memory.
+ *
+ * Nothing is decoded when a view is created. Map and array views hand out
+ * views of their children by skipping over the bytes of the children in
+ * front of them, so pulling a few fields out of a large document only
+ * decodes those fields. Lookups are linear in the number of children; use
+ * asLLSD() on sub-trees that are accessed heavily.
+ *
+ * A view does not copy or own the buffer: the buffer must outlive the view
+ * and every view obtained from it. A failed lookup gives an undefined view;
+ * malformed data makes lookups fail and asLLSD() return undefined.
+ */
+class LL_COMMON_API LLSDBinaryView
+{
+public:
+    typedef std::function<bool(std::string_view key, const LLSDBinaryView& value)> map_visitor_t;
+    typedef std::function<bool(size_t index, const LLSDBinaryView& value)> array_visitor_t;
+
+    LLSDBinaryView();
+
+    /**
+     * @brief View of the first value in the buffer.
+     *
+     * The binary header ("<? LLSD/Binary ?>") is not skipped, as with
+     * LLSDSerialize::fromBinary().
+     */
+    LLSDBinaryView(const U8* data, size_t size);
+
+    LLSD::Type type() const;
+    bool isDefined() const  { return type() != LLSD::TypeUndefined; }
+    bool isMap() const      { return type() == LLSD::TypeMap; }
+    bool isArray() const    { return type() == LLSD::TypeArray; }
+
+    /**
+     * @brief Number of entries of a map or array as given in the data,
+     * 0 for anything else.
+     */
+    size_t size() const;
+
+    bool has(std::string_view key) const;
+    LLSDBinaryView operator[](std::string_view key) const;
+    LLSDBinaryView operator[](const char* key) const
+    {
+        return key ? (*this)[std::string_view(key)] : LLSDBinaryView();
+    }
+    LLSDBinaryView operator[](size_t index) const;
+    template <typename IDX,
+              typename std::enable_if<std::is_convertible<IDX, size_t>::value, bool>::type = true>
+    LLSDBinaryView operator[](IDX i) const { return (*this)[size_t(i)]; }
+
+    /**
+     * @brief Call visitor for each entry of a map, or each element of an
+     * array, in document order until it returns false. Returns false if the
+     * data turned out to be malformed.
+     */
+    bool visitMap(const map_visitor_t& visitor) const;
+    bool visitArray(const array_visitor_t& visitor) const;
+
+    /**
+     * @brief Decode the value and everything below it.
+     */
+    LLSD asLLSD(S32 max_depth = -1) const;
+
+    /**
+     * @brief Characters of a string or URI without copying them. Empty for
+     * other types and for strings in the notation style (quoted) encoding,
+     * which need unescaping: use asLLSD() for those.
+     */
+    std::string_view asStringView() const;
+
+    /**
+     * @brief Number of bytes the value takes in the buffer, 0 if it is
+     * malformed.
+     */
+    size_t getEncodedSize() const;
+
+private:
+    const U8*   mData;  // type marker of the value
+    const U8*   mEnd;   // end of the buffer
+};
+// </AS:Chanayane>
+
 
 /**
  * @class LLSDFormatter
@@ -846,6 +933,24 @@ public:
         (void)p->parse(str, sd, max_bytes, max_depth);
         return sd;
     }
+    // <AS:Chanayane> Zero-copy binary LLSD parsing
+    /**
+     * @brief Parse binary LLSD straight out of a memory buffer.
+     *
+     * Accepts the same data as the stream version and gives the same
+     * result, but walks the buffer directly instead of reading the stream
+     * a byte at a time, and inserts map keys without an intermediate copy.
+     * @param sd [out] The parsed data
+     * @param data Start of the binary LLSD
+     * @param size Number of bytes available at data
+     * @param max_depth Max depth parser will check before exiting
+     *  with parse error, -1 - unlimited.
+     * @param bytes_read [out] If not null, the number of bytes consumed
+     * @return Returns the number of LLSD objects parsed into sd, or
+     *  LLSDParser::PARSE_FAILURE.
+     */
+    static S32 fromBinary(LLSD& sd, const U8* data, size_t size, S32 max_depth = -1, size_t* bytes_read = nullptr);
+    // </AS:Chanayane>
 };
 
 class LL_COMMON_API LLUZipHelper : public LLRefCount
@@ -31,7 +31,10 @@
 #include <deque>
 
 #include "apr_base64.h"
-#include <boost/regex.hpp>
+// <AS:Chanayane> SIMD text parsing
+//#include <boost/regex.hpp>
+#include "llsdscan.h"
+// </AS:Chanayane>
 #include <stack>
 
 extern "C"
@@ -358,19 +361,72 @@ void clear_eol(std::istream& input)
     }
 }
 
+// <AS:Chanayane> SIMD text parsing
+//static unsigned get_till_eol(std::istream& input, char *buf, unsigned bufsize)
+//{
+//    unsigned count = 0;
+//    while (count < bufsize && input.good())
+//    {
+//        char c = input.get();
+//        buf[count++] = c;
+//        if (is_eol(c))
+//            break;
+//    }
+//    return count;
+//}
+
+// Read up to and including the next '\n', or bufsize bytes. istream::getline()
+// searches the stream buffer in bulk instead of taking a sentry per character.
+// Unlike the loop above it does not stop at a lone '\r'.
 static unsigned get_till_eol(std::istream& input, char *buf, unsigned bufsize)
 {
-    unsigned count = 0;
-    while (count < bufsize && input.good())
+    // getline() wants room for its terminating NUL
+    input.getline(buf, bufsize);
+    unsigned count = (unsigned)input.gcount();
+    if (input.eof())
     {
-        char c = input.get();
-        buf[count++] = c;
-        if (is_eol(c))
-            break;
+        // last line without a newline. Pass the EOF marker on to expat like
+        // the loop above did: it is what makes a document that is not closed
+        // by </llsd> fail. getline() left room for it. Leave the stream
+        // failed, as a get() past the end would have
+        buf[count++] = (char)EOF;
+        input.setstate(std::ios::failbit);
+        return count;
     }
+    if (input.fail())
+    {
+        // line longer than the buffer, the rest comes with the next call
+        if (count)
+        {
+            input.clear();
+        }
+        return count;
+    }
+    // getline() consumed the newline and stored a NUL in its place
+    buf[count - 1] = '\n';
     return count;
 }
 
+// Copy in to out without whitespace, a run at a time.
+static void strip_space(const std::string& in, std::string& out)
+{
+    const char* begin = in.data();
+    const char* end = begin + in.size();
+    out.clear();
+    out.reserve(in.size());
+    while (begin < end)
+    {
+        const char* space = llsd_find_space(begin, end);
+        out.append(begin, space);
+        if (space == end)
+        {
+            break;
+        }
+        begin = space + 1;
+    }
+}
+// </AS:Chanayane>
+
 S32 LLSDXMLParser::Impl::parse(std::istream& input, LLSD& data)
 {
     XML_Status status;
@@ -822,9 +878,13 @@ void LLSDXMLParser::Impl::endElementHandler(const XML_Char* name)
             // created by python and other non-linden systems - DEV-39358
             // Fortunately we have very little binary passing now,
             // so performance impact shold be negligible. + poppy 2009-09-04
-            boost::regex r;
-            r.assign("\\s");
-            std::string stripped = boost::regex_replace(mCurrentContent, r, "");
+            // <AS:Chanayane> SIMD text parsing
+            //boost::regex r;
+            //r.assign("\\s");
+            //std::string stripped = boost::regex_replace(mCurrentContent, r, "");
+            std::string stripped;
+            strip_space(mCurrentContent, stripped);
+            // </AS:Chanayane>
             S32 len = apr_base64_decode_len(stripped.c_str());
             std::vector<U8> data;
             data.resize(len);
@@ -0,0 +1,109 @@
+/**
+ * @file lllatencyhistogram_test.cpp
+ * @brief Test for lllatencyhistogram.h
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+#include "linden_common.h"
+#include "../test/lltut.h"
+
+#include "../lllatencyhistogram.h"
+
+namespace tut
+{
+    struct latencyhistogram
+    {
+        // True if value is within the histogram's resolution of expected
+        static bool close(U64 value, U64 expected)
+        {
+            F64 error = fabs((F64)value - (F64)expected);
+            return error <= llmax(1.0, (F64)expected / 8.0);
+        }
+    };
+
+    typedef test_group<latencyhistogram> latencyhistogram_t;
+    typedef latencyhistogram_t::object latencyhistogram_object_t;
+    tut::latencyhistogram_t tut_latencyhistogram("LLLatencyHistogram");
+
+    template<> template<>
+    void latencyhistogram_object_t::test<1>()
+    {
+        set_test_name("empty histogram");
+        LLLatencyHistogram histogram;
+        ensure_equals("count", histogram.getCount(), (U64)0);
+        ensure_equals("p50", histogram.getPercentile(0.5f), (U64)0);
+    }
+
+    template<> template<>
+    void latencyhistogram_object_t::test<2>()
+    {
+        set_test_name("small values are exact");
+        LLLatencyHistogram histogram;
+        for (U64 i = 0; i < 8; ++i)
+        {
+            histogram.record(i);
+        }
+        ensure_equals("count", histogram.getCount(), (U64)8);
+        ensure_equals("p0", histogram.getPercentile(0.f), (U64)0);
+        ensure_equals("p50", histogram.getPercentile(0.5f), (U64)3);
+        ensure_equals("p100", histogram.getPercentile(1.f), (U64)7);
+    }
+
+    template<> template<>
+    void latencyhistogram_object_t::test<3>()
+    {
+        set_test_name("percentiles of a uniform spread");
+        LLLatencyHistogram histogram;
+        for (U64 i = 1; i <= 10000; ++i)
+        {
+            histogram.record(i * 10);
+        }
+        U64 p50 = histogram.getPercentile(0.5f);
+        U64 p95 = histogram.getPercentile(0.95f);
+        U64 p99 = histogram.getPercentile(0.99f);
+        ensure("p50 " + std::to_string(p50), close(p50, 50000));
+        ensure("p95 " + std::to_string(p95), close(p95, 95000));
+        ensure("p99 " + std::to_string(p99), close(p99, 99000));
+        ensure("ordered", p50 <= p95 && p95 <= p99);
+    }
+
+    template<> template<>
+    void latencyhistogram_object_t::test<4>()
+    {
+        set_test_name("tail and reset");
+        LLLatencyHistogram histogram;
+        for (U32 i = 0; i < 99; ++i)
+        {
+            histogram.record(100);
+        }
+        histogram.record(5000000); // one 5s outlier
+        histogram.record(U64(1) << 40); // beyond the last bucket
+        ensure("p50 " + std::to_string(histogram.getPercentile(0.5f)), close(histogram.getPercentile(0.5f), 100));
+        ensure("p99 is the outlier", histogram.getPercentile(0.99f) > 4000000);
+        histogram.reset();
+        ensure_equals("count after reset", histogram.getCount(), (U64)0);
+    }
+}
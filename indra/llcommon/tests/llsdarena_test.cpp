@@ -0,0 +1,142 @@
+/**
+ * @file llsdarena_test.cpp
+ * @brief Tests for LLSDArena.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+
+#include "linden_common.h"
+#include "../test/lltut.h"
+
+#include "llsd.h"
+#include "llsdarena.h"
+#include "llsdserialize.h"
+#include "llsdutil.h"
+#include "llsdtestdocument.h"
+
+#include <sstream>
+#include <thread>
+
+namespace tut
+{
+    struct sd_arena
+    {
+        static std::string toBinary(const LLSD& sd)
+        {
+            std::ostringstream ostr;
+            LLSDSerialize::toBinary(sd, ostr);
+            return ostr.str();
+        }
+
+        static S32 parse(LLSD& sd, const std::string& data)
+        {
+            return LLSDSerialize::fromBinary(sd, (const U8*)data.data(), data.size());
+        }
+    };
+
+    typedef test_group<sd_arena> sd_arena_t;
+    typedef sd_arena_t::object sd_arena_object_t;
+    tut::sd_arena_t tut_sd_arena("LLSDArena");
+
+    template<> template<>
+    void sd_arena_object_t::test<1>()
+    {
+        set_test_name("same values as the heap");
+        const std::string data = toBinary(llsd_test_document(100));
+        LLSD expected;
+        ensure("heap parse", parse(expected, data) > 0);
+
+        LLSD actual;
+        {
+            LLSDArena arena;
+            LLSDArena::Scope scope(arena);
+            ensure("scope active", LLSDArena::active());
+            ensure("arena parse", parse(actual, data) > 0);
+            ensure("arena used", arena.getBytesAllocated() > 0);
+        }
+        ensure("scope ended", !LLSDArena::active());
+        ensure("same data", llsd_equals(expected, actual));
+        ensure_equals("map iteration", actual[42]["permissions"].size(), (size_t)4);
+    }
+
+    template<> template<>
+    void sd_arena_object_t::test<2>()
+    {
+        set_test_name("values outlive the arena");
+        LLSD kept;
+        LLSD first;
+        LLSD second;
+        {
+            LLSDArena arena(256);
+            LLSDArena::Scope scope(arena);
+            first = 5;
+            second = 5;
+            kept["count"] = 5;
+            kept["enabled"] = true;
+            kept["name"] = "a string long enough to need its own heap block";
+            for (S32 i = 0; i < 100; ++i)
+            {
+                kept["list"].append(i * 1000);
+            }
+            ensure("several chunks", arena.getChunkCount() > 1);
+        }
+
+        // interned scalars are shared, never modified in place
+        second = 6;
+        ensure_equals("first unchanged", first.asInteger(), 5);
+        ensure_equals("second changed", second.asInteger(), 6);
+        kept["count"] = 7;
+        ensure_equals("map value changed", kept["count"].asInteger(), 7);
+        ensure_equals("other value unchanged", first.asInteger(), 5);
+
+        // copy on write across arena and heap values
+        LLSD copy = kept;
+        copy["name"] = "changed";
+        ensure_equals("original name", kept["name"].asString(), std::string("a string long enough to need its own heap block"));
+        ensure_equals("list", kept["list"][99].asInteger(), 99000);
+        ensure("bool", kept["enabled"].asBoolean());
+    }
+
+    template<> template<>
+    void sd_arena_object_t::test<3>()
+    {
+        set_test_name("release on another thread");
+        LLSD doc;
+        {
+            LLSDArena arena;
+            LLSDArena::Scope scope(arena);
+            parse(doc, toBinary(llsd_test_document(50)));
+        }
+        std::thread worker([doc = std::move(doc)]() mutable
+                           {
+                               ensure_equals("size", doc.size(), (size_t)50);
+                               doc.clear();
+                           });
+        worker.join();
+        ensure("moved from", doc.isUndefined());
+    }
+}
@@ -0,0 +1,185 @@
+/**
+ * @file llsdbinaryparse_test.cpp
+ * @brief Tests for parsing binary LLSD from memory.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+
+#include "linden_common.h"
+#include "../test/lltut.h"
+
+#include "llsd.h"
+#include "llsdserialize.h"
+#include "llsdutil.h"
+#include "llsdtestdocument.h"
+
+#include <sstream>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/stream.hpp>
+
+namespace tut
+{
+    struct sd_binary_parse
+    {
+        static std::string toBinary(const LLSD& sd)
+        {
+            std::ostringstream ostr;
+            LLSDSerialize::toBinary(sd, ostr);
+            return ostr.str();
+        }
+
+        static S32 streamParse(LLSD& sd, const std::string& data, S32 max_depth = -1)
+        {
+            boost::iostreams::stream<boost::iostreams::array_source> istr(data.data(), data.size());
+            return LLSDSerialize::fromBinary(sd, istr, data.size(), max_depth);
+        }
+
+        static S32 spanParse(LLSD& sd, const std::string& data, S32 max_depth = -1, size_t* bytes_read = nullptr)
+        {
+            return LLSDSerialize::fromBinary(sd, (const U8*)data.data(), data.size(), max_depth, bytes_read);
+        }
+
+        static LLSDBinaryView view(const std::string& data)
+        {
+            return LLSDBinaryView((const U8*)data.data(), data.size());
+        }
+    };
+
+    typedef test_group<sd_binary_parse> sd_binary_parse_t;
+    typedef sd_binary_parse_t::object sd_binary_parse_object_t;
+    tut::sd_binary_parse_t tut_sd_binary_parse("LLSDBinaryParse");
+
+    template<> template<>
+    void sd_binary_parse_object_t::test<1>()
+    {
+        set_test_name("same result as the stream parser");
+        LLSD doc = llsd_test_document(20);
+        doc.append(LLSD());
+        doc.append(true);
+        doc.append(LLURI("http://example.com/"));
+        doc.append(LLSD::emptyMap());
+        doc.append(LLSD::emptyArray());
+        std::string data = toBinary(doc);
+
+        LLSD expected;
+        LLSD actual;
+        size_t bytes_read = 0;
+        S32 expected_count = streamParse(expected, data);
+        ensure_equals("parse count", spanParse(actual, data, -1, &bytes_read), expected_count);
+        ensure("same data", llsd_equals(expected, actual));
+        ensure_equals("bytes read", bytes_read, data.size());
+
+        // Trailing data is left alone, as with a stream
+        data += "junk";
+        ensure_equals("parse count with trailing data", spanParse(actual, data, -1, &bytes_read), expected_count);
+        ensure_equals("bytes read with trailing data", bytes_read, data.size() - 4);
+    }
+
+    template<> template<>
+    void sd_binary_parse_object_t::test<2>()
+    {
+        set_test_name("notation style strings");
+        static const char raw[] = "{\0\0\0\x02'a\\x41b'\"v\\n\"k\0\0\0\x01zs\0\0\0\x02hi}";
+        std::string data(raw, sizeof(raw) - 1);
+
+        LLSD expected;
+        LLSD actual;
+        ensure_equals("parse count", spanParse(actual, data), streamParse(expected, data));
+        ensure("same data", llsd_equals(expected, actual));
+        ensure_equals("unescaped key", actual["aAb"].asString(), std::string("v\n"));
+        ensure_equals("view of quoted key", view(data)["aAb"].asLLSD().asString(), std::string("v\n"));
+        ensure_equals("encoded size", view(data).getEncodedSize(), data.size());
+    }
+
+    template<> template<>
+    void sd_binary_parse_object_t::test<3>()
+    {
+        set_test_name("malformed input");
+        std::string data = toBinary(llsd_test_document(3));
+        for (size_t size = 1; size < data.size(); ++size)
+        {
+            LLSD sd;
+            std::string truncated = data.substr(0, size);
+            ensure_equals("truncated at " + std::to_string(size), spanParse(sd, truncated), (S32)LLSDParser::PARSE_FAILURE);
+            ensure("cleared at " + std::to_string(size), sd.isUndefined());
+            ensure_equals("view size at " + std::to_string(size), view(truncated).getEncodedSize(), (size_t)0);
+        }
+
+        LLSD sd;
+        ensure_equals("empty", spanParse(sd, std::string()), 0);
+        ensure_equals("unknown marker", spanParse(sd, std::string("x")), (S32)LLSDParser::PARSE_FAILURE);
+        ensure_equals("huge array", spanParse(sd, std::string("[\x7f\xff\xff\xff!]", 7)), (S32)LLSDParser::PARSE_FAILURE);
+        ensure_equals("huge string", spanParse(sd, std::string("s\x7f\xff\xff\xffhi", 7)), (S32)LLSDParser::PARSE_FAILURE);
+        ensure_equals("negative string", spanParse(sd, std::string("s\xff\xff\xff\xff", 5)), (S32)LLSDParser::PARSE_FAILURE);
+
+        std::string nested;
+        for (S32 i = 0; i < 100; ++i)
+        {
+            nested += std::string("[\0\0\0\x01", 5);
+        }
+        nested += "!" + std::string(100, ']');
+        ensure_equals("too deep", spanParse(sd, nested, 96), (S32)LLSDParser::PARSE_FAILURE);
+        ensure_equals("deep enough", spanParse(sd, nested, 101), 101);
+    }
+
+    template<> template<>
+    void sd_binary_parse_object_t::test<4>()
+    {
+        set_test_name("lazy view");
+        LLSD doc;
+        doc["items"] = llsd_test_document(10);
+        doc["version"] = 3;
+        doc["label"] = "inventory";
+        std::string data = toBinary(doc);
+
+        LLSDBinaryView root = view(data);
+        ensure("map", root.isMap());
+        ensure_equals("map size", root.size(), (size_t)3);
+        ensure("has", root.has("version"));
+        ensure("has not", !root.has("missing"));
+        ensure("missing is undefined", !root["missing"].isDefined());
+        ensure_equals("scalar", root["version"].asLLSD().asInteger(), 3);
+        ensure_equals("string view", std::string(root["label"].asStringView()), std::string("inventory"));
+
+        LLSDBinaryView items = root["items"];
+        ensure("array", items.isArray());
+        ensure_equals("array size", items.size(), (size_t)10);
+        ensure("element", llsd_equals(items[7].asLLSD(), doc["items"][7]));
+        ensure("field", llsd_equals(items[7]["asset_id"].asLLSD(), doc["items"][7]["asset_id"]));
+        ensure("out of range", !items[10].isDefined());
+        ensure("whole document", llsd_equals(root.asLLSD(), doc));
+        ensure_equals("encoded size", root.getEncodedSize(), data.size());
+
+        S32 visited = 0;
+        ensure("visit", root.visitMap([&](std::string_view key, const LLSDBinaryView& value)
+                                      {
+                                          ++visited;
+                                          return key != "label";
+                                      }));
+        ensure_equals("visit stops early", visited, 2);
+    }
+}
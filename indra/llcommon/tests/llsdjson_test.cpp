@@ -0,0 +1,134 @@
+/**
+ * @file llsdjson_test.cpp
+ * @brief Tests for the streaming LLSD <-> JSON conversion.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+
+
+#include "linden_common.h"
+#include "../test/lltut.h"
+
+#include "llsd.h"
+#include "llsdjson.h"
+#include "llsdutil.h"
+#include "llsdtestdocument.h"
+
+#include <sstream>
+
+namespace tut
+{
+    struct sd_json
+    {
+        static LLSD parseStream(const std::string& text, bool& ok)
+        {
+            std::istringstream istr(text);
+            boost::system::error_code ec;
+            LLSD result;
+            ok = LlsdFromJsonStream(istr, result, ec);
+            ensure_equals("error code matches result", ec.failed(), !ok);
+            return result;
+        }
+
+        static void ensureParsesLikeTree(const std::string& text)
+        {
+            LLSD expected = LlsdFromJson(boost::json::parse(text));
+            boost::system::error_code ec;
+            LLSD actual;
+            ensure("string parse " + text, LlsdFromJsonString(text, actual, ec));
+            ensure("string parse matches " + text, llsd_equals(expected, actual));
+            bool ok = false;
+            actual = parseStream(text, ok);
+            ensure("stream parse " + text, ok);
+            ensure("stream parse matches " + text, llsd_equals(expected, actual));
+        }
+    };
+    typedef test_group<sd_json> sd_json_t;
+    typedef sd_json_t::object sd_json_object_t;
+    tut::sd_json_t tut_sd_json("LLSDJson");
+
+    template<> template<>
+    void sd_json_object_t::test<1>()
+    {
+        set_test_name("reader matches tree conversion");
+        ensureParsesLikeTree("null");
+        ensureParsesLikeTree("true");
+        ensureParsesLikeTree("-17");
+        ensureParsesLikeTree("2.5e-3");
+        ensureParsesLikeTree("\"esc\\\"aped\\n\\u00e9\\ud83d\\ude00\"");
+        ensureParsesLikeTree("[]");
+        ensureParsesLikeTree("{}");
+        ensureParsesLikeTree(" [1, [2, [3, {}]], {\"a\": {\"b\": [null, false]}}] ");
+        ensureParsesLikeTree("{\"dup\": 1, \"key\": \"v\", \"dup\": 2}");
+        ensureParsesLikeTree(LlsdToJsonString(llsd_test_document(200, false)));
+    }
+
+    template<> template<>
+    void sd_json_object_t::test<2>()
+    {
+        set_test_name("writer matches tree conversion");
+        LLSD docs = llsd::array(LLSD(), true, false, 0, -2147483647, 1.0, 0.1, -1.5e300,
+                                "plain", "\x01\x1f\"\\/\b\f\n\r\t", LLUUID::generateNewID(),
+                                LLDate::now(), LLURI("http://example.com/"),
+                                LLSD::emptyMap(), LLSD::emptyArray(), llsd_test_document(50, false));
+        for (const LLSD& doc : llsd::inArray(docs))
+        {
+            std::string text = LlsdToJsonString(doc);
+            ensure("writer output parses " + text,
+                   boost::json::parse(text) == LlsdToJson(doc));
+
+            std::ostringstream ostr;
+            LlsdToJsonStream(doc, ostr);
+            ensure_equals("stream and string output", ostr.str(), text);
+        }
+    }
+
+    template<> template<>
+    void sd_json_object_t::test<3>()
+    {
+        set_test_name("malformed input");
+        const char* bad[] = { "", "[1, 2", "{\"a\" 1}", "{\"a\": 1} x", "[1] [2]", "tru", "\"open" };
+        for (const char* text : bad)
+        {
+            boost::system::error_code ec;
+            LLSD result("stale");
+            ensure(std::string("string rejects ") + text, !LlsdFromJsonString(text, result, ec));
+            ensure(std::string("string result cleared ") + text, result.isUndefined());
+            bool ok = true;
+            result = parseStream(text, ok);
+            ensure(std::string("stream rejects ") + text, !ok);
+            ensure(std::string("stream result cleared ") + text, result.isUndefined());
+        }
+
+        // Trailing whitespace after a document spanning several reads
+        bool ok = false;
+        LLSD doc = llsd_test_document(500, false);
+        LLSD result = parseStream(LlsdToJsonString(doc) + "\n \r\n\t", ok);
+        ensure("trailing whitespace", ok);
+        ensure_equals("large document size", result.size(), doc.size());
+    }
+}
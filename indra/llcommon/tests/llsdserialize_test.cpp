@@ -51,6 +51,10 @@ typedef U32 uint32_t;
 #include "llsdutil.h"
 #include "llformat.h"
 #include "llmemorystream.h"
+// <AS:Chanayane> SIMD text parsing
+#include "llsdscan.h"
+#include "llsdtestdocument.h"
+// </AS:Chanayane>
 
 #include "../test/hexdump.h"
 #include "../test/lltut.h"
@@ -492,6 +496,10 @@ namespace tut
         v = LLSD::emptyMap();
         fillmap(v, 10, 3); // 10^6 maps
         checkRoundTrip(msg + " many nested maps", v);
+
+        // <AS:Chanayane> SIMD text parsing
+        checkRoundTrip(msg + " inventory document", llsd_test_document(50));
+        // </AS:Chanayane>
     }
 
     typedef tut::test_group<TestLLSDSerializeData> TestLLSDSerializeGroup;
@@ -857,6 +865,67 @@ namespace tut
             8);
     }
 
+    // <AS:Chanayane> SIMD text parsing
+    template<> template<>
+    void TestLLSDXMLParsingObject::test<6>()
+    {
+        // whitespace inside base64 binary
+        LLSD::Binary hello({ 'h', 'e', 'l', 'l', 'o' });
+        ensureParse(
+            "base64 with whitespace",
+            "<llsd><binary>aGVs\n bG8=\r\n</binary></llsd>",
+            hello,
+            1);
+
+        // well formed xml that is not llsd, and llsd that is not closed
+        ensureParse(
+            "html",
+            "<html><body><p>ha ha</p></body></html>",
+            LLSD(),
+            LLSDParser::PARSE_FAILURE);
+        ensureParse(
+            "unterminated llsd",
+            "<llsd><string>ha ha</string>",
+            LLSD(),
+            LLSDParser::PARSE_FAILURE);
+    }
+
+    template<> template<>
+    void TestLLSDXMLParsingObject::test<7>()
+    {
+        // a line longer than the read buffer, then a second document
+        std::string name(5000, 'n');
+        std::istringstream input("<llsd><string>" + name + "</string></llsd>\n"
+                                 "<llsd><integer>7</integer></llsd>\n");
+        LLSD sd;
+        ensure_equals("long line", LLSDSerialize::fromXML(sd, input), 1);
+        ensure_equals("long line value", sd.asString(), name);
+        ensure_equals("second document", LLSDSerialize::fromXML(sd, input), 1);
+        ensure_equals("second document value", sd.asInteger(), 7);
+    }
+
+    template<> template<>
+    void TestLLSDXMLParsingObject::test<8>()
+    {
+        // whitespace scanner used to strip base64
+        std::string text(100, 'a');
+        text[70] = '\n';
+        text[90] = ' ';
+        const char* begin = text.data();
+        const char* end = begin + text.size();
+        ensure_equals("find space", llsd_find_space(begin, end) - begin, 70);
+        ensure_equals("find space after", llsd_find_space(begin + 71, end) - begin, 90);
+        ensure("find no space", llsd_find_space(begin, begin + 70) == begin + 70);
+        for (char c = 1; c < 127; ++c)
+        {
+            std::string one(20, 'x');
+            one[17] = c;
+            bool expected = (c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r');
+            ensure_equals("space class", llsd_find_space(one.data(), one.data() + one.size()) == one.data() + 17, expected);
+        }
+    }
+    // </AS:Chanayane>
+
 
     /*
     TODO:
@@ -1259,6 +1328,46 @@ namespace tut
             9);
     }
 
+    // <AS:Chanayane> SIMD text parsing
+    template<> template<>
+    void TestLLSDNotationParsingObject::test<22>()
+    {
+        // escapes in delimited strings
+        ensureParse("escaped delimiter", "'it\\'s'", LLSD("it's"), 1);
+        ensureParse("hex escape", "\"\\x41\\x62\\n\"", LLSD("Ab\n"), 1);
+        // the delimiter is eaten as the second nybble
+        ensureParse(
+            "delimiter inside escape",
+            "'\\x4''",
+            LLSD(std::string(1, (char)((4 << 4) | hex_as_nybble('\'')))),
+            1);
+        LLSD val;
+        val["a'b"] = "c\\";
+        ensureParse("escaped map key", "{'a\\'b':'c\\\\'}", val, 2);
+        ensureParse(
+            "escaped uri",
+            "l\"http://example.com/\\\"x\"",
+            LLSD(LLURI("http://example.com/\"x")),
+            1);
+        ensureParse("unterminated", "'abc", LLSD(), LLSDParser::PARSE_FAILURE);
+        ensureParse("unterminated escape", "'abc\\'", LLSD(), LLSDParser::PARSE_FAILURE);
+    }
+
+    template<> template<>
+    void TestLLSDNotationParsingObject::test<23>()
+    {
+        // byte scanner used to find escapes
+        std::string text(100, 'a');
+        text[37] = '\\';
+        text[90] = ' ';
+        const char* begin = text.data();
+        const char* end = begin + text.size();
+        ensure_equals("find byte", llsd_find_byte(begin, end, '\\') - begin, 37);
+        ensure_equals("find byte in tail", llsd_find_byte(begin + 80, end, ' ') - begin, 90);
+        ensure("find missing byte", llsd_find_byte(begin, end, 'z') == end);
+    }
+    // </AS:Chanayane>
+
     /**
      * @class TestLLSDBinaryParsing
      * @brief Concrete instance of a parse tester.
@@ -0,0 +1,73 @@
+/**
+ * @file llsdtestdocument.h
+ * @brief Sample LLSD document shared by the LLSD parser and serializer tests.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+
+#if ! defined(LL_LLSDTESTDOCUMENT_H)
+#define LL_LLSDTESTDOCUMENT_H
+
+#include "llsd.h"
+#include "llsdutil.h"
+#include "lluuid.h"
+
+#include <string>
+
+// Something shaped like an inventory or AIS response, with enough escapes
+// and whitespace to exercise the slow paths of the text parsers as well.
+// JSON has no binary type, so with_binary = false leaves the data field out.
+inline LLSD llsd_test_document(S32 items, bool with_binary = true)
+{
+    LLSD doc = LLSD::emptyArray();
+    for (S32 i = 0; i < items; ++i)
+    {
+        LLSD item;
+        item["name"] = "Object " + std::to_string(i);
+        item["desc"] = "It's a \"quoted\" description\nwith a \\ and a tab\t";
+        item["item_id"] = LLUUID::generateNewID();
+        item["asset_id"] = LLUUID::generateNewID();
+        item["type"] = i % 24;
+        item["flags"] = i;
+        item["is_link"] = (i % 5) == 0;
+        item["sale_price"] = 10.5 * i;
+        item["created_at"] = LLDate((F64)(1700000000 + i));
+        item["thumbnail"] = LLSD();
+        item["permissions"] = llsd::map("base_mask", 0x7fffffff, "owner_mask", 0x82000,
+                                        "next_owner_mask", 0x82000, "group_id", LLUUID());
+        item["position"] = llsd::array(1.0, 2.0, 3.0);
+        item["tags"] = llsd::array("one", "two", LLSD::emptyArray(), LLSD::emptyMap());
+        if (with_binary)
+        {
+            item["data"] = LLSD::Binary(48, (U8)i);
+        }
+        doc.append(item);
+    }
+    return doc;
+}
+
+#endif /* ! defined(LL_LLSDTESTDOCUMENT_H) */
@@ -153,6 +153,12 @@ constexpr int HTTP_CONNECTION_LIMIT_MAX = 256;
 constexpr long HTTP_PIPELINING_DEFAULT = 0L;
 constexpr long HTTP_PIPELINING_MAX = 20L;
 
+// <AS:Chanayane> HTTP/2 multiplexing
+// Concurrent stream limits per connection
+constexpr long HTTP_HTTP2_STREAMS_DEFAULT = 0L;
+constexpr long HTTP_HTTP2_STREAMS_MAX = 256L;
+// </AS:Chanayane>
+
 // Miscellaneous defaults
 constexpr bool HTTP_USE_RETRY_AFTER_DEFAULT = true;
 constexpr long HTTP_THROTTLE_RATE_DEFAULT = 0L;
@@ -163,6 +169,20 @@ constexpr long HTTP_THROTTLE_RATE_DEFAULT = 0L;
 // request, ready and active queues.
 constexpr int HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS = 2;
 
+// <AS:Chanayane> Event-driven service loop
+// Longest time the worker thread blocks on transport sockets
+// before making another pass, in case a socket escaped the
+// wait set.
+constexpr int HTTP_SERVICE_LOOP_WAIT_MAX_MS = 50;
+// </AS:Chanayane>
+
+// <AS:Chanayane> Contiguous replies
+// Largest announced reply body for which a single contiguous
+// buffer is reserved up front.  Anything bigger is collected
+// in ordinary blocks.
+constexpr size_t HTTP_CONTIGUOUS_REPLY_MAX = 64U * 1024U * 1024U;
+// </AS:Chanayane>
+
 // Block allocation size (a tuning parameter) is found
 // in bufferarray.h.
 
@@ -32,6 +32,14 @@
 #include "_httppolicy.h"
 
 #include "llhttpconstants.h"
+#include "lltimer.h" // <AS:Chanayane/> Event-driven service loop
+#include "httpstats.h" // <AS:Chanayane/> HTTP/2 multiplexing
+// <AS:Chanayane> Event-driven service loop
+#if ! LLCORE_CURL_MULTI_POLL && ! LL_WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+// </AS:Chanayane>
 
 namespace
 {
@@ -51,6 +59,17 @@ void check_curl_multi_setopt(CURLM* handle, CURLMoption option, ARG argument)
 
 static const char * const LOG_CORE("CoreHttp");
 
+// <AS:Chanayane> Event-driven service loop
+#if ! LLCORE_CURL_MULTI_POLL
+// curl_multi_wait() cannot be interrupted, so wakeup() writes a byte
+// to a descriptor that is part of every wait.
+bool open_wake_fds(curl_socket_t fds[2]);
+void close_wake_fds(curl_socket_t fds[2]);
+void signal_wake_fd(curl_socket_t fd);
+void drain_wake_fd(curl_socket_t fd);
+#endif
+// </AS:Chanayane>
+
 } // end anonymous namespace
 
 
@@ -64,8 +83,15 @@ HttpLibcurl::HttpLibcurl(HttpService * service)
       mPolicyCount(0),
       mMultiHandles(NULL),
       mActiveHandles(NULL),
-      mDirtyPolicy(NULL)
-{}
+      mDirtyPolicy(NULL),
+      mWaitMulti(NULL) // <AS:Chanayane/> Event-driven service loop
+{
+    // <AS:Chanayane> Event-driven service loop
+#if ! LLCORE_CURL_MULTI_POLL
+    mWakeFds[0] = mWakeFds[1] = CURL_SOCKET_BAD;
+#endif
+    // </AS:Chanayane>
+}
 
 
 HttpLibcurl::~HttpLibcurl()
@@ -107,6 +133,21 @@ void HttpLibcurl::shutdown()
         mDirtyPolicy = NULL;
     }
 
+    // <AS:Chanayane> Event-driven service loop
+    {
+        LLCoreInt::HttpScopedLock lock(mWaitMutex);
+
+        if (mWaitMulti)
+        {
+            curl_multi_cleanup(mWaitMulti);
+            mWaitMulti = NULL;
+        }
+#if ! LLCORE_CURL_MULTI_POLL
+        close_wake_fds(mWakeFds);
+#endif
+    }
+    // </AS:Chanayane>
+
     mPolicyCount = 0;
 }
 
@@ -133,6 +174,31 @@ void HttpLibcurl::start(int policy_count)
         mDirtyPolicy[policy_class] = false;
         policyUpdated(policy_class);
     }
+
+    // <AS:Chanayane> Event-driven service loop
+    {
+        LLCoreInt::HttpScopedLock lock(mWaitMutex);
+
+        // Failure only costs us the old fixed sleep
+#if LLCORE_CURL_MULTI_POLL
+        mWaitMulti = curl_multi_init();
+#else
+        if (open_wake_fds(mWakeFds))
+        {
+            mWaitMulti = curl_multi_init();
+            if (! mWaitMulti)
+            {
+                close_wake_fds(mWakeFds);
+            }
+        }
+        else
+        {
+            LL_WARNS(LOG_CORE) << "Failed to create HTTP service wakeup descriptors, "
+                               << "falling back to a fixed sleep." << LL_ENDL;
+        }
+#endif
+    }
+    // </AS:Chanayane>
 }
 
 
@@ -211,12 +277,132 @@ HttpService::ELoopSpeed HttpLibcurl::processTransport()
 
     if (! mActiveOps.empty())
     {
-        ret = HttpService::NORMAL;
+        // <AS:Chanayane> Event-driven service loop
+        // Active requests only move on socket activity or libcurl
+        // timeouts, both of which end waitTransport().
+        //ret = HttpService::NORMAL;
+        ret = (std::min)(ret, HttpService::TRANSPORT_WAIT);
+        // </AS:Chanayane>
     }
     return ret;
 }
 
 
+// <AS:Chanayane> Event-driven service loop
+// All policy classes have their own multi handle but a thread can
+// only block in one, so the sockets of every class are gathered into
+// the extra descriptors of a multi handle with no transfers of its
+// own.  That handle is also the one wakeup() interrupts.
+void HttpLibcurl::waitTransport(int max_wait_ms)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_NETWORK;
+    if (mWaitMulti)
+    {
+        std::vector<curl_waitfd> wait_fds;
+        long timeout(max_wait_ms);
+
+        for (unsigned int policy_class(0); policy_class < mPolicyCount; ++policy_class)
+        {
+            if (! mMultiHandles[policy_class] || ! mActiveHandles[policy_class])
+            {
+                continue;
+            }
+
+            long class_timeout(-1);
+            if (CURLM_OK == curl_multi_timeout(mMultiHandles[policy_class], &class_timeout)
+                && class_timeout >= 0)
+            {
+                timeout = (std::min)(timeout, class_timeout);
+            }
+
+            fd_set read_fds, write_fds, exc_fds;
+            FD_ZERO(&read_fds);
+            FD_ZERO(&write_fds);
+            FD_ZERO(&exc_fds);
+            int max_fd(-1);
+            if (CURLM_OK != curl_multi_fdset(mMultiHandles[policy_class], &read_fds, &write_fds, &exc_fds, &max_fd))
+            {
+                continue;
+            }
+#if LL_WINDOWS
+            const struct
+            {
+                const fd_set &  mSet;
+                short           mEvents;
+            } sets[] = { { read_fds, CURL_WAIT_POLLIN }, { write_fds, CURL_WAIT_POLLOUT }, { exc_fds, CURL_WAIT_POLLPRI } };
+            for (const auto & set : sets)
+            {
+                for (u_int i(0); i < set.mSet.fd_count; ++i)
+                {
+                    curl_waitfd wait_fd = { set.mSet.fd_array[i], set.mEvents, 0 };
+                    wait_fds.push_back(wait_fd);
+                }
+            }
+#else
+            for (int fd(0); fd <= max_fd; ++fd)
+            {
+                short events((FD_ISSET(fd, &read_fds) ? CURL_WAIT_POLLIN : 0)
+                             | (FD_ISSET(fd, &write_fds) ? CURL_WAIT_POLLOUT : 0)
+                             | (FD_ISSET(fd, &exc_fds) ? CURL_WAIT_POLLPRI : 0));
+                if (events)
+                {
+                    curl_waitfd wait_fd = { fd, events, 0 };
+                    wait_fds.push_back(wait_fd);
+                }
+            }
+#endif
+        }
+
+        if (timeout <= 0)
+        {
+            return;
+        }
+
+        int num_fds(0);
+#if LLCORE_CURL_MULTI_POLL
+        CURLMcode status(curl_multi_poll(mWaitMulti,
+                                         wait_fds.empty() ? NULL : &wait_fds[0],
+                                         (unsigned int) wait_fds.size(),
+                                         int(timeout),
+                                         &num_fds));
+#else
+        curl_waitfd wake_fd = { mWakeFds[0], CURL_WAIT_POLLIN, 0 };
+        wait_fds.push_back(wake_fd);
+        CURLMcode status(curl_multi_wait(mWaitMulti,
+                                         &wait_fds[0],
+                                         (unsigned int) wait_fds.size(),
+                                         int(timeout),
+                                         &num_fds));
+        // A wakeup() arriving after this is still pending for the
+        // next wait, and new requests are picked up before it.
+        drain_wake_fd(mWakeFds[0]);
+#endif
+        if (CURLM_OK == status)
+        {
+            return;
+        }
+        check_curl_multi_code(status);
+    }
+    ms_sleep(HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS);
+}
+
+
+void HttpLibcurl::wakeup()
+{
+    LLCoreInt::HttpScopedLock lock(mWaitMutex);
+
+    if (mWaitMulti)
+    {
+#if LLCORE_CURL_MULTI_POLL
+        curl_multi_wakeup(mWaitMulti);
+#else
+        signal_wake_fd(mWakeFds[1]);
+#endif
+    }
+}
+// </AS:Chanayane>
+
+
 // Caller has provided us with a ref count on op.
 void HttpLibcurl::addOp(const HttpOpRequest::ptr_t &op)
 {
@@ -242,6 +428,7 @@ void HttpLibcurl::addOp(const HttpOpRequest::ptr_t &op)
         return;
     }
     op->mCurlActive = true;
+    op->mTimes.mStarted = totalTime(); // <AS:Chanayane/> Request phase latencies
     mActiveOps.insert(op);
     ++mActiveHandles[op->mReqPolicy];
 
@@ -464,6 +651,24 @@ bool HttpLibcurl::completeRequest(CURLM * multi_handle, CURL * handle, CURLcode
     }
     // /</FS:ND>
 
+    // <AS:Chanayane> HTTP/2 multiplexing
+    if (handle)
+    {
+        long http_version(0L);
+        long new_connections(0L);
+        curl_easy_getinfo(handle, CURLINFO_HTTP_VERSION, &http_version);
+        curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &new_connections);
+        HTTPStats::instance().recordTransfer(http_version >= CURL_HTTP_VERSION_2_0, new_connections);
+    }
+    // </AS:Chanayane>
+
+    // <AS:Chanayane> Request phase latencies
+    if (handle)
+    {
+        op->recordTimes();
+    }
+    // </AS:Chanayane>
+
     if (multi_handle && handle)
     {
         // Detach from multi and recycle handle
@@ -542,7 +747,29 @@ void HttpLibcurl::policyUpdated(unsigned int policy_class)
         policy.stallPolicy(policy_class, false);
         mDirtyPolicy[policy_class] = false;
 
-        if (options.mPipelining > 1)
+        // <AS:Chanayane> HTTP/2 multiplexing
+        if (options.mHttp2Streams > 0)
+        {
+            // Streams share connections; libcurl keeps requests it
+            // cannot place yet pending on the multi handle.
+            check_curl_multi_setopt(multi_handle,
+                                     CURLMOPT_PIPELINING,
+                                     long(CURLPIPE_MULTIPLEX));
+            check_curl_multi_setopt(multi_handle,
+                                     CURLMOPT_MAX_HOST_CONNECTIONS,
+                                     long(options.mPerHostConnectionLimit));
+            check_curl_multi_setopt(multi_handle,
+                                     CURLMOPT_MAX_TOTAL_CONNECTIONS,
+                                     long(options.mConnectionLimit));
+#if LIBCURL_VERSION_NUM >= 0x074300
+            // requires curl 7.67.0, the server's own limit applies before that
+            check_curl_multi_setopt(multi_handle,
+                                     CURLMOPT_MAX_CONCURRENT_STREAMS,
+                                     long(options.mHttp2Streams));
+#endif
+        }
+        // </AS:Chanayane>
+        else if (options.mPipelining > 1) // <AS:Chanayane/> HTTP/2 multiplexing
         {
             // We'll try to do pipelining on this multihandle
             check_curl_multi_setopt(multi_handle,
@@ -709,4 +936,120 @@ void check_curl_multi_code(CURLMcode code)
     }
 }
 
+
+// <AS:Chanayane> Event-driven service loop
+#if ! LLCORE_CURL_MULTI_POLL
+#if LL_WINDOWS
+
+// Only sockets can be waited on, so use a loopback UDP socket
+// connected to itself for both ends.
+bool open_wake_fds(curl_socket_t fds[2])
+{
+    SOCKET sock(socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP));
+    if (INVALID_SOCKET == sock)
+    {
+        return false;
+    }
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    int addr_len(sizeof(addr));
+    u_long non_blocking(1);
+    if (bind(sock, (sockaddr *) &addr, sizeof(addr))
+        || getsockname(sock, (sockaddr *) &addr, &addr_len)
+        || connect(sock, (sockaddr *) &addr, sizeof(addr))
+        || ioctlsocket(sock, FIONBIO, &non_blocking))
+    {
+        closesocket(sock);
+        return false;
+    }
+    fds[0] = fds[1] = sock;
+    return true;
+}
+
+
+void close_wake_fds(curl_socket_t fds[2])
+{
+    if (CURL_SOCKET_BAD != fds[0])
+    {
+        closesocket(fds[0]);
+    }
+    fds[0] = fds[1] = CURL_SOCKET_BAD;
+}
+
+
+void signal_wake_fd(curl_socket_t fd)
+{
+    const char byte(0);
+    send(fd, &byte, 1, 0);
+}
+
+
+void drain_wake_fd(curl_socket_t fd)
+{
+    char buffer[64];
+    while (recv(fd, buffer, sizeof(buffer), 0) > 0)
+    {}
+}
+
+#else
+
+bool open_wake_fds(curl_socket_t fds[2])
+{
+    int pipe_fds[2];
+    if (pipe(pipe_fds))
+    {
+        return false;
+    }
+    for (int fd : pipe_fds)
+    {
+        if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) < 0
+            || fcntl(fd, F_SETFD, FD_CLOEXEC) < 0)
+        {
+            close(pipe_fds[0]);
+            close(pipe_fds[1]);
+            return false;
+        }
+    }
+    fds[0] = pipe_fds[0];
+    fds[1] = pipe_fds[1];
+    return true;
+}
+
+
+void close_wake_fds(curl_socket_t fds[2])
+{
+    for (int i(0); i < 2; ++i)
+    {
+        if (CURL_SOCKET_BAD != fds[i])
+        {
+            close(fds[i]);
+            fds[i] = CURL_SOCKET_BAD;
+        }
+    }
+}
+
+
+void signal_wake_fd(curl_socket_t fd)
+{
+    // A full pipe already has a wakeup pending
+    const char byte(0);
+    ssize_t written(write(fd, &byte, 1));
+    (void) written;
+}
+
+
+void drain_wake_fd(curl_socket_t fd)
+{
+    char buffer[64];
+    while (read(fd, buffer, sizeof(buffer)) > 0)
+    {}
+}
+
+#endif // LL_WINDOWS
+#endif // ! LLCORE_CURL_MULTI_POLL
+// </AS:Chanayane>
+
 }  // end anonymous namespace
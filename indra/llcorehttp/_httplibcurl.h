@@ -34,9 +34,21 @@
 
 #include <set>
 
+// <AS:Chanayane> Event-driven service loop
+// curl_multi_poll() and curl_multi_wakeup() arrived in 7.68.0.  Older
+// versions wait in curl_multi_wait() (7.28.0) and get woken through a
+// descriptor of our own.
+#if LIBCURL_VERSION_NUM >= 0x074400
+#define LLCORE_CURL_MULTI_POLL 1
+#else
+#define LLCORE_CURL_MULTI_POLL 0
+#endif
+// </AS:Chanayane>
+
 #include "httprequest.h"
 #include "_httpservice.h"
 #include "_httpinternal.h"
+#include "_mutex.h" // <AS:Chanayane/> Event-driven service loop
 
 
 namespace LLCore
@@ -77,6 +89,22 @@ public:
     /// Threading:  called by worker thread.
     HttpService::ELoopSpeed processTransport();
 
+    // <AS:Chanayane> Event-driven service loop
+    /// Block until a socket of an active request is ready, libcurl
+    /// has a timeout to service, wakeup() is called or @max_wait_ms
+    /// elapses.  If the wait handle could not be set up this is a
+    /// plain sleep of HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS.
+    ///
+    /// Threading:  called by worker thread.
+    void waitTransport(int max_wait_ms);
+
+    /// Interrupt a waitTransport() in progress, or make the next
+    /// one return at once.
+    ///
+    /// Threading:  callable by any thread.
+    void wakeup();
+    // </AS:Chanayane>
+
     /// Add request to the active list.  Caller is expected to have
     /// provided us with a reference count on the op to hold the
     /// request.  (No additional references will be added.)
@@ -215,6 +243,13 @@ protected:
     CURLM **            mMultiHandles;      // One handle per policy class
     int *               mActiveHandles;     // Active count per policy class
     bool *              mDirtyPolicy;       // Dirty policy update waiting for stall (per pc)
+    // <AS:Chanayane> Event-driven service loop
+    CURLM *             mWaitMulti;         // Handle-less multi waitTransport() blocks in, owner
+    LLCoreInt::HttpMutex mWaitMutex;        // Guards mWaitMulti for wakeup()
+#if ! LLCORE_CURL_MULTI_POLL
+    curl_socket_t       mWakeFds[2];        // Read and write ends signalled by wakeup(), owner
+#endif
+    // </AS:Chanayane>
 
 }; // end class HttpLibcurl
 
@@ -155,7 +155,12 @@ HttpOpRequest::HttpOpRequest()
       mPolicyRetryLimit(HTTP_RETRY_COUNT_DEFAULT),
       mPolicyMinRetryBackoff(HttpTime(HTTP_RETRY_BACKOFF_MIN_DEFAULT)),
       mPolicyMaxRetryBackoff(HttpTime(HTTP_RETRY_BACKOFF_MAX_DEFAULT)),
-      mCallbackSSLVerify(nullptr)
+      // <AS:Chanayane> Request phase latencies
+      //mCallbackSSLVerify(nullptr)
+      mCallbackSSLVerify(nullptr),
+      mTimes(),
+      mTimesValid(false)
+      // </AS:Chanayane>
 {
     // *NOTE:  As members are added, retry initialization/cleanup
     // may need to be extended in @see prepareRequest().
@@ -282,12 +287,82 @@ void HttpOpRequest::visitNotifier(HttpRequest * request)
 
         response->setTransferStats(stats);
 
+        // <AS:Chanayane> Request phase latencies
+        if (mTimesValid)
+        {
+            HTTPStats::instance().recordRequestEvents(mTimes);
+        }
+        // </AS:Chanayane>
+
         mUserHandler->onCompleted(this->getHandle(), response);
 
         response->release();
     }
 }
 
+// <AS:Chanayane> Request phase latencies
+namespace
+{
+    U64 curl_time_us(CURL * handle, CURLINFO info)
+    {
+        // The microsecond variants only exist from libcurl 7.61
+#if LIBCURL_VERSION_NUM >= 0x073d00
+        curl_off_t value(0);
+        if (CURLE_OK != curl_easy_getinfo(handle, info, &value) || value < 0)
+        {
+            return 0;
+        }
+        return U64(value);
+#else
+        double value(0.0);
+        if (CURLE_OK != curl_easy_getinfo(handle, info, &value) || value < 0.0)
+        {
+            return 0;
+        }
+        return U64(value * 1000000.0);
+#endif
+    }
+
+#if LIBCURL_VERSION_NUM >= 0x073d00
+#define LLCORE_CURLINFO_TIME(name) CURLINFO_ ## name ## _TIME_T
+#else
+#define LLCORE_CURLINFO_TIME(name) CURLINFO_ ## name ## _TIME
+#endif
+}
+
+
+void HttpOpRequest::recordTimes()
+{
+    if (! mCurlHandle)
+    {
+        return;
+    }
+
+    long new_connections(0L);
+    curl_easy_getinfo(mCurlHandle, CURLINFO_NUM_CONNECTS, &new_connections);
+
+    mTimes.mCreated = mMetricCreated;
+    mTimes.mNameLookup = curl_time_us(mCurlHandle, LLCORE_CURLINFO_TIME(NAMELOOKUP));
+    mTimes.mConnect = curl_time_us(mCurlHandle, LLCORE_CURLINFO_TIME(CONNECT));
+    mTimes.mAppConnect = curl_time_us(mCurlHandle, LLCORE_CURLINFO_TIME(APPCONNECT));
+    mTimes.mPreTransfer = curl_time_us(mCurlHandle, LLCORE_CURLINFO_TIME(PRETRANSFER));
+    mTimes.mStartTransfer = curl_time_us(mCurlHandle, LLCORE_CURLINFO_TIME(STARTTRANSFER));
+    mTimes.mTotal = curl_time_us(mCurlHandle, LLCORE_CURLINFO_TIME(TOTAL));
+    mTimes.mNewConnection = new_connections > 0;
+    mTimesValid = true;
+
+    HTTPStats & stats(HTTPStats::instance());
+    stats.recordRequest(mReqPolicy, mTimes);
+    if (stats.isTracing())
+    {
+        stats.traceRequest(mReqPolicy, methodToString(mReqMethod), mReqURL, mStatus.getType(),
+                           mReplyBody ? mReplyBody->size() : 0, mTimes);
+    }
+}
+
+#undef LLCORE_CURLINFO_TIME
+// </AS:Chanayane>
+
 // /*static*/
 // HttpOpRequest::ptr_t HttpOpRequest::fromHandle(HttpHandle handle)
 // {
@@ -452,6 +527,12 @@ void HttpOpRequest::setupCommon(HttpRequest::policy_t policy_id,
         {
             mProcFlags |= PF_USE_RETRY_AFTER;
         }
+        // <AS:Chanayane> Contiguous replies
+        if (options->getContiguousReply())
+        {
+            mProcFlags |= PF_CONTIGUOUS_REPLY;
+        }
+        // </AS:Chanayane>
         mPolicyRetryLimit = options->getRetries();
         mPolicyRetryLimit = llclamp(mPolicyRetryLimit, HTTP_RETRY_COUNT_MIN, HTTP_RETRY_COUNT_MAX);
         mTracing = (std::max)(mTracing, llclamp(options->getTrace(), HTTP_TRACE_MIN, HTTP_TRACE_MAX));
@@ -492,6 +573,7 @@ HttpStatus HttpOpRequest::prepareRequest(HttpService * service)
     mReplyLength = 0;
     mReplyFullLength = 0;
     mReplyHeaders.reset();
+    mTimesValid = false; // <AS:Chanayane/> Request phase latencies
     mReplyConType.clear();
 
     // *FIXME:  better error handling later
@@ -767,6 +849,22 @@ HttpStatus HttpOpRequest::prepareRequest(HttpService * service)
 /******************************/
         check_curl_easy_setopt(mCurlHandle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2_0);
     }
+    // <AS:Chanayane> HTTP/2 multiplexing
+    if (cpolicy.mHttp2Streams > 0L)
+    {
+        // Falls back to HTTP/1.1 for plain http and servers without
+        // HTTP/2.  Waiting for a connection that can multiplex keeps
+        // a burst of requests from each opening its own connection.
+        // Streams share bandwidth so give transfers the same extra
+        // room as pipelined ones.
+        check_curl_easy_setopt(mCurlHandle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        check_curl_easy_setopt(mCurlHandle, CURLOPT_PIPEWAIT, 1L);
+        if (cpolicy.mPipelining <= 1L)
+        {
+            xfer_timeout *= 2L;
+        }
+    }
+    // </AS:Chanayane>
     // *DEBUG:  Enable following override for timeout handling and "[curl:bugs] #1420" tests
     //if (cpolicy.mPipelining)
     //{
@@ -806,6 +904,27 @@ size_t HttpOpRequest::writeCallback(void * data, size_t size, size_t nmemb, void
     if (! op->mReplyBody)
     {
         op->mReplyBody = new BufferArray();
+        // <AS:Chanayane> Contiguous replies
+        if (op->mProcFlags & PF_CONTIGUOUS_REPLY)
+        {
+            // Headers are complete by the time the first body bytes
+            // arrive so the announced length is known here.  Fall back
+            // to the requested range if the server didn't send one.
+            curl_off_t content_length(-1);
+#if LIBCURL_VERSION_NUM >= 0x073700
+            curl_easy_getinfo(op->mCurlHandle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &content_length);
+#else
+            double content_length_d(-1.0);
+            curl_easy_getinfo(op->mCurlHandle, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &content_length_d);
+            content_length = (curl_off_t) content_length_d;
+#endif
+            const size_t expected(content_length > 0 ? size_t(content_length) : op->mReqLength);
+            if (expected && expected <= HTTP_CONTIGUOUS_REPLY_MAX)
+            {
+                op->mReplyBody->reserveContiguous(expected);
+            }
+        }
+        // </AS:Chanayane>
     }
     const size_t req_size(size * nmemb);
     const size_t write_size(op->mReplyBody->append(static_cast<char *>(data), req_size));
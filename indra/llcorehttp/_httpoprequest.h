@@ -43,6 +43,7 @@
 
 #include "httpheaders.h"
 #include "httpoptions.h"
+#include "httpstats.h" // <AS:Chanayane/> Request phase latencies
 
 namespace LLCore
 {
@@ -158,6 +159,16 @@ public:
 
     virtual HttpStatus cancel();
 
+    // <AS:Chanayane> Request phase latencies
+    // Reads libcurl's timings of the completed transfer into mTimes
+    // and feeds the phase histograms and the HTTP trace.  Must run
+    // before the curl handle is recycled.
+    //
+    // Threading:  called by worker thread
+    //
+    void recordTimes();
+    // </AS:Chanayane>
+
 protected:
     // Common setup for all the request methods.
     //
@@ -187,6 +198,7 @@ protected:
     static const unsigned int   PF_SCAN_RANGE_HEADER = 0x00000001U;
     static const unsigned int   PF_SAVE_HEADERS = 0x00000002U;
     static const unsigned int   PF_USE_RETRY_AFTER = 0x00000004U;
+    static const unsigned int   PF_CONTIGUOUS_REPLY = 0x00000008U; // <AS:Chanayane/> Contiguous replies
 
     HttpRequest::policyCallback_t   mCallbackSSLVerify;
 
@@ -226,6 +238,11 @@ public:
     int                 mPolicyRetryLimit;
     HttpTime            mPolicyMinRetryBackoff; // initial delay between retries (mcs)
     HttpTime            mPolicyMaxRetryBackoff;
+
+    // <AS:Chanayane> Request phase latencies
+    HTTPStats::RequestTimes mTimes;
+    bool                mTimesValid;
+    // </AS:Chanayane>
 };  // end class HttpOpRequest
 
 
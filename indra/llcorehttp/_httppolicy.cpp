@@ -253,6 +253,13 @@ HttpService::ELoopSpeed HttpPolicy::processReadyQueue()
                          ? (state.mOptions.mPerHostConnectionLimit
                             * state.mOptions.mPipelining)
                          : state.mOptions.mConnectionLimit);
+        // <AS:Chanayane> HTTP/2 multiplexing
+        if (state.mOptions.mHttp2Streams > 0L)
+        {
+            // Libcurl queues what the connections cannot take yet
+            active_limit = int(state.mOptions.mPerHostConnectionLimit * state.mOptions.mHttp2Streams);
+        }
+        // </AS:Chanayane>
         int needed(active_limit - active);      // Expect negatives here
 
         if (needed > 0)
@@ -321,11 +328,24 @@ HttpService::ELoopSpeed HttpPolicy::processReadyQueue()
 
     throttle_on:
 
-        if (! readyq.empty() || ! retryq.empty())
+        // <AS:Chanayane> Event-driven service loop
+        // With every slot taken the ready queue only moves when a
+        // request completes, which ends the transport wait.  Retries
+        // and throttling run on timers and still need polling.
+        //if (! readyq.empty() || ! retryq.empty())
+        //{
+        //    // If anything is ready, continue looping...
+        //    result = HttpService::NORMAL;
+        //}
+        if (! retryq.empty() || (throttle_enabled && state.mThrottleLeft <= 0 && ! readyq.empty()))
         {
-            // If anything is ready, continue looping...
             result = HttpService::NORMAL;
         }
+        else if (! readyq.empty())
+        {
+            result = (std::min)(result, HttpService::TRANSPORT_WAIT);
+        }
+        // </AS:Chanayane>
     } // end foreach policy_class
 
     return result;
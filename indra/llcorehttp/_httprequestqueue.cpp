@@ -81,6 +81,12 @@ HttpStatus HttpRequestQueue::addOp(const HttpRequestQueue::opPtr_t &op)
         }
         wake = mQueue.empty();
         mQueue.push_back(op);
+        // <AS:Chanayane> Event-driven service loop
+        if (wake && mWakeup)
+        {
+            mWakeup();
+        }
+        // </AS:Chanayane>
     }
     if (wake)
     {
@@ -147,6 +153,12 @@ bool HttpRequestQueue::stopQueue()
     {
         HttpScopedLock lock(mQueueMutex);
 
+        // <AS:Chanayane> Event-driven service loop
+        if (mWakeup)
+        {
+            mWakeup();
+        }
+        // </AS:Chanayane>
         if (!mQueueStopped)
         {
             mQueueStopped = true;
@@ -159,4 +171,14 @@ bool HttpRequestQueue::stopQueue()
 }
 
 
+// <AS:Chanayane> Event-driven service loop
+void HttpRequestQueue::setWakeupCallback(const wakeup_t & callback)
+{
+    HttpScopedLock lock(mQueueMutex);
+
+    mWakeup = callback;
+}
+// </AS:Chanayane>
+
+
 } // end namespace LLCore
@@ -28,6 +28,7 @@
 #define _LLCORE_HTTP_REQUEST_QUEUE_H_
 
 
+#include <functional> // <AS:Chanayane/> Event-driven service loop
 #include <vector>
 
 #include "httpcommon.h"
@@ -126,6 +127,19 @@ public:
     /// Threading:  callable by any thread.
     bool stopQueue();
 
+    // <AS:Chanayane> Event-driven service loop
+    typedef std::function<void()> wakeup_t;
+
+    /// Install a callback run, with the queue locked, whenever
+    /// an operation lands on an empty queue or the queue is
+    /// stopped.  Lets a worker blocked somewhere other than
+    /// @fetchAll (i.e. in the transport) see new requests.  An
+    /// empty function removes the callback.
+    ///
+    /// Threading:  callable by any thread.
+    void setWakeupCallback(const wakeup_t & callback);
+    // </AS:Chanayane>
+
 protected:
     static HttpRequestQueue *           sInstance;
 
@@ -134,6 +148,7 @@ protected:
     LLCoreInt::HttpMutex                mQueueMutex;
     LLCoreInt::HttpConditionVariable    mQueueCV;
     bool                                mQueueStopped;
+    wakeup_t                            mWakeup; // <AS:Chanayane/> Event-driven service loop
 
 }; // end class HttpRequestQueue
 
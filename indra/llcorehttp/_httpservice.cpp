@@ -62,7 +62,8 @@ const HttpService::OptionDescriptor HttpService::sOptionDesc[] =
     {   true,       true,       true,       false,      false   },      // PO_TRACE
     {   true,       true,       false,      true,       false   },      // PO_ENABLE_PIPELINING
     {   true,       true,       false,      true,       false   },      // PO_THROTTLE_RATE
-    {   false,      false,      true,       false,      true    }       // PO_SSL_VERIFY_CALLBACK
+    {   false,      false,      true,       false,      true    },      // PO_SSL_VERIFY_CALLBACK
+    {   true,       true,       false,      true,       false   }       // PO_HTTP2_STREAMS <AS:Chanayane/> HTTP/2 multiplexing
 };
 HttpService * HttpService::sInstance(NULL);
 volatile HttpService::EState HttpService::sState(NOT_INITIALIZED);
@@ -111,6 +112,7 @@ HttpService::~HttpService()
 
     if (mRequestQueue)
     {
+        mRequestQueue->setWakeupCallback(HttpRequestQueue::wakeup_t()); // <AS:Chanayane/> Event-driven service loop
         mRequestQueue->release();
         mRequestQueue = NULL;
     }
@@ -210,6 +212,10 @@ void HttpService::startThread()
     // Push current policy definitions, enable policy & transport components
     mPolicy->start();
     mTransport->start(mLastPolicy + 1);
+    // <AS:Chanayane> Event-driven service loop
+    HttpLibcurl * transport(mTransport);
+    mRequestQueue->setWakeupCallback([transport]() { transport->wakeup(); });
+    // </AS:Chanayane>
 
     mThread = new LLCoreInt::HttpThread(boost::bind(&HttpService::threadRun, this, _1));
     sState = RUNNING;
@@ -305,10 +311,21 @@ void HttpService::threadRun(LLCoreInt::HttpThread * thread)
             loop = (std::min)(loop, new_loop);
 
             // Determine whether to spin, sleep briefly or sleep for next request
-            if (REQUEST_SLEEP != loop)
+            // <AS:Chanayane> Event-driven service loop
+            // Both waits end early on socket activity or a new request.
+            //if (REQUEST_SLEEP != loop)
+            //{
+            //    ms_sleep(HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS);
+            //}
+            if (NORMAL == loop)
             {
-                ms_sleep(HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS);
+                mTransport->waitTransport(HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS);
             }
+            else if (TRANSPORT_WAIT == loop)
+            {
+                mTransport->waitTransport(HTTP_SERVICE_LOOP_WAIT_MAX_MS);
+            }
+            // </AS:Chanayane>
         }
         catch (const LLContinueError&)
         {
@@ -105,6 +105,7 @@ public:
     enum ELoopSpeed
     {
         NORMAL,                 ///< continuous polling of request, ready, active queues
+        TRANSPORT_WAIT,         ///< can block until transport or request queue activity // <AS:Chanayane/> Event-driven service loop
         REQUEST_SLEEP           ///< can sleep indefinitely waiting for request queue write
     };
 
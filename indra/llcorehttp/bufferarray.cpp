@@ -62,6 +62,7 @@ public:
 
 protected:
     Block(size_t len);
+    Block(char * storage, size_t len); // <AS:Chanayane/> Contiguous replies
 
     // Allocate the block with the additional space for the
     // buffered data at the end of the object.
@@ -71,14 +72,30 @@ public:
     // Only public entry to get a block.
     static Block * alloc(size_t len);
 
+    // <AS:Chanayane> Contiguous replies
+    // Block whose data lives in a separate ll_aligned_malloc_16()
+    // allocation that can be handed over with detach().
+    static Block * allocAligned(size_t len);
+
+    char * detach();
+    // </AS:Chanayane>
+
 public:
     size_t mUsed;
     size_t mAlloced;
 
+    // <AS:Chanayane> Contiguous replies
     // *NOTE:  Must be last member of the object.  We'll
     // overallocate as requested via operator new and index
     // into the array at will.
-    char mData[1];
+    //char mData[1];
+
+    // Either the space overallocated past the end of the object
+    // by operator new or, for aligned blocks, the separate
+    // allocation owned by the block.
+    char * mData;
+    bool mAligned;
+    // </AS:Chanayane>
 };
 
 
@@ -184,6 +201,47 @@ void * BufferArray::appendBufferAlloc(size_t len)
 }
 
 
+// <AS:Chanayane> Contiguous replies
+bool BufferArray::reserveContiguous(size_t len)
+{
+    if (mLen || ! mBlocks.empty() || ! len)
+    {
+        return false;
+    }
+
+    Block * block(NULL);
+    try
+    {
+        block = Block::allocAligned(len);
+    }
+    catch (std::bad_alloc&)
+    {
+        LL_WARNS() << "Unable to reserve " << len << " contiguous bytes, using ordinary blocks" << LL_ENDL;
+        return false;
+    }
+    mBlocks.push_back(block);
+    return true;
+}
+
+
+char * BufferArray::detachContiguous(size_t * len)
+{
+    if (mBlocks.size() != 1 || ! mBlocks[0]->mAligned)
+    {
+        return NULL;
+    }
+
+    Block * block(mBlocks[0]);
+    *len = block->mUsed;
+    char * data(block->detach());
+    delete block;
+    mBlocks.clear();
+    mLen = 0;
+    return data;
+}
+// </AS:Chanayane>
+
+
 size_t BufferArray::read(size_t pos, void * dst, size_t len)
 {
     char * c_dst(static_cast<char *>(dst));
@@ -325,14 +383,36 @@ bool BufferArray::getBlockStartEnd(int block, const char ** start, const char **
 
 BufferArray::Block::Block(size_t len)
     : mUsed(0),
-      mAlloced(len)
+      // <AS:Chanayane> Contiguous replies
+      //mAlloced(len)
+      mAlloced(len),
+      mData(reinterpret_cast<char *>(this + 1)),
+      mAligned(false)
+      // </AS:Chanayane>
 {
     memset(mData, 0, len);
 }
 
 
+// <AS:Chanayane> Contiguous replies
+BufferArray::Block::Block(char * storage, size_t len)
+    : mUsed(0),
+      mAlloced(len),
+      mData(storage),
+      mAligned(true)
+{}
+// </AS:Chanayane>
+
+
 BufferArray::Block::~Block()
 {
+    // <AS:Chanayane> Contiguous replies
+    if (mAligned && mData)
+    {
+        ll_aligned_free_16(mData);
+    }
+    mData = NULL;
+    // </AS:Chanayane>
     mUsed = 0;
     mAlloced = 0;
 }
@@ -340,7 +420,11 @@ BufferArray::Block::~Block()
 
 void * BufferArray::Block::operator new(size_t len, size_t addl_len)
 {
-    void * mem = new char[len + addl_len + sizeof(void *)];
+    // <AS:Chanayane> Contiguous replies
+    // 'len' covers the object itself, the data follows it.
+    //void * mem = new char[len + addl_len + sizeof(void *)];
+    void * mem = new char[len + addl_len];
+    // </AS:Chanayane>
     return mem;
 }
 
@@ -365,4 +449,35 @@ BufferArray::Block * BufferArray::Block::alloc(size_t len)
 }
 
 
+// <AS:Chanayane> Contiguous replies
+BufferArray::Block * BufferArray::Block::allocAligned(size_t len)
+{
+    char * storage(static_cast<char *>(ll_aligned_malloc_16(len)));
+    if (! storage)
+    {
+        throw std::bad_alloc();
+    }
+    try
+    {
+        return new (0) Block(storage, len);
+    }
+    catch (...)
+    {
+        ll_aligned_free_16(storage);
+        throw;
+    }
+}
+
+
+char * BufferArray::Block::detach()
+{
+    char * data(mData);
+    mData = NULL;
+    mUsed = 0;
+    mAlloced = 0;
+    return data;
+}
+// </AS:Chanayane>
+
+
 }  // end namespace LLCore
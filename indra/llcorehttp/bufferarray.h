@@ -120,6 +120,26 @@ public:
     /// size of the instance or do a mix of both.
     size_t write(size_t pos, const void * src, size_t len);
 
+    // <AS:Chanayane> Contiguous replies
+    /// Pre-sizes an empty instance with a single block of 'len'
+    /// bytes so that appends totalling up to 'len' land in one
+    /// contiguous, 16-byte aligned allocation.  Anything beyond
+    /// that goes into ordinary blocks.
+    ///
+    /// @return         True if the block was allocated.  Fails
+    ///                 if the instance is not empty.
+    bool reserveContiguous(size_t len);
+
+    /// Hands the storage of a block created by reserveContiguous()
+    /// over to the caller when it holds all of the instance's data.
+    /// The caller frees it with ll_aligned_free_16().  The instance
+    /// is left empty, for every holder of a reference.
+    ///
+    /// @return         The data, with its length in *len, or NULL
+    ///                 if it isn't all in a single reserved block.
+    char * detachContiguous(size_t * len);
+    // </AS:Chanayane>
+
 protected:
     int findBlock(size_t pos, size_t * ret_offset);
 
@@ -58,6 +58,7 @@ void usage(std::ostream & out);
 static int concurrency_limit(40);
 static int highwater(100);
 static int pipeline_depth(0);
+static int http2_streams(0); // <AS:Chanayane/> HTTP/2 multiplexing
 static int tracing(0);
 static char url_format[1024] = "http://example.com/some/path?texture_id=%s.texture";
 
@@ -165,7 +166,7 @@ int main(int argc, char** argv)
     bool do_verbose(false);
 
     int option(-1);
-    while (-1 != (option = getopt(argc, argv, "u:c:h?RwvH:p:t:")))
+    while (-1 != (option = getopt(argc, argv, "u:c:h?RwvH:p:t:2:")))
     {
         switch (option)
         {
@@ -219,6 +220,23 @@ int main(int argc, char** argv)
             }
             break;
 
+        // <AS:Chanayane> HTTP/2 multiplexing
+        case '2':
+            {
+                unsigned long value;
+                char * end;
+
+                value = strtoul(optarg, &end, 10);
+                if (value > 256 || *end != '\0')
+                {
+                    usage(std::cerr);
+                    return 1;
+                }
+                http2_streams = value;
+            }
+            break;
+        // </AS:Chanayane>
+
         case '5':
             {
                 unsigned long value;
@@ -289,6 +307,15 @@ int main(int argc, char** argv)
                                                    pipeline_depth,
                                                    NULL);
     }
+    // <AS:Chanayane> HTTP/2 multiplexing
+    if (http2_streams)
+    {
+        LLCore::HttpRequest::setStaticPolicyOption(LLCore::HttpRequest::PO_HTTP2_STREAMS,
+                                                   LLCore::HttpRequest::DEFAULT_POLICY_ID,
+                                                   http2_streams,
+                                                   NULL);
+    }
+    // </AS:Chanayane>
     if (tracing)
     {
         LLCore::HttpRequest::setStaticPolicyOption(LLCore::HttpRequest::PO_TRACE,
@@ -394,6 +421,8 @@ void usage(std::ostream & out)
         "                       Range:  [1..200]  Default:  " << highwater << "\n"
         " -p <depth>            If <depth> is positive, enables and sets pipelineing\n"
         "                       depth on HTTP requests.  Default:  " << pipeline_depth << "\n"
+        " -2 <streams>          If <streams> is positive, requests HTTP/2 and multiplexes\n"
+        "                       up to that many streams per connection.  Default:  " << http2_streams << "\n"
         " -t <level>            If <level> is positive ([1..3]), enables and sets HTTP\n"
         "                       tracing on HTTP requests.  Default:  " << tracing << "\n"
         " -v                    Verbose mode.  Issue some chatter while running\n"
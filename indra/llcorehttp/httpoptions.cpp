@@ -48,7 +48,11 @@ HttpOptions::HttpOptions() :
     mVerifyHost(false),
     mDNSCacheTimeout(-1L),
     mLastModified(0),
-    mNoBody(false)
+    // <AS:Chanayane> Contiguous replies
+    //mNoBody(false)
+    mNoBody(false),
+    mContiguousReply(false)
+    // </AS:Chanayane>
 {}
 
 
@@ -135,6 +139,13 @@ void HttpOptions::setLastModified(time_t lastModified)
     mLastModified = lastModified;
 }
 
+// <AS:Chanayane> Contiguous replies
+void HttpOptions::setContiguousReply(bool contiguous)
+{
+    mContiguousReply = contiguous;
+}
+// </AS:Chanayane>
+
 void HttpOptions::setDefaultSSLVerifyPeer(bool verify)
 {
     sDefaultVerifyPeer = verify;
@@ -184,6 +184,19 @@ public:
         return mLastModified;
     }
 
+    // <AS:Chanayane> Contiguous replies
+    /// Collect the response body in a single, 16-byte aligned
+    /// buffer sized from the Content-Length header or the requested
+    /// byte range, so the consumer can take it over with
+    /// BufferArray::detachContiguous() instead of copying it out.
+    /// Default: false
+    void                setContiguousReply(bool contiguous);
+    bool                getContiguousReply() const
+    {
+        return mContiguousReply;
+    }
+    // </AS:Chanayane>
+
     /// Sets default behavior for verifying that the name in the
     /// security certificate matches the name of the host contacted.
     /// Defaults false if not set, but should be set according to
@@ -206,6 +219,7 @@ protected:
     int                 mDNSCacheTimeout;
     bool                mNoBody;
     time_t              mLastModified;
+    bool                mContiguousReply; // <AS:Chanayane/> Contiguous replies
 
     static bool         sDefaultVerifyPeer;
 }; // end class HttpOptions
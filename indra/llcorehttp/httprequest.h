@@ -232,6 +232,22 @@ public:
         /// Global only
         PO_SSL_VERIFY_CALLBACK,
 
+        // <AS:Chanayane> HTTP/2 multiplexing
+        /// If greater than 0, requests in the class ask for HTTP/2
+        /// over TLS and are multiplexed as streams on shared
+        /// connections, up to this many concurrent streams per
+        /// connection.  New requests wait for a connection that can
+        /// take another stream rather than opening their own.
+        /// PO_PER_HOST_CONNECTION_LIMIT still bounds the number of
+        /// connections, and servers that only speak HTTP/1.1 get
+        /// the usual one request per connection.  Takes precedence
+        /// over PO_PIPELINING_DEPTH.  A value of zero, the default,
+        /// leaves the class on HTTP/1.1.
+        ///
+        /// Per-class only
+        PO_HTTP2_STREAMS,
+        // </AS:Chanayane>
+
         PO_LAST  // Always at end
     };
 
@@ -26,17 +26,88 @@
 
 #include "httpstats.h"
 #include "llerror.h"
+// <AS:Chanayane> Request phase latencies
+#include "httpcommon.h"
+#include "_httpinternal.h"
+#include "llsdjson.h"
+#include "lluuid.h"
+
+#include <algorithm>
+// </AS:Chanayane>
 
 namespace LLCore
 {
+// <AS:Chanayane> Request phase latencies
+static_assert(HTTPStats::PHASE_COUNT == 7, "Update sPhaseEvents and getPhaseName()");
+
+namespace
+{
+    LLTrace::EventStatHandle<F64Milliseconds> sHttpQueueTime("http_queue_time", "Time HTTP requests wait for a connection slot");
+    LLTrace::EventStatHandle<F64Milliseconds> sHttpDNSTime("http_dns_time", "Name lookup time of new HTTP connections");
+    LLTrace::EventStatHandle<F64Milliseconds> sHttpConnectTime("http_connect_time", "TCP connect time of new HTTP connections");
+    LLTrace::EventStatHandle<F64Milliseconds> sHttpTLSTime("http_tls_time", "TLS handshake time of new HTTP connections");
+    LLTrace::EventStatHandle<F64Milliseconds> sHttpFirstByteTime("http_first_byte_time", "Time from sending an HTTP request to the first byte of the response");
+    LLTrace::EventStatHandle<F64Milliseconds> sHttpTransferTime("http_transfer_time", "Time receiving HTTP response bodies");
+    LLTrace::EventStatHandle<F64Milliseconds> sHttpTotalTime("http_total_time", "Time from creating an HTTP request to its completion");
+
+    LLTrace::EventStatHandle<F64Milliseconds> * const sPhaseEvents[HTTPStats::PHASE_COUNT] =
+    {
+        &sHttpQueueTime,
+        &sHttpDNSTime,
+        &sHttpConnectTime,
+        &sHttpTLSTime,
+        &sHttpFirstByteTime,
+        &sHttpTransferTime,
+        &sHttpTotalTime
+    };
+
+    // Scheme, host and path of url, without credentials, query or
+    // fragment.  Path segments starting with a UUID, i.e. capability ids,
+    // are replaced so that the trace can be shared.
+    std::string getTraceURL(const std::string & url)
+    {
+        const size_t scheme_end(url.find("://"));
+        size_t host_start((scheme_end == std::string::npos) ? 0 : scheme_end + 3);
+        const size_t path_end(std::min(url.find_first_of("?#", host_start), url.size()));
+        const size_t path_start(std::min(url.find('/', host_start), path_end));
+        const size_t at(url.rfind('@', path_start));
+        if (at != std::string::npos && at >= host_start)
+        {
+            host_start = at + 1;
+        }
+
+        std::string result(url, 0, (scheme_end == std::string::npos) ? 0 : scheme_end + 3);
+        result.append(url, host_start, path_start - host_start);
+        for (size_t segment = path_start; segment < path_end; )
+        {
+            const size_t next(std::min(url.find('/', segment + 1), path_end));
+            const std::string name(url, segment + 1, next - segment - 1);
+            result += '/';
+            if (name.size() >= UUID_STR_LENGTH - 1 && LLUUID::validate(name.substr(0, UUID_STR_LENGTH - 1)))
+            {
+                result += "[cap]";
+            }
+            else
+            {
+                result += name;
+            }
+            segment = next;
+        }
+        return result;
+    }
+}
+// </AS:Chanayane>
+
 HTTPStats::HTTPStats()
 {
+    static_assert(PHASE_CLASS_LIMIT == HTTP_POLICY_CLASS_LIMIT); // <AS:Chanayane/> Request phase latencies
     resetStats();
 }
 
 
 HTTPStats::~HTTPStats()
 {
+    stopTrace(); // <AS:Chanayane/> Request phase latencies
 }
 
 void HTTPStats::resetStats()
@@ -45,6 +116,20 @@ void HTTPStats::resetStats()
     mDataDown.reset();
     mDataUp.reset();
     mRequests = 0;
+    // <AS:Chanayane> HTTP/2 multiplexing
+    mMultiplexedTransfers = 0;
+    mSingleTransfers = 0;
+    mConnections = 0;
+    // </AS:Chanayane>
+    // <AS:Chanayane> Request phase latencies
+    for (int policy_class = 0; policy_class < PHASE_CLASS_LIMIT; ++policy_class)
+    {
+        for (int phase = 0; phase < PHASE_COUNT; ++phase)
+        {
+            mPhaseLatency[policy_class][phase].reset();
+        }
+    }
+    // </AS:Chanayane>
 }
 
 
@@ -84,6 +169,289 @@ namespace
     }
 }
 
+// <AS:Chanayane> Request phase latencies
+// static
+const char * HTTPStats::getPhaseName(EPhase phase)
+{
+    static const char * const names[PHASE_COUNT] =
+    {
+        "queue",
+        "dns",
+        "connect",
+        "tls",
+        "first_byte",
+        "transfer",
+        "total"
+    };
+    return (phase >= 0 && phase < PHASE_COUNT) ? names[phase] : "unknown";
+}
+
+
+// static
+bool HTTPStats::getPhaseDuration(const RequestTimes & times, EPhase phase, U64 & microseconds)
+{
+    microseconds = 0;
+    switch (phase)
+    {
+    case PHASE_QUEUE:
+        if (times.mStarted < times.mCreated)
+        {
+            return false;
+        }
+        microseconds = times.mStarted - times.mCreated;
+        return true;
+
+    case PHASE_DNS:
+        if (! times.mNewConnection)
+        {
+            return false;
+        }
+        microseconds = times.mNameLookup;
+        return true;
+
+    case PHASE_CONNECT:
+        if (! times.mNewConnection || times.mConnect < times.mNameLookup)
+        {
+            return false;
+        }
+        microseconds = times.mConnect - times.mNameLookup;
+        return true;
+
+    case PHASE_TLS:
+        // No handshake on plain HTTP, and libcurl reports 0 then
+        if (! times.mNewConnection || times.mAppConnect < times.mConnect || ! times.mAppConnect)
+        {
+            return false;
+        }
+        microseconds = times.mAppConnect - times.mConnect;
+        return true;
+
+    case PHASE_FIRST_BYTE:
+        // Nothing received, e.g. a failed connection
+        if (! times.mStartTransfer || times.mStartTransfer < times.mPreTransfer)
+        {
+            return false;
+        }
+        microseconds = times.mStartTransfer - times.mPreTransfer;
+        return true;
+
+    case PHASE_TRANSFER:
+        if (! times.mStartTransfer || times.mTotal < times.mStartTransfer)
+        {
+            return false;
+        }
+        microseconds = times.mTotal - times.mStartTransfer;
+        return true;
+
+    case PHASE_TOTAL:
+        if (times.mStarted < times.mCreated)
+        {
+            return false;
+        }
+        microseconds = times.mStarted - times.mCreated + times.mTotal;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+
+void HTTPStats::recordRequest(int policy_class, const RequestTimes & times)
+{
+    if (policy_class < 0 || policy_class >= PHASE_CLASS_LIMIT)
+    {
+        return;
+    }
+
+    for (int phase = 0; phase < PHASE_COUNT; ++phase)
+    {
+        U64 microseconds;
+        if (getPhaseDuration(times, EPhase(phase), microseconds))
+        {
+            mPhaseLatency[policy_class][phase].record(microseconds);
+        }
+    }
+}
+
+
+void HTTPStats::recordRequestEvents(const RequestTimes & times)
+{
+    for (int phase = 0; phase < PHASE_COUNT; ++phase)
+    {
+        U64 microseconds;
+        if (getPhaseDuration(times, EPhase(phase), microseconds))
+        {
+            record(*sPhaseEvents[phase], F64Microseconds(F64(microseconds)));
+        }
+    }
+}
+
+
+U64 HTTPStats::getPhaseCount(int policy_class, EPhase phase) const
+{
+    if (policy_class < 0 || policy_class >= PHASE_CLASS_LIMIT || phase < 0 || phase >= PHASE_COUNT)
+    {
+        return 0;
+    }
+    return mPhaseLatency[policy_class][phase].getCount();
+}
+
+
+U64 HTTPStats::getPhasePercentile(int policy_class, EPhase phase, F32 fraction) const
+{
+    if (policy_class < 0 || policy_class >= PHASE_CLASS_LIMIT || phase < 0 || phase >= PHASE_COUNT)
+    {
+        return 0;
+    }
+    return mPhaseLatency[policy_class][phase].getPercentile(fraction);
+}
+
+
+bool HTTPStats::startTrace(const std::string & filename)
+{
+    LLMutexLock lock(&mTraceMutex);
+
+    if (mTraceFile)
+    {
+        return true;
+    }
+
+    mTraceFile = LLFile::fopen(filename, "wb");
+    if (! mTraceFile)
+    {
+        LL_WARNS("HTTPCore") << "Unable to open HTTP trace file " << filename << LL_ENDL;
+        return false;
+    }
+
+    // JSON array format.  The closing bracket is optional for the
+    // trace viewers, so a truncated file can still be loaded.
+    fputs("[\n", mTraceFile);
+    mTraceRequests = 0;
+    mTraceEvents = 0;
+    mTraceBytes = 2;
+    mTracing = true;
+    LL_INFOS("HTTPCore") << "Writing HTTP trace to " << filename << LL_ENDL;
+    return true;
+}
+
+
+void HTTPStats::stopTrace()
+{
+    LLMutexLock lock(&mTraceMutex);
+
+    mTracing = false;
+    if (mTraceFile)
+    {
+        fputs("\n]\n", mTraceFile);
+        LLFile::close(mTraceFile);
+        mTraceFile = nullptr;
+        LL_INFOS("HTTPCore") << "HTTP trace closed after " << mTraceRequests << " requests" << LL_ENDL;
+    }
+}
+
+
+void HTTPStats::traceRequest(int policy_class, const std::string & method, const std::string & url,
+                             S32 status, size_t bytes, const RequestTimes & times)
+{
+    if (! mTracing)
+    {
+        return;
+    }
+
+    LLMutexLock lock(&mTraceMutex);
+
+    if (! mTraceFile)
+    {
+        return;
+    }
+
+    // Requests overlap, so they are async events (one track per request
+    // in the viewer) with the phases nested inside.  HttpTime values can
+    // exceed the LLSD integer range, timestamps are written as reals.
+    const std::string id(llformat("0x%llx", (unsigned long long) ++mTraceRequests));
+    std::ostringstream out;
+    auto write_event = [&](const char * name, const char * ph, U64 ts, const LLSD & args)
+    {
+        LLSD event;
+        event["name"] = name;
+        event["cat"] = "http";
+        event["ph"] = ph;
+        event["id"] = id;
+        event["pid"] = 1;
+        event["tid"] = policy_class;
+        event["ts"] = F64(ts);
+        if (args.isDefined())
+        {
+            event["args"] = args;
+        }
+        if (mTraceEvents++)
+        {
+            out << ",\n";
+        }
+        LlsdToJsonStream(event, out);
+    };
+
+    U64 duration;
+    const U64 end(times.mStarted + times.mTotal);
+    const std::string trace_url(getTraceURL(url));
+    const std::string name(method + " " + trace_url);
+
+    LLSD args;
+    args["url"] = trace_url;
+    args["method"] = method;
+    args["status"] = status;
+    args["bytes"] = F64(bytes);
+    args["policy_class"] = policy_class;
+    args["new_connection"] = times.mNewConnection;
+    write_event(name.c_str(), "b", times.mCreated, args);
+
+    if (getPhaseDuration(times, PHASE_QUEUE, duration))
+    {
+        write_event(getPhaseName(PHASE_QUEUE), "b", times.mCreated, LLSD());
+        write_event(getPhaseName(PHASE_QUEUE), "e", times.mStarted, LLSD());
+    }
+
+    // The remaining phases follow libcurl's timeline from mStarted
+    const struct
+    {
+        EPhase  mPhase;
+        U64     mStart;
+    } phases[] =
+    {
+        { PHASE_DNS,        0 },
+        { PHASE_CONNECT,    times.mNameLookup },
+        { PHASE_TLS,        times.mConnect },
+        { PHASE_FIRST_BYTE, times.mPreTransfer },
+        { PHASE_TRANSFER,   times.mStartTransfer }
+    };
+    for (const auto & phase : phases)
+    {
+        if (getPhaseDuration(times, phase.mPhase, duration))
+        {
+            write_event(getPhaseName(phase.mPhase), "b", times.mStarted + phase.mStart, LLSD());
+            write_event(getPhaseName(phase.mPhase), "e", times.mStarted + phase.mStart + duration, LLSD());
+        }
+    }
+
+    write_event(name.c_str(), "e", end, LLSD());
+
+    const std::string text(out.str());
+    fwrite(text.data(), 1, text.size(), mTraceFile);
+    mTraceBytes += text.size();
+
+    if (mTraceBytes >= TRACE_MAX_BYTES)
+    {
+        mTracing = false;
+        fputs("\n]\n", mTraceFile);
+        LLFile::close(mTraceFile);
+        mTraceFile = nullptr;
+        LL_WARNS("HTTPCore") << "HTTP trace stopped at " << mTraceBytes / (1024 * 1024) << " MB after "
+                             << mTraceRequests << " requests" << LL_ENDL;
+    }
+}
+// </AS:Chanayane>
+
 void HTTPStats::dumpStats()
 {
     std::stringstream out;
@@ -93,6 +461,10 @@ void HTTPStats::dumpStats()
     out << "Data Sent: " << byte_count_converter(mDataUp.getSum()) << "   (" << mDataUp.getSum() << ")" << std::endl;
     out << "Data Recv: " << byte_count_converter(mDataDown.getSum()) << "   (" << mDataDown.getSum() << ")" << std::endl;
     out << "Total requests: " << mRequests << "(request objects created)" << std::endl;
+    // <AS:Chanayane> HTTP/2 multiplexing
+    out << "Transfers: " << mMultiplexedTransfers << " as HTTP/2 streams, " << mSingleTransfers
+        << " as HTTP/1.x requests, over " << mConnections << " new connections" << std::endl;
+    // </AS:Chanayane>
     out << std::endl;
     out << "Result Codes:" << std::endl << "--- -----" << std::endl;
 
@@ -101,6 +473,36 @@ void HTTPStats::dumpStats()
         out << (*it).first << " " << (*it).second << std::endl;
     }
 
+    // <AS:Chanayane> Request phase latencies
+    out << std::endl;
+    out << "Phase latencies per policy class, p50/p95/p99 in ms (count):" << std::endl;
+    for (int policy_class = 0; policy_class < PHASE_CLASS_LIMIT; ++policy_class)
+    {
+        if (! getPhaseCount(policy_class, PHASE_TOTAL))
+        {
+            continue;
+        }
+
+        out << "Class " << policy_class << ":";
+        for (int phase = 0; phase < PHASE_COUNT; ++phase)
+        {
+            const EPhase ephase(static_cast<EPhase>(phase));
+            const U64 count(getPhaseCount(policy_class, ephase));
+            if (! count)
+            {
+                continue;
+            }
+            out << "  " << getPhaseName(ephase) << " "
+                << std::setprecision(4)
+                << getPhasePercentile(policy_class, ephase, 0.5f) / 1000.0 << "/"
+                << getPhasePercentile(policy_class, ephase, 0.95f) / 1000.0 << "/"
+                << getPhasePercentile(policy_class, ephase, 0.99f) / 1000.0
+                << " (" << count << ")";
+        }
+        out << std::endl;
+    }
+    // </AS:Chanayane>
+
     LL_WARNS("HTTPCore") << out.str() << LL_ENDL;
 }
 
@@ -32,6 +32,12 @@
 #include "llstatsaccumulator.h"
 #include "llsingleton.h"
 #include "llsd.h"
+// <AS:Chanayane> Request phase latencies
+#include "llfile.h"
+#include "lllatencyhistogram.h"
+#include "llmutex.h"
+#include <atomic>
+// </AS:Chanayane>
 
 namespace LLCore
 {
@@ -59,12 +65,104 @@ namespace LLCore
 
         void    recordResultCode(S32 code);
 
+        // <AS:Chanayane> HTTP/2 multiplexing
+        // Completed transfer, whether it ran as a stream on a multiplexed
+        // (HTTP/2 or later) connection and how many connections it opened
+        void    recordTransfer(bool multiplexed, long new_connections)
+        {
+            ++(multiplexed ? mMultiplexedTransfers : mSingleTransfers);
+            mConnections += (S32)new_connections;
+        }
+        // </AS:Chanayane>
+
+        // <AS:Chanayane> Request phase latencies
+        // Where the time of a request goes, from its creation by the
+        // application to the last byte of the response.
+        enum EPhase
+        {
+            PHASE_QUEUE = 0,        // waiting in the request and ready queues
+            PHASE_DNS,              // name lookup
+            PHASE_CONNECT,          // TCP connect
+            PHASE_TLS,              // TLS handshake
+            PHASE_FIRST_BYTE,       // request sent, waiting for the response
+            PHASE_TRANSFER,         // receiving the response body
+            PHASE_TOTAL,            // creation to completion
+            PHASE_COUNT
+        };
+
+        // Timestamps of one request attempt, in microseconds
+        struct RequestTimes
+        {
+            U64     mCreated{ 0 };          // request created, HttpTime
+            U64     mStarted{ 0 };          // handed to libcurl, HttpTime
+            // libcurl timings, relative to mStarted
+            U64     mNameLookup{ 0 };
+            U64     mConnect{ 0 };
+            U64     mAppConnect{ 0 };
+            U64     mPreTransfer{ 0 };
+            U64     mStartTransfer{ 0 };
+            U64     mTotal{ 0 };
+            bool    mNewConnection{ false };
+        };
+
+        static const char * getPhaseName(EPhase phase);
+
+        // Duration of a phase of the request.  Returns false for phases
+        // that did not happen, e.g. DNS and connect on a reused connection.
+        static bool getPhaseDuration(const RequestTimes & times, EPhase phase, U64 & microseconds);
+
+        // Adds a completed request to the histograms of its policy class.
+        // Threading:  called by worker thread
+        void    recordRequest(int policy_class, const RequestTimes & times);
+
+        // Samples the LLTrace event stats of each phase.  Done when the
+        // response is delivered, on the thread that made the request, so
+        // it lands in that thread's recording.
+        void    recordRequestEvents(const RequestTimes & times);
+
+        U64     getPhaseCount(int policy_class, EPhase phase) const;
+        U64     getPhasePercentile(int policy_class, EPhase phase, F32 fraction) const;
+
+        // Chrome trace (chrome://tracing, Perfetto) of every request
+        // completed while tracing is on, written as a JSON array of
+        // async events, one row per policy class.  The file stays
+        // loadable if the viewer exits without stopTrace().  URLs are
+        // written without query and capability ids, and tracing stops
+        // once the file reaches TRACE_MAX_BYTES.
+        static constexpr size_t TRACE_MAX_BYTES = 64 * 1024 * 1024;
+        bool    startTrace(const std::string & filename);
+        void    stopTrace();
+        bool    isTracing() const { return mTracing; }
+
+        // Threading:  called by worker thread
+        void    traceRequest(int policy_class, const std::string & method, const std::string & url,
+                             S32 status, size_t bytes, const RequestTimes & times);
+        // </AS:Chanayane>
+
         void    dumpStats();
     private:
         StatsAccumulator mDataDown;
         StatsAccumulator mDataUp;
 
         S32              mRequests;
+        // <AS:Chanayane> HTTP/2 multiplexing
+        S32              mMultiplexedTransfers;
+        S32              mSingleTransfers;
+        S32              mConnections;
+        // </AS:Chanayane>
+
+        // <AS:Chanayane> Request phase latencies
+        // Same limit as HTTP_POLICY_CLASS_LIMIT, which is internal
+        static constexpr int PHASE_CLASS_LIMIT = 32;
+        LLLatencyHistogram mPhaseLatency[PHASE_CLASS_LIMIT][PHASE_COUNT];
+
+        LLMutex          mTraceMutex;
+        LLFILE *         mTraceFile{ nullptr };
+        U64              mTraceRequests{ 0 };
+        U64              mTraceEvents{ 0 };
+        size_t           mTraceBytes{ 0 };
+        std::atomic<bool> mTracing{ false };
+        // </AS:Chanayane>
 
         std::map<S32, S32> mResutCodes;
     };
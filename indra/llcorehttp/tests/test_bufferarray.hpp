@@ -27,6 +27,7 @@
 #define TEST_LLCORE_BUFFER_ARRAY_H_
 
 #include "bufferarray.h"
+#include "llmemory.h" // <AS:Chanayane/> Contiguous replies
 
 #include <iostream>
 
@@ -374,6 +375,59 @@ void BufferArrayTestObjectType::test<8>()
     ba->release();
 }
 
+// <AS:Chanayane> Contiguous replies
+template <> template <>
+void BufferArrayTestObjectType::test<9>()
+{
+    set_test_name("BufferArray reserveContiguous/detachContiguous");
+
+    // create a new ref counted object with an implicit reference
+    BufferArray * ba = new BufferArray();
+
+    char str1[] = "abcdefghij";
+    size_t str1_len(strlen(str1));
+
+    // Reserve more than a default block and fill it exactly
+    const size_t reserved(BufferArray::BLOCK_ALLOC_SIZE + 2 * str1_len);
+    ensure("Reserve on empty BA succeeds", ba->reserveContiguous(reserved));
+    ensure("Reserve doesn't change size", 0 == ba->size());
+    ensure("Second reserve refused", ! ba->reserveContiguous(reserved));
+
+    size_t written(0);
+    while (written < reserved)
+    {
+        written += ba->append(str1, (std::min)(str1_len, reserved - written));
+    }
+    ensure("Size matches reservation", reserved == ba->size());
+
+    size_t detached_len(0);
+    char * detached(ba->detachContiguous(&detached_len));
+    ensure("Detached data non-NULL", NULL != detached);
+    ensure("Detached length correct", reserved == detached_len);
+    ensure("Detached data aligned", 0 == (reinterpret_cast<uintptr_t>(detached) & 0xf));
+    ensure("Detached content correct", 0 == strncmp(detached + BufferArray::BLOCK_ALLOC_SIZE / str1_len * str1_len, str1, str1_len));
+    ensure("BA empty after detach", 0 == ba->size());
+    ll_aligned_free_16(detached);
+
+    // Overflowing the reservation spills into ordinary blocks and
+    // the data can no longer be detached, only read.
+    char buffer[256];
+    ensure("Reserve after detach succeeds", ba->reserveContiguous(str1_len));
+    ba->append(str1, str1_len);
+    ba->append(str1, str1_len);
+    ensure("Overflowed size correct", 2 * str1_len == ba->size());
+    ensure("Overflowed BA not detachable", NULL == ba->detachContiguous(&detached_len));
+    memset(buffer, 'X', sizeof(buffer));
+    size_t len(ba->read(0, buffer, sizeof(buffer)));
+    ensure("Overflowed read length correct", 2 * str1_len == len);
+    ensure("Overflowed content correct.1", 0 == strncmp(buffer, str1, str1_len));
+    ensure("Overflowed content correct.2", 0 == strncmp(buffer + str1_len, str1, str1_len));
+
+    // release the implicit reference, causing the object to be released
+    ba->release();
+}
+// </AS:Chanayane>
+
 }  // end namespace tut
 
 
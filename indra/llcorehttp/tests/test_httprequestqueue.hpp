@@ -151,6 +151,49 @@ void HttpRequestqueueTestObjectType::test<4>()
     }
 }
 
+// <AS:Chanayane> Event-driven service loop
+template <> template <>
+void HttpRequestqueueTestObjectType::test<5>()
+{
+    set_test_name("HttpRequestQueue wakeup callback");
+
+    // create a new ref counted object with an implicit reference
+    HttpRequestQueue::init();
+
+    HttpRequestQueue * rq = HttpRequestQueue::instanceOf();
+
+    int wakeups(0);
+    rq->setWakeupCallback([&wakeups]() { ++wakeups; });
+
+    HttpOperation::ptr_t op(new HttpOpNull());
+    rq->addOp(op);
+    ensure_equals("Adding to an empty queue wakes the service", wakeups, 1);
+
+    op.reset(new HttpOpNull());
+    rq->addOp(op);
+    ensure_equals("Adding to a busy queue does not", wakeups, 1);
+
+    {
+        HttpRequestQueue::OpContainer ops;
+        rq->fetchAll(false, ops);
+        ensure("Two go in, two come out", 2 == ops.size());
+    }
+
+    op.reset(new HttpOpNull());
+    rq->addOp(op);
+    ensure_equals("Adding to a drained queue wakes again", wakeups, 2);
+
+    rq->stopQueue();
+    ensure_equals("Stopping the queue wakes the service", wakeups, 3);
+
+    rq->setWakeupCallback(HttpRequestQueue::wakeup_t());
+    op.reset();
+
+    // release the singleton
+    HttpRequestQueue::term();
+}
+// </AS:Chanayane>
+
 }  // end namespace tut
 
 
@@ -51,6 +51,39 @@ static const std::string CACHE_FILENAME_PREFIX("sl_cache");
 
 std::string LLDiskCache::sCacheDir;
 
+// <AS:Chanayane> Index-backed LRU eviction
+/**
+ * The journal lives next to the cache files. Its name deliberately does not
+ * contain CACHE_FILENAME_PREFIX so it is never mistaken for a cache file.
+ */
+static const std::string CACHE_INDEX_FILENAME("cache_index.jnl");
+static const char CACHE_INDEX_MAGIC[4] = { 'L', 'D', 'C', 'J' };
+static const U32 CACHE_INDEX_VERSION = 1;
+
+/**
+ * Journal record opcodes. INDEX_OP_CLOSE is appended on a clean shutdown;
+ * a journal that does not end with it is not trusted on the next start.
+ * INDEX_OP_OPEN is appended (and flushed) when a clean journal is reopened
+ * so that a crash later in the session does not leave it looking closed.
+ */
+static const U32 INDEX_OP_UPDATE = 1;
+static const U32 INDEX_OP_REMOVE = 2;
+static const U32 INDEX_OP_CLOSE = 3;
+static const U32 INDEX_OP_OPEN = 4;
+
+/**
+ * The journal is rewritten once it holds this many more records than twice
+ * the number of live entries.
+ */
+static const size_t INDEX_COMPACT_SLACK = 4096;
+
+/**
+ * Same threshold as LLFileSystem::updateFileAccessTime(): reads closer
+ * together than this only reorder the in-memory index.
+ */
+static const std::time_t INDEX_ACCESS_THRESHOLD = 1 * 60 * 60;
+// </AS:Chanayane>
+
 // <FS:Ansariel> Optimize asset simple disk cache
 static const char* subdirs = "0123456789abcdef";
 
@@ -75,6 +108,9 @@ LLDiskCache::LLDiskCache(const std::string& cache_dir,
         LLFile::mkdir(dirname);
     }
     // </FS:Ansariel>
+
+    loadIndex(); // <AS:Chanayane/> Index-backed LRU eviction
+
     // <FS:Beq> add static assets into the new cache after clear.
     // Only missing entries are copied on init, skiplist is setup
     // For everything we populate FS specific assets to allow future updates
@@ -82,6 +118,14 @@ LLDiskCache::LLDiskCache(const std::string& cache_dir,
     // </FS:Beq>
 }
 
+// <AS:Chanayane> Index-backed LRU eviction
+LLDiskCache::~LLDiskCache()
+{
+    LLMutexLock lock(&mIndexMutex);
+    closeJournal(true);
+}
+// </AS:Chanayane>
+
 // WARNING: purge() is called by LLPurgeDiskCacheThread. As such it must
 // NOT touch any LLDiskCache data without introducing and locking a mutex!
 
@@ -110,222 +154,564 @@ LLDiskCache::LLDiskCache(const std::string& cache_dir,
 // will prevent this. B continues with the next file. If the file is already
 // gone before A finally gets to open it, this operation will fail and the
 // asset will have to be re-requested.
+// <AS:Chanayane> Index-backed LRU eviction
+// The index is the source of truth for sizes and access order, so purging
+// no longer walks the directory tree: victims are taken from the least
+// recently used end of the index under mIndexMutex and the files are then
+// deleted outside of the lock so LLFileSystem callers are not held up by
+// the filesystem.
 void LLDiskCache::purge()
 {
+    LL_PROFILE_ZONE_SCOPED;
+
+    bool index_valid = false;
+    {
+        LLMutexLock lock(&mIndexMutex);
+        index_valid = mIndexValid;
+    }
+    if (!index_valid)
+    {
+        rebuildIndex();
+    }
+
     if (mEnableCacheDebugInfo)
     {
         LL_INFOS() << "Total dir size before purge is " << dirFileSize(sCacheDir) << LL_ENDL;
     }
 
-    boost::system::error_code ec;
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    typedef std::pair<std::time_t, std::pair<uintmax_t, std::string>> file_info_t;
-    std::vector<file_info_t> file_info;
+    std::vector<IndexEntry> victims;
+    uintmax_t file_size_total = 0;
+    uintmax_t deleted_size_total = 0;
+    size_t file_count = 0;
+    S32 skip = 0;
+    bool compact = false;
+    bool below_high_water = false;
+    {
+        LLMutexLock lock(&mIndexMutex);
+
+        file_size_total = mIndexTotalSize;
+        file_count = mIndexMap.size();
+
+        // <FS:Beq> add high water/low water thresholds to reduce the churn in the cache.
+        LL_DEBUGS("LLDiskCache") << "Cache is " << (int)(((F32)file_size_total)/mMaxSizeBytes*100.0) << "% full" << LL_ENDL;
+        below_high_water = file_size_total < mMaxSizeBytes * (mHighPercent/100);
+        if (below_high_water)
+        {
+            // Nothing to do here
+            LL_DEBUGS("LLDiskCache") << "Not exceded high water - do nothing" << LL_ENDL;
+            updateCacheSize(file_size_total);
+        }
+        else
+        {
+            // If we reach here we are above the trigger level so we must purge until we've removed enough to take us down to the low water mark.
+            auto target_size = (uintmax_t)(mMaxSizeBytes * (mLowPercent/100));
+            LL_INFOS() << "Purging cache to a maximum of " << target_size << " bytes" << LL_ENDL;
+            // </FS:Beq>
+
+            // Every entry is visited at most once: protected static assets are
+            // moved to the most recently used end so they don't sit in front of
+            // the entries that can actually be evicted.
+            size_t to_visit = mIndexLRU.size();
+            const std::time_t now = std::time(nullptr);
+            while (to_visit-- > 0 && (file_size_total - deleted_size_total) > target_size)
+            {
+                IndexEntry& entry = mIndexLRU.front();
+                // <FS> Make sure static assets are not eliminated
+                if (std::find(mSkipList.begin(), mSkipList.end(), entry.mID.asString()) != mSkipList.end())
+                {
+                    entry.mLastAccess = now;
+                    mIndexLRU.splice(mIndexLRU.end(), mIndexLRU, mIndexLRU.begin());
+                    ++skip;
+                    continue;
+                }
+                // </FS>
+                deleted_size_total += entry.mSize;
+                victims.push_back(entry);
+                indexErase(victims.back().mID, true);
+            }
+        }
+
+        // Compaction writes the journal outside of the lock
+        compact = mJournalRecords > 2 * mIndexMap.size() + INDEX_COMPACT_SLACK;
+        if (!compact && mJournalFile)
+        {
+            fflush(mJournalFile);
+        }
+    }
+    if (compact)
+    {
+        compactIndex();
+    }
+    if (below_high_water)
+    {
+        return;
+    }
+
+    boost::system::error_code ec;
+    for (const IndexEntry& entry : victims)
+    {
+        const std::string filename = metaDataToFilepath(entry.mID, entry.mType);
+#if LL_WINDOWS
+        boost::filesystem::remove(ll_convert<std::wstring>(filename), ec);
+#else
+        boost::filesystem::remove(filename, ec);
+#endif
+        if (ec.failed())
+        {
+            LL_WARNS() << "Failed to delete cache file " << filename << ": " << ec.message() << LL_ENDL;
+        }
+        else if (mEnableCacheDebugInfo)
+        {
+            // <FS:Beq> update the debug logging to be more useful
+            LL_INFOS() << "DELETE  " << entry.mLastAccess << "  " << entry.mSize << "  " << filename << LL_ENDL;
+        }
+    }
+
+// <FS:Beq> update the debug logging to be more useful
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto execute_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+    auto newCacheSize = updateCacheSize(file_size_total - deleted_size_total);
+    LL_INFOS("LLDiskCache") << "Total dir size after purge is " << newCacheSize << LL_ENDL;
+    LL_INFOS("LLDiskCache") << "Cache purge took " << execute_time << " ms to execute for " << file_count << " files" << LL_ENDL;
+// </FS:Beq>
+    LL_INFOS("LLDiskCache") << "Deleted: " << victims.size() << " Skipped: " << skip << " Kept: " << file_count - victims.size() << LL_ENDL;    // <FS:Beq/> Extra accounting to track the retention of static assets
+    LL_INFOS("LLDiskCache") << "Total of " << deleted_size_total << " bytes removed." << LL_ENDL;    // <FS:Beq/> Extra accounting to track the retention of static assets
+}
+
+std::string LLDiskCache::getIndexFilename() const
+{
+    return sCacheDir + gDirUtilp->getDirDelimiter() + CACHE_INDEX_FILENAME;
+}
+
+void LLDiskCache::loadIndex()
+{
+    LL_PROFILE_ZONE_SCOPED;
+    LLMutexLock lock(&mIndexMutex);
+
+    const std::string filename = getIndexFilename();
+    bool clean = false;
+    if (LLFILE* file = LLFile::fopen(filename, "rb"))
+    {
+        char magic[sizeof(CACHE_INDEX_MAGIC)] = {};
+        U32 version = 0;
+        // A journal cut off mid-record was not closed cleanly either
+        fseek(file, 0, SEEK_END);
+        const long file_size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        const bool whole_records = file_size >= (long)(sizeof(CACHE_INDEX_MAGIC) + sizeof(CACHE_INDEX_VERSION)) &&
+            (file_size - sizeof(CACHE_INDEX_MAGIC) - sizeof(CACHE_INDEX_VERSION)) % sizeof(IndexRecord) == 0;
+
+        if (whole_records &&
+            fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+            fread(&version, sizeof(version), 1, file) == 1 &&
+            memcmp(magic, CACHE_INDEX_MAGIC, sizeof(magic)) == 0 &&
+            version == CACHE_INDEX_VERSION)
+        {
+            IndexRecord record;
+            bool corrupt = false;
+            while (!corrupt && fread(&record, sizeof(record), 1, file) == 1)
+            {
+                LLUUID id;
+                memcpy(id.mData, record.mID, UUID_BYTES);
+                switch (record.mOp)
+                {
+                    case INDEX_OP_UPDATE:
+                        indexUpdate(id, (LLAssetType::EType)record.mType, record.mSize, (std::time_t)record.mLastAccess, false);
+                        clean = false;
+                        break;
+                    case INDEX_OP_REMOVE:
+                        indexErase(id, false);
+                        clean = false;
+                        break;
+                    case INDEX_OP_CLOSE:
+                        clean = true;
+                        break;
+                    case INDEX_OP_OPEN:
+                        clean = false;
+                        break;
+                    default:
+                        corrupt = true;
+                        clean = false;
+                        break;
+                }
+                ++mJournalRecords;
+            }
+        }
+        LLFile::close(file);
+    }
+
+    if (clean)
+    {
+        mIndexValid = true;
+        mJournalFile = LLFile::fopen(filename, "ab");
+        if (mJournalFile)
+        {
+            // The journal now ends with INDEX_OP_CLOSE; make it look open
+            // again on disk right away, records appended later may not be
+            // flushed before a crash.
+            journalRecord(INDEX_OP_OPEN, IndexEntry{});
+            fflush(mJournalFile);
+        }
+        LL_INFOS("LLDiskCache") << "Loaded cache index: " << mIndexMap.size() << " files, " << mIndexTotalSize << " bytes" << LL_ENDL;
+    }
+    else
+    {
+        // Whatever was replayed cannot be trusted; start over and let the
+        // next purge() rebuild the index from the directory contents. Files
+        // recorded in the meantime go into a fresh journal.
+        LL_INFOS("LLDiskCache") << "Cache index missing or not closed cleanly, it will be rebuilt" << LL_ENDL;
+        mIndexLRU.clear();
+        mIndexMap.clear();
+        mIndexTotalSize = 0;
+        mIndexValid = false;
+        openJournal(true);
+    }
+    updateCacheSize(mIndexTotalSize);
+}
+
+void LLDiskCache::rebuildIndex()
+{
+    LL_PROFILE_ZONE_SCOPED;
+    auto start_time = std::chrono::high_resolution_clock::now();
 
+    // Scan without holding the lock; this is the slow part.
+    std::vector<IndexEntry> scanned;
+    // Leftovers of LLMappedFile::getTempFilename() and replaceFile() writes
+    // cut short by a crash. Recent ones may still be in use by a writer.
+    const std::time_t stale_time = std::time(nullptr) - 60;
+    std::vector<boost::filesystem::path> leftovers;
+    boost::system::error_code ec;
 #if LL_WINDOWS
     std::wstring cache_path(ll_convert<std::wstring>(sCacheDir));
 #else
     std::string cache_path(sCacheDir);
 #endif
-    uintmax_t file_size_total = 0; // <FS:Beq/> try to make simple cache less naive.
-    
     if (boost::filesystem::is_directory(cache_path, ec) && !ec.failed())
     {
-        // <FS:Ansariel> Optimize asset simple disk cache
-        //boost::filesystem::directory_iterator iter(cache_path, ec);
-        //while (iter != boost::filesystem::directory_iterator() && !ec.failed())
         boost::filesystem::recursive_directory_iterator iter(cache_path, ec);
         while (iter != boost::filesystem::recursive_directory_iterator() && !ec.failed())
-        // </FS:Ansariel>
         {
             if (boost::filesystem::is_regular_file(*iter, ec) && !ec.failed())
             {
-                if ((*iter).path().string().find(CACHE_FILENAME_PREFIX) != std::string::npos)
+                const std::string file_path = (*iter).path().string();
+                const std::string file_name = gDirUtilp->getBaseFileName(file_path, false);
+                std::string base_name = gDirUtilp->getBaseFileName(file_path, true);
+                const bool is_prefixed = file_name.compare(0, CACHE_FILENAME_PREFIX.size(), CACHE_FILENAME_PREFIX) == 0;
+                const std::string extension = gDirUtilp->getExtension(file_path);
+                if (is_prefixed && (extension == "tmp" || extension == "old"))
                 {
+                    std::time_t file_time = boost::filesystem::last_write_time(*iter, ec);
+                    if (!ec.failed() && file_time < stale_time)
+                    {
+                        leftovers.push_back((*iter).path());
+                    }
+                    ec.clear();
+                }
+                else if (is_prefixed && extension == "asset" &&
+                    base_name.size() >= CACHE_FILENAME_PREFIX.size() + 1 + UUID_STR_LENGTH - 1)
+                {
+                    // skip "sl_cache_" and trailing "_N"
+                    const std::string uuid_as_string = base_name.substr(CACHE_FILENAME_PREFIX.size() + 1, UUID_STR_LENGTH - 1);
                     uintmax_t file_size = boost::filesystem::file_size(*iter, ec);
-                    if (ec.failed())
+                    std::time_t file_time = 0;
+                    if (!ec.failed())
                     {
-                        continue;
+                        file_time = boost::filesystem::last_write_time(*iter, ec);
                     }
-                    const std::string file_path = (*iter).path().string();
-                    const std::time_t file_time = boost::filesystem::last_write_time(*iter, ec);
-                    if (ec.failed())
+                    if (!ec.failed() && LLUUID::validate(uuid_as_string))
                     {
-                        continue;
+                        scanned.push_back({ LLUUID(uuid_as_string), LLAssetType::AT_UNKNOWN, file_size, file_time });
                     }
-                    file_size_total += file_size; // <FS:Beq/> try to make simple cache less naive.
-
-                    file_info.push_back(file_info_t(file_time, { file_size, file_path }));
                 }
             }
             iter.increment(ec);
         }
     }
 
-    // <FS:Beq> add high water/low water thresholds to reduce the churn in the cache.
-    LL_DEBUGS("LLDiskCache") << "Cache is " << (int)(((F32)file_size_total)/mMaxSizeBytes*100.0) << "% full" << LL_ENDL;
-    if( file_size_total < mMaxSizeBytes * (mHighPercent/100) )
+    for (const auto& leftover : leftovers)
     {
-        // Nothing to do here 
-        LL_DEBUGS("LLDiskCache") << "Not exceded high water - do nothing" << LL_ENDL;
-        return;
+        boost::filesystem::remove(leftover, ec);
     }
-    // If we reach here we are above the trigger level so we must purge until we've removed enough to take us down to the low water mark.
-    // </FS:Beq>
-    std::sort(file_info.begin(), file_info.end(), [](file_info_t& x, file_info_t& y)
+
+    std::sort(scanned.begin(), scanned.end(), [](const IndexEntry& x, const IndexEntry& y)
     {
-        return x.first < y.first; // <FS:Beq/> sort oldest to newest, to we can remove the oldest files first.
+        return x.mLastAccess < y.mLastAccess;
     });
 
+    {
+        LLMutexLock lock(&mIndexMutex);
 
-    // <FS:Beq> add high water/low water thresholds to reduce the churn in the cache.
-    auto target_size = (uintmax_t)(mMaxSizeBytes * (mLowPercent/100));
-    LL_INFOS() << "Purging cache to a maximum of " << target_size << " bytes" << LL_ENDL;
-    // </FS:Beq>
+        // Anything recorded while we were scanning is newer than what is on
+        // disk, so scanned files go in front of it, newest scanned file last.
+        for (auto it = scanned.rbegin(); it != scanned.rend(); ++it)
+        {
+            if (mIndexMap.find(it->mID) == mIndexMap.end())
+            {
+                mIndexLRU.push_front(*it);
+                mIndexMap.emplace(it->mID, mIndexLRU.begin());
+                mIndexTotalSize += it->mSize;
+            }
+        }
+        mIndexValid = true;
+        updateCacheSize(mIndexTotalSize);
+    }
+    compactIndex();
 
-    // <FS:Beq> Extra accounting to track the retention of static assets
-    //std::vector<bool> file_removed;
-    enum class purge_action { delete_file=0, keep_file, skip_file };
-    std::map<std::string,purge_action> file_removed;
-    auto keep{file_info.size()};
-    auto del{0};
-    auto skip{0};
-    // </FS:Beq>
-    // <FS:Beq> revised purge logic to track amount removed not retained to shortern loop
-    // uintmax_t file_size_total = 0;
-    // if (mEnableCacheDebugInfo)
-    // {
-    //     file_removed.reserve(file_info.size());
-    // }
-    // uintmax_t file_size_total = 0;
-    // for (file_info_t& entry : file_info)
-    // {
-    //     file_size_total += entry.second.first;
-
-    //     bool should_remove = file_size_total > mMaxSizeBytes;
-    //     if (mEnableCacheDebugInfo)
-    //     {
-    //         file_removed.push_back(should_remove);
-    //     }
-    uintmax_t deleted_size_total = 0;
-    for (const file_info_t& entry : file_info)
+    auto execute_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time).count();
+    LL_INFOS("LLDiskCache") << "Rebuilt cache index from " << scanned.size() << " files in " << execute_time << " ms, removed "
+                            << leftovers.size() << " leftover temporary files" << LL_ENDL;
+}
+
+void LLDiskCache::openJournal(bool truncate)
+{
+    if (mJournalFile)
     {
-        // first check if we still need to delete more files
-        bool should_remove = (file_size_total - deleted_size_total) > target_size;
+        LLFile::close(mJournalFile);
+        mJournalFile = nullptr;
+    }
 
-        // <FS> Make sure static assets are not eliminated
-        auto action{ should_remove ? purge_action::delete_file : purge_action::keep_file };
-        if (!should_remove)
+    const std::string filename = getIndexFilename();
+    if (!truncate)
+    {
+        mJournalFile = LLFile::fopen(filename, "ab");
+    }
+    else
+    {
+        // A compaction in flight would replace the fresh journal with a
+        // snapshot of what it is discarding
+        mCompacting = false;
+        mCompactBacklog.clear();
+        if ((mJournalFile = LLFile::fopen(filename, "wb")))
         {
-            break;
+            fwrite(CACHE_INDEX_MAGIC, 1, sizeof(CACHE_INDEX_MAGIC), mJournalFile);
+            fwrite(&CACHE_INDEX_VERSION, sizeof(CACHE_INDEX_VERSION), 1, mJournalFile);
+            mJournalRecords = 0;
         }
+    }
 
-        auto this_file_size = entry.second.first;
-        deleted_size_total += this_file_size;
-        auto uuid_as_string = gDirUtilp->getBaseFileName(entry.second.second, true);
-        uuid_as_string      = uuid_as_string.substr(CACHE_FILENAME_PREFIX.size() + 1, 36);  // skip "sl_cache_" and trailing "_N"
-        // LL_INFOS() << "checking UUID=" <<uuid_as_string<< LL_ENDL;
-        if (std::find(mSkipList.begin(), mSkipList.end(), uuid_as_string) != mSkipList.end())
+    if (!mJournalFile)
+    {
+        LL_WARNS("LLDiskCache") << "Unable to open cache index " << filename << LL_ENDL;
+    }
+}
+
+void LLDiskCache::closeJournal(bool clean)
+{
+    if (mJournalFile)
+    {
+        // An index that still needs a rebuild must not look clean next session
+        if (clean && mIndexValid)
         {
-            // this is one of our protected items so no purging
-            should_remove = false;
-            action = purge_action::skip_file;
-            boost::filesystem::last_write_time(entry.second.second, ec);  // force these to the front of the list next time so that purge size works 
-            skip++;
+            journalRecord(INDEX_OP_CLOSE, IndexEntry{});
         }
-        else{
-            del++;
+        LLFile::close(mJournalFile);
+        mJournalFile = nullptr;
+    }
+}
+
+void LLDiskCache::compactIndex()
+{
+    LL_PROFILE_ZONE_SCOPED;
+    const std::string filename = getIndexFilename();
+    const std::string tmp_filename = filename + ".tmp";
+
+    // Take the snapshot under the lock, write it without. Records journaled
+    // meanwhile still go to the current journal and are also kept in
+    // mCompactBacklog to be appended to the snapshot before it replaces it.
+    std::vector<IndexEntry> snapshot;
+    {
+        LLMutexLock lock(&mIndexMutex);
+        if (mCompacting)
+        {
+            return;
         }
-        keep--;
-        if (mEnableCacheDebugInfo)
+        mCompacting = true;
+        mCompactBacklog.clear();
+        snapshot.assign(mIndexLRU.begin(), mIndexLRU.end());
+    }
+
+    // Write the snapshot to a temporary file first so a crash part way
+    // through leaves the previous journal in place.
+    LLFILE* file = LLFile::fopen(tmp_filename, "wb");
+    if (file)
+    {
+        fwrite(CACHE_INDEX_MAGIC, 1, sizeof(CACHE_INDEX_MAGIC), file);
+        fwrite(&CACHE_INDEX_VERSION, sizeof(CACHE_INDEX_VERSION), 1, file);
+        for (const IndexEntry& entry : snapshot)
         {
-            file_removed.emplace(entry.second.second, action);
+            writeRecord(file, INDEX_OP_UPDATE, entry);
         }
-    // </FS>
-        if (should_remove)
+    }
+
+    LLMutexLock lock(&mIndexMutex);
+    if (!file || !mCompacting)
+    {
+        // Could not write, or the journal was reset by clearCache()
+        if (file)
         {
-            boost::filesystem::remove(entry.second.second, ec);
-            if (ec.failed())
-            {
-                LL_WARNS() << "Failed to delete cache file " << entry.second.second << ": " << ec.message() << LL_ENDL;
-            }
+            LLFile::close(file);
+            LLFile::remove(tmp_filename);
         }
+        else
+        {
+            LL_WARNS("LLDiskCache") << "Unable to write cache index " << tmp_filename << LL_ENDL;
+        }
+        mCompacting = false;
+        mCompactBacklog.clear();
+        return;
     }
-// <FS:Beq> update the debug logging to be more useful
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto execute_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
-// </FS:Beq>
-    if (mEnableCacheDebugInfo)
+    mCompacting = false;
+
+    for (const auto& record : mCompactBacklog)
+    {
+        writeRecord(file, record.first, record.second);
+    }
+    const size_t num_records = snapshot.size() + mCompactBacklog.size();
+    mCompactBacklog.clear();
+    LLFile::close(file);
+
+    closeJournal(false);
+    if (LLFile::rename(tmp_filename, filename) != 0)
+    {
+        LL_WARNS("LLDiskCache") << "Unable to replace cache index " << filename << LL_ENDL;
+        openJournal(true);
+        mIndexValid = false;
+        return;
+    }
+    openJournal(false);
+    mJournalRecords = num_records;
+}
+
+// static
+bool LLDiskCache::writeRecord(LLFILE* file, U32 op, const IndexEntry& entry)
+{
+    IndexRecord record;
+    memcpy(record.mID, entry.mID.mData, UUID_BYTES);
+    record.mLastAccess = (S64)entry.mLastAccess;
+    record.mSize = (U64)entry.mSize;
+    record.mType = (S32)entry.mType;
+    record.mOp = op;
+    return fwrite(&record, sizeof(record), 1, file) == 1;
+}
+
+void LLDiskCache::journalRecord(U32 op, const IndexEntry& entry)
+{
+    if (mCompacting)
+    {
+        mCompactBacklog.emplace_back(op, entry);
+    }
+
+    if (mJournalFile && writeRecord(mJournalFile, op, entry))
+    {
+        ++mJournalRecords;
+    }
+}
+
+void LLDiskCache::indexUpdate(const LLUUID& id, LLAssetType::EType at, uintmax_t size, std::time_t last_access, bool journal)
+{
+    index_map_t::iterator found = mIndexMap.find(id);
+    if (found != mIndexMap.end())
     {
-        // <FS:Beq> update the debug logging to be more useful
-        // auto end_time = std::chrono::high_resolution_clock::now();
-        // auto execute_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
-        // </FS:Beq>
+        IndexEntry& entry = *found->second;
+        mIndexTotalSize -= entry.mSize;
+        entry.mType = at;
+        entry.mSize = size;
+        entry.mLastAccess = last_access;
+        mIndexLRU.splice(mIndexLRU.end(), mIndexLRU, found->second);
+    }
+    else
+    {
+        mIndexLRU.push_back({ id, at, size, last_access });
+        mIndexMap.emplace(id, std::prev(mIndexLRU.end()));
+    }
+    mIndexTotalSize += size;
+
+    if (journal)
+    {
+        journalRecord(INDEX_OP_UPDATE, mIndexLRU.back());
+    }
+}
 
-        // Log afterward so it doesn't affect the time measurement
-        // Logging thousands of file results can take hundreds of milliseconds
-        uintmax_t deleted_so_far{ 0 }; // <FS:Beq/> update the debug logging to be more useful
-        for (size_t i = 0; i < file_info.size(); ++i)
+void LLDiskCache::indexErase(const LLUUID& id, bool journal)
+{
+    index_map_t::iterator found = mIndexMap.find(id);
+    if (found != mIndexMap.end())
+    {
+        index_lru_t::iterator entry = found->second;
+        mIndexTotalSize -= entry->mSize;
+        if (journal)
         {
-            const file_info_t& entry = file_info[i];
-            // <FS> Static asset stuff
-            deleted_so_far += entry.second.first; // <FS:Beq/> update the debug logging to be more useful
-            //const bool removed = file_removed[i];
-            //const std::string action = removed ? "DELETE:" : "KEEP:";
-            std::string action{};
-
-            // Check if the file exists in the map
-            auto& filename{ entry.second.second };
-            if (file_removed.find(filename) != file_removed.end()) {
-            // File found in the map, retrieve the corresponding enum value
-            switch (file_removed[filename])
-            {
-                case purge_action::delete_file:
-                    action = "DELETE";
-                    del++;
-                break;
-                case purge_action::skip_file:
-                    action = "STATIC";
-                    skip++;
-                break;
-                default:
-                // Handle any unexpected enum value
-                    action = "UNKNOWN";
-                break;
-            }
-            }
-            else 
-            {
-                action = "KEEP";
-            }            
-            // </FS>
-
-            // have to do this because of LL_INFO/LL_END weirdness
-            std::ostringstream line;
-
-            line << action << "  ";
-            line << entry.first << "  ";
-            line << entry.second.first << "  ";
-            line << entry.second.second;
-            line << " (" << file_size_total - deleted_so_far << "/" << mMaxSizeBytes << ")"; // <FS:Beq/> update the debug logging to be more useful
-            LL_INFOS() << line.str() << LL_ENDL;
+            journalRecord(INDEX_OP_REMOVE, *entry);
         }
-// <FS:Beq> make the summary stats more easily enabled.
+        mIndexMap.erase(found);
+        mIndexLRU.erase(entry);
     }
-    // <FS:Beq> update the debug logging to be more useful
-        // LL_INFOS() << "Total dir size after purge is " << dirFileSize(sCacheDir) << LL_ENDL;
-        // LL_INFOS() << "Cache purge took " << execute_time << " ms to execute for " << file_info.size() << " files" << LL_ENDL;
+}
 
-    auto newCacheSize = updateCacheSize(file_size_total - deleted_size_total); 
-    LL_INFOS("LLDiskCache") << "Total dir size after purge is " << newCacheSize << LL_ENDL; 
-    LL_INFOS("LLDiskCache") << "Cache purge took " << execute_time << " ms to execute for " << file_info.size() << " files" << LL_ENDL;
-// </FS:Beq>
-    LL_INFOS("LLDiskCache") << "Deleted: " << del << " Skipped: " << skip << " Kept: " << keep << LL_ENDL;    // <FS:Beq/> Extra accounting to track the retention of static assets
-    LL_INFOS("LLDiskCache") << "Total of " << deleted_size_total << " bytes removed." << LL_ENDL;    // <FS:Beq/> Extra accounting to track the retention of static assets
-    // } <FS:Beq/> this bracket was moved up a few lines.
+LLDiskCache::EIndexAccess LLDiskCache::recordAccess(const LLUUID& id)
+{
+    LLMutexLock lock(&mIndexMutex);
+
+    index_map_t::iterator found = mIndexMap.find(id);
+    if (found == mIndexMap.end())
+    {
+        return INDEX_MISS;
+    }
+
+    IndexEntry& entry = *found->second;
+    mIndexLRU.splice(mIndexLRU.end(), mIndexLRU, found->second);
+
+    // Only journal (and touch the file on disk) once per threshold period;
+    // the in-memory order above is always exact.
+    const std::time_t now = std::time(nullptr);
+    if (now - entry.mLastAccess <= INDEX_ACCESS_THRESHOLD)
+    {
+        return INDEX_FRESH;
+    }
+    entry.mLastAccess = now;
+    journalRecord(INDEX_OP_UPDATE, entry);
+    return INDEX_STALE;
+}
+
+void LLDiskCache::recordWrite(const LLUUID& id, LLAssetType::EType at, uintmax_t end_pos, bool truncated)
+{
+    LLMutexLock lock(&mIndexMutex);
+
+    uintmax_t size = end_pos;
+    if (!truncated)
+    {
+        index_map_t::iterator found = mIndexMap.find(id);
+        if (found != mIndexMap.end())
+        {
+            size = llmax(size, found->second->mSize);
+        }
+    }
+    indexUpdate(id, at, size, std::time(nullptr), true);
 }
 
+void LLDiskCache::recordRemove(const LLUUID& id)
+{
+    LLMutexLock lock(&mIndexMutex);
+    indexErase(id, true);
+}
+
+void LLDiskCache::recordRename(const LLUUID& old_id, const LLUUID& new_id, LLAssetType::EType new_at)
+{
+    LLMutexLock lock(&mIndexMutex);
+
+    index_map_t::iterator found = mIndexMap.find(old_id);
+    if (found != mIndexMap.end())
+    {
+        const uintmax_t size = found->second->mSize;
+        indexErase(old_id, true);
+        indexUpdate(new_id, new_at, size, std::time(nullptr), true);
+    }
+}
+// </AS:Chanayane>
+
 const std::string LLDiskCache::metaDataToFilepath(const LLUUID& id, LLAssetType::EType at)
 {
     // <FS:Ansariel> Store assets in subfolders
@@ -342,15 +728,18 @@ const std::string LLDiskCache::getCacheInfo()
 
     F32 max_in_mb = (F32)mMaxSizeBytes / (1024.0f * 1024.0f);
     // <FS:Beq> stall prevention. We still need to make sure this initialised when called at startup.
-    F32 percent_used;
-    if (mStoredCacheSize > 0)
-    {
-        percent_used = ((F32)mStoredCacheSize / (F32)mMaxSizeBytes) * 100.0f;
-    }
-    else
-    {
-        percent_used = ((F32)dirFileSize(sCacheDir) / (F32)mMaxSizeBytes) * 100.0f; 
-    }
+    // <AS:Chanayane> dirFileSize() is a constant time read once the index is valid
+    //F32 percent_used;
+    //if (mStoredCacheSize > 0)
+    //{
+    //    percent_used = ((F32)mStoredCacheSize / (F32)mMaxSizeBytes) * 100.0f;
+    //}
+    //else
+    //{
+    //    percent_used = ((F32)dirFileSize(sCacheDir) / (F32)mMaxSizeBytes) * 100.0f; 
+    //}
+    F32 percent_used = ((F32)dirFileSize(sCacheDir) / (F32)mMaxSizeBytes) * 100.0f;
+    // </AS:Chanayane>
     // </FS:Beq>
     cache_info << std::fixed;
     cache_info << std::setprecision(1);
@@ -394,6 +783,12 @@ void LLDiskCache::prepopulateCacheWithStatic()
                     {
                         LL_WARNS("LLDiskCache") << "Failed to copy " << from_asset_file << " to " << to_asset_file << LL_ENDL;
                     }
+                    // <AS:Chanayane> Index-backed LRU eviction
+                    else if (llstat file_stat; LLFile::stat(to_asset_file, &file_stat) == 0)
+                    {
+                        recordWrite(uuid, LLAssetType::AT_UNKNOWN, file_stat.st_size, true);
+                    }
+                    // </AS:Chanayane>
                 }
                 if (std::find(mSkipList.begin(), mSkipList.end(), uuid_as_string) == mSkipList.end())
                 {
@@ -412,6 +807,19 @@ void LLDiskCache::prepopulateCacheWithStatic()
 void LLDiskCache::clearCache()
 {
     LL_INFOS() << "clearing cache " << sCacheDir << LL_ENDL;
+
+    // <AS:Chanayane> Index-backed LRU eviction
+    {
+        LLMutexLock lock(&mIndexMutex);
+        mIndexLRU.clear();
+        mIndexMap.clear();
+        mIndexTotalSize = 0;
+        mIndexValid = true;
+        openJournal(true);
+        updateCacheSize(0);
+    }
+    // </AS:Chanayane>
+
     /**
      * See notes on performance in dirFileSize(..) - there may be
      * a quicker way to do this by operating on the parent dir vs
@@ -502,6 +910,17 @@ uintmax_t LLDiskCache::dirFileSize(const std::string& dir, bool force)
     using namespace std::chrono;
     const seconds cache_duration{ 120 };// A rather arbitrary number. it takes 5 seconds+ on a fast drive to scan 80K+ items. purge runs every minute and will update. so 120 should mean we never need a superfluous cache scan.
 
+    // <AS:Chanayane> Index-backed LRU eviction
+    if (dir == sCacheDir)
+    {
+        LLMutexLock lock(&mIndexMutex);
+        if (mIndexValid)
+        {
+            return updateCacheSize(mIndexTotalSize);
+        }
+    }
+    // </AS:Chanayane>
+
     const auto current_time = system_clock::now();
 
     const auto time_difference = duration_cast<seconds>(current_time - mLastScanTime);
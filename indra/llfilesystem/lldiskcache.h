@@ -36,6 +36,16 @@
  *    the same sized directory of files, writing the last updated
  *    time to each took less than 600ms indicating that this
  *    important part of the mechanism has almost no overhead.
+ * 6/ <AS:Chanayane> Scanning the directory tree as described in 3/ does not
+ *    scale to caches of tens of gigabytes, so the cache now keeps an index of
+ *    every file (UUID, asset type, size and time of last access) in LRU order.
+ *    The index is updated incrementally by LLFileSystem as files are written,
+ *    read, renamed and removed, and is persisted as an append-only journal
+ *    next to the cache files. Purging walks the index from the least recently
+ *    used end, so it costs O(files evicted) and the cache size is a constant
+ *    time read. If the journal is missing or was not closed cleanly (viewer
+ *    crash), the next purge rebuilds the index with a single directory scan.
+ *    </AS:Chanayane>
  *
  * $LicenseInfo:firstyear=2009&license=viewerlgpl$
  * Second Life Viewer Source Code
@@ -63,7 +73,12 @@
 #define _LLDISKCACHE
 
 #include "llsingleton.h"
+#include "llassettype.h"
+#include "llmutex.h"
+#include "lluuid.h"
 #include <chrono>
+#include <list>
+#include <unordered_map>
 using namespace std::chrono;
 
 
@@ -108,7 +123,7 @@ class LLDiskCache :
                     // </FS:Beq>
                     );
 
-        virtual ~LLDiskCache() = default;
+        virtual ~LLDiskCache(); // <AS:Chanayane/> Close the index journal cleanly
 
     public:
         /**
@@ -159,7 +174,107 @@ class LLDiskCache :
         void setLowWaterPercentage(F32 LowPct) { mLowPercent = llclamp(LowPct, 0.0, mHighPercent);  };
         // </FS:Beq>
 
+        // <AS:Chanayane> Index-backed LRU eviction
+        /**
+         * Result of recordAccess(): whether the index knows the file and, if
+         * so, whether the access was far enough from the previous one that
+         * the file's last write time on disk should be refreshed as well.
+         */
+        enum EIndexAccess
+        {
+            INDEX_MISS = 0,
+            INDEX_FRESH,
+            INDEX_STALE
+        };
+
+        /**
+         * Mark a cache file as the most recently used entry. Called by
+         * LLFileSystem whenever a file is opened for reading.
+         */
+        EIndexAccess recordAccess(const LLUUID& id);
+
+        /**
+         * Record that a cache file was written. end_pos is the write position
+         * after the write; if truncated is false the file may have been larger
+         * than that before (READ_WRITE mode) and the larger size is kept.
+         */
+        void recordWrite(const LLUUID& id, LLAssetType::EType at, uintmax_t end_pos, bool truncated);
+
+        /**
+         * Record that a cache file was removed or renamed by LLFileSystem.
+         */
+        void recordRemove(const LLUUID& id);
+        void recordRename(const LLUUID& old_id, const LLUUID& new_id, LLAssetType::EType new_at);
+        // </AS:Chanayane>
+
     private:
+        // <AS:Chanayane> Index-backed LRU eviction
+        struct IndexEntry
+        {
+            LLUUID              mID;
+            LLAssetType::EType  mType;
+            uintmax_t           mSize;
+            std::time_t         mLastAccess;
+        };
+        typedef std::list<IndexEntry> index_lru_t;
+        typedef std::unordered_map<LLUUID, index_lru_t::iterator> index_map_t;
+
+        /**
+         * On-disk journal record. Fixed width fields laid out so the struct
+         * has no padding and can be read and written as a whole.
+         */
+        struct IndexRecord
+        {
+            U8  mID[UUID_BYTES];
+            S64 mLastAccess;
+            U64 mSize;
+            S32 mType;
+            U32 mOp;
+        };
+
+        /**
+         * Load the journal written by a previous session and open it for
+         * appending. Leaves mIndexValid false if the journal is missing,
+         * corrupt or was not closed cleanly.
+         */
+        void loadIndex();
+
+        /**
+         * Scan the cache directory and merge every file found into the index.
+         * This is the only place that walks the directory tree and it only
+         * runs when the journal could not be trusted.
+         */
+        void rebuildIndex();
+
+        /**
+         * Rewrite the journal as one record per live entry. Called without
+         * mIndexMutex held; the file is written outside the lock.
+         */
+        void compactIndex();
+
+        /**
+         * Helpers that manipulate the in-memory index and append to the
+         * journal. Called with mIndexMutex held.
+         */
+        void indexUpdate(const LLUUID& id, LLAssetType::EType at, uintmax_t size, std::time_t last_access, bool journal);
+        void indexErase(const LLUUID& id, bool journal);
+        void journalRecord(U32 op, const IndexEntry& entry);
+        static bool writeRecord(LLFILE* file, U32 op, const IndexEntry& entry);
+        void openJournal(bool truncate);
+        void closeJournal(bool clean);
+        std::string getIndexFilename() const;
+
+        LLMutex         mIndexMutex;
+        index_lru_t     mIndexLRU;          // least recently used at the front
+        index_map_t     mIndexMap;
+        uintmax_t       mIndexTotalSize{ 0 };
+        bool            mIndexValid{ false };
+        LLFILE*         mJournalFile{ nullptr };
+        size_t          mJournalRecords{ 0 };
+        bool            mCompacting{ false };
+        std::vector<std::pair<U32, IndexEntry> > mCompactBacklog; // journaled while compacting
+        // </AS:Chanayane>
+
         /**
          * Utility function to gather the total size the files in a given
          * directory. Primarily used here to determine the directory size
@@ -43,6 +43,8 @@ constexpr S32 LLFileSystem::APPEND      = 0x00000006;  // 0x00000004 & LLFileSys
 
 static LLTrace::BlockTimerStatHandle FTM_VFILE_WAIT("VFile Wait");
 
+std::atomic<bool> LLFileSystem::sUseMemoryMapping{ false }; // <AS:Chanayane/> Memory-mapped reads
+
 LLFileSystem::LLFileSystem(const LLUUID& file_id, const LLAssetType::EType file_type, S32 mode)
 {
     mFileType = file_type;
@@ -59,15 +61,42 @@ LLFileSystem::LLFileSystem(const LLUUID& file_id, const LLAssetType::EType file_
         // build the filename (TODO: we do this in a few places - perhaps we should factor into a single function)
         const std::string filename = LLDiskCache::metaDataToFilepath(mFileID, mFileType);
 
-        // update the last access time for the file if it exists - this is required
-        // even though we are reading and not writing because this is the
-        // way the cache works - it relies on a valid "last accessed time" for
-        // each file so it knows how to remove the oldest, unused files
-        bool exists = gDirUtilp->fileExists(filename);
-        if (exists)
+        // <AS:Chanayane> Index-backed LRU eviction
+        // The cache index tracks the access order itself, so the file only
+        // needs to be touched on disk when the index says it has gone stale.
+        // Files the index does not know yet (it is still being rebuilt) are
+        // handled as before and added to the index on the way.
+        //// update the last access time for the file if it exists - this is required
+        //// even though we are reading and not writing because this is the
+        //// way the cache works - it relies on a valid "last accessed time" for
+        //// each file so it knows how to remove the oldest, unused files
+        //bool exists = gDirUtilp->fileExists(filename);
+        //if (exists)
+        //{
+        //    updateFileAccessTime(filename);
+        //}
+        LLDiskCache::EIndexAccess access = LLDiskCache::INDEX_MISS;
+        if (LLDiskCache::instanceExists())
+        {
+            access = LLDiskCache::getInstance()->recordAccess(mFileID);
+        }
+
+        if (access == LLDiskCache::INDEX_STALE)
         {
             updateFileAccessTime(filename);
         }
+        else if (access == LLDiskCache::INDEX_MISS)
+        {
+            if (llstat file_stat; LLFile::stat(filename, &file_stat) == 0 && S_ISREG(file_stat.st_mode))
+            {
+                updateFileAccessTime(filename);
+                if (LLDiskCache::instanceExists())
+                {
+                    LLDiskCache::getInstance()->recordWrite(mFileID, mFileType, file_stat.st_size, true);
+                }
+            }
+        }
+        // </AS:Chanayane>
     }
 }
 
@@ -102,6 +131,13 @@ bool LLFileSystem::removeFile(const LLUUID& file_id, const LLAssetType::EType fi
 
     LLFile::remove(filename.c_str(), suppress_error);
 
+    // <AS:Chanayane> Index-backed LRU eviction
+    if (LLDiskCache::instanceExists())
+    {
+        LLDiskCache::getInstance()->recordRemove(file_id);
+    }
+    // </AS:Chanayane>
+
     return true;
 }
 
@@ -121,6 +157,12 @@ bool LLFileSystem::renameFile(const LLUUID& old_file_id, const LLAssetType::ETyp
         //return false;
         LL_WARNS() << "Failed to rename " << old_file_id << " to " << new_file_id << " reason: " << strerror(errno) << LL_ENDL;
     }
+    // <AS:Chanayane> Index-backed LRU eviction
+    else if (LLDiskCache::instanceExists())
+    {
+        LLDiskCache::getInstance()->recordRename(old_file_id, new_file_id, new_file_type);
+    }
+    // </AS:Chanayane>
 
     return true;
 }
@@ -202,6 +244,56 @@ bool LLFileSystem::read(U8* buffer, S32 bytes)
     return success;
 }
 
+// <AS:Chanayane> Memory-mapped reads
+bool LLFileSystem::readSpan(ReadSpan& span, S32 bytes)
+{
+    LL_PROFILE_ZONE_COLOR(tracy::Color::Gold);
+    span = ReadSpan();
+    mBytesRead = 0;
+
+    if (bytes <= 0)
+    {
+        return false;
+    }
+
+    if (sUseMemoryMapping)
+    {
+        const std::string filename = LLDiskCache::metaDataToFilepath(mFileID, mFileType);
+        LLMappedFile::ptr_t mapping = LLMappedFile::open(filename);
+        if (mapping)
+        {
+            if ((size_t)mPosition < mapping->getSize())
+            {
+                mBytesRead = (S32)llmin((size_t)bytes, mapping->getSize() - (size_t)mPosition);
+                span.mData = mapping->getData() + mPosition;
+                span.mSize = mBytesRead;
+                span.mMapping = mapping;
+                mPosition += mBytesRead;
+            }
+            return mBytesRead > 0;
+        }
+        // Fall through to a plain read if the file could not be mapped
+    }
+
+    std::shared_ptr<U8[]> buffer(new(std::nothrow) U8[bytes]);
+    if (!buffer)
+    {
+        LL_WARNS() << "Failed to allocate " << bytes << " bytes to read " << mFileID << LL_ENDL;
+        span.mAllocationFailed = true;
+        return false;
+    }
+
+    if (read(buffer.get(), bytes))
+    {
+        span.mBuffer = buffer;
+        span.mData = buffer.get();
+        span.mSize = mBytesRead;
+        return true;
+    }
+    return false;
+}
+// </AS:Chanayane>
+
 S32 LLFileSystem::getLastBytesRead() const
 {
     LL_PROFILE_ZONE_COLOR(tracy::Color::Gold); // <FS:Beq> measure cache performance
@@ -307,17 +399,44 @@ bool LLFileSystem::write(const U8* buffer, S32 bytes)
     }
     else
     {
-        LLFILE* ofs = LLFile::fopen(filename, "wb");
+        // <AS:Chanayane> Memory-mapped reads
+        // Truncating a file that is mapped by a reader would make the reader
+        // fault on the pages past the new end, so while reads may be mapped
+        // every file is written aside and replaced instead. Checking for a
+        // live mapping first would race with a reader mapping the file
+        // between the check and the truncation. Existing mappings keep
+        // seeing the old contents.
+        //LLFILE* ofs = LLFile::fopen(filename, "wb");
+        const bool replace = sUseMemoryMapping || LLMappedFile::isMapped(filename);
+        const std::string write_filename = replace ? LLMappedFile::getTempFilename(filename) : filename;
+        LLFILE* ofs = LLFile::fopen(write_filename, "wb");
+        // </AS:Chanayane>
         if (ofs)
         {
             S32 bytes_written = static_cast<S32>(fwrite(buffer, 1, bytes, ofs));
             mPosition = ftell(ofs);
             fclose(ofs);
             success = (bytes_written == bytes);
+            // <AS:Chanayane> Memory-mapped reads
+            if (replace && (!success || !LLMappedFile::replaceFile(write_filename, filename)))
+            {
+                LLFile::remove(write_filename);
+                success = false;
+            }
+            // </AS:Chanayane>
         }
     }
     // </FS:Ansariel>
 
+    // <AS:Chanayane> Index-backed LRU eviction
+    // Only a plain WRITE truncates; APPEND leaves mPosition at the end of
+    // the file and READ_WRITE may have overwritten the middle of it.
+    if (success && LLDiskCache::instanceExists())
+    {
+        LLDiskCache::getInstance()->recordWrite(mFileID, mFileType, mPosition, mMode != READ_WRITE);
+    }
+    // </AS:Chanayane>
+
     return success;
 }
 
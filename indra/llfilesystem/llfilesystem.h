@@ -33,6 +33,9 @@
 #include "lluuid.h"
 #include "llassettype.h"
 #include "lldiskcache.h"
+#include "llmappedfile.h" // <AS:Chanayane/> Memory-mapped reads
+
+#include <atomic>
 
 class LLFileSystem
 {
@@ -41,6 +44,42 @@ class LLFileSystem
         ~LLFileSystem() = default;
 
         bool read(U8* buffer, S32 bytes);
+
+        // <AS:Chanayane> Memory-mapped reads
+        /**
+         * Read-only view of a range of a cache file, filled in by readSpan().
+         * When memory mapped reads are enabled it points straight into a
+         * shared mapping of the file; otherwise it owns a heap copy of the
+         * bytes. Either way the data stays valid for as long as the span, or
+         * any copy of it, is alive, so it can be handed to another thread.
+         */
+        class ReadSpan
+        {
+        public:
+            const U8*   getData() const { return mData; }
+            S32         getSize() const { return mSize; }
+            bool        isMapped() const { return mMapping != nullptr; }
+            bool        allocationFailed() const { return mAllocationFailed; }
+
+        private:
+            friend class LLFileSystem;
+            LLMappedFile::ptr_t     mMapping;
+            std::shared_ptr<U8[]>   mBuffer;
+            const U8*               mData{ nullptr };
+            S32                     mSize{ 0 };
+            bool                    mAllocationFailed{ false };
+        };
+
+        /**
+         * Like read(), but without a caller supplied buffer: reads up to
+         * bytes from the current position into span and advances it.
+         */
+        bool readSpan(ReadSpan& span, S32 bytes);
+
+        static void setUseMemoryMapping(bool enable) { sUseMemoryMapping = enable; }
+        static bool getUseMemoryMapping() { return sUseMemoryMapping; }
+        // </AS:Chanayane>
+
         S32  getLastBytesRead() const;
         bool eof() const;
 
@@ -78,6 +117,8 @@ class LLFileSystem
         S32     mPosition;
         S32     mMode;
         S32     mBytesRead;
+
+        static std::atomic<bool> sUseMemoryMapping; // <AS:Chanayane/> Memory-mapped reads
 };
 
 #endif  // LL_FILESYSTEM_H
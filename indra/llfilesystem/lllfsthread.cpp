@@ -28,6 +28,27 @@
 #include "lllfsthread.h"
 #include "llstl.h"
 #include "llapr.h"
+// <AS:Chanayane> Batched I/O backend
+#include "lltimer.h"
+#include "lltrace.h"
+
+#include <cerrno>
+#if LL_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Enough to keep a batch of texture cache reads in flight without
+    // holding on to too many open files.
+    constexpr U32 LFS_RING_ENTRIES = 64;
+
+    LLTrace::SampleStatHandle<> sLFSQueueDepth("lfsqueuedepth", "Requests waiting in the local file system thread queue");
+    LLTrace::SampleStatHandle<> sLFSInFlight("lfsinflight", "Local file system requests submitted to the kernel and not yet completed");
+    LLTrace::EventStatHandle<F64Milliseconds> sLFSCompletionTime("lfscompletiontime", "Time from queueing a local file system request to its completion");
+}
+// </AS:Chanayane>
 
 //============================================================================
 
@@ -36,11 +57,18 @@
 //============================================================================
 // Run on MAIN thread
 //static
-void LLLFSThread::initClass(bool local_is_threaded)
+// <AS:Chanayane> Batched I/O backend
+//void LLLFSThread::initClass(bool local_is_threaded)
+//{
+//    llassert(sLocal == NULL);
+//    sLocal = new LLLFSThread(local_is_threaded);
+//}
+void LLLFSThread::initClass(bool local_is_threaded, bool use_io_uring)
 {
     llassert(sLocal == NULL);
-    sLocal = new LLLFSThread(local_is_threaded);
+    sLocal = new LLLFSThread(local_is_threaded, use_io_uring);
 }
+// </AS:Chanayane>
 
 //static
 S32 LLLFSThread::updateClass(U32 ms_elapsed)
@@ -64,21 +92,152 @@ void LLLFSThread::cleanupClass()
 
 //----------------------------------------------------------------------------
 
-LLLFSThread::LLLFSThread(bool threaded) :
+LLLFSThread::LLLFSThread(bool threaded, bool use_io_uring) : // <AS:Chanayane/> Batched I/O backend
     LLQueuedThread("LFS", threaded)
 {
     if(!mLocalAPRFilePoolp)
     {
         mLocalAPRFilePoolp = new LLVolatileAPRPool() ;
     }
+
+    // <AS:Chanayane> Batched I/O backend
+    if (use_io_uring && mRing.init(LFS_RING_ENTRIES))
+    {
+        U32 slots = mRing.getCapacity();
+        mInFlight.resize(slots, nullptr);
+        mFreeSlots.reserve(slots);
+        for (U32 i = slots; i > 0; --i)
+        {
+            mFreeSlots.push_back(i - 1);
+        }
+        mCompletions.reserve(slots);
+        LL_INFOS() << "LLLFSThread using io_uring with " << slots << " entries" << LL_ENDL;
+    }
+    // </AS:Chanayane>
 }
 
 LLLFSThread::~LLLFSThread()
 {
+    // <AS:Chanayane> Batched I/O backend
+    // ~LLQueuedThread() calls endThread() when not threaded, but by then
+    // only the base class version is left; complete what is on the ring here
+    if (!getThreaded())
+    {
+        endThread();
+    }
+    // </AS:Chanayane>
     // mLocalAPRFilePoolp cleanup in LLThread
     // ~LLQueuedThread() will be called here
 }
 
+// <AS:Chanayane> Batched I/O backend
+// virtual, called from own thread
+void LLLFSThread::processRequest(QueuedRequest* qreq)
+{
+    if (!mRing.isValid())
+    {
+        LLQueuedThread::processRequest(qreq);
+        return;
+    }
+
+    LL_PROFILE_ZONE_SCOPED;
+    mIdleThread = false;
+
+    if (beginRequest(qreq))
+    {
+        Request* req = (Request*)qreq;
+        llassert(!mFreeSlots.empty());
+        U32 slot = mFreeSlots.back();
+        if (req->queueBatched(mRing, slot))
+        {
+            mFreeSlots.pop_back();
+            mInFlight[slot] = req;
+        }
+        else
+        {
+            bool complete = req->processRequest();
+            endRequest(req, complete);
+        }
+    }
+
+    size_t pending = getPending();
+    sample(sLFSQueueDepth, (F64)pending);
+    sample(sLFSInFlight, (F64)getInFlight());
+
+    // Keep queueing while more requests are waiting so they are submitted
+    // together, but never leave anything in flight once the queue is empty:
+    // nothing would come back to complete it.
+    if (mFreeSlots.empty())
+    {
+        flushBatch(false);
+    }
+    else if (pending == 0)
+    {
+        flushBatch(true);
+    }
+
+    mIdleThread = true;
+}
+
+// virtual, called from own thread
+void LLLFSThread::threadedUpdate()
+{
+    flushBatch(true);
+}
+
+// virtual, called from own thread
+void LLLFSThread::endThread()
+{
+    flushBatch(true);
+}
+
+void LLLFSThread::flushBatch(bool wait_all)
+{
+    LL_PROFILE_ZONE_SCOPED;
+    U32 failures = 0;
+    while (getInFlight() > 0 && (wait_all || mFreeSlots.empty()))
+    {
+        if (!mRing.submit(1))
+        {
+            if (++failures < 3)
+            {
+                continue;
+            }
+            // The ring is unusable; fail whatever is still in flight and
+            // fall back to blocking I/O from now on.
+            LL_WARNS() << "io_uring submission failed, reverting to blocking file I/O" << LL_ENDL;
+            for (U32 slot = 0; slot < mInFlight.size(); ++slot)
+            {
+                if (Request* req = mInFlight[slot])
+                {
+                    mInFlight[slot] = nullptr;
+                    req->completeBatched(-EIO);
+                    endRequest(req, true);
+                }
+            }
+            mFreeSlots.clear();
+            mRing.release();
+            break;
+        }
+        failures = 0;
+
+        mCompletions.clear();
+        mRing.reap(mCompletions);
+        for (const LLLFSURing::Completion& completion : mCompletions)
+        {
+            U32 slot = (U32)completion.mUserData;
+            Request* req = mInFlight[slot];
+            llassert(req);
+            mInFlight[slot] = nullptr;
+            mFreeSlots.push_back(slot);
+            req->completeBatched(completion.mResult);
+            endRequest(req, true);
+        }
+    }
+    sample(sLFSInFlight, (F64)getInFlight());
+}
+// </AS:Chanayane>
+
 //----------------------------------------------------------------------------
 
 LLLFSThread::handle_t LLLFSThread::read(const std::string& filename,    /* Flawfinder: ignore */
@@ -138,7 +297,11 @@ LLLFSThread::Request::Request(LLLFSThread* thread,
     mOffset(offset),
     mBytes(numbytes),
     mBytesRead(0),
-    mResponder(responder)
+    mResponder(responder),
+    // <AS:Chanayane> Batched I/O backend
+    mQueuedTime(LLTimer::getTotalTime()),
+    mFD(-1)
+    // </AS:Chanayane>
 {
     if (numbytes <= 0)
     {
@@ -154,6 +317,12 @@ LLLFSThread::Request::~Request()
 void LLLFSThread::Request::finishRequest(bool completed)
 {
     LL_PROFILE_ZONE_SCOPED;
+    // <AS:Chanayane> Batched I/O backend
+    if (completed)
+    {
+        record(sLFSCompletionTime, F64Microseconds((F64)(LLTimer::getTotalTime() - mQueuedTime)));
+    }
+    // </AS:Chanayane>
     if (mResponder.notNull())
     {
         mResponder->completed(completed ? mBytesRead : 0);
@@ -235,6 +404,87 @@ bool LLLFSThread::Request::processRequest()
     return complete;
 }
 
+// <AS:Chanayane> Batched I/O backend
+bool LLLFSThread::Request::queueBatched(LLLFSURing& ring, U64 user_data)
+{
+#if LL_LINUX
+    if (mBytes <= 0 || (mOperation == FILE_READ && mOffset < 0))
+    {
+        // Nothing to transfer; let the blocking path deal with it
+        return false;
+    }
+
+    int flags = O_CLOEXEC;
+    if (mOperation == FILE_READ)
+    {
+        flags |= O_RDONLY;
+    }
+    else
+    {
+        flags |= O_WRONLY | O_CREAT;
+        if (mOffset < 0)
+        {
+            flags |= O_APPEND;
+        }
+    }
+    mFD = ::open(mFileName.c_str(), flags, 0666);
+    if (mFD < 0)
+    {
+        // The blocking path reports the failure
+        return false;
+    }
+
+    // An offset of -1 uses (and advances) the file position, which with
+    // O_APPEND is the end of the file.
+    U64 offset = mOffset < 0 ? (U64)-1 : (U64)mOffset;
+    bool queued = mOperation == FILE_READ ?
+        ring.queueRead(mFD, mBuffer, (U32)mBytes, offset, user_data) :
+        ring.queueWrite(mFD, mBuffer, (U32)mBytes, offset, user_data);
+    if (!queued)
+    {
+        ::close(mFD);
+        mFD = -1;
+    }
+    return queued;
+#else
+    return false;
+#endif
+}
+
+void LLLFSThread::Request::completeBatched(S32 result)
+{
+#if LL_LINUX
+    if (result < 0)
+    {
+        LL_WARNS() << "LLLFS: Unable to " << (mOperation == FILE_READ ? "read" : "write")
+                   << " file: " << mFileName << " (error " << -result << ")" << LL_ENDL;
+        mBytesRead = 0; // fail
+    }
+    else
+    {
+        mBytesRead = result;
+        // Regular files only write short on errors such as a full disk;
+        // retry the remainder once, the same way a blocking write would.
+        if (mOperation == FILE_WRITE && mBytesRead < mBytes && mFD >= 0)
+        {
+            ssize_t written = mOffset < 0 ?
+                ::write(mFD, mBuffer + mBytesRead, mBytes - mBytesRead) :
+                ::pwrite(mFD, mBuffer + mBytesRead, mBytes - mBytesRead, (off_t)mOffset + mBytesRead);
+            if (written > 0)
+            {
+                mBytesRead += (S32)written;
+            }
+        }
+    }
+    if (mFD >= 0)
+    {
+        ::close(mFD);
+        mFD = -1;
+    }
+#endif
+}
+// </AS:Chanayane>
+
 //============================================================================
 
 LLLFSThread::Responder::~Responder()
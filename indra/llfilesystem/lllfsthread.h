@@ -34,6 +34,7 @@
 
 #include "llpointer.h"
 #include "llqueuedthread.h"
+#include "lllfsuring.h" // <AS:Chanayane/> Batched I/O backend
 
 //============================================================================
 // Threaded Local File System
@@ -98,6 +99,21 @@ public:
         /*virtual*/ void finishRequest(bool completed);
         /*virtual*/ void deleteRequest();
 
+        // <AS:Chanayane> Batched I/O backend
+        /**
+         * Open the file and queue the read or write on ring instead of
+         * performing it inline. Returns false if the request has to go
+         * through the blocking processRequest() path instead.
+         */
+        bool queueBatched(LLLFSURing& ring, U64 user_data);
+
+        /**
+         * Finish a batched request with the result of its completion
+         * (bytes transferred or -errno) and close the file.
+         */
+        void completeBatched(S32 result);
+        // </AS:Chanayane>
+
     private:
         LLLFSThread* mThread;
         operation_t mOperation;
@@ -110,11 +126,16 @@ public:
         S32 mBytesRead; // bytes read from file
 
         LLPointer<Responder> mResponder;
+
+        // <AS:Chanayane> Batched I/O backend
+        U64 mQueuedTime;    // LLTimer::getTotalTime() when the request was made
+        int mFD;            // open file while the request is on the ring
+        // </AS:Chanayane>
     };
 
     //------------------------------------------------------------------------
 public:
-    LLLFSThread(bool threaded = true);
+    LLLFSThread(bool threaded = true, bool use_io_uring = false); // <AS:Chanayane/> Batched I/O backend
     ~LLLFSThread();
 
     // Return a Request handle
@@ -126,10 +147,42 @@ public:
                    Responder* responder);
 
     // static initializers
-    static void initClass(bool local_is_threaded = true); // Setup sLocal
+    // <AS:Chanayane> Batched I/O backend
+    //static void initClass(bool local_is_threaded = true); // Setup sLocal
+    static void initClass(bool local_is_threaded = true, bool use_io_uring = false); // Setup sLocal
+    // </AS:Chanayane>
     static S32 updateClass(U32 ms_elapsed);
     static void cleanupClass();     // Delete sLocal
 
+    // <AS:Chanayane> Batched I/O backend
+    bool isBatched() const { return mRing.isValid(); }
+
+protected:
+    /**
+     * With the io_uring backend, reads and writes are queued on the ring
+     * and submitted as one batch once the request queue has drained or
+     * the ring is full, instead of being performed one at a time.
+     */
+    void processRequest(QueuedRequest* req) override;
+
+private:
+    void threadedUpdate() override;
+    void endThread() override;
+
+    /**
+     * Submit queued operations and complete finished requests. Waits until
+     * nothing is left in flight if wait_all is set, otherwise until at
+     * least one ring slot is free again.
+     */
+    void flushBatch(bool wait_all);
+    U32 getInFlight() const { return mRing.getCapacity() - (U32)mFreeSlots.size(); }
+
+    LLLFSURing mRing;
+    std::vector<Request*> mInFlight;    // indexed by ring user data
+    std::vector<U32> mFreeSlots;
+    std::vector<LLLFSURing::Completion> mCompletions;
+    // </AS:Chanayane>
+
 public:
     static LLLFSThread* sLocal;     // Default local file thread
 };
@@ -0,0 +1,290 @@
+/**
+ * @file lllfsuring.cpp
+ * @brief Minimal io_uring submission/completion ring used by LLLFSThread on Linux.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+#include "linden_common.h"
+
+#include "lllfsuring.h"
+
+#if LL_LINUX
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// io_uring needs both the kernel headers and IORING_OP_READ/WRITE (5.6+),
+// which is checked at runtime through IORING_FEAT_RW_CUR_POS.
+#if LL_LINUX && defined(__NR_io_uring_setup) && defined(IORING_FEAT_RW_CUR_POS)
+#define LL_LFS_URING 1
+#else
+#define LL_LFS_URING 0
+#endif
+
+#if LL_LFS_URING
+namespace
+{
+    int io_uring_setup(U32 entries, io_uring_params* params)
+    {
+        return (int)syscall(__NR_io_uring_setup, entries, params);
+    }
+
+    int io_uring_enter(int fd, U32 to_submit, U32 min_complete, U32 flags)
+    {
+        return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+    }
+
+    // The rings are shared with the kernel: our side of each index is
+    // published with release semantics and the kernel's side is read with
+    // acquire semantics.
+    U32 load_acquire(const U32* p)
+    {
+        return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+    }
+
+    void store_release(U32* p, U32 v)
+    {
+        __atomic_store_n(p, v, __ATOMIC_RELEASE);
+    }
+}
+#endif
+
+LLLFSURing::~LLLFSURing()
+{
+    release();
+}
+
+void LLLFSURing::release()
+{
+#if LL_LFS_URING
+    if (mSQEs)
+    {
+        munmap(mSQEs, mSQEsSize);
+    }
+    if (mCQRing && mCQRing != mSQRing)
+    {
+        munmap(mCQRing, mCQRingSize);
+    }
+    if (mSQRing)
+    {
+        munmap(mSQRing, mSQRingSize);
+    }
+    if (mRingFD >= 0)
+    {
+        close(mRingFD);
+    }
+#endif
+    mSQEs = mCQRing = mSQRing = nullptr;
+    mRingFD = -1;
+    mSQEntries = 0;
+    mToSubmit = 0;
+}
+
+bool LLLFSURing::init(U32 entries)
+{
+    release();
+
+#if LL_LFS_URING
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = io_uring_setup(entries, &params);
+    if (fd < 0)
+    {
+        LL_INFOS() << "io_uring not available (" << strerror(errno) << ")" << LL_ENDL;
+        return false;
+    }
+    mRingFD = fd;
+
+    if (!(params.features & IORING_FEAT_RW_CUR_POS))
+    {
+        LL_INFOS() << "io_uring too old for IORING_OP_READ/WRITE" << LL_ENDL;
+        release();
+        return false;
+    }
+
+    mSQRingSize = params.sq_off.array + params.sq_entries * sizeof(U32);
+    mCQRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap)
+    {
+        mSQRingSize = mCQRingSize = llmax(mSQRingSize, mCQRingSize);
+    }
+
+    void* sq_ring = mmap(nullptr, mSQRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED)
+    {
+        release();
+        return false;
+    }
+    mSQRing = sq_ring;
+
+    if (single_mmap)
+    {
+        mCQRing = mSQRing;
+    }
+    else
+    {
+        void* cq_ring = mmap(nullptr, mCQRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cq_ring == MAP_FAILED)
+        {
+            release();
+            return false;
+        }
+        mCQRing = cq_ring;
+    }
+
+    mSQEsSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, mSQEsSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+    {
+        release();
+        return false;
+    }
+    mSQEs = sqes;
+
+    U8* sq = (U8*)mSQRing;
+    mSQHead = (U32*)(sq + params.sq_off.head);
+    mSQTail = (U32*)(sq + params.sq_off.tail);
+    mSQMask = (U32*)(sq + params.sq_off.ring_mask);
+    mSQArray = (U32*)(sq + params.sq_off.array);
+
+    U8* cq = (U8*)mCQRing;
+    mCQHead = (U32*)(cq + params.cq_off.head);
+    mCQTail = (U32*)(cq + params.cq_off.tail);
+    mCQMask = (U32*)(cq + params.cq_off.ring_mask);
+    mCQEs = cq + params.cq_off.cqes;
+
+    mSQEntries = params.sq_entries;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool LLLFSURing::queue(U8 opcode, int fd, const U8* buffer, U32 bytes, U64 offset, U64 user_data)
+{
+#if LL_LFS_URING
+    if (!isValid())
+    {
+        return false;
+    }
+
+    const U32 tail = *mSQTail;
+    if (tail - load_acquire(mSQHead) >= mSQEntries)
+    {
+        return false;
+    }
+
+    const U32 index = tail & *mSQMask;
+    io_uring_sqe* sqe = (io_uring_sqe*)mSQEs + index;
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->addr = (U64)(uintptr_t)buffer;
+    sqe->len = bytes;
+    sqe->off = offset;
+    sqe->user_data = user_data;
+    mSQArray[index] = index;
+
+    store_release(mSQTail, tail + 1);
+    ++mToSubmit;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool LLLFSURing::queueRead(int fd, U8* buffer, U32 bytes, U64 offset, U64 user_data)
+{
+#if LL_LFS_URING
+    return queue(IORING_OP_READ, fd, buffer, bytes, offset, user_data);
+#else
+    return false;
+#endif
+}
+
+bool LLLFSURing::queueWrite(int fd, const U8* buffer, U32 bytes, U64 offset, U64 user_data)
+{
+#if LL_LFS_URING
+    return queue(IORING_OP_WRITE, fd, buffer, bytes, offset, user_data);
+#else
+    return false;
+#endif
+}
+
+bool LLLFSURing::submit(U32 wait_nr)
+{
+#if LL_LFS_URING
+    if (!isValid())
+    {
+        return false;
+    }
+
+    while (mToSubmit > 0 || wait_nr > 0)
+    {
+        int ret = io_uring_enter(mRingFD, mToSubmit, wait_nr, wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            LL_WARNS() << "io_uring_enter failed: " << strerror(errno) << LL_ENDL;
+            return false;
+        }
+        mToSubmit -= llmin((U32)ret, mToSubmit);
+        break;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+U32 LLLFSURing::reap(std::vector<Completion>& completions)
+{
+    U32 count = 0;
+#if LL_LFS_URING
+    if (!isValid())
+    {
+        return 0;
+    }
+
+    U32 head = *mCQHead;
+    const U32 tail = load_acquire(mCQTail);
+    const U32 mask = *mCQMask;
+    while (head != tail)
+    {
+        const io_uring_cqe* cqe = (const io_uring_cqe*)mCQEs + (head & mask);
+        completions.push_back({ (U64)cqe->user_data, (S32)cqe->res });
+        ++head;
+        ++count;
+    }
+    store_release(mCQHead, head);
+#endif
+    return count;
+}
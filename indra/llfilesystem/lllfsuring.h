@@ -0,0 +1,115 @@
+/**
+ * @file lllfsuring.h
+ * @brief Minimal io_uring submission/completion ring used by LLLFSThread on Linux.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+#ifndef LL_LLLFSURING_H
+#define LL_LLLFSURING_H
+
+#include <vector>
+
+/**
+ * Thin wrapper around a Linux io_uring instance, talking to the kernel
+ * through the raw system calls so no extra library is needed.
+ *
+ * Only what LLLFSThread needs is exposed: queueing reads and writes on
+ * already opened file descriptors, submitting them as one batch and
+ * collecting the completions. The ring is single producer / single
+ * consumer and must only be used from one thread.
+ *
+ * On other platforms, or when the running kernel does not support
+ * io_uring (too old, or blocked by a sandbox), init() returns false and
+ * the caller keeps using blocking I/O.
+ */
+class LLLFSURing
+{
+    LOG_CLASS(LLLFSURing);
+public:
+    struct Completion
+    {
+        U64 mUserData;
+        S32 mResult;    // bytes transferred, or -errno
+    };
+
+    LLLFSURing() = default;
+    ~LLLFSURing();
+
+    LLLFSURing(const LLLFSURing&) = delete;
+    LLLFSURing& operator=(const LLLFSURing&) = delete;
+
+    bool init(U32 entries);
+    bool isValid() const { return mRingFD >= 0; }
+
+    // Number of operations that can be queued before submitting
+    U32 getCapacity() const { return mSQEntries; }
+
+    /**
+     * Queue an operation; it is not started until submit(). Returns false
+     * if the submission queue is full.
+     */
+    bool queueRead(int fd, U8* buffer, U32 bytes, U64 offset, U64 user_data);
+    bool queueWrite(int fd, const U8* buffer, U32 bytes, U64 offset, U64 user_data);
+
+    /**
+     * Submit everything queued so far and block until at least wait_nr
+     * operations have completed. Returns false on a ring error.
+     */
+    bool submit(U32 wait_nr);
+
+    /**
+     * Append all available completions to completions. Returns how many
+     * were added.
+     */
+    U32 reap(std::vector<Completion>& completions);
+
+    // Tear the ring down; isValid() is false afterwards
+    void release();
+
+private:
+    bool queue(U8 opcode, int fd, const U8* buffer, U32 bytes, U64 offset, U64 user_data);
+
+    int         mRingFD{ -1 };
+    U32         mSQEntries{ 0 };
+    U32         mToSubmit{ 0 };
+
+    void*       mSQRing{ nullptr };
+    size_t      mSQRingSize{ 0 };
+    void*       mCQRing{ nullptr };
+    size_t      mCQRingSize{ 0 };
+    void*       mSQEs{ nullptr };
+    size_t      mSQEsSize{ 0 };
+
+    U32*        mSQHead{ nullptr };
+    U32*        mSQTail{ nullptr };
+    U32*        mSQMask{ nullptr };
+    U32*        mSQArray{ nullptr };
+    U32*        mCQHead{ nullptr };
+    U32*        mCQTail{ nullptr };
+    U32*        mCQMask{ nullptr };
+    void*       mCQEs{ nullptr };
+};
+
+#endif // LL_LLLFSURING_H
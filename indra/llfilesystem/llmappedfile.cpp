@@ -0,0 +1,217 @@
+/**
+ * @file llmappedfile.cpp
+ * @brief Shared read-only memory mappings of cache files.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+#include "linden_common.h"
+
+#include "llmappedfile.h"
+
+#if LL_WINDOWS
+#include "llwin32headers.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+LLMappedFile::registry_t LLMappedFile::sRegistry;
+LLMutex LLMappedFile::sRegistryMutex;
+std::atomic<U32> LLMappedFile::sTempCounter{ 0 };
+
+LLMappedFile::~LLMappedFile()
+{
+#if LL_WINDOWS
+    if (mData)
+    {
+        UnmapViewOfFile(mData);
+    }
+    if (mMapping)
+    {
+        CloseHandle((HANDLE)mMapping);
+    }
+#else
+    if (mData)
+    {
+        munmap((void*)mData, mSize);
+    }
+#endif
+}
+
+// static
+bool LLMappedFile::getStamp(const std::string& filename, FileStamp& stamp)
+{
+    llstat file_stat;
+    if (LLFile::stat(filename, &file_stat) != 0 || !S_ISREG(file_stat.st_mode))
+    {
+        return false;
+    }
+    stamp.mInode = (U64)file_stat.st_ino;
+    stamp.mSize = (U64)file_stat.st_size;
+    stamp.mModified = (S64)file_stat.st_mtime;
+    return true;
+}
+
+bool LLMappedFile::map(const std::string& filename)
+{
+#if LL_WINDOWS
+    // Allow the cache to delete or rename the file while it is mapped; the
+    // view keeps the old contents alive until it is unmapped.
+    HANDLE file = CreateFileW(ll_convert<std::wstring>(filename).c_str(), GENERIC_READ,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping)
+    {
+        return false;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, (SIZE_T)mSize);
+    if (!data)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+    mMapping = mapping;
+    mData = (const U8*)data;
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    void* data = mmap(nullptr, mSize, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+    mData = (const U8*)data;
+#endif
+    return true;
+}
+
+// static
+LLMappedFile::ptr_t LLMappedFile::open(const std::string& filename)
+{
+    LL_PROFILE_ZONE_SCOPED;
+
+    FileStamp stamp;
+    if (!getStamp(filename, stamp) || stamp.mSize == 0 || stamp.mSize > (U64)SIZE_MAX)
+    {
+        return ptr_t();
+    }
+
+    LLMutexLock lock(&sRegistryMutex);
+
+    registry_t::iterator found = sRegistry.find(filename);
+    if (found != sRegistry.end())
+    {
+        ptr_t existing = found->second.lock();
+        if (existing && existing->mStamp == stamp)
+        {
+            return existing;
+        }
+    }
+
+    std::shared_ptr<LLMappedFile> mapped(new LLMappedFile());
+    mapped->mSize = (size_t)stamp.mSize;
+    mapped->mStamp = stamp;
+    if (!mapped->map(filename))
+    {
+        LL_DEBUGS() << "Unable to map " << filename << LL_ENDL;
+        return ptr_t();
+    }
+
+    // Drop registry entries whose mappings have all been released while we
+    // hold the lock anyway; this keeps the registry the size of the live set.
+    for (registry_t::iterator it = sRegistry.begin(); it != sRegistry.end(); )
+    {
+        if (it->second.expired())
+        {
+            it = sRegistry.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    sRegistry[filename] = mapped;
+    return mapped;
+}
+
+// static
+bool LLMappedFile::isMapped(const std::string& filename)
+{
+    LLMutexLock lock(&sRegistryMutex);
+
+    registry_t::const_iterator found = sRegistry.find(filename);
+    return found != sRegistry.end() && !found->second.expired();
+}
+
+// static
+std::string LLMappedFile::getTempFilename(const std::string& filename)
+{
+    // Several threads may write the same cache file at once
+    return llformat("%s.%u.tmp", filename.c_str(), ++sTempCounter);
+}
+
+// static
+bool LLMappedFile::replaceFile(const std::string& src, const std::string& dst)
+{
+    if (LLFile::rename(src, dst, ENOENT) == 0)
+    {
+        return true;
+    }
+#if LL_WINDOWS
+    if (!LLFile::isfile(dst))
+    {
+        return false;
+    }
+    const std::string aside = llformat("%s.%u.old", dst.c_str(), ++sTempCounter);
+    if (LLFile::rename(dst, aside) != 0)
+    {
+        LL_WARNS() << "Unable to move " << dst << " aside to replace it" << LL_ENDL;
+        return false;
+    }
+    if (LLFile::rename(src, dst) != 0)
+    {
+        // Put the previous contents back rather than lose the entry
+        LLFile::rename(aside, dst);
+        return false;
+    }
+    // Deletion is deferred by the system until the last view is unmapped
+    LLFile::remove(aside, ENOENT);
+    return true;
+#else
+    return false;
+#endif
+}
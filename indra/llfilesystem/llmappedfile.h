@@ -0,0 +1,124 @@
+/**
+ * @file llmappedfile.h
+ * @brief Shared read-only memory mappings of cache files.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+#ifndef LL_LLMAPPEDFILE_H
+#define LL_LLMAPPEDFILE_H
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "llmutex.h"
+
+/**
+ * Read-only memory mapping of a whole file.
+ *
+ * Mappings are shared: opening the same file again while a previous mapping
+ * is still referenced hands out that mapping, so several readers of the same
+ * cache file (mesh header, then each LOD) share the same pages instead of
+ * each copying their slice into a heap buffer.
+ *
+ * A mapping stays valid for as long as a reference to it is held, even if
+ * the file is replaced or deleted in the meantime. LLFileSystem never
+ * truncates a file in place while it is mapped (see LLFileSystem::write()),
+ * so readers cannot fault on a mapping that became shorter than the file.
+ */
+class LLMappedFile
+{
+    LOG_CLASS(LLMappedFile);
+public:
+    typedef std::shared_ptr<const LLMappedFile> ptr_t;
+
+    ~LLMappedFile();
+
+    /**
+     * Map filename, or return the existing mapping of it if one is alive and
+     * the file has not changed since. Returns an empty pointer if the file
+     * does not exist, is empty or cannot be mapped.
+     */
+    static ptr_t open(const std::string& filename);
+
+    /**
+     * True if a live mapping of filename exists. Used by writers to decide
+     * whether the file can be rewritten in place.
+     */
+    static bool isMapped(const std::string& filename);
+
+    /**
+     * Unique name next to filename to write its new contents to before
+     * replaceFile() moves them into place.
+     */
+    static std::string getTempFilename(const std::string& filename);
+
+    /**
+     * Move src over dst, which may be mapped. POSIX rename() does this
+     * atomically; Windows refuses to replace a file that has a mapped view,
+     * so there dst is first moved aside (allowed by the FILE_SHARE_DELETE
+     * the mapping was opened with) and deleted once src took its place.
+     */
+    static bool replaceFile(const std::string& src, const std::string& dst);
+
+    const U8* getData() const { return mData; }
+    size_t getSize() const { return mSize; }
+
+private:
+    LLMappedFile() = default;
+    LLMappedFile(const LLMappedFile&) = delete;
+    LLMappedFile& operator=(const LLMappedFile&) = delete;
+
+    bool map(const std::string& filename);
+
+    // Identity of the file at the time it was mapped
+    struct FileStamp
+    {
+        U64         mInode{ 0 };
+        U64         mSize{ 0 };
+        S64         mModified{ 0 };
+
+        bool operator==(const FileStamp& other) const
+        {
+            return mInode == other.mInode && mSize == other.mSize && mModified == other.mModified;
+        }
+    };
+    static bool getStamp(const std::string& filename, FileStamp& stamp);
+
+    const U8*       mData{ nullptr };
+    size_t          mSize{ 0 };
+    FileStamp       mStamp;
+#if LL_WINDOWS
+    void*           mMapping{ nullptr };
+#endif
+
+    typedef std::map<std::string, std::weak_ptr<const LLMappedFile>> registry_t;
+    static registry_t   sRegistry;
+    static LLMutex      sRegistryMutex;
+    static std::atomic<U32> sTempCounter;
+};
+
+#endif // LL_LLMAPPEDFILE_H
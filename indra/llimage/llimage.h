@@ -32,6 +32,8 @@
 #include "llpointer.h"
 #include "lltrace.h"
 
+#include <functional> // <AS:Chanayane/> Streaming encoders
+
 constexpr S32 MIN_IMAGE_MIP =  2; // 4x4, only used for expand/contract power of 2
 constexpr S32 MAX_IMAGE_MIP = 12; // 4096x4096
 
@@ -379,6 +381,21 @@ public:
 
     virtual bool encode(const LLImageRaw* raw_image, F32 encode_time) = 0;
 
+    // <AS:Chanayane> Streaming encoders
+    // Receives the encoded bytes in order as the encoder produces them, for
+    // instance to write them to a file or an LLFileSystem. Returns false to
+    // abort the encode.
+    typedef std::function<bool(const U8* data, size_t size)> encode_sink_t;
+
+    // Encode raw_image into sink without building the whole file in memory.
+    // Formats without a streaming encoder encode in memory and hand the
+    // result over in one piece.
+    virtual bool encodeStream(const LLImageRaw* raw_image, const encode_sink_t& sink);
+
+    // encodeStream() into a new file. A partly written file is removed.
+    bool encodeToFile(const LLImageRaw* raw_image, const std::string& filename);
+    // </AS:Chanayane>
+
     S8 getCodec() const;
     bool isDecoding() const { return mDecoding; }
     bool isDecoded()  const { return mDecoded; }
@@ -31,6 +31,7 @@
 #include "llmath.h"
 #include "llmemory.h"
 #include "llsd.h"
+#include <atomic> // <AS:Chanayane/> Threaded J2C decode
 
 // Declare the prototype for this factory function here. It is implemented in
 // other files which define a LLImageJ2CImpl subclass, but only ONE static
@@ -42,6 +43,49 @@ LLImageJ2CImpl* fallbackCreateLLImageJ2CImpl();
 LLImageCompressionTester* LLImageJ2C::sTesterp = NULL ;
 const std::string sTesterName("ImageCompressionTester");
 
+// <AS:Chanayane> Threaded J2C decode
+static std::atomic<S32> sDecodeCores{ 0 };
+static std::atomic<S32> sDecodesRunning{ 0 };
+static std::atomic<S32> sDecodeHelpers{ 0 };
+
+//static
+void LLImageJ2C::setDecodeCores(S32 cores)
+{
+    sDecodeCores = llmax(cores, 0);
+}
+
+//static
+S32 LLImageJ2C::acquireDecodeHelpers(S32 wanted)
+{
+    if (wanted <= 0)
+    {
+        return 0;
+    }
+
+    S32 helpers = sDecodeHelpers.load();
+    S32 granted;
+    do
+    {
+        S32 idle = sDecodeCores.load() - sDecodesRunning.load() - helpers;
+        granted = llclamp(idle, 0, wanted);
+        if (!granted)
+        {
+            return 0;
+        }
+    } while (!sDecodeHelpers.compare_exchange_weak(helpers, helpers + granted));
+    return granted;
+}
+
+//static
+void LLImageJ2C::releaseDecodeHelpers(S32 helpers)
+{
+    if (helpers > 0)
+    {
+        sDecodeHelpers -= helpers;
+    }
+}
+// </AS:Chanayane>
+
 //static
 std::string LLImageJ2C::getEngineInfo()
 {
@@ -175,7 +219,9 @@ bool LLImageJ2C::decodeChannels(LLImageRaw *raw_imagep, F32 decode_time, S32 fir
         {
             // Update the raw discard level
             updateRawDiscardLevel();
+            ++sDecodesRunning; // <AS:Chanayane/> Threaded J2C decode
             res = mImpl->decodeImpl(*this, *raw_imagep, decode_time, first_channel, max_channel_count);
+            --sDecodesRunning; // <AS:Chanayane/> Threaded J2C decode
         }
     }
 
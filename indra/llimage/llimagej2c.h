@@ -78,6 +78,16 @@ public:
 
     static std::string getEngineInfo();
 
+    // <AS:Chanayane> Threaded J2C decode
+    // Number of cores image decoding may keep busy. Every running decode
+    // counts as one, decoders of large images may borrow what is left as
+    // helper threads. 0 (the default) disables helper threads.
+    static void setDecodeCores(S32 cores);
+    // Borrow up to wanted helper threads, returns how many were granted.
+    static S32 acquireDecodeHelpers(S32 wanted);
+    static void releaseDecodeHelpers(S32 helpers);
+    // </AS:Chanayane>
+
 protected:
     friend class LLImageJ2CImpl;
     friend class LLImageJ2COJ;
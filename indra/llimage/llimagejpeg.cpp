@@ -34,10 +34,17 @@
 #if !LL_ARM64
 jmp_buf LLImageJPEG::sSetjmpBuffer ;
 #endif
+
+// <AS:Chanayane> Streaming encoders
+// Compressed bytes collected before they go to the sink
+static constexpr S32 ENCODE_OUTPUT_BUFFER_SIZE = 64 * 1024;
+// </AS:Chanayane>
+
 LLImageJPEG::LLImageJPEG(S32 quality)
 :   LLImageFormatted(IMG_CODEC_JPEG),
     mOutputBuffer( NULL ),
     mOutputBufferSize( 0 ),
+    mEncodeSink( NULL ), // <AS:Chanayane/> Streaming encoders
     mEncodeQuality( quality ) // on a scale from 1 to 100
 {
 }
@@ -388,24 +395,35 @@ boolean LLImageJPEG::encodeEmptyOutputBuffer( j_compress_ptr cinfo )
 {
   LLImageJPEG* self = (LLImageJPEG*) cinfo->client_data;
 
-  // Should very rarely happen, since our output buffer is
-  // as large as the input to start out with.
-
-  // Double the buffer size;
-  S32 new_buffer_size = self->mOutputBufferSize * 2;
-  U8* new_buffer = new(std::nothrow) U8[ new_buffer_size ];
-  if (!new_buffer)
+  // <AS:Chanayane> Streaming encoders
+  // The output buffer is a small fixed window now, hand it to the sink
+  // every time it fills up instead of growing it
+  //// Should very rarely happen, since our output buffer is
+  //// as large as the input to start out with.
+  //
+  //// Double the buffer size;
+  //S32 new_buffer_size = self->mOutputBufferSize * 2;
+  //U8* new_buffer = new(std::nothrow) U8[ new_buffer_size ];
+  //if (!new_buffer)
+  //{
+  //  self->setLastError("Out of memory in LLImageJPEG::encodeEmptyOutputBuffer( j_compress_ptr cinfo )");
+  //  LLTHROW(LLContinueError("Out of memory in LLImageJPEG::encodeEmptyOutputBuffer( j_compress_ptr cinfo )"));
+  //}
+  //memcpy( new_buffer, self->mOutputBuffer, self->mOutputBufferSize );   /* Flawfinder: ignore */
+  //delete[] self->mOutputBuffer;
+  //self->mOutputBuffer = new_buffer;
+  //
+  //cinfo->dest->next_output_byte = self->mOutputBuffer + self->mOutputBufferSize;
+  //cinfo->dest->free_in_buffer = self->mOutputBufferSize;
+  //self->mOutputBufferSize = new_buffer_size;
+  if (!(*self->mEncodeSink)(self->mOutputBuffer, self->mOutputBufferSize))
   {
-    self->setLastError("Out of memory in LLImageJPEG::encodeEmptyOutputBuffer( j_compress_ptr cinfo )");
-    LLTHROW(LLContinueError("Out of memory in LLImageJPEG::encodeEmptyOutputBuffer( j_compress_ptr cinfo )"));
+    ERREXIT(cinfo, JERR_FILE_WRITE);
   }
-  memcpy( new_buffer, self->mOutputBuffer, self->mOutputBufferSize );   /* Flawfinder: ignore */
-  delete[] self->mOutputBuffer;
-  self->mOutputBuffer = new_buffer;
 
-  cinfo->dest->next_output_byte = self->mOutputBuffer + self->mOutputBufferSize;
+  cinfo->dest->next_output_byte = self->mOutputBuffer;
   cinfo->dest->free_in_buffer = self->mOutputBufferSize;
-  self->mOutputBufferSize = new_buffer_size;
+  // </AS:Chanayane>
 
   return true;
 }
@@ -420,13 +438,20 @@ void LLImageJPEG::encodeTermDestination( j_compress_ptr cinfo )
 {
     LLImageJPEG* self = (LLImageJPEG*) cinfo->client_data;
 
-    LLImageDataLock lock(self);
-
+    // <AS:Chanayane> Streaming encoders
+    //LLImageDataLock lock(self);
+    //
+    //S32 file_bytes = (S32)(self->mOutputBufferSize - cinfo->dest->free_in_buffer);
+    //if(self->allocateData(file_bytes))
+    //    memcpy( self->getData(), self->mOutputBuffer, file_bytes ); /* Flawfinder: ignore */
+    //else
+    //    LL_WARNS() << "allocateData() failed." << LL_ENDL;
     S32 file_bytes = (S32)(self->mOutputBufferSize - cinfo->dest->free_in_buffer);
-    if(self->allocateData(file_bytes))
-        memcpy( self->getData(), self->mOutputBuffer, file_bytes ); /* Flawfinder: ignore */
-    else
-        LL_WARNS() << "allocateData() failed." << LL_ENDL;
+    if (file_bytes > 0 && !(*self->mEncodeSink)(self->mOutputBuffer, file_bytes))
+    {
+        ERREXIT(cinfo, JERR_FILE_WRITE);
+    }
+    // </AS:Chanayane>
 }
 
 // static
@@ -494,7 +519,30 @@ void LLImageJPEG::errorOutputMessage( j_common_ptr cinfo )
     LL_WARNS() << "LLImageJPEG " << (is_decode ? "decode " : "encode ") << " failed: " << buffer << LL_ENDL;
 }
 
+// <AS:Chanayane> Streaming encoders
 bool LLImageJPEG::encode( const LLImageRaw* raw_image, F32 encode_time )
+{
+    std::vector<U8> encoded;
+    if (!encodeStream(raw_image, [&encoded](const U8* data, size_t size)
+                      {
+                          encoded.insert(encoded.end(), data, data + size);
+                          return true;
+                      }))
+    {
+        return false;
+    }
+
+    LLImageDataLock lockOut(this);
+    if (allocateData((S32)encoded.size()))
+        memcpy(getData(), encoded.data(), encoded.size());
+    else
+        LL_WARNS() << "allocateData() failed." << LL_ENDL;
+    return true;
+}
+
+//bool LLImageJPEG::encode( const LLImageRaw* raw_image, F32 encode_time )
+bool LLImageJPEG::encodeStream( const LLImageRaw* raw_image, const encode_sink_t& sink )
+// </AS:Chanayane>
 {
     llassert_always(raw_image);
 
@@ -521,10 +569,16 @@ bool LLImageJPEG::encode( const LLImageRaw* raw_image, F32 encode_time )
 
     setSize(raw_image->getWidth(), raw_image->getHeight(), raw_image->getComponents());
 
-    // Allocate a temporary buffer big enough to hold the entire compressed image (and then some)
-    // (Note: we make it bigger in emptyOutputBuffer() if we need to)
+    // <AS:Chanayane> Streaming encoders
+    //// Allocate a temporary buffer big enough to hold the entire compressed image (and then some)
+    //// (Note: we make it bigger in emptyOutputBuffer() if we need to)
+    //delete[] mOutputBuffer;
+    //mOutputBufferSize = getWidth() * getHeight() * getComponents() + 1024;
+    // Output goes to sink each time this buffer fills up
     delete[] mOutputBuffer;
-    mOutputBufferSize = getWidth() * getHeight() * getComponents() + 1024;
+    mOutputBufferSize = ENCODE_OUTPUT_BUFFER_SIZE;
+    mEncodeSink = &sink;
+    // </AS:Chanayane>
     mOutputBuffer = new(std::nothrow) U8[ mOutputBufferSize ];
     if (mOutputBuffer == NULL)
     {
@@ -53,6 +53,7 @@ public:
     /*virtual*/ bool updateData();
     /*virtual*/ bool decode(LLImageRaw* raw_image, F32 decode_time);
     /*virtual*/ bool encode(const LLImageRaw* raw_image, F32 encode_time);
+    /*virtual*/ bool encodeStream(const LLImageRaw* raw_image, const encode_sink_t& sink); // <AS:Chanayane/> Streaming encoders
 
     void            setEncodeQuality( S32 q )   { mEncodeQuality = q; } // on a scale from 1 to 100
     S32             getEncodeQuality()          { return mEncodeQuality; }
@@ -75,6 +76,7 @@ public:
 protected:
     U8*             mOutputBuffer;      // temp buffer used during encoding
     S32             mOutputBufferSize;  // bytes in mOuputBuffer
+    const encode_sink_t* mEncodeSink;   // <AS:Chanayane/> Streaming encoders: receives mOutputBuffer when full
 
     S32             mEncodeQuality;     // on a scale from 1 to 100
 private:
@@ -140,39 +140,84 @@ bool LLImagePNG::encode(const LLImageRaw* raw_image, F32 encode_time)
 
     resetLastError();
 
-    LLImageDataSharedLock lockIn(raw_image);
+    // <AS:Chanayane> Streaming encoders
+    // The encoded image grows as the encoder writes it, rather than going
+    // through a temporary buffer the size of the raw image
+    //LLImageDataSharedLock lockIn(raw_image);
+    //LLImageDataLock lockOut(this);
+    //
+    //// Image logical size
+    //setSize(raw_image->getWidth(), raw_image->getHeight(), raw_image->getComponents());
+    //
+    //// Temporary buffer to hold the encoded image. Note: the final image
+    //// size should be much smaller due to compression.
+    //U32 bufferSize = getWidth() * getHeight() * getComponents() + 8192;
+    //U8* tmpWriteBuffer = new(std::nothrow) U8[ bufferSize ];
+    //if (!tmpWriteBuffer)
+    //{
+    //    setLastError("LLImagePNG::out of memory");
+    //    return false;
+    //}
+    //
+    //// Delegate actual encoding work to wrapper
+    //LLPngWrapper pngWrapper;
+    //if (!pngWrapper.writePng(raw_image, tmpWriteBuffer, bufferSize))
+    //{
+    //    setLastError(pngWrapper.getErrorMessage());
+    //    delete[] tmpWriteBuffer;
+    //    return false;
+    //}
+    //
+    //// Resize internal buffer and copy from temp
+    //U32 encodedSize = pngWrapper.getFinalSize();
+    //if(allocateData(encodedSize))
+    //    memcpy(getData(), tmpWriteBuffer, encodedSize);
+    //else
+    //    LL_WARNS() << "allocateData() failed." << LL_ENDL;
+    //
+    //delete[] tmpWriteBuffer;
+    std::vector<U8> encoded;
+    if (!encodeStream(raw_image, [&encoded](const U8* data, size_t size)
+                      {
+                          encoded.insert(encoded.end(), data, data + size);
+                          return true;
+                      }))
+    {
+        return false;
+    }
+
     LLImageDataLock lockOut(this);
+    if (allocateData((S32)encoded.size()))
+        memcpy(getData(), encoded.data(), encoded.size());
+    else
+        LL_WARNS() << "allocateData() failed." << LL_ENDL;
+    // </AS:Chanayane>
+
+    return (getData()!=NULL);
+}
+
+// <AS:Chanayane> Streaming encoders
+bool LLImagePNG::encodeStream(const LLImageRaw* raw_image, const encode_sink_t& sink)
+{
+    llassert_always(raw_image);
+
+    resetLastError();
 
-    // Image logical size
-    setSize(raw_image->getWidth(), raw_image->getHeight(), raw_image->getComponents());
+    LLImageDataSharedLock lockIn(raw_image);
 
-    // Temporary buffer to hold the encoded image. Note: the final image
-    // size should be much smaller due to compression.
-    U32 bufferSize = getWidth() * getHeight() * getComponents() + 8192;
-    U8* tmpWriteBuffer = new(std::nothrow) U8[ bufferSize ];
-    if (!tmpWriteBuffer)
     {
-        setLastError("LLImagePNG::out of memory");
-        return false;
+        LLImageDataLock lockOut(this);
+        // Image logical size
+        setSize(raw_image->getWidth(), raw_image->getHeight(), raw_image->getComponents());
     }
 
     // Delegate actual encoding work to wrapper
     LLPngWrapper pngWrapper;
-    if (!pngWrapper.writePng(raw_image, tmpWriteBuffer, bufferSize))
+    if (!pngWrapper.writePng(raw_image, sink))
     {
         setLastError(pngWrapper.getErrorMessage());
-        delete[] tmpWriteBuffer;
         return false;
     }
-
-    // Resize internal buffer and copy from temp
-    U32 encodedSize = pngWrapper.getFinalSize();
-    if(allocateData(encodedSize))
-        memcpy(getData(), tmpWriteBuffer, encodedSize);
-    else
-        LL_WARNS() << "allocateData() failed." << LL_ENDL;
-
-    delete[] tmpWriteBuffer;
-
-    return (getData()!=NULL);
+    return true;
 }
+// </AS:Chanayane>
@@ -41,6 +41,7 @@ public:
     /*virtual*/ bool updateData();
     /*virtual*/ bool decode(LLImageRaw* raw_image, F32 decode_time);
     /*virtual*/ bool encode(const LLImageRaw* raw_image, F32 encode_time);
+    /*virtual*/ bool encodeStream(const LLImageRaw* raw_image, const encode_sink_t& sink); // <AS:Chanayane/> Streaming encoders
 };
 
 #endif
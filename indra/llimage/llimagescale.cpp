@@ -0,0 +1,1117 @@
+/**
+ * @file llimagescale.cpp
+ * @brief SIMD and multithreaded pixel scaling and mip generation kernels
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+
+#include "linden_common.h"
+
+#include "llimagescale.h"
+
+#include "workqueue.h"
+
+#include <boost/preprocessor.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__arm64__) || defined(__aarch64__)
+#include "sse2neon.h"
+#else
+#include <emmintrin.h>
+#if defined(__SSE4_1__) || defined(__AVX__)
+#include <smmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define LL_IMAGE_SCALE_AVX2 1
+#endif
+#endif
+
+bool LLImageScale::sUseSIMD = true;
+bool LLImageScale::sUseThreads = true;
+
+// Work, in source plus destination pixels, below which an image is not
+// worth splitting across threads, and the work given to each task
+static constexpr U64 MIN_THREADED_WORK = 2 * 1024 * 1024;
+static constexpr U64 TASK_WORK = 512 * 1024;
+
+//static
+const char* LLImageScale::getSIMDName()
+{
+#if defined(__arm64__) || defined(__aarch64__)
+    return "NEON";
+#elif LL_IMAGE_SCALE_AVX2
+    return "AVX2";
+#elif defined(__SSE4_1__) || defined(__AVX__)
+    return "SSE4.1";
+#else
+    return "SSE2";
+#endif
+}
+
+// Run func(row_begin, row_end) over [0, rows) in slices of rows_per_task,
+// on the "General" thread pool and the calling thread, and return once all
+// rows are done.
+static void split_rows(U32 rows, U32 rows_per_task, const std::function<void(U32, U32)>& func)
+{
+    rows_per_task = llmax(rows_per_task, 1U);
+    const U32 count = (rows + rows_per_task - 1) / rows_per_task;
+    LL::WorkQueue::ptr_t queue;
+    if (count > 1 && LLImageScale::getUseThreads())
+    {
+        queue = LL::WorkQueue::getInstance("General");
+    }
+    if (!queue)
+    {
+        func(0, rows);
+        return;
+    }
+
+    struct Shared
+    {
+        std::atomic<U32>        mNext{ 0 };
+        U32                     mDone{ 0 };
+        std::mutex              mMutex;
+        std::condition_variable mCond;
+    };
+    auto shared = std::make_shared<Shared>();
+
+    // Helpers that start after the last slice was taken find nothing to do
+    // and never touch func
+    auto work = [shared, count, rows, rows_per_task, func]()
+    {
+        U32 index;
+        while ((index = shared->mNext.fetch_add(1)) < count)
+        {
+            const U32 begin = index * rows_per_task;
+            func(begin, llmin(begin + rows_per_task, rows));
+            std::lock_guard<std::mutex> lock(shared->mMutex);
+            if (++shared->mDone == count)
+            {
+                shared->mCond.notify_all();
+            }
+        }
+    };
+
+    U32 helpers = llmin(count - 1, llmax(1U, std::thread::hardware_concurrency()));
+    for (U32 i = 0; i < helpers; ++i)
+    {
+        if (!queue->post(work))
+        {
+            break;
+        }
+    }
+
+    work();
+
+    std::unique_lock<std::mutex> lock(shared->mMutex);
+    shared->mCond.wait(lock, [&]() { return shared->mDone == count; });
+}
+
+//..................................................................................
+//..................................................................................
+// Helper macrose's for generate cycle unwrap templates
+//..................................................................................
+#define _UNROL_GEN_TPL_arg_0(arg)
+#define _UNROL_GEN_TPL_arg_1(arg) arg
+
+#define _UNROL_GEN_TPL_comma_0
+#define _UNROL_GEN_TPL_comma_1 BOOST_PP_COMMA()
+//..................................................................................
+#define _UNROL_GEN_TPL_ARGS_macro(z,n,seq) \
+    BOOST_PP_CAT(_UNROL_GEN_TPL_arg_, BOOST_PP_MOD(n, 2))(BOOST_PP_SEQ_ELEM(n, seq)) BOOST_PP_CAT(_UNROL_GEN_TPL_comma_, BOOST_PP_AND(BOOST_PP_MOD(n, 2), BOOST_PP_NOT_EQUAL(BOOST_PP_INC(n), BOOST_PP_SEQ_SIZE(seq))))
+
+#define _UNROL_GEN_TPL_ARGS(seq) \
+    BOOST_PP_REPEAT(BOOST_PP_SEQ_SIZE(seq), _UNROL_GEN_TPL_ARGS_macro, seq)
+//..................................................................................
+
+#define _UNROL_GEN_TPL_TYPE_ARGS_macro(z,n,seq) \
+    BOOST_PP_SEQ_ELEM(n, seq) BOOST_PP_CAT(_UNROL_GEN_TPL_comma_, BOOST_PP_AND(BOOST_PP_MOD(n, 2), BOOST_PP_NOT_EQUAL(BOOST_PP_INC(n), BOOST_PP_SEQ_SIZE(seq))))
+
+#define _UNROL_GEN_TPL_TYPE_ARGS(seq) \
+    BOOST_PP_REPEAT(BOOST_PP_SEQ_SIZE(seq), _UNROL_GEN_TPL_TYPE_ARGS_macro, seq)
+//..................................................................................
+#define _UNROLL_GEN_TPL_foreach_ee(z, n, seq) \
+    executor<n>(_UNROL_GEN_TPL_ARGS(seq));
+
+#define _UNROLL_GEN_TPL(name, args_seq, operation, spec) \
+    template<> struct name<spec> { \
+    private: \
+        template<S32 _idx> inline void executor(_UNROL_GEN_TPL_TYPE_ARGS(args_seq)) { \
+            BOOST_PP_SEQ_ENUM(operation) ; \
+        } \
+    public: \
+        inline void operator()(_UNROL_GEN_TPL_TYPE_ARGS(args_seq)) { \
+            BOOST_PP_REPEAT(spec, _UNROLL_GEN_TPL_foreach_ee, args_seq) \
+        } \
+};
+//..................................................................................
+#define _UNROLL_GEN_TPL_foreach_seq_macro(r, data, elem) \
+    _UNROLL_GEN_TPL(BOOST_PP_SEQ_ELEM(0, data), BOOST_PP_SEQ_ELEM(1, data), BOOST_PP_SEQ_ELEM(2, data), elem)
+
+#define UNROLL_GEN_TPL(name, args_seq, operation, spec_seq) \
+    /*general specialization - should not be implemented!*/ \
+    template<U8> struct name { inline void operator()(_UNROL_GEN_TPL_TYPE_ARGS(args_seq)) { /*static_assert(!"Should not be instantiated.");*/  } }; \
+    BOOST_PP_SEQ_FOR_EACH(_UNROLL_GEN_TPL_foreach_seq_macro, (name)(args_seq)(operation), spec_seq)
+//..................................................................................
+//..................................................................................
+
+
+//..................................................................................
+// Generated unrolling loop templates with specializations
+//..................................................................................
+//example: for(c = 0; c < ch; ++c) comp[c] = cx[0] = 0;
+UNROLL_GEN_TPL(uroll_zeroze_cx_comp, (S32 *)(cx)(S32 *)(comp), (cx[_idx] = comp[_idx] = 0), (1)(2)(3)(4));
+//example: for(c = 0; c < ch; ++c) comp[c] >>= 4;
+UNROLL_GEN_TPL(uroll_comp_rshftasgn_constval, (S32 *)(comp)(const S32)(cval), (comp[_idx] >>= cval), (1)(2)(3)(4));
+//example: for(c = 0; c < ch; ++c) comp[c] = (cx[c] >> 5) * yap;
+UNROLL_GEN_TPL(uroll_comp_asgn_cx_rshft_cval_all_mul_val, (S32 *)(comp)(S32 *)(cx)(const S32)(cval)(S32)(val), (comp[_idx] = (cx[_idx] >> cval) * val), (1)(2)(3)(4));
+//example: for(c = 0; c < ch; ++c) comp[c] += (cx[c] >> 5) * Cy;
+UNROLL_GEN_TPL(uroll_comp_plusasgn_cx_rshft_cval_all_mul_val, (S32 *)(comp)(S32 *)(cx)(const S32)(cval)(S32)(val), (comp[_idx] += (cx[_idx] >> cval) * val), (1)(2)(3)(4));
+//example: for(c = 0; c < ch; ++c) comp[c] += pix[c] * info.xapoints[x];
+UNROLL_GEN_TPL(uroll_inp_plusasgn_pix_mul_val, (S32 *)(comp)(const U8 *)(pix)(S32)(val), (comp[_idx] += pix[_idx] * val), (1)(2)(3)(4));
+//example: for(c = 0; c < ch; ++c) cx[c] = pix[c] * info.xapoints[x];
+UNROLL_GEN_TPL(uroll_inp_asgn_pix_mul_val, (S32 *)(comp)(const U8 *)(pix)(S32)(val), (comp[_idx] = pix[_idx] * val), (1)(2)(3)(4));
+//example: for(c = 0; c < ch; ++c) comp[c] = ((cx[c] * info.yapoints[y]) + (comp[c] * (256 - info.yapoints[y]))) >> 16;
+UNROLL_GEN_TPL(uroll_comp_asgn_cx_mul_apoint_plus_comp_mul_inv_apoint_allshifted_16_r, (S32 *)(comp)(S32 *)(cx)(S32)(apoint), (comp[_idx] = ((cx[_idx] * apoint) + (comp[_idx] * (256 - apoint))) >> 16), (1)(2)(3)(4));
+//example: for(c = 0; c < ch; ++c) comp[c] = (comp[c] + pix[c] * info.yapoints[y]) >> 8;
+UNROLL_GEN_TPL(uroll_comp_asgn_comp_plus_pix_mul_apoint_allshifted_8_r, (S32 *)(comp)(const U8 *)(pix)(S32)(apoint), (comp[_idx] = (comp[_idx] + pix[_idx] * apoint) >> 8), (1)(2)(3)(4));
+//example: for(c = 0; c < ch; ++c) comp[c] = ((comp[c]*(256 - info.xapoints[x])) + ((cx[c] * info.xapoints[x]))) >> 12;
+UNROLL_GEN_TPL(uroll_comp_asgn_comp_mul_inv_apoint_plus_cx_mul_apoint_allshifted_12_r, (S32 *)(comp)(S32)(apoint)(S32 *)(cx), (comp[_idx] = ((comp[_idx] * (256-apoint)) + (cx[_idx] * apoint)) >> 12), (1)(2)(3)(4));
+//example: for(c = 0; c < ch; ++c) *dptr++ = comp[c]&0xff;
+UNROLL_GEN_TPL(uroll_uref_dptr_inc_asgn_comp_and_ff, (U8 *&)(dptr)(S32 *)(comp), (*dptr++ = comp[_idx]&0xff), (1)(2)(3)(4));
+//example: for(c = 0; c < ch; ++c) *dptr++ = (sptr[info.xpoints[x]*ch + c])&0xff;
+UNROLL_GEN_TPL(uroll_uref_dptr_inc_asgn_sptr_apoint_plus_idx_alland_ff, (U8 *&)(dptr)(const U8 *)(sptr)(S32)(apoint), (*dptr++ = sptr[apoint + _idx]&0xff), (1)(2)(3)(4));
+//example: for(c = 0; c < ch; ++c) *dptr++ = (comp[c]>>10)&0xff;
+UNROLL_GEN_TPL(uroll_uref_dptr_inc_asgn_comp_rshft_cval_and_ff, (U8 *&)(dptr)(S32 *)(comp)(const S32)(cval), (*dptr++ = (comp[_idx]>>cval)&0xff), (1)(2)(3)(4));
+//..................................................................................
+
+
+template<U8 ch>
+struct scale_info
+{
+public:
+    std::vector<S32> xpoints;
+    std::vector<const U8*> ystrides;
+    std::vector<S32> xapoints, yapoints;
+    S32 xup_yup;
+
+public:
+    //unrolling loop types declaration
+    typedef uroll_zeroze_cx_comp<ch>                                                        uroll_zeroze_cx_comp_t;
+    typedef uroll_comp_rshftasgn_constval<ch>                                               uroll_comp_rshftasgn_constval_t;
+    typedef uroll_comp_asgn_cx_rshft_cval_all_mul_val<ch>                                   uroll_comp_asgn_cx_rshft_cval_all_mul_val_t;
+    typedef uroll_comp_plusasgn_cx_rshft_cval_all_mul_val<ch>                               uroll_comp_plusasgn_cx_rshft_cval_all_mul_val_t;
+    typedef uroll_inp_plusasgn_pix_mul_val<ch>                                              uroll_inp_plusasgn_pix_mul_val_t;
+    typedef uroll_inp_asgn_pix_mul_val<ch>                                                  uroll_inp_asgn_pix_mul_val_t;
+    typedef uroll_comp_asgn_cx_mul_apoint_plus_comp_mul_inv_apoint_allshifted_16_r<ch>      uroll_comp_asgn_cx_mul_apoint_plus_comp_mul_inv_apoint_allshifted_16_r_t;
+    typedef uroll_comp_asgn_comp_plus_pix_mul_apoint_allshifted_8_r<ch>                     uroll_comp_asgn_comp_plus_pix_mul_apoint_allshifted_8_r_t;
+    typedef uroll_comp_asgn_comp_mul_inv_apoint_plus_cx_mul_apoint_allshifted_12_r<ch>      uroll_comp_asgn_comp_mul_inv_apoint_plus_cx_mul_apoint_allshifted_12_r_t;
+    typedef uroll_uref_dptr_inc_asgn_comp_and_ff<ch>                                        uroll_uref_dptr_inc_asgn_comp_and_ff_t;
+    typedef uroll_uref_dptr_inc_asgn_sptr_apoint_plus_idx_alland_ff<ch>                     uroll_uref_dptr_inc_asgn_sptr_apoint_plus_idx_alland_ff_t;
+    typedef uroll_uref_dptr_inc_asgn_comp_rshft_cval_and_ff<ch>                             uroll_uref_dptr_inc_asgn_comp_rshft_cval_and_ff_t;
+
+public:
+    scale_info(const U8 *src, U32 srcW, U32 srcH, U32 dstW, U32 dstH, U32 srcStride)
+        : xup_yup((dstW >= srcW) + ((dstH >= srcH) << 1))
+    {
+        calc_x_points(srcW, dstW);
+        calc_y_strides(src, srcStride, srcH, dstH);
+        calc_aa_points(srcW, dstW, xup_yup&1, xapoints);
+        calc_aa_points(srcH, dstH, xup_yup&2, yapoints);
+    }
+
+private:
+    //...........................................................................................
+    void calc_x_points(U32 srcW, U32 dstW)
+    {
+        xpoints.resize(dstW+1);
+
+        S32 val = dstW >= srcW ? 0x8000 * srcW / dstW - 0x8000 : 0;
+        S32 inc = (srcW << 16) / dstW;
+
+        for(U32 i = 0, j = 0; i < dstW; ++i, ++j, val += inc)
+        {
+            xpoints[j] = llmax(0, val >> 16);
+        }
+    }
+    //...........................................................................................
+    void calc_y_strides(const U8 *src, U32 srcStride, U32 srcH, U32 dstH)
+    {
+        ystrides.resize(dstH+1);
+
+        S32 val = dstH >= srcH ? 0x8000 * srcH / dstH - 0x8000 : 0;
+        S32 inc = (srcH << 16) / dstH;
+
+        for(U32 i = 0, j = 0; i < dstH; ++i, ++j, val += inc)
+        {
+            ystrides[j] = src + llmax(0, val >> 16) * srcStride;
+        }
+    }
+    //...........................................................................................
+    void calc_aa_points(U32 srcSz, U32 dstSz, bool scale_up, std::vector<S32> &vp)
+    {
+        vp.resize(dstSz);
+
+        if(scale_up)
+        {
+            S32 val = 0x8000 * srcSz / dstSz - 0x8000;
+            S32 inc = (srcSz << 16) / dstSz;
+            U32 pos;
+
+            for(U32 i = 0, j = 0; i < dstSz; ++i, ++j, val += inc)
+            {
+                pos = val >> 16;
+
+                if (pos >= (srcSz - 1))
+                    vp[j] = 0;
+                else
+                    vp[j] = (val >> 8) - ((val >> 8) & 0xffffff00);
+            }
+        }
+        else
+        {
+            S32 inc = (srcSz << 16) / dstSz;
+            S32 Cp = ((dstSz << 14) / srcSz) + 1;
+            S32 ap;
+
+            for(U32 i = 0, j = 0, val = 0; i < dstSz; ++i, ++j, val += inc)
+            {
+                ap = ((0x100 - ((val >> 8) & 0xff)) * Cp) >> 8;
+                vp[j] = ap | (Cp << 16);
+            }
+        }
+    }
+};
+
+
+// Rows [y_begin, y_end) of the scaled image
+template<U8 ch>
+inline void bilinear_scale(
+    const scale_info<ch>& info, U32 srcStride
+    , U8 *dst, U32 dstW, U32 dstStride, U32 y_begin, U32 y_end
+    )
+{
+    typedef scale_info<ch> scale_info_t;
+
+    const U8 *sptr;
+    U8 *dptr;
+    U32 x, y;
+    const U8 *pix;
+
+    S32 cx[ch], comp[ch];
+
+
+    if(3 == info.xup_yup)
+    { //scale x/y - up
+        for(y = y_begin; y < y_end; ++y)
+        {
+            dptr = dst + (y * dstStride);
+            sptr = info.ystrides[y];
+
+            if(0 < info.yapoints[y])
+            {
+                for(x = 0; x < dstW; ++x)
+                {
+                    //for(c = 0; c < ch; ++c) cx[c] = comp[c] = 0;
+                    typename scale_info_t::uroll_zeroze_cx_comp_t()(cx, comp);
+
+                    if(0 < info.xapoints[x])
+                    {
+                        pix = info.ystrides[y] + info.xpoints[x] * ch;
+
+                        //for(c = 0; c < ch; ++c) comp[c] = pix[c] * (256 - info.xapoints[x]);
+                        typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(comp, pix, 256 - info.xapoints[x]);
+
+                        pix += ch;
+
+                        //for(c = 0; c < ch; ++c) comp[c] += pix[c] * info.xapoints[x];
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(comp, pix, info.xapoints[x]);
+
+                        pix += srcStride;
+
+                        //for(c = 0; c < ch; ++c) cx[c] = pix[c] * info.xapoints[x];
+                        typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(cx, pix, info.xapoints[x]);
+
+                        pix -= ch;
+
+                        //for(c = 0; c < ch; ++c) {
+                        //  cx[c] += pix[c] * (256 - info.xapoints[x]);
+                        //  comp[c] = ((cx[c] * info.yapoints[y]) + (comp[c] * (256 - info.yapoints[y]))) >> 16;
+                        //  *dptr++ = comp[c]&0xff;
+                        //}
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, 256 - info.xapoints[x]);
+                        typename scale_info_t::uroll_comp_asgn_cx_mul_apoint_plus_comp_mul_inv_apoint_allshifted_16_r_t()(comp, cx, info.yapoints[y]);
+                        typename scale_info_t::uroll_uref_dptr_inc_asgn_comp_and_ff_t()(dptr, comp);
+                    }
+                    else
+                    {
+                        pix = info.ystrides[y] + info.xpoints[x] * ch;
+
+                        //for(c = 0; c < ch; ++c) comp[c] = pix[c] * (256 - info.yapoints[y]);
+                        typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(comp, pix, 256-info.yapoints[y]);
+
+                        pix += srcStride;
+
+                        //for(c = 0; c < ch; ++c) {
+                        //  comp[c] = (comp[c] + pix[c] * info.yapoints[y]) >> 8;
+                        //  *dptr++ = comp[c]&0xff;
+                        //}
+                        typename scale_info_t::uroll_comp_asgn_comp_plus_pix_mul_apoint_allshifted_8_r_t()(comp, pix, info.yapoints[y]);
+                        typename scale_info_t::uroll_uref_dptr_inc_asgn_comp_and_ff_t()(dptr, comp);
+                    }
+                }
+            }
+            else
+            {
+                for(x = 0; x < dstW; ++x)
+                {
+                    if(0 < info.xapoints[x])
+                    {
+                        pix = info.ystrides[y] + info.xpoints[x] * ch;
+
+                        //for(c = 0; c < ch; ++c) {
+                        //  comp[c] = pix[c] * (256 - info.xapoints[x]);
+                        //  comp[c] = (comp[c] + pix[c] * info.xapoints[x]) >> 8;
+                        //  *dptr++ = comp[c]&0xff;
+                        //}
+                        typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(comp, pix, 256 - info.xapoints[x]);
+                        typename scale_info_t::uroll_comp_asgn_comp_plus_pix_mul_apoint_allshifted_8_r_t()(comp, pix, info.xapoints[x]);
+                        typename scale_info_t::uroll_uref_dptr_inc_asgn_comp_and_ff_t()(dptr, comp);
+                    }
+                    else
+                    {
+                        //for(c = 0; c < ch; ++c) *dptr++ = (sptr[info.xpoints[x]*ch + c])&0xff;
+                        typename scale_info_t::uroll_uref_dptr_inc_asgn_sptr_apoint_plus_idx_alland_ff_t()(dptr, sptr, info.xpoints[x]*ch);
+                    }
+                }
+            }
+        }
+    }
+    else if(info.xup_yup == 1)
+    { //scaling down vertically
+        S32 Cy, j;
+        S32 yap;
+
+        for(y = y_begin; y < y_end; y++)
+        {
+            Cy = info.yapoints[y] >> 16;
+            yap = info.yapoints[y] & 0xffff;
+
+            dptr = dst + (y * dstStride);
+
+            for(x = 0; x < dstW; x++)
+            {
+                pix = info.ystrides[y] + info.xpoints[x] * ch;
+
+                //for(c = 0; c < ch; ++c) comp[c] = pix[c] * yap;
+                typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(comp, pix, yap);
+
+                pix += srcStride;
+
+                for(j = (1 << 14) - yap; j > Cy; j -= Cy, pix += srcStride)
+                {
+                    //for(c = 0; c < ch; ++c) comp[c] += pix[c] * Cy;
+                    typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(comp, pix, Cy);
+                }
+
+                if(j > 0)
+                {
+                    //for(c = 0; c < ch; ++c) comp[c] += pix[c] * j;
+                    typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(comp, pix, j);
+                }
+
+                if(info.xapoints[x] > 0)
+                {
+                    pix = info.ystrides[y] + info.xpoints[x]*ch + ch;
+                    //for(c = 0; c < ch; ++c) cx[c] = pix[c] * yap;
+                    typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(cx, pix, yap);
+
+                    pix += srcStride;
+                    for(j = (1 << 14) - yap; j > Cy; j -= Cy)
+                    {
+                        //for(c = 0; c < ch; ++c) cx[c] += pix[c] * Cy;
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, Cy);
+                        pix += srcStride;
+                    }
+
+                    if(j > 0)
+                    {
+                        //for(c = 0; c < ch; ++c) cx[c] += pix[c] * j;
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, j);
+                    }
+
+                    //for(c = 0; c < ch; ++c) comp[c] = ((comp[c]*(256 - info.xapoints[x])) + ((cx[c] * info.xapoints[x]))) >> 12;
+                    typename scale_info_t::uroll_comp_asgn_comp_mul_inv_apoint_plus_cx_mul_apoint_allshifted_12_r_t()(comp, info.xapoints[x], cx);
+                }
+                else
+                {
+                    //for(c = 0; c < ch; ++c) comp[c] >>= 4;
+                    typename scale_info_t::uroll_comp_rshftasgn_constval_t()(comp, 4);
+                }
+
+                //for(c = 0; c < ch; ++c) *dptr++ = (comp[c]>>10)&0xff;
+                typename scale_info_t::uroll_uref_dptr_inc_asgn_comp_rshft_cval_and_ff_t()(dptr, comp, 10);
+            }
+        }
+    }
+    else if(info.xup_yup == 2)
+    { // scaling down horizontally
+        S32 Cx, j;
+        S32 xap;
+
+        for(y = y_begin; y < y_end; y++)
+        {
+            dptr = dst + (y * dstStride);
+
+            for(x = 0; x < dstW; x++)
+            {
+                Cx = info.xapoints[x] >> 16;
+                xap = info.xapoints[x] & 0xffff;
+
+                pix = info.ystrides[y] + info.xpoints[x] * ch;
+
+                //for(c = 0; c < ch; ++c) comp[c] = pix[c] * xap;
+                typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(comp, pix, xap);
+
+                pix+=ch;
+                for(j = (1 << 14) - xap; j > Cx; j -= Cx)
+                {
+                    //for(c = 0; c < ch; ++c) comp[c] += pix[c] * Cx;
+                    typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(comp, pix, Cx);
+                    pix+=ch;
+                }
+
+                if(j > 0)
+                {
+                    //for(c = 0; c < ch; ++c) comp[c] += pix[c] * j;
+                    typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(comp, pix, j);
+                }
+
+                if(info.yapoints[y] > 0)
+                {
+                    pix = info.ystrides[y] + info.xpoints[x]*ch + srcStride;
+                    //for(c = 0; c < ch; ++c) cx[c] = pix[c] * xap;
+                    typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(cx, pix, xap);
+
+                    pix+=ch;
+                    for(j = (1 << 14) - xap; j > Cx; j -= Cx)
+                    {
+                        //for(c = 0; c < ch; ++c) cx[c] += pix[c] * Cx;
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, Cx);
+                        pix+=ch;
+                    }
+
+                    if(j > 0)
+                    {
+                        //for(c = 0; c < ch; ++c) cx[c] += pix[c] * j;
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, j);
+                    }
+
+                    //for(c = 0; c < ch; ++c) comp[c] = ((comp[c] * (256 - info.yapoints[y])) + ((cx[c] * info.yapoints[y]))) >> 12;
+                    typename scale_info_t::uroll_comp_asgn_comp_mul_inv_apoint_plus_cx_mul_apoint_allshifted_12_r_t()(comp, info.yapoints[y], cx);
+                }
+                else
+                {
+                    //for(c = 0; c < ch; ++c) comp[c] >>= 4;
+                    typename scale_info_t::uroll_comp_rshftasgn_constval_t()(comp, 4);
+                }
+
+                //for(c = 0; c < ch; ++c) *dptr++ = (comp[c]>>10)&0xff;
+                typename scale_info_t::uroll_uref_dptr_inc_asgn_comp_rshft_cval_and_ff_t()(dptr, comp, 10);
+            }
+        }
+    }
+    else
+    { //scale x/y - down
+        S32 Cx, Cy, i, j;
+        S32 xap, yap;
+
+        for(y = y_begin; y < y_end; y++)
+        {
+            Cy = info.yapoints[y] >> 16;
+            yap = info.yapoints[y] & 0xffff;
+
+            dptr = dst + (y * dstStride);
+            for(x = 0; x < dstW; x++)
+            {
+                Cx = info.xapoints[x] >> 16;
+                xap = info.xapoints[x] & 0xffff;
+
+                sptr = info.ystrides[y] + info.xpoints[x] * ch;
+                pix = sptr;
+                sptr += srcStride;
+
+                //for(c = 0; c < ch; ++c) cx[c] = pix[c] * xap;
+                typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(cx, pix, xap);
+
+                pix+=ch;
+                for(i = (1 << 14) - xap; i > Cx; i -= Cx)
+                {
+                    //for(c = 0; c < ch; ++c) cx[c] += pix[c] * Cx;
+                    typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, Cx);
+                    pix+=ch;
+                }
+
+                if(i > 0)
+                {
+                    //for(c = 0; c < ch; ++c) cx[c] += pix[c] * i;
+                    typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, i);
+                }
+
+                //for(c = 0; c < ch; ++c) comp[c] = (cx[c] >> 5) * yap;
+                typename scale_info_t::uroll_comp_asgn_cx_rshft_cval_all_mul_val_t()(comp, cx, 5, yap);
+
+                for(j = (1 << 14) - yap; j > Cy; j -= Cy)
+                {
+                    pix = sptr;
+                    sptr += srcStride;
+
+                    //for(c = 0; c < ch; ++c) cx[c] = pix[c] * xap;
+                    typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(cx, pix, xap);
+
+                    pix+=ch;
+                    for(i = (1 << 14) - xap; i > Cx; i -= Cx)
+                    {
+                        //for(c = 0; c < ch; ++c) cx[c] += pix[c] * Cx;
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, Cx);
+                        pix+=ch;
+                    }
+
+                    if(i > 0)
+                    {
+                        //for(c = 0; c < ch; ++c) cx[c] += pix[c] * i;
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, i);
+                    }
+
+                    //for(c = 0; c < ch; ++c) comp[c] += (cx[c] >> 5) * Cy;
+                    typename scale_info_t::uroll_comp_plusasgn_cx_rshft_cval_all_mul_val_t()(comp, cx, 5, Cy);
+                }
+
+                if(j > 0)
+                {
+                    pix = sptr;
+                    sptr += srcStride;
+
+                    //for(c = 0; c < ch; ++c) cx[c] = pix[c] * xap;
+                    typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(cx, pix, xap);
+
+                    pix+=ch;
+                    for(i = (1 << 14) - xap; i > Cx; i -= Cx)
+                    {
+                        //for(c = 0; c < ch; ++c) cx[c] += pix[c] * Cx;
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, Cx);
+                        pix+=ch;
+                    }
+
+                    if(i > 0)
+                    {
+                        //for(c = 0; c < ch; ++c) cx[c] += pix[c] * i;
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, i);
+                    }
+
+                    //for(c = 0; c < ch; ++c) comp[c] += (cx[c] >> 5) * j;
+                    typename scale_info_t::uroll_comp_plusasgn_cx_rshft_cval_all_mul_val_t()(comp, cx, 5, j);
+                }
+
+                //for(c = 0; c < ch; ++c) *dptr++ = (comp[c]>>23)&0xff;
+                typename scale_info_t::uroll_uref_dptr_inc_asgn_comp_rshft_cval_and_ff_t()(dptr, comp, 23);
+            }
+        }
+    } //else
+}
+
+//..................................................................................
+// SIMD version of the "scale x/y - down" case of bilinear_scale(), which is
+// the one used for snapshots and upload preparation. The scalar code
+// computes, for each destination pixel, a horizontal sum for every source
+// row under it and then weights those sums vertically. The horizontal sums
+// of a source row do not depend on the destination row, so here they are
+// computed for a whole row at once (channels in SIMD lanes) and the
+// vertical weighting runs over contiguous arrays. The arithmetic is the
+// same, so is the result.
+//..................................................................................
+
+// 32 bit product of non negative lanes
+static inline __m128i mul_epi32_lo(__m128i a, __m128i b)
+{
+#if defined(__SSE4_1__) || defined(__AVX__) || defined(__arm64__) || defined(__aarch64__)
+    return _mm_mullo_epi32(a, b);
+#else
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+}
+
+// One pixel, one channel per 32 bit lane. A 3 channel pixel is read as 4
+// bytes, the extra one masked off, unless that would read past row_end.
+template<U8 ch>
+static inline __m128i load_pixel(const U8* pix, const U8* row_end)
+{
+    U32 value;
+    if (ch == 4)
+    {
+        memcpy(&value, pix, 4);
+    }
+    else if (pix + 4 <= row_end)
+    {
+        memcpy(&value, pix, 4);
+        value &= 0xffffff;
+    }
+    else
+    {
+        value = pix[0] | ((U32)pix[1] << 8) | ((U32)pix[2] << 16);
+    }
+    const __m128i zero = _mm_setzero_si128();
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128((int)value), zero), zero);
+}
+
+// Pixel times a weight below 2^15: the high 16 bits of each lane are zero
+// in both operands, so madd gives the full 32 bit product
+static inline __m128i weigh_pixel(__m128i pixel, S32 weight)
+{
+    return _mm_madd_epi16(pixel, _mm_set1_epi32(weight));
+}
+
+// Horizontal sums ("cx" in bilinear_scale()) of one source row for every
+// destination column, 3 or 4 channels. out needs dstW * ch + 1 entries, the
+// stores of 3 channel pixels spill one lane into the next pixel.
+template<U8 ch>
+static void scale_down_row(const scale_info<ch>& info, const U8* row, const U8* row_end, U32 dstW, S32* out)
+{
+    for (U32 x = 0; x < dstW; ++x, out += ch)
+    {
+        const S32 Cx = info.xapoints[x] >> 16;
+        const S32 xap = info.xapoints[x] & 0xffff;
+        const U8* pix = row + info.xpoints[x] * ch;
+        S32 i;
+
+        __m128i cx = weigh_pixel(load_pixel<ch>(pix, row_end), xap);
+        pix += ch;
+        const __m128i weight = _mm_set1_epi32(Cx);
+        for (i = (1 << 14) - xap; i > Cx; i -= Cx, pix += ch)
+        {
+            cx = _mm_add_epi32(cx, _mm_madd_epi16(load_pixel<ch>(pix, row_end), weight));
+        }
+        if (i > 0)
+        {
+            cx = _mm_add_epi32(cx, weigh_pixel(load_pixel<ch>(pix, row_end), i));
+        }
+        _mm_storeu_si128((__m128i*)out, cx);
+    }
+}
+
+// comp = (cx >> 5) * weight, or comp += (cx >> 5) * weight
+template<bool accumulate>
+static void weigh_row(S32* comp, const S32* cx, U32 count, S32 weight)
+{
+    U32 k = 0;
+#if LL_IMAGE_SCALE_AVX2
+    const __m256i weight8 = _mm256_set1_epi32(weight);
+    for (; k + 8 <= count; k += 8)
+    {
+        __m256i value = _mm256_mullo_epi32(_mm256_srai_epi32(_mm256_loadu_si256((const __m256i*)(cx + k)), 5), weight8);
+        if (accumulate)
+        {
+            value = _mm256_add_epi32(value, _mm256_loadu_si256((const __m256i*)(comp + k)));
+        }
+        _mm256_storeu_si256((__m256i*)(comp + k), value);
+    }
+#endif
+    const __m128i weight4 = _mm_set1_epi32(weight);
+    for (; k + 4 <= count; k += 4)
+    {
+        __m128i value = mul_epi32_lo(_mm_srai_epi32(_mm_loadu_si128((const __m128i*)(cx + k)), 5), weight4);
+        if (accumulate)
+        {
+            value = _mm_add_epi32(value, _mm_loadu_si128((const __m128i*)(comp + k)));
+        }
+        _mm_storeu_si128((__m128i*)(comp + k), value);
+    }
+    for (; k < count; ++k)
+    {
+        comp[k] = accumulate ? comp[k] + (cx[k] >> 5) * weight : (cx[k] >> 5) * weight;
+    }
+}
+
+// dst = (comp >> 23) & 0xff
+static void store_row(U8* dst, const S32* comp, U32 count)
+{
+    U32 k = 0;
+    const __m128i mask = _mm_set1_epi32(0xff);
+    for (; k + 16 <= count; k += 16)
+    {
+        __m128i a = _mm_and_si128(_mm_srai_epi32(_mm_loadu_si128((const __m128i*)(comp + k)), 23), mask);
+        __m128i b = _mm_and_si128(_mm_srai_epi32(_mm_loadu_si128((const __m128i*)(comp + k + 4)), 23), mask);
+        __m128i c = _mm_and_si128(_mm_srai_epi32(_mm_loadu_si128((const __m128i*)(comp + k + 8)), 23), mask);
+        __m128i d = _mm_and_si128(_mm_srai_epi32(_mm_loadu_si128((const __m128i*)(comp + k + 12)), 23), mask);
+        _mm_storeu_si128((__m128i*)(dst + k), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+    }
+    for (; k < count; ++k)
+    {
+        dst[k] = (comp[k] >> 23) & 0xff;
+    }
+}
+
+// Rows [y_begin, y_end) of a scale down in both directions
+template<U8 ch>
+static void bilinear_scale_down_simd(
+    const scale_info<ch>& info, U32 srcW, U32 srcStride
+    , U8 *dst, U32 dstW, U32 dstStride, U32 y_begin, U32 y_end
+    )
+{
+    const U32 row_bytes = srcW * ch;
+    const U32 count = dstW * ch;
+    std::vector<S32> cx(count + 1);
+    std::vector<S32> comp(count);
+
+    for (U32 y = y_begin; y < y_end; ++y)
+    {
+        const S32 Cy = info.yapoints[y] >> 16;
+        const S32 yap = info.yapoints[y] & 0xffff;
+        const U8* sptr = info.ystrides[y];
+
+        scale_down_row<ch>(info, sptr, sptr + row_bytes, dstW, cx.data());
+        weigh_row<false>(comp.data(), cx.data(), count, yap);
+        sptr += srcStride;
+
+        S32 j;
+        for (j = (1 << 14) - yap; j > Cy; j -= Cy, sptr += srcStride)
+        {
+            scale_down_row<ch>(info, sptr, sptr + row_bytes, dstW, cx.data());
+            weigh_row<true>(comp.data(), cx.data(), count, Cy);
+        }
+
+        if (j > 0)
+        {
+            scale_down_row<ch>(info, sptr, sptr + row_bytes, dstW, cx.data());
+            weigh_row<true>(comp.data(), cx.data(), count, j);
+        }
+
+        store_row(dst + y * dstStride, comp.data(), count);
+    }
+}
+
+template<U8 ch>
+static void bilinear_scale(const U8 *src, U32 srcW, U32 srcH, U32 srcStride, U8 *dst, U32 dstW, U32 dstH, U32 dstStride)
+{
+    scale_info<ch> info(src, srcW, srcH, dstW, dstH, srcStride);
+    // With 1 or 2 channels most of a register would be wasted, the scalar
+    // code is as fast
+    const bool simd = LLImageScale::getUseSIMD() && info.xup_yup == 0 && ch >= 3;
+
+    auto rows = [&](U32 y_begin, U32 y_end)
+    {
+        if (simd)
+        {
+            bilinear_scale_down_simd<ch>(info, srcW, srcStride, dst, dstW, dstStride, y_begin, y_end);
+        }
+        else
+        {
+            bilinear_scale<ch>(info, srcStride, dst, dstW, dstStride, y_begin, y_end);
+        }
+    };
+
+    const U64 work = (U64)srcW * srcH + (U64)dstW * dstH;
+    if (work < MIN_THREADED_WORK || dstH < 2)
+    {
+        rows(0, dstH);
+        return;
+    }
+    const U64 row_work = llmax(work / dstH, (U64)1);
+    split_rows(dstH, (U32)llmax(TASK_WORK / row_work, (U64)1), rows);
+}
+
+//static
+void LLImageScale::bilinearScale(const U8* src, U32 src_width, U32 src_height, U32 components, U32 src_stride,
+                                 U8* dst, U32 dst_width, U32 dst_height, U32 dst_stride)
+{
+    LL_PROFILE_ZONE_SCOPED;
+    if (!src_width || !src_height || !dst_width || !dst_height)
+    {
+        return;
+    }
+
+    switch (components)
+    {
+    case 1:
+        bilinear_scale<1>(src, src_width, src_height, src_stride, dst, dst_width, dst_height, dst_stride);
+        break;
+    case 2:
+        bilinear_scale<2>(src, src_width, src_height, src_stride, dst, dst_width, dst_height, dst_stride);
+        break;
+    case 3:
+        bilinear_scale<3>(src, src_width, src_height, src_stride, dst, dst_width, dst_height, dst_stride);
+        break;
+    case 4:
+        bilinear_scale<4>(src, src_width, src_height, src_stride, dst, dst_width, dst_height, dst_stride);
+        break;
+    default:
+        llassert(!"Implement if need");
+        break;
+    }
+}
+
+//..................................................................................
+// Mip generation
+//..................................................................................
+
+// Scalar reference, also used for the tail of each row
+template<S32 ch>
+static inline void avg4_colors(const U8* a, const U8* b, const U8* c, const U8* d, U8* dst)
+{
+    for (S32 i = 0; i < ch; ++i)
+    {
+        dst[i] = (U8)(((U32)(a[i]) + b[i] + c[i] + d[i])>>2);
+    }
+}
+
+template<S32 ch>
+static void mip_row_scalar(const U8* row0, const U8* row1, U8* dst, S32 begin, S32 width)
+{
+    for (S32 w = begin; w < width; ++w)
+    {
+        const S32 i = w * ch * 2;
+        avg4_colors<ch>(row0 + i, row0 + i + ch, row1 + i, row1 + i + ch, dst + w * ch);
+    }
+}
+
+// Sum of the two source rows, 16 bits per channel. lo holds bytes 0-7 of
+// the 16 loaded, hi bytes 8-15.
+static inline void sum_rows(const U8* row0, const U8* row1, __m128i& lo, __m128i& hi)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i a = _mm_loadu_si128((const __m128i*)row0);
+    const __m128i b = _mm_loadu_si128((const __m128i*)row1);
+    lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+    hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+}
+
+// One row of 4 channel output, 4 pixels (32 source bytes per row) at a time
+static S32 mip_row4(const U8* row0, const U8* row1, U8* dst, S32 width)
+{
+    S32 w = 0;
+#if LL_IMAGE_SCALE_AVX2
+    const __m256i zero8 = _mm256_setzero_si256();
+    for (; w + 8 <= width; w += 8)
+    {
+        const __m256i a = _mm256_loadu_si256((const __m256i*)(row0 + w * 8));
+        const __m256i b = _mm256_loadu_si256((const __m256i*)(row1 + w * 8));
+        const __m256i a2 = _mm256_loadu_si256((const __m256i*)(row0 + w * 8 + 32));
+        const __m256i b2 = _mm256_loadu_si256((const __m256i*)(row1 + w * 8 + 32));
+        // Per 128 bit lane: lo = pixels 0,1 hi = pixels 2,3 of that lane
+        __m256i lo = _mm256_add_epi16(_mm256_unpacklo_epi8(a, zero8), _mm256_unpacklo_epi8(b, zero8));
+        __m256i hi = _mm256_add_epi16(_mm256_unpackhi_epi8(a, zero8), _mm256_unpackhi_epi8(b, zero8));
+        __m256i lo2 = _mm256_add_epi16(_mm256_unpacklo_epi8(a2, zero8), _mm256_unpacklo_epi8(b2, zero8));
+        __m256i hi2 = _mm256_add_epi16(_mm256_unpackhi_epi8(a2, zero8), _mm256_unpackhi_epi8(b2, zero8));
+        // Add horizontal neighbours: pixel pairs sit in the two 64 bit halves
+        __m256i s = _mm256_add_epi16(_mm256_unpacklo_epi64(lo, hi), _mm256_unpackhi_epi64(lo, hi));
+        __m256i s2 = _mm256_add_epi16(_mm256_unpacklo_epi64(lo2, hi2), _mm256_unpackhi_epi64(lo2, hi2));
+        s = _mm256_srli_epi16(s, 2);
+        s2 = _mm256_srli_epi16(s2, 2);
+        // packus works per 128 bit lane, put the output pixels back in order
+        _mm256_storeu_si256((__m256i*)(dst + w * 4), _mm256_permute4x64_epi64(_mm256_packus_epi16(s, s2), 0xD8));
+    }
+#endif
+    for (; w + 4 <= width; w += 4)
+    {
+        __m128i lo, hi, lo2, hi2;
+        sum_rows(row0 + w * 8, row1 + w * 8, lo, hi);
+        sum_rows(row0 + w * 8 + 16, row1 + w * 8 + 16, lo2, hi2);
+        __m128i s = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+        __m128i s2 = _mm_add_epi16(_mm_unpacklo_epi64(lo2, hi2), _mm_unpackhi_epi64(lo2, hi2));
+        _mm_storeu_si128((__m128i*)(dst + w * 4), _mm_packus_epi16(_mm_srli_epi16(s, 2), _mm_srli_epi16(s2, 2)));
+    }
+    return w;
+}
+
+// One row of 2 channel output, 8 pixels (32 source bytes per row) at a time
+static S32 mip_row2(const U8* row0, const U8* row1, U8* dst, S32 width)
+{
+    S32 w = 0;
+    for (; w + 8 <= width; w += 8)
+    {
+        __m128i lo, hi, lo2, hi2;
+        sum_rows(row0 + w * 4, row1 + w * 4, lo, hi);
+        sum_rows(row0 + w * 4 + 16, row1 + w * 4 + 16, lo2, hi2);
+        // Each 64 bit group holds two source pixels, add the upper into the lower
+        lo = _mm_add_epi16(lo, _mm_srli_epi64(lo, 32));
+        hi = _mm_add_epi16(hi, _mm_srli_epi64(hi, 32));
+        lo2 = _mm_add_epi16(lo2, _mm_srli_epi64(lo2, 32));
+        hi2 = _mm_add_epi16(hi2, _mm_srli_epi64(hi2, 32));
+        // Gather the sums (dwords 0 and 2) into the low half
+        __m128i s = _mm_unpacklo_epi64(_mm_shuffle_epi32(lo, _MM_SHUFFLE(3, 1, 2, 0)), _mm_shuffle_epi32(hi, _MM_SHUFFLE(3, 1, 2, 0)));
+        __m128i s2 = _mm_unpacklo_epi64(_mm_shuffle_epi32(lo2, _MM_SHUFFLE(3, 1, 2, 0)), _mm_shuffle_epi32(hi2, _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm_storeu_si128((__m128i*)(dst + w * 2), _mm_packus_epi16(_mm_srli_epi16(s, 2), _mm_srli_epi16(s2, 2)));
+    }
+    return w;
+}
+
+// One row of 1 channel output, 16 pixels (32 source bytes per row) at a time
+static S32 mip_row1(const U8* row0, const U8* row1, U8* dst, S32 width)
+{
+    S32 w = 0;
+#if LL_IMAGE_SCALE_AVX2
+    const __m256i mask8 = _mm256_set1_epi16(0xff);
+    for (; w + 32 <= width; w += 32)
+    {
+        const __m256i a = _mm256_loadu_si256((const __m256i*)(row0 + w * 2));
+        const __m256i b = _mm256_loadu_si256((const __m256i*)(row1 + w * 2));
+        const __m256i a2 = _mm256_loadu_si256((const __m256i*)(row0 + w * 2 + 32));
+        const __m256i b2 = _mm256_loadu_si256((const __m256i*)(row1 + w * 2 + 32));
+        __m256i s = _mm256_add_epi16(_mm256_add_epi16(_mm256_and_si256(a, mask8), _mm256_srli_epi16(a, 8)),
+                                     _mm256_add_epi16(_mm256_and_si256(b, mask8), _mm256_srli_epi16(b, 8)));
+        __m256i s2 = _mm256_add_epi16(_mm256_add_epi16(_mm256_and_si256(a2, mask8), _mm256_srli_epi16(a2, 8)),
+                                      _mm256_add_epi16(_mm256_and_si256(b2, mask8), _mm256_srli_epi16(b2, 8)));
+        _mm256_storeu_si256((__m256i*)(dst + w),
+                            _mm256_permute4x64_epi64(_mm256_packus_epi16(_mm256_srli_epi16(s, 2), _mm256_srli_epi16(s2, 2)), 0xD8));
+    }
+#endif
+    const __m128i mask = _mm_set1_epi16(0xff);
+    for (; w + 16 <= width; w += 16)
+    {
+        const __m128i a = _mm_loadu_si128((const __m128i*)(row0 + w * 2));
+        const __m128i b = _mm_loadu_si128((const __m128i*)(row1 + w * 2));
+        const __m128i a2 = _mm_loadu_si128((const __m128i*)(row0 + w * 2 + 16));
+        const __m128i b2 = _mm_loadu_si128((const __m128i*)(row1 + w * 2 + 16));
+        // Even bytes plus odd bytes of both rows
+        __m128i s = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(a, mask), _mm_srli_epi16(a, 8)),
+                                  _mm_add_epi16(_mm_and_si128(b, mask), _mm_srli_epi16(b, 8)));
+        __m128i s2 = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(a2, mask), _mm_srli_epi16(a2, 8)),
+                                   _mm_add_epi16(_mm_and_si128(b2, mask), _mm_srli_epi16(b2, 8)));
+        _mm_storeu_si128((__m128i*)(dst + w), _mm_packus_epi16(_mm_srli_epi16(s, 2), _mm_srli_epi16(s2, 2)));
+    }
+    return w;
+}
+
+// One row of 3 channel output. Three byte pixels do not line up with SIMD
+// lanes, so only the vertical sum is vectorised, into sums, and the
+// horizontal pairs are added from there.
+static S32 mip_row3(const U8* row0, const U8* row1, U8* dst, S32 width, std::vector<U16>& sums)
+{
+    const S32 count = width * 6;
+    sums.resize(count);
+    S32 k = 0;
+    for (; k + 16 <= count; k += 16)
+    {
+        __m128i lo, hi;
+        sum_rows(row0 + k, row1 + k, lo, hi);
+        _mm_storeu_si128((__m128i*)(sums.data() + k), lo);
+        _mm_storeu_si128((__m128i*)(sums.data() + k + 8), hi);
+    }
+    for (; k < count; ++k)
+    {
+        sums[k] = (U16)row0[k] + row1[k];
+    }
+
+    const U16* sum = sums.data();
+    for (S32 w = 0; w < width; ++w, sum += 6, dst += 3)
+    {
+        dst[0] = (U8)(((U32)sum[0] + sum[3]) >> 2);
+        dst[1] = (U8)(((U32)sum[1] + sum[4]) >> 2);
+        dst[2] = (U8)(((U32)sum[2] + sum[5]) >> 2);
+    }
+    return width;
+}
+
+template<S32 ch>
+static void generate_mip_rows(const U8* indata, U8* mipdata, S32 width, S32 begin, S32 end)
+{
+    const S32 in_stride = width * 2 * ch;
+    const bool simd = LLImageScale::getUseSIMD();
+    std::vector<U16> sums;
+
+    for (S32 h = begin; h < end; ++h)
+    {
+        const U8* row0 = indata + h * 2 * in_stride;
+        const U8* row1 = row0 + in_stride;
+        U8* dst = mipdata + h * width * ch;
+
+        S32 done = 0;
+        if (simd)
+        {
+            switch (ch)
+            {
+            case 4: done = mip_row4(row0, row1, dst, width); break;
+            case 3: done = mip_row3(row0, row1, dst, width, sums); break;
+            case 2: done = mip_row2(row0, row1, dst, width); break;
+            case 1: done = mip_row1(row0, row1, dst, width); break;
+            }
+        }
+        mip_row_scalar<ch>(row0, row1, dst, done, width);
+    }
+}
+
+template<S32 ch>
+static void generate_mip(const U8* indata, U8* mipdata, S32 width, S32 height)
+{
+    auto rows = [&](U32 begin, U32 end)
+    {
+        generate_mip_rows<ch>(indata, mipdata, width, (S32)begin, (S32)end);
+    };
+
+    // Source plus destination pixels
+    const U64 work = (U64)width * height * 5;
+    if (work < MIN_THREADED_WORK || height < 2)
+    {
+        rows(0, height);
+        return;
+    }
+    const U64 row_work = (U64)width * 5;
+    split_rows(height, (U32)llmax(TASK_WORK / row_work, (U64)1), rows);
+}
+
+//static
+void LLImageScale::generateMip(const U8* indata, U8* mipdata, S32 width, S32 height, S32 components)
+{
+    llassert(width > 0 && height > 0);
+    switch (components)
+    {
+    case 4:
+        generate_mip<4>(indata, mipdata, width, height);
+        break;
+    case 3:
+        generate_mip<3>(indata, mipdata, width, height);
+        break;
+    case 2:
+        generate_mip<2>(indata, mipdata, width, height);
+        break;
+    case 1:
+        generate_mip<1>(indata, mipdata, width, height);
+        break;
+    default:
+        LL_WARNS() << "generateMmip called with bad num channels: " << components << LL_ENDL;
+        break;
+    }
+}
@@ -0,0 +1,74 @@
+/**
+ * @file llimagescale.h
+ * @brief Raw image scaling and mip generation kernels
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+
+#ifndef LL_LLIMAGESCALE_H
+#define LL_LLIMAGESCALE_H
+
+#include "stdtypes.h"
+
+/**
+ * Pixel kernels behind LLImageRaw::scale(), LLImageRaw::scaled(),
+ * LLImageRaw::copyScaled() and LLImageBase::generateMip().
+ *
+ * Mip generation and the bilinear down scale of 3 and 4 component images
+ * have SIMD versions (SSE2, NEON through sse2neon, AVX2 when the viewer is
+ * built with it) that produce exactly the same pixels as the scalar code.
+ * Large images are also split by rows across the
+ * "General" thread pool, the calling thread taking rows as well; when
+ * there is no such pool the work is done on the calling thread.
+ */
+class LLImageScale
+{
+public:
+    // Anti-aliased bilinear scale of an image with 1 to 4 components.
+    // Strides are in bytes.
+    static void bilinearScale(const U8* src, U32 src_width, U32 src_height, U32 components, U32 src_stride,
+                              U8* dst, U32 dst_width, U32 dst_height, U32 dst_stride);
+
+    // 2x2 box filter: mipdata (width x height) from indata (2*width x 2*height)
+    static void generateMip(const U8* indata, U8* mipdata, S32 width, S32 height, S32 components);
+
+    // Kernel selection, both on by default. The scalar single threaded
+    // kernels are the reference the others are checked against.
+    static void setUseSIMD(bool use_simd) { sUseSIMD = use_simd; }
+    static void setUseThreads(bool use_threads) { sUseThreads = use_threads; }
+    static bool getUseSIMD() { return sUseSIMD; }
+    static bool getUseThreads() { return sUseThreads; }
+
+    // Instruction set of the SIMD kernels in this build
+    static const char* getSIMDName();
+
+private:
+    static bool sUseSIMD;
+    static bool sUseThreads;
+};
+
+#endif // LL_LLIMAGESCALE_H
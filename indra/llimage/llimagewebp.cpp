@@ -174,6 +174,8 @@ bool LLImageWebP::encode(const LLImageRaw* raw_image, F32 encode_time)
         memcpy(tmp_buff.get() + i * stride, row, stride);
     }
 
+// <AS:Chanayane> Parallel upload encode
+    /*
     U8* encodedData = nullptr;
     size_t encodedSize = 0;
     if (components == 4)
@@ -201,6 +203,58 @@ bool LLImageWebP::encode(const LLImageRaw* raw_image, F32 encode_time)
     // Copy
     memcpy(getData(), encodedData, encodedSize);
     WebPFree(encodedData);
+    */
+
+    // Same settings as WebPEncodeLossless*(), through the advanced API so
+    // that libwebp may run its analysis passes on a second thread.
+    WebPConfig config;
+    if (!WebPConfigPreset(&config, WEBP_PRESET_DEFAULT, 70.f))
+    {
+        setLastError("LLImageWebP could not initialize encoder");
+        return false;
+    }
+    config.lossless = 1;
+    config.thread_level = 1;
+
+    WebPPicture picture;
+    if (!WebPPictureInit(&picture))
+    {
+        setLastError("LLImageWebP could not initialize encoder");
+        return false;
+    }
+    picture.use_argb = 1;
+    picture.width = width;
+    picture.height = height;
+
+    WebPMemoryWriter writer;
+    WebPMemoryWriterInit(&writer);
+    picture.writer = WebPMemoryWrite;
+    picture.custom_ptr = &writer;
+
+    bool imported = (components == 4) ? WebPPictureImportRGBA(&picture, tmp_buff.get(), (int)stride)
+                                       : WebPPictureImportRGB(&picture, tmp_buff.get(), (int)stride);
+    tmp_buff.reset();
+    bool encoded = imported && WebPEncode(&config, &picture);
+    WebPPictureFree(&picture);
+
+    if (!encoded || writer.size == 0)
+    {
+        setLastError("LLImageWebP::Failed to encode image");
+        WebPMemoryWriterClear(&writer);
+        return false;
+    }
+
+    if (!allocateData((S32)writer.size))
+    {
+        setLastError("LLImageWebP::Failed to allocate final buffer for image");
+        WebPMemoryWriterClear(&writer);
+        return false;
+    }
+
+    // Copy
+    memcpy(getData(), writer.mem, writer.size);
+    WebPMemoryWriterClear(&writer);
+// </AS:Chanayane>
 
     return true;
 }
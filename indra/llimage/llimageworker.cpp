@@ -28,6 +28,7 @@
 
 #include "llimageworker.h"
 #include "llimagedxt.h"
+#include "llimagej2c.h" // <AS:Chanayane/> Threaded J2C decode
 #include "threadpool.h"
 
 /*--------------------------------------------------------------------------*/
@@ -69,6 +70,15 @@ LLImageDecodeThread::LLImageDecodeThread(bool /*threaded*/)
 {
     mThreadPool = std::make_unique<LL::ThreadPool>("ImageDecode", 8);
     mThreadPool->start();
+
+    // <AS:Chanayane> Threaded J2C decode
+    // Leave a core to the main thread. Cores the pool does not keep busy
+    // are lent to the decoders of large images as helper threads, so a
+    // lone 2048px texture no longer decodes on one core while the rest of
+    // the pool sits idle, and a full pool gets no helpers at all.
+    S32 cores = (S32)std::thread::hardware_concurrency();
+    LLImageJ2C::setDecodeCores(llmax(cores - 1, 1));
+    // </AS:Chanayane>
 }
 
 //virtual
@@ -119,6 +129,7 @@ LLImageDecodeThread::handle_t LLImageDecodeThread::decodeImage(
 
 void LLImageDecodeThread::shutdown()
 {
+    LLImageJ2C::setDecodeCores(0); // <AS:Chanayane/> Threaded J2C decode
     mThreadPool->close();
 }
 
@@ -33,12 +33,206 @@
 
 #include "llexception.h"
 
+// <AS:Chanayane> Streaming encoders
+#include "workqueue.h"
+
+#ifdef LL_USESYSTEMLIBS
+# include <zlib.h>
+#else
+# include "zlib-ng/zlib.h"
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+// </AS:Chanayane>
+
 namespace {
 // Failure to load an image shouldn't crash the whole viewer.
 struct PngError: public LLContinueError
 {
     PngError(png_const_charp msg): LLContinueError(msg) {}
 };
+
+// <AS:Chanayane> Streaming encoders
+// Filtered bytes given to each deflate task. Blocks are compressed
+// independently, so smaller blocks cost compression ratio.
+constexpr U32 DEFLATE_BLOCK_BYTES = 1 << 20;
+// Images smaller than this are left to libpng
+constexpr U64 PARALLEL_DEFLATE_MIN_BYTES = 4 << 20;
+
+inline U8 paeth_predictor(S32 a, S32 b, S32 c)
+{
+    const S32 p = a + b - c;
+    const S32 pa = abs(p - a);
+    const S32 pb = abs(p - b);
+    const S32 pc = abs(p - c);
+    if (pa <= pb && pa <= pc)
+    {
+        return (U8)a;
+    }
+    return (U8)(pb <= pc ? b : c);
+}
+
+// Residual of byte i of row for a PNG filter type. prev is the row above,
+// NULL for the first row.
+inline U8 filter_byte(U8 type, const U8* row, const U8* prev, U32 i, U32 bpp)
+{
+    const S32 left = i >= bpp ? row[i - bpp] : 0;
+    const S32 up = prev ? prev[i] : 0;
+    const S32 up_left = (prev && i >= bpp) ? prev[i - bpp] : 0;
+    switch (type)
+    {
+    case PNG_FILTER_VALUE_SUB:
+        return (U8)(row[i] - left);
+    case PNG_FILTER_VALUE_UP:
+        return (U8)(row[i] - up);
+    case PNG_FILTER_VALUE_AVG:
+        return (U8)(row[i] - ((left + up) >> 1));
+    case PNG_FILTER_VALUE_PAETH:
+        return (U8)(row[i] - paeth_predictor(left, up, up_left));
+    default:
+        return row[i];
+    }
+}
+
+// Filter one row into out (rowBytes + 1 bytes). The filter type is picked
+// as libpng does by default: smallest sum of the residuals taken as signed
+// bytes.
+void filter_row(const U8* row, const U8* prev, U32 rowBytes, U32 bpp, U8* out)
+{
+    U8 best_type = PNG_FILTER_VALUE_NONE;
+    U64 best_sum = ~0ULL;
+    for (U8 type = PNG_FILTER_VALUE_NONE; type < PNG_FILTER_VALUE_LAST; ++type)
+    {
+        U64 sum = 0;
+        for (U32 i = 0; i < rowBytes && sum < best_sum; ++i)
+        {
+            sum += abs((S8)filter_byte(type, row, prev, i, bpp));
+        }
+        if (sum < best_sum)
+        {
+            best_sum = sum;
+            best_type = type;
+        }
+    }
+
+    out[0] = best_type;
+    for (U32 i = 0; i < rowBytes; ++i)
+    {
+        out[i + 1] = filter_byte(best_type, row, prev, i, bpp);
+    }
+}
+
+struct DeflateBlock
+{
+    std::vector<U8>     mOut;
+    uLong               mAdler{ 0 };
+    uLong               mLength{ 0 };
+    bool                mOK{ false };
+    bool                mDone{ false };     // guarded by DeflateJob::mMutex
+    std::atomic<bool>   mClaimed{ false };
+};
+
+// Shared with the tasks on the thread pool, which may start after the
+// encode has finished or failed and then find nothing to do
+struct DeflateJob
+{
+    const U8*                       mData;
+    U32                             mHeight;
+    U32                             mRowBytes;
+    U32                             mBpp;
+    U32                             mRowsPerBlock;
+    std::unique_ptr<DeflateBlock[]> mBlocks;
+    U32                             mCount;
+    std::mutex                      mMutex;
+    std::condition_variable         mCond;
+
+    // Compress a block unless another thread took it already
+    void run(U32 index)
+    {
+        DeflateBlock& block = mBlocks[index];
+        if (block.mClaimed.exchange(true))
+        {
+            return;
+        }
+        compress(index, block);
+        std::lock_guard<std::mutex> lock(mMutex);
+        block.mDone = true;
+        mCond.notify_all();
+    }
+
+    // Wait for a block, taking it over if nobody started it
+    void wait(U32 index)
+    {
+        DeflateBlock& block = mBlocks[index];
+        if (!block.mClaimed.exchange(true))
+        {
+            compress(index, block);
+            std::lock_guard<std::mutex> lock(mMutex);
+            block.mDone = true;
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCond.wait(lock, [&block]() { return block.mDone; });
+    }
+
+    // Make sure no task touches the image any more
+    void abandon(U32 posted)
+    {
+        for (U32 i = 0; i < posted; ++i)
+        {
+            DeflateBlock& block = mBlocks[i];
+            if (block.mClaimed.exchange(true))
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mCond.wait(lock, [&block]() { return block.mDone; });
+            }
+        }
+    }
+
+    void compress(U32 index, DeflateBlock& block)
+    {
+        LL_PROFILE_ZONE_SCOPED;
+        const U32 begin = index * mRowsPerBlock;
+        const U32 end = llmin(begin + mRowsPerBlock, mHeight);
+        const U32 stride = mRowBytes + 1;
+
+        // PNG rows run top down, LLImageRaw rows bottom up
+        std::vector<U8> filtered((end - begin) * stride);
+        for (U32 row = begin; row < end; ++row)
+        {
+            const U8* data = mData + (mHeight - 1 - row) * mRowBytes;
+            const U8* prev = row ? data + mRowBytes : NULL;
+            filter_row(data, prev, mRowBytes, mBpp, &filtered[(row - begin) * stride]);
+        }
+
+        block.mLength = (uLong)filtered.size();
+        block.mAdler = adler32(adler32(0L, Z_NULL, 0), filtered.data(), (uInt)filtered.size());
+
+        // Raw deflate, the zlib header and the checksum are written around
+        // the blocks. Every block but the last ends on a sync flush so the
+        // streams concatenate into one.
+        z_stream stream{};
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_FILTERED) != Z_OK)
+        {
+            return;
+        }
+        block.mOut.resize(deflateBound(&stream, block.mLength) + 16);
+        stream.next_in = filtered.data();
+        stream.avail_in = (uInt)filtered.size();
+        stream.next_out = block.mOut.data();
+        stream.avail_out = (uInt)block.mOut.size();
+        const bool last = index == mCount - 1;
+        const int ret = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+        block.mOK = last ? ret == Z_STREAM_END : (ret == Z_OK && stream.avail_in == 0);
+        block.mOut.resize(block.mOut.size() - stream.avail_out);
+        deflateEnd(&stream);
+    }
+};
+// </AS:Chanayane>
 } // anonymous namespace
 
 // ---------------------------------------------------------------------------
@@ -111,15 +305,24 @@ void LLPngWrapper::readDataCallback(png_structp png_ptr, png_bytep dest, png_siz
 // copy the encoded result into our data buffer.
 void LLPngWrapper::writeDataCallback(png_structp png_ptr, png_bytep src, png_size_t length)
 {
-    PngDataInfo *dataInfo = (PngDataInfo *) png_get_io_ptr(png_ptr);
-    if (dataInfo->mOffset + length > dataInfo->mDataSize)
+    // <AS:Chanayane> Streaming encoders
+    //PngDataInfo *dataInfo = (PngDataInfo *) png_get_io_ptr(png_ptr);
+    //if (dataInfo->mOffset + length > dataInfo->mDataSize)
+    //{
+    //    png_error(png_ptr, "Data write error. Requested data size exceeds available data size.");
+    //    return;
+    //}
+    //U8 *dest = &dataInfo->mData[dataInfo->mOffset];
+    //memcpy(dest, src, length);
+    //dataInfo->mOffset += static_cast<U32>(length);
+    PngWriteInfo *writeInfo = (PngWriteInfo *) png_get_io_ptr(png_ptr);
+    if (!(*writeInfo->mSink)(src, length))
     {
-        png_error(png_ptr, "Data write error. Requested data size exceeds available data size.");
+        png_error(png_ptr, "Data write error.");
         return;
     }
-    U8 *dest = &dataInfo->mData[dataInfo->mOffset];
-    memcpy(dest, src, length);
-    dataInfo->mOffset += static_cast<U32>(length);
+    writeInfo->mWritten += static_cast<U32>(length);
+    // </AS:Chanayane>
 }
 
 // Flush the write output pointer
@@ -290,7 +493,10 @@ void LLPngWrapper::updateMetaData()
 
 // Method to write raw image into PNG at dest. The raw scanline begins
 // at the bottom of the image per SecondLife conventions.
-bool LLPngWrapper::writePng(const LLImageRaw* rawImage, U8* dest, size_t destSize)
+// <AS:Chanayane> Streaming encoders
+//bool LLPngWrapper::writePng(const LLImageRaw* rawImage, U8* dest, size_t destSize)
+bool LLPngWrapper::writePng(const LLImageRaw* rawImage, const LLImageFormatted::encode_sink_t& sink)
+// </AS:Chanayane>
 {
     try
     {
@@ -328,10 +534,13 @@ bool LLPngWrapper::writePng(const LLImageRaw* rawImage, U8* dest, size_t destSiz
         mWriteInfoPtr = png_create_info_struct(mWritePngPtr);
 
         // Setup write function
-        PngDataInfo dataPtr{};
-        dataPtr.mData = dest;
-        dataPtr.mOffset = 0;
-        dataPtr.mDataSize = static_cast<S32>(destSize);
+        // <AS:Chanayane> Streaming encoders
+        //PngDataInfo dataPtr{};
+        //dataPtr.mData = dest;
+        //dataPtr.mOffset = 0;
+        //dataPtr.mDataSize = static_cast<S32>(destSize);
+        PngWriteInfo dataPtr{ &sink, 0 };
+        // </AS:Chanayane>
         png_set_write_fn(mWritePngPtr, &dataPtr, &writeDataCallback, &writeFlush);
 
         // Setup image params
@@ -355,17 +564,27 @@ bool LLPngWrapper::writePng(const LLImageRaw* rawImage, U8* dest, size_t destSiz
         // Ready to write, start with the header
         png_write_info(mWritePngPtr, mWriteInfoPtr);
 
-        // Write image (sorry, must const-cast for libpng)
-        const U8 * rowPointer;
-        for (U32 i=0; i < mHeight; i++)
+        // <AS:Chanayane> Streaming encoders
+        if ((U64)offset * mHeight >= PARALLEL_DEFLATE_MIN_BYTES && LL::WorkQueue::getInstance("General"))
         {
-            rowPointer = &data[(mHeight-1-i)*offset];
-            png_write_row(mWritePngPtr, const_cast<png_bytep>(rowPointer));
+            writeImageDataParallel(data, offset);
         }
+        else
+        {
+            // Write image (sorry, must const-cast for libpng)
+            const U8 * rowPointer;
+            for (U32 i=0; i < mHeight; i++)
+            {
+                rowPointer = &data[(mHeight-1-i)*offset];
+                png_write_row(mWritePngPtr, const_cast<png_bytep>(rowPointer));
+            }
 
-        // Finish up
-        png_write_end(mWritePngPtr, mWriteInfoPtr);
-        mFinalSize = dataPtr.mOffset;
+            // Finish up
+            png_write_end(mWritePngPtr, mWriteInfoPtr);
+        }
+        //mFinalSize = dataPtr.mOffset;
+        mFinalSize = dataPtr.mWritten;
+        // </AS:Chanayane>
     }
     catch (const PngError& msg)
     {
@@ -378,6 +597,66 @@ bool LLPngWrapper::writePng(const LLImageRaw* rawImage, U8* dest, size_t destSiz
     return true;
 }
 
+// <AS:Chanayane> Streaming encoders
+void LLPngWrapper::writeImageDataParallel(const U8* data, U32 rowBytes)
+{
+    LL_PROFILE_ZONE_SCOPED;
+    LL::WorkQueue::ptr_t queue = LL::WorkQueue::getInstance("General");
+
+    auto job = std::make_shared<DeflateJob>();
+    job->mData = data;
+    job->mHeight = mHeight;
+    job->mRowBytes = rowBytes;
+    job->mBpp = mChannels;
+    job->mRowsPerBlock = llmax(1U, DEFLATE_BLOCK_BYTES / (rowBytes + 1));
+    job->mCount = (mHeight + job->mRowsPerBlock - 1) / job->mRowsPerBlock;
+    job->mBlocks.reset(new DeflateBlock[job->mCount]);
+
+    // Compressed blocks wait here until they can be written in order, so
+    // only let a few of them run ahead
+    const U32 window = 2 * llmax(1U, std::thread::hardware_concurrency());
+    U32 posted = 0;
+
+    try
+    {
+        // zlib header: deflate, 32K window, default compression
+        static const U8 header[2] = { 0x78, 0x9c };
+        png_write_chunk(mWritePngPtr, (png_const_bytep)"IDAT", header, sizeof(header));
+
+        uLong adler = 1;
+        for (U32 next = 0; next < job->mCount; ++next)
+        {
+            for (; posted < llmin(next + window, job->mCount); ++posted)
+            {
+                const U32 index = posted;
+                // A block that could not be posted is compressed by wait()
+                queue->post([job, index]() { job->run(index); });
+            }
+
+            job->wait(next);
+            DeflateBlock& block = job->mBlocks[next];
+            if (!block.mOK)
+            {
+                LLTHROW(PngError("Problem compressing image data"));
+            }
+            adler = adler32_combine(adler, block.mAdler, block.mLength);
+            png_write_chunk(mWritePngPtr, (png_const_bytep)"IDAT", block.mOut.data(), block.mOut.size());
+            std::vector<U8>().swap(block.mOut);
+        }
+
+        const U8 trailer[4] = { (U8)(adler >> 24), (U8)(adler >> 16), (U8)(adler >> 8), (U8)adler };
+        png_write_chunk(mWritePngPtr, (png_const_bytep)"IDAT", trailer, sizeof(trailer));
+        png_write_chunk(mWritePngPtr, (png_const_bytep)"IEND", NULL, 0);
+    }
+    catch (...)
+    {
+        // Tasks still queued must not read the image once we return
+        job->abandon(posted);
+        throw;
+    }
+}
+// </AS:Chanayane>
+
 // Cleanup various internal structures
 void LLPngWrapper::releaseResources()
 {
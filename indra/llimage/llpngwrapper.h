@@ -45,7 +45,11 @@ public:
 
     bool isValidPng(U8* src);
     bool readPng(U8* src, S32 dataSize, LLImageRaw* rawImage, ImageInfo *infop = NULL);
-    bool writePng(const LLImageRaw* rawImage, U8* dst, size_t destSize);
+    // <AS:Chanayane> Streaming encoders
+    //bool writePng(const LLImageRaw* rawImage, U8* dst, size_t destSize);
+    // Large images are deflated in blocks on the "General" thread pool
+    bool writePng(const LLImageRaw* rawImage, const LLImageFormatted::encode_sink_t& sink);
+    // </AS:Chanayane>
     U32  getFinalSize();
     const std::string& getErrorMessage();
 
@@ -64,6 +68,18 @@ private:
         S32 mDataSize;
     };
 
+    // <AS:Chanayane> Streaming encoders
+    struct PngWriteInfo
+    {
+        const LLImageFormatted::encode_sink_t* mSink;
+        U32 mWritten;
+    };
+
+    // Filter and deflate the image rows in parallel, then write them as
+    // IDAT chunks followed by IEND
+    void writeImageDataParallel(const U8* data, U32 rowBytes);
+    // </AS:Chanayane>
+
     static void writeFlush(png_structp png_ptr);
     static void errorHandler(png_structp png_ptr, png_const_charp msg);
     static void readDataCallback(png_structp png_ptr, png_bytep dest, png_size_t length);
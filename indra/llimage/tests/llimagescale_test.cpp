@@ -0,0 +1,205 @@
+/**
+ * @file llimagescale_test.cpp
+ * @brief Test cases for the SIMD and multithreaded image scaling kernels
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+
+#include "linden_common.h"
+
+#include "../llimagescale.h"
+
+#include "threadpool.h"
+
+#include "../test/lltut.h"
+
+#include <vector>
+
+namespace tut
+{
+    struct imagescale_test
+    {
+        imagescale_test()
+        {
+            LLImageScale::setUseSIMD(true);
+            LLImageScale::setUseThreads(true);
+        }
+
+        ~imagescale_test()
+        {
+            LLImageScale::setUseSIMD(true);
+            LLImageScale::setUseThreads(true);
+        }
+
+        static std::vector<U8> makeImage(U32 width, U32 height, U32 components, U32 seed)
+        {
+            std::vector<U8> data(width * height * components);
+            U32 value = seed * 2654435761U + 1;
+            for (U8& byte : data)
+            {
+                value = value * 1664525U + 1013904223U;
+                byte = (U8)(value >> 24);
+            }
+            return data;
+        }
+
+        static std::vector<U8> scale(const std::vector<U8>& src, U32 src_width, U32 src_height, U32 components,
+                                     U32 dst_width, U32 dst_height, bool simd, bool threads)
+        {
+            LLImageScale::setUseSIMD(simd);
+            LLImageScale::setUseThreads(threads);
+            std::vector<U8> dst(dst_width * dst_height * components);
+            LLImageScale::bilinearScale(src.data(), src_width, src_height, components, src_width * components,
+                                        dst.data(), dst_width, dst_height, dst_width * components);
+            return dst;
+        }
+
+        static std::vector<U8> mip(const std::vector<U8>& src, S32 width, S32 height, S32 components, bool simd, bool threads)
+        {
+            LLImageScale::setUseSIMD(simd);
+            LLImageScale::setUseThreads(threads);
+            std::vector<U8> dst(width * height * components);
+            LLImageScale::generateMip(src.data(), dst.data(), width, height, components);
+            return dst;
+        }
+
+        // Reference box filter, written out independently of the kernels
+        static std::vector<U8> naiveMip(const std::vector<U8>& src, S32 width, S32 height, S32 components)
+        {
+            std::vector<U8> dst(width * height * components);
+            const S32 in_stride = width * 2 * components;
+            for (S32 y = 0; y < height; ++y)
+            {
+                for (S32 x = 0; x < width; ++x)
+                {
+                    for (S32 c = 0; c < components; ++c)
+                    {
+                        const S32 i = y * 2 * in_stride + x * 2 * components + c;
+                        const U32 sum = (U32)src[i] + src[i + components] + src[i + in_stride] + src[i + in_stride + components];
+                        dst[(y * width + x) * components + c] = (U8)(sum >> 2);
+                    }
+                }
+            }
+            return dst;
+        }
+
+        static std::string label(U32 src_width, U32 src_height, U32 dst_width, U32 dst_height, U32 components)
+        {
+            std::ostringstream out;
+            out << src_width << "x" << src_height << " -> " << dst_width << "x" << dst_height << " (" << components << " components)";
+            return out.str();
+        }
+    };
+
+    typedef test_group<imagescale_test> imagescale_t;
+    typedef imagescale_t::object imagescale_object_t;
+    tut::imagescale_t tut_imagescale("LLImageScale");
+
+    template<> template<>
+    void imagescale_object_t::test<1>()
+    {
+        set_test_name("SIMD bilinear scale matches the scalar one");
+
+        struct Size { U32 src_w, src_h, dst_w, dst_h; };
+        const Size sizes[] = {
+            { 512, 512, 128, 128 },     // down
+            { 1000, 750, 333, 101 },    // down, odd ratios
+            { 37, 23, 5, 3 },           // down, tails shorter than a SIMD register
+            { 64, 64, 256, 256 },       // up
+            { 300, 40, 100, 160 },      // down x, up y
+            { 40, 300, 160, 100 },      // up x, down y
+            { 256, 256, 256, 256 },     // same size
+        };
+
+        for (U32 components = 1; components <= 4; ++components)
+        {
+            for (const Size& size : sizes)
+            {
+                std::vector<U8> src = makeImage(size.src_w, size.src_h, components, size.src_w + components);
+                std::vector<U8> expected = scale(src, size.src_w, size.src_h, components, size.dst_w, size.dst_h, false, false);
+                std::vector<U8> actual = scale(src, size.src_w, size.src_h, components, size.dst_w, size.dst_h, true, false);
+                ensure_memory_matches(label(size.src_w, size.src_h, size.dst_w, size.dst_h, components).c_str(),
+                                      actual.data(), (U32)actual.size(), expected.data(), (U32)expected.size());
+            }
+        }
+    }
+
+    template<> template<>
+    void imagescale_object_t::test<2>()
+    {
+        set_test_name("SIMD mip generation matches the box filter");
+
+        const S32 sizes[][2] = { { 1, 1 }, { 3, 5 }, { 17, 9 }, { 64, 64 }, { 129, 33 }, { 512, 256 } };
+        for (S32 components = 1; components <= 4; ++components)
+        {
+            for (const auto& size : sizes)
+            {
+                std::vector<U8> src = makeImage(size[0] * 2, size[1] * 2, components, size[0] + components);
+                std::vector<U8> expected = naiveMip(src, size[0], size[1], components);
+                std::string name = label(size[0] * 2, size[1] * 2, size[0], size[1], components);
+
+                std::vector<U8> scalar = mip(src, size[0], size[1], components, false, false);
+                ensure_memory_matches((name + " scalar").c_str(), scalar.data(), (U32)scalar.size(), expected.data(), (U32)expected.size());
+
+                std::vector<U8> simd = mip(src, size[0], size[1], components, true, false);
+                ensure_memory_matches((name + " SIMD").c_str(), simd.data(), (U32)simd.size(), expected.data(), (U32)expected.size());
+            }
+        }
+    }
+
+    template<> template<>
+    void imagescale_object_t::test<3>()
+    {
+        set_test_name("Multithreaded kernels match the single threaded ones");
+
+        LL::ThreadPool pool("General", 4);
+        pool.start();
+
+        for (U32 components = 1; components <= 4; ++components)
+        {
+            // Large enough to be split across the pool
+            std::vector<U8> src = makeImage(2048, 2048, components, components);
+
+            std::vector<U8> expected = scale(src, 2048, 2048, components, 700, 500, false, false);
+            std::vector<U8> actual = scale(src, 2048, 2048, components, 700, 500, true, true);
+            ensure_memory_matches(label(2048, 2048, 700, 500, components).c_str(),
+                                  actual.data(), (U32)actual.size(), expected.data(), (U32)expected.size());
+
+            expected = scale(src, 2048, 2048, components, 3000, 2500, false, false);
+            actual = scale(src, 2048, 2048, components, 3000, 2500, false, true);
+            ensure_memory_matches(label(2048, 2048, 3000, 2500, components).c_str(),
+                                  actual.data(), (U32)actual.size(), expected.data(), (U32)expected.size());
+
+            expected = naiveMip(src, 1024, 1024, components);
+            actual = mip(src, 1024, 1024, components, true, true);
+            ensure_memory_matches(label(2048, 2048, 1024, 1024, components).c_str(),
+                                  actual.data(), (U32)actual.size(), expected.data(), (U32)expected.size());
+        }
+
+        pool.close();
+    }
+}
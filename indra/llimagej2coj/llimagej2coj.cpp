@@ -30,6 +30,31 @@
 // this is defined so that we get static linking.
 #include "openjpeg.h"
 
+// <AS:Chanayane> Threaded J2C decode
+// OpenJPEG 2.3 is the first release that can spread a decode over its own
+// worker threads.
+#if OPJ_VERSION_MAJOR > 2 || (OPJ_VERSION_MAJOR == 2 && OPJ_VERSION_MINOR >= 3)
+#define LL_OPJ_DECODE_THREADS 1
+#else
+#define LL_OPJ_DECODE_THREADS 0
+#endif
+
+// Images of at least this many pixels at the requested discard level ask for
+// one helper thread, four times that asks for MAX_DECODE_HELPERS.
+const S64 DECODE_HELPER_PIXELS = 1024 * 1024;
+const S32 MAX_DECODE_HELPERS = 3;
+// </AS:Chanayane>
+
+// <AS:Chanayane> Parallel upload encode
+// OpenJPEG 2.5 is the first release whose compressor honours
+// opj_codec_set_threads(); older ones only thread the decompressor.
+#if OPJ_VERSION_MAJOR > 2 || (OPJ_VERSION_MAJOR == 2 && OPJ_VERSION_MINOR >= 5)
+#define LL_OPJ_ENCODE_THREADS 1
+#else
+#define LL_OPJ_ENCODE_THREADS 0
+#endif
+// </AS:Chanayane>
+
 // Factory function: see declaration in llimagej2c.cpp
 LLImageJ2CImpl* fallbackCreateLLImageJ2CImpl()
 {
@@ -296,6 +321,8 @@ public:
             opj_destroy_cstr_info(&codestream_info);
         }
         codestream_info = nullptr;
+
+        releaseHelpers(); // <AS:Chanayane/> Threaded J2C decode
     }
 
     bool readHeader(
@@ -378,12 +405,16 @@ public:
         return true;
     }
 
-    bool decode(U8* data, U32 dataSize, U32* channels, U8 discard_level)
+    // <AS:Chanayane> Threaded J2C decode
+    //bool decode(U8* data, U32 dataSize, U32* channels, U8 discard_level)
+    bool decode(U8* data, U32 dataSize, U32* channels, U8 discard_level, S32 wanted_helpers = 0)
+    // </AS:Chanayane>
     {
         parameters.flags &= ~OPJ_DPARAMETERS_DUMP_FLAG;
 
         decoder = opj_create_decompress(OPJ_CODEC_J2K);
         opj_setup_decoder(decoder, &parameters);
+        setupHelpers(wanted_helpers); // <AS:Chanayane/> Threaded J2C decode
 
         opj_set_info_handler(decoder, info_callback, this);
         opj_set_warning_handler(decoder, warning_callback, this);
@@ -435,6 +466,7 @@ public:
         }
 
         OPJ_BOOL decoded = opj_decode(decoder, stream, image);
+        releaseHelpers(); // <AS:Chanayane/> Threaded J2C decode
 
         // count was zero.  The latter is just a sanity check before we
         // dereference the array.
@@ -452,11 +484,43 @@ public:
     opj_image_t* getImage() { return image; }
 
 private:
+    // <AS:Chanayane> Threaded J2C decode
+    // Borrow helper threads from the decode core budget and let the codec
+    // spread the code-blocks of each tile over them. Needs to happen before
+    // opj_read_header().
+    void setupHelpers(S32 wanted)
+    {
+#if LL_OPJ_DECODE_THREADS
+        if (wanted > 0 && opj_has_thread_support())
+        {
+            S32 granted = LLImageJ2C::acquireDecodeHelpers(wanted);
+            // The calling thread only waits for the codec's own threads
+            if (granted && opj_codec_set_threads(decoder, granted + 1))
+            {
+                held_helpers = granted;
+                return;
+            }
+            LLImageJ2C::releaseDecodeHelpers(granted);
+        }
+#endif
+    }
+
+    void releaseHelpers()
+    {
+        LLImageJ2C::releaseDecodeHelpers(held_helpers);
+        held_helpers = 0;
+    }
+    // </AS:Chanayane>
+
     opj_dparameters_t         parameters;
     opj_image_t*              image = nullptr;
     opj_codec_t*              decoder = nullptr;
     opj_stream_t*             stream = nullptr;
     opj_codestream_info_v2_t* codestream_info = nullptr;
+
+    // <AS:Chanayane> Threaded J2C decode
+    S32                       held_helpers = 0;   // borrowed from the decode core budget
+    // </AS:Chanayane>
 };
 
 class JPEG2KEncode : public JPEG2KBase
@@ -500,6 +564,8 @@ public:
 
     ~JPEG2KEncode()
     {
+        LLImageJ2C::releaseDecodeHelpers(helpers); // <AS:Chanayane/> Parallel upload encode
+
         if (encoder)
         {
             opj_destroy_codec(encoder);
@@ -583,6 +649,13 @@ public:
             return false;
         }
 
+        // <AS:Chanayane> Parallel upload encode
+        // Large uploads borrow helper threads from the same core budget as
+        // decodes, the codec spreads code-blocks over them.
+        S64 pixels = (S64)rawImageIn.getWidth() * rawImageIn.getHeight();
+        setupHelpers(pixels >= 4 * DECODE_HELPER_PIXELS ? MAX_DECODE_HELPERS : (pixels >= DECODE_HELPER_PIXELS ? 1 : 0));
+        // </AS:Chanayane>
+
         U32 tile_count = width_tiles * height_tiles;
         U32 data_size_guess = tile_count * TILE_SIZE;
 
@@ -773,11 +846,30 @@ public:
     opj_image_t* getImage() { return image; }
 
 private:
+    // <AS:Chanayane> Parallel upload encode
+    void setupHelpers(S32 wanted)
+    {
+#if LL_OPJ_ENCODE_THREADS
+        if (wanted > 0 && opj_has_thread_support())
+        {
+            S32 granted = LLImageJ2C::acquireDecodeHelpers(wanted);
+            if (granted && opj_codec_set_threads(encoder, granted + 1))
+            {
+                helpers = granted;
+                return;
+            }
+            LLImageJ2C::releaseDecodeHelpers(granted);
+        }
+#endif
+    }
+    // </AS:Chanayane>
+
     opj_cparameters_t   parameters;
     opj_image_t*        image = nullptr;
     opj_codec_t*        encoder = nullptr;
     opj_stream_t*       stream = nullptr;
     char*               comment_text = nullptr;
+    S32                 helpers = 0; // <AS:Chanayane/> Parallel upload encode
 };
 
 
@@ -855,7 +947,13 @@ bool LLImageJ2COJ::decodeImpl(LLImageJ2C &base, LLImageRaw &raw_image, F32 decod
     U32 image_channels = 0;
     S32 data_size = base.getDataSize();
     S32 max_bytes = (base.getMaxBytes() ? base.getMaxBytes() : data_size);
-    bool decoded = decoder.decode(base.getData(), max_bytes, &image_channels, base.mDiscardLevel);
+    // <AS:Chanayane> Threaded J2C decode
+    //bool decoded = decoder.decode(base.getData(), max_bytes, &image_channels, base.mDiscardLevel);
+    S32 level = llmax((S32)base.mDiscardLevel, 0);
+    S64 pixels = (S64)(base.getWidth() >> level) * (S64)(base.getHeight() >> level);
+    S32 wanted_helpers = pixels >= 4 * DECODE_HELPER_PIXELS ? MAX_DECODE_HELPERS : (pixels >= DECODE_HELPER_PIXELS ? 1 : 0);
+    bool decoded = decoder.decode(base.getData(), max_bytes, &image_channels, base.mDiscardLevel, wanted_helpers);
+    // </AS:Chanayane>
 
     // set correct channel count early so failed decodes don't miss it...
     S32 channels = (S32)image_channels - first_channel;
@@ -2324,7 +2324,7 @@ bool LLVolume::unpackVolumeFaces(std::istream& is, S32 size)
     return unpackVolumeFacesInternal(mdl);
 }
 
-bool LLVolume::unpackVolumeFaces(U8* in_data, S32 size)
+bool LLVolume::unpackVolumeFaces(const U8* in_data, S32 size)
 {
     //input data is now pointing at a zlib compressed block of LLSD
     //decompress block
@@ -2731,6 +2731,234 @@ bool LLVolume::unpackVolumeFacesInternal(const LLSD& mdl)
 }
 
 
+// <AS:Chanayane> Pre-optimized mesh LOD cache
+namespace
+{
+    const U32 OPTIMIZED_FACES_MAGIC = 0x4F56534C; // "LSVO"
+    const U32 OPTIMIZED_FACES_VERSION = 1;
+
+    const U32 OPTIMIZED_FACE_TANGENTS = 0x1;
+    const U32 OPTIMIZED_FACE_WEIGHTS = 0x2;
+    const U32 OPTIMIZED_FACE_WEIGHTS_SCRUBBED = 0x4;
+
+    struct OptimizedFacesHeader
+    {
+        U32 mMagic;
+        U32 mVersion;
+        U32 mNumFaces;
+        U32 mPad;
+    };
+
+    // Followed by the position/normal/texture coordinate block exactly as
+    // resizeVertices() allocates it, then tangents, weights and the index
+    // block as resizeIndices() allocates it. Every block is a multiple of
+    // 16 bytes long.
+    struct OptimizedFaceHeader
+    {
+        S32 mNumVertices;
+        S32 mNumIndices;
+        U32 mFlags;
+        U32 mPad;
+        F32 mExtents[3][4];         // min, max, center
+        F32 mTexCoordExtents[2][2];
+        F32 mNormalizedScale[4];
+    };
+
+    static_assert(sizeof(OptimizedFacesHeader) % 16 == 0, "OptimizedFacesHeader must keep blocks aligned");
+    static_assert(sizeof(OptimizedFaceHeader) % 16 == 0, "OptimizedFaceHeader must keep blocks aligned");
+
+    size_t vertex_block_size(S32 num_verts)
+    {
+        return sizeof(LLVector4a) * 2 * num_verts + (((num_verts * sizeof(LLVector2)) + 0xF) & ~0xF);
+    }
+
+    size_t index_block_size(S32 num_indices)
+    {
+        return ((num_indices * sizeof(U16)) + 0xF) & ~0xF;
+    }
+}
+
+bool LLVolume::packOptimizedFaces(std::vector<U8>& out) const
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    size_t total = sizeof(OptimizedFacesHeader);
+    for (const LLVolumeFace& face : mVolumeFaces)
+    {
+        if (face.mNumVertices && (!face.mPositions || face.mTexCoords != (LLVector2*)(face.mNormals + face.mNumVertices)))
+        {
+            // Not laid out by resizeVertices(), cannot be stored as one block
+            return false;
+        }
+        total += sizeof(OptimizedFaceHeader) + vertex_block_size(face.mNumVertices) + index_block_size(face.mNumIndices);
+        if (face.mTangents)
+        {
+            total += sizeof(LLVector4a) * face.mNumVertices;
+        }
+        if (face.mWeights)
+        {
+            total += sizeof(LLVector4a) * face.mNumVertices;
+        }
+    }
+
+    out.assign(total, 0);
+    U8* dst = out.data();
+
+    OptimizedFacesHeader header = { OPTIMIZED_FACES_MAGIC, OPTIMIZED_FACES_VERSION, (U32)mVolumeFaces.size(), 0 };
+    memcpy(dst, &header, sizeof(header));
+    dst += sizeof(header);
+
+    for (const LLVolumeFace& face : mVolumeFaces)
+    {
+        OptimizedFaceHeader face_header;
+        memset(&face_header, 0, sizeof(face_header));
+        face_header.mNumVertices = face.mNumVertices;
+        face_header.mNumIndices = face.mNumIndices;
+        face_header.mFlags = (face.mTangents ? OPTIMIZED_FACE_TANGENTS : 0)
+            | (face.mWeights ? OPTIMIZED_FACE_WEIGHTS : 0)
+            | (face.mWeightsScrubbed ? OPTIMIZED_FACE_WEIGHTS_SCRUBBED : 0);
+        for (S32 i = 0; i < 3; ++i)
+        {
+            face.mExtents[i].store4a(face_header.mExtents[i]);
+        }
+        for (S32 i = 0; i < 2; ++i)
+        {
+            face_header.mTexCoordExtents[i][0] = face.mTexCoordExtents[i].mV[VX];
+            face_header.mTexCoordExtents[i][1] = face.mTexCoordExtents[i].mV[VY];
+        }
+        face_header.mNormalizedScale[0] = face.mNormalizedScale.mV[VX];
+        face_header.mNormalizedScale[1] = face.mNormalizedScale.mV[VY];
+        face_header.mNormalizedScale[2] = face.mNormalizedScale.mV[VZ];
+        memcpy(dst, &face_header, sizeof(face_header));
+        dst += sizeof(face_header);
+
+        size_t size = vertex_block_size(face.mNumVertices);
+        if (size)
+        {
+            memcpy(dst, face.mPositions, size);
+            dst += size;
+        }
+        size = sizeof(LLVector4a) * face.mNumVertices;
+        if (face.mTangents)
+        {
+            memcpy(dst, face.mTangents, size);
+            dst += size;
+        }
+        if (face.mWeights)
+        {
+            memcpy(dst, face.mWeights, size);
+            dst += size;
+        }
+        size = index_block_size(face.mNumIndices);
+        if (size)
+        {
+            memcpy(dst, face.mIndices, face.mNumIndices * sizeof(U16));
+            dst += size;
+        }
+    }
+
+    llassert(dst == out.data() + out.size());
+    return true;
+}
+
+bool LLVolume::unpackOptimizedFaces(const U8* data, size_t size)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    const U8* end = data + size;
+    OptimizedFacesHeader header;
+    if (!data || size < sizeof(header))
+    {
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    data += sizeof(header);
+    if (header.mMagic != OPTIMIZED_FACES_MAGIC || header.mVersion != OPTIMIZED_FACES_VERSION
+        || header.mNumFaces == 0 || header.mNumFaces > (U32)(end - data) / sizeof(OptimizedFaceHeader))
+    {
+        return false;
+    }
+
+    mVolumeFaces.clear();
+    mVolumeFaces.resize(header.mNumFaces);
+
+    for (LLVolumeFace& face : mVolumeFaces)
+    {
+        OptimizedFaceHeader face_header;
+        if ((size_t)(end - data) < sizeof(face_header))
+        {
+            mVolumeFaces.clear();
+            return false;
+        }
+        memcpy(&face_header, data, sizeof(face_header));
+        data += sizeof(face_header);
+
+        S32 num_verts = face_header.mNumVertices;
+        S32 num_indices = face_header.mNumIndices;
+        size_t vert_size = sizeof(LLVector4a) * llmax(num_verts, 0);
+        size_t needed = vertex_block_size(num_verts) + index_block_size(num_indices)
+            + ((face_header.mFlags & OPTIMIZED_FACE_TANGENTS) ? vert_size : 0)
+            + ((face_header.mFlags & OPTIMIZED_FACE_WEIGHTS) ? vert_size : 0);
+        if (num_verts < 0 || num_verts > 65536 || num_indices < 0 || num_indices % 3
+            || needed > (size_t)(end - data))
+        {
+            mVolumeFaces.clear();
+            return false;
+        }
+
+        face.resizeVertices(num_verts);
+        face.resizeIndices(num_indices);
+        if ((num_verts && !face.mPositions) || (num_indices && !face.mIndices))
+        {
+            LL_WARNS() << "Failed to allocate " << num_verts << " vertices and " << num_indices << " indices" << LL_ENDL;
+            mVolumeFaces.clear();
+            return false;
+        }
+
+        size_t block = vertex_block_size(num_verts);
+        if (block)
+        {
+            memcpy(face.mPositions, data, block);
+            data += block;
+        }
+        if (face_header.mFlags & OPTIMIZED_FACE_TANGENTS)
+        {
+            face.allocateTangents(num_verts);
+            memcpy(face.mTangents, data, vert_size);
+            data += vert_size;
+        }
+        if (face_header.mFlags & OPTIMIZED_FACE_WEIGHTS)
+        {
+            face.allocateWeights(num_verts);
+            memcpy(face.mWeights, data, vert_size);
+            data += vert_size;
+        }
+        face.mWeightsScrubbed = (face_header.mFlags & OPTIMIZED_FACE_WEIGHTS_SCRUBBED) != 0;
+        block = index_block_size(num_indices);
+        if (block)
+        {
+            memcpy(face.mIndices, data, num_indices * sizeof(U16));
+            data += block;
+        }
+
+        for (S32 i = 0; i < 3; ++i)
+        {
+            face.mExtents[i].load4a(face_header.mExtents[i]);
+        }
+        for (S32 i = 0; i < 2; ++i)
+        {
+            face.mTexCoordExtents[i].set(face_header.mTexCoordExtents[i][0], face_header.mTexCoordExtents[i][1]);
+        }
+        face.mNormalizedScale.set(face_header.mNormalizedScale[0], face_header.mNormalizedScale[1], face_header.mNormalizedScale[2]);
+        face.mOptimized = true;
+    }
+
+    mSculptLevel = 0;  // success!
+
+    return true;
+}
+// </AS:Chanayane>
+
 bool LLVolume::isMeshAssetLoaded() const
 {
     return mIsMeshAssetLoaded;
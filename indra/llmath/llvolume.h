@@ -1125,7 +1125,15 @@ protected:
     void createVolumeFaces();
 public:
     bool unpackVolumeFaces(std::istream& is, S32 size);
-    bool unpackVolumeFaces(U8* in_data, S32 size);
+    bool unpackVolumeFaces(const U8* in_data, S32 size); // <AS:Chanayane/> Memory-mapped reads: accept read-only data
+
+    // <AS:Chanayane> Pre-optimized mesh LOD cache
+    // Serialize the faces as unpackVolumeFaces() leaves them (dequantized,
+    // tangents generated and cache optimized) in their in-memory layout, so
+    // that unpackOptimizedFaces() only has to copy the arrays back.
+    bool packOptimizedFaces(std::vector<U8>& out) const;
+    bool unpackOptimizedFaces(const U8* data, size_t size);
+    // </AS:Chanayane>
 private:
     bool unpackVolumeFacesInternal(const LLSD& mdl);
 
@@ -353,9 +353,15 @@ S32 LLCircuitData::resendUnackedPackets(const F64Seconds now)
 
             packetp->mBuffer[0] |= LL_RESENT_FLAG;  // tag packet id as being a resend
 
-            gMessageSystem->mPacketRing.sendPacket(packetp->mSocket,
+            // <AS:Chanayane> Batched UDP receive and send
+            // Sent together by LLCircuit::resendUnackedPackets()
+            //gMessageSystem->mPacketRing.sendPacket(packetp->mSocket,
+            //                                   (char *)packetp->mBuffer, packetp->mBufferLength,
+            //                                   packetp->mHost);
+            gMessageSystem->mPacketRing.queuePacket(packetp->mSocket,
                                                (char *)packetp->mBuffer, packetp->mBufferLength,
                                                packetp->mHost);
+            // </AS:Chanayane>
 
             mThrottles.throttleOverflow(TC_RESEND, packetp->mBufferLength * 8.f);
 
@@ -602,6 +608,7 @@ void LLCircuit::resendUnackedPackets(S32& unacked_list_length, S32& unacked_list
         unacked_list_length += circ->resendUnackedPackets(now);
         unacked_list_size += circ->getUnackedPacketBytes();
     }
+    gMessageSystem->mPacketRing.sendQueuedPackets(); // <AS:Chanayane/> Batched UDP receive and send
 }
 
 
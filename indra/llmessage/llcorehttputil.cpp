@@ -594,15 +594,22 @@ LLSD HttpCoroJSONHandler::handleSuccess(LLCore::HttpResponse * response, LLCore:
     LLCore::BufferArrayStream bas(body);
 
     boost::system::error_code ec;
-    boost::json::value jsonRoot = boost::json::parse(bas, ec);
-    if(ec.failed())
+    // <AS:Chanayane> Streaming JSON conversion
+    //boost::json::value jsonRoot = boost::json::parse(bas, ec);
+    //if(ec.failed())
+    //{   // deserialization failed.  Record the reason and pass back an empty map for markup.
+    //    status = LLCore::HttpStatus(499, std::string(ec.what()));
+    //    return result;
+    //}
+
+    //// Convert the JSON structure to LLSD
+    //result = LlsdFromJson(jsonRoot);
+    if (!LlsdFromJsonStream(bas, result, ec))
     {   // deserialization failed.  Record the reason and pass back an empty map for markup.
         status = LLCore::HttpStatus(499, std::string(ec.what()));
-        return result;
+        return LLSD::emptyMap();
     }
-
-    // Convert the JSON structure to LLSD
-    result = LlsdFromJson(jsonRoot);
+    // </AS:Chanayane>
 
     return result;
 }
@@ -619,15 +626,20 @@ LLSD HttpCoroJSONHandler::parseBody(LLCore::HttpResponse *response, bool &succes
     LLCore::BufferArrayStream bas(body);
 
     boost::system::error_code ec;
-    boost::json::value jsonRoot = boost::json::parse(bas, ec);
-    if (ec.failed())
-    {
-        success = false;
-        return LLSD();
-    }
-
-    // Convert the JSON structure to LLSD
-    return LlsdFromJson(jsonRoot);
+    // <AS:Chanayane> Streaming JSON conversion
+    //boost::json::value jsonRoot = boost::json::parse(bas, ec);
+    //if (ec.failed())
+    //{
+    //    success = false;
+    //    return LLSD();
+    //}
+
+    //// Convert the JSON structure to LLSD
+    //return LlsdFromJson(jsonRoot);
+    LLSD result;
+    success = LlsdFromJsonStream(bas, result, ec);
+    return result;
+    // </AS:Chanayane>
 }
 
 //========================================================================
@@ -803,8 +815,11 @@ LLSD HttpCoroutineAdapter::postJsonAndSuspend(LLCore::HttpRequest::ptr_t request
 
     {
         LLCore::BufferArrayStream outs(rawbody.get());
-        auto root = LlsdToJson(body);
-        std::string value = boost::json::serialize(root);
+        // <AS:Chanayane> Streaming JSON conversion
+        //auto root = LlsdToJson(body);
+        //std::string value = boost::json::serialize(root);
+        std::string value = LlsdToJsonString(body);
+        // </AS:Chanayane>
 
         LL_WARNS("Http::post") << "JSON Generates: \"" << value << "\"" << LL_ENDL;
 
@@ -862,8 +877,11 @@ LLSD HttpCoroutineAdapter::putJsonAndSuspend(LLCore::HttpRequest::ptr_t request,
 
     {
         LLCore::BufferArrayStream outs(rawbody.get());
-        auto root = LlsdToJson(body);
-        std::string value = boost::json::serialize(root);
+        // <AS:Chanayane> Streaming JSON conversion
+        //auto root = LlsdToJson(body);
+        //std::string value = boost::json::serialize(root);
+        std::string value = LlsdToJsonString(body);
+        // </AS:Chanayane>
 
         LL_WARNS("Http::put") << "JSON Generates: \"" << value << "\"" << LL_ENDL;
         outs << value;
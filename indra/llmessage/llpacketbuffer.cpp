@@ -67,6 +67,36 @@ void LLPacketBuffer::init(S32 hSocket)
     mReceivingIF = ::get_receiving_interface();
 }
 
+// <AS:Chanayane> Batched UDP receive and send
+// static
+S32 LLPacketBuffer::initBatch(S32 hSocket, LLPacketBuffer * const * packets, S32 count)
+{
+#if LL_LINUX
+    char* buffers[NET_BATCH_SIZE];
+    S32 sizes[NET_BATCH_SIZE];
+    LLHost senders[NET_BATCH_SIZE];
+    LLHost receiving_ifs[NET_BATCH_SIZE];
+
+    count = llmin(count, NET_BATCH_SIZE);
+    for (S32 i = 0; i < count; ++i)
+    {
+        buffers[i] = packets[i]->mData;
+    }
+
+    S32 received = receive_packets(hSocket, buffers, sizes, senders, receiving_ifs, count);
+    for (S32 i = 0; i < received; ++i)
+    {
+        packets[i]->mSize = sizes[i];
+        packets[i]->mHost = senders[i];
+        packets[i]->mReceivingIF = receiving_ifs[i];
+    }
+    return received;
+#else
+    return -1;
+#endif
+}
+// </AS:Chanayane>
+
 void LLPacketBuffer::init(const char* buffer, S32 data_size, const LLHost& host)
 {
     if (data_size > NET_BUFFER_SIZE)
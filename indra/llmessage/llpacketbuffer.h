@@ -46,6 +46,12 @@ public:
     void init(S32 hSocket);
     void init(const char* buffer, S32 data_size, const LLHost& host);
 
+    // <AS:Chanayane> Batched UDP receive and send
+    // Receives up to 'count' packets with one system call.  Returns the
+    // number received, or -1 if batched receive is not available.
+    static S32 initBatch(S32 hSocket, LLPacketBuffer * const * packets, S32 count);
+    // </AS:Chanayane>
+
 protected:
     char    mData[NET_BUFFER_SIZE]; // packet data       /* Flawfinder : ignore */
     S32     mSize;                  // size of buffer in bytes
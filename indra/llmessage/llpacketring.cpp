@@ -54,6 +54,7 @@ LLPacketRing::LLPacketRing ()
     {
         mPacketRing[i] = new LLPacketBuffer(invalid_host, nullptr, 0);
     }
+    mSparePacket = new LLPacketBuffer(invalid_host, nullptr, 0); // <AS:Chanayane/> Batched UDP receive and send
 }
 
 LLPacketRing::~LLPacketRing ()
@@ -63,6 +64,10 @@ LLPacketRing::~LLPacketRing ()
         delete packet;
     }
     mPacketRing.clear();
+    // <AS:Chanayane> Batched UDP receive and send
+    delete mSparePacket;
+    mSparePacket = nullptr;
+    // </AS:Chanayane>
     mNumBufferedPackets = 0;
     mNumBufferedBytes = 0;
     mHeadIndex = 0;
@@ -274,11 +279,16 @@ S32 LLPacketRing::bufferInboundPacket(S32 socket)
     }
     else
     {
-        packet->init(socket);
-        packet_size = packet->getSize();
+        // <AS:Chanayane> Batched UDP receive and send
+        //packet->init(socket);
+        //packet_size = packet->getSize();
+        mSparePacket->init(socket);
+        packet_size = mSparePacket->getSize();
+        // </AS:Chanayane>
         if (packet_size > 0)
         {
             mActualBytesIn += packet_size;
+            std::swap(mPacketRing[mHeadIndex], mSparePacket); // <AS:Chanayane/> Batched UDP receive and send
 
             mHeadIndex = (mHeadIndex + 1) % (S16)(mPacketRing.size());
             if (mNumBufferedPackets < MAX_BUFFER_RING_SIZE)
@@ -296,8 +306,104 @@ S32 LLPacketRing::bufferInboundPacket(S32 socket)
     return packet_size;
 }
 
+// <AS:Chanayane> Batched UDP receive and send
+S32 LLPacketRing::bufferInboundPackets(S32 socket)
+{
+    if (mNumBufferedPackets == mPacketRing.size() && mNumBufferedPackets < MAX_BUFFER_RING_SIZE)
+    {
+        expandRing();
+    }
+
+    // receive into the slots following mHeadIndex; when the ring is maxed
+    // out these hold the oldest buffered packets, which get overwritten
+    S16 ring_size = (S16)(mPacketRing.size());
+    bool overwriting = (mNumBufferedPackets == ring_size);
+    S32 count = llmin(overwriting ? (S32)ring_size : (S32)(ring_size - mNumBufferedPackets), NET_BATCH_SIZE);
+
+    LLPacketBuffer* packets[NET_BATCH_SIZE];
+    S32 old_sizes[NET_BATCH_SIZE];
+    for (S32 i = 0; i < count; ++i)
+    {
+        packets[i] = mPacketRing[(mHeadIndex + i) % ring_size];
+        old_sizes[i] = packets[i]->getSize();
+    }
+
+    S32 received = LLPacketBuffer::initBatch(socket, packets, count);
+    if (received <= 0)
+    {
+        return received;
+    }
+
+    // keep the non-empty packets contiguous after mHeadIndex
+    S32 stored = 0;
+    S32 stored_bytes = 0;
+    for (S32 i = 0; i < received; ++i)
+    {
+        S32 packet_size = packets[i]->getSize();
+        if (packet_size > 0)
+        {
+            mActualBytesIn += packet_size;
+            stored_bytes += packet_size;
+            if (stored != i)
+            {
+                std::swap(mPacketRing[(mHeadIndex + stored) % ring_size], mPacketRing[(mHeadIndex + i) % ring_size]);
+            }
+            ++stored;
+        }
+    }
+
+    if (overwriting)
+    {
+        // we overwrote the 'received' oldest packets
+        for (S32 i = 0; i < received; ++i)
+        {
+            mNumBufferedBytes -= old_sizes[i];
+        }
+        mNumBufferedPackets = ring_size - (S16)(received - stored);
+    }
+    else
+    {
+        mNumBufferedPackets += (S16)stored;
+    }
+    mNumBufferedBytes += stored_bytes;
+    mHeadIndex = (mHeadIndex + stored) % ring_size;
+    return stored;
+}
+// </AS:Chanayane>
+
 S32 LLPacketRing::drainSocket(S32 socket)
 {
+    // <AS:Chanayane> Batched UDP receive and send
+    if (mBatchedIO && !LLProxy::isSOCKSProxyEnabled())
+    {
+        S32 old_num_packets = mNumBufferedPackets;
+        S32 num_received = 0;
+        S32 num_stored = 1;
+        while (num_stored > 0)
+        {
+            num_stored = bufferInboundPackets(socket);
+            if (num_stored > 0)
+            {
+                num_received += num_stored;
+            }
+        }
+        if (num_stored == 0)
+        {
+            S32 num_dropped_packets = (num_received + old_num_packets) - mNumBufferedPackets;
+            if (num_dropped_packets > 0)
+            {
+                mNumDroppedPackets += num_dropped_packets;
+            }
+            return (S32)(mNumBufferedPackets);
+        }
+
+        // no recvmmsg() here, finish with one packet at a time
+        LL_INFOS("Messaging") << "Batched UDP receive not available, disabling batched I/O" << LL_ENDL;
+        setBatchedIO(false);
+        mNumDroppedPackets += llmax((num_received + old_num_packets) - mNumBufferedPackets, 0);
+    }
+    // </AS:Chanayane>
+
     // drain into buffer
     S32 packet_size = 1;
     S32 num_loops = 0;
@@ -317,6 +423,69 @@ S32 LLPacketRing::drainSocket(S32 socket)
     return (S32)(mNumBufferedPackets);
 }
 
+// <AS:Chanayane> Batched UDP receive and send
+bool LLPacketRing::queuePacket(int socket, const char * datap, S32 data_size, LLHost host)
+{
+#if LL_LINUX
+    if (mBatchedIO && !LLProxy::isSOCKSProxyEnabled() && data_size <= NET_BUFFER_SIZE)
+    {
+        if (mNumQueuedPackets > 0 && socket != mQueuedSocket)
+        {
+            sendQueuedPackets();
+        }
+        if (mSendSlab.empty())
+        {
+            mSendSlab.resize(NET_BATCH_SIZE * NET_BUFFER_SIZE);
+        }
+
+        memcpy(&mSendSlab[mNumQueuedPackets * NET_BUFFER_SIZE], datap, data_size);
+        mQueuedSizes[mNumQueuedPackets] = data_size;
+        mQueuedHosts[mNumQueuedPackets] = host;
+        mQueuedSocket = socket;
+        mActualBytesOut += data_size;
+
+        if (++mNumQueuedPackets == NET_BATCH_SIZE)
+        {
+            sendQueuedPackets();
+        }
+        return true;
+    }
+    sendQueuedPackets();
+#endif
+    return sendPacket(socket, datap, data_size, host);
+}
+
+void LLPacketRing::sendQueuedPackets()
+{
+#if LL_LINUX
+    if (mNumQueuedPackets == 0)
+    {
+        return;
+    }
+
+    const char* buffers[NET_BATCH_SIZE];
+    for (S32 i = 0; i < mNumQueuedPackets; ++i)
+    {
+        buffers[i] = &mSendSlab[i * NET_BUFFER_SIZE];
+    }
+    send_packets(mQueuedSocket, buffers, mQueuedSizes, mQueuedHosts, mNumQueuedPackets);
+    mNumQueuedPackets = 0;
+#endif
+}
+
+void LLPacketRing::setBatchedIO(bool enabled)
+{
+#if ! LL_LINUX
+    enabled = false;
+#endif
+    if (!enabled)
+    {
+        sendQueuedPackets();
+    }
+    mBatchedIO = enabled;
+}
+// </AS:Chanayane>
+
 bool LLPacketRing::expandRing()
 {
     // compute larger size
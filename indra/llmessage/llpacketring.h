@@ -49,6 +49,19 @@ public:
     // drains packets from socket and returns final mNumBufferedPackets
     S32 drainSocket(S32 socket);
 
+    // <AS:Chanayane> Batched UDP receive and send
+    // queue one packet to be sent by the next sendQueuedPackets(); the data
+    // is copied so the caller's buffer may go away.  Sends at once when
+    // batched sends are not available.
+    bool queuePacket(int h_socket, const char * send_buffer, S32 buf_size, LLHost host);
+
+    // send everything queued by queuePacket()
+    void sendQueuedPackets();
+
+    void setBatchedIO(bool enabled);
+    bool getBatchedIO() const { return mBatchedIO; }
+    // </AS:Chanayane>
+
     void dropPackets(U32);
     void setDropPercentage (F32 percent_to_drop);
 
@@ -77,6 +90,12 @@ protected:
     // returns packet_size of packet buffered
     S32 bufferInboundPacket(S32 socket);
 
+    // <AS:Chanayane> Batched UDP receive and send
+    // returns number of packets buffered by one batched receive, -1 if
+    // batched receive is not available
+    S32 bufferInboundPackets(S32 socket);
+    // </AS:Chanayane>
+
     // returns 'true' if ring was expanded
     bool expandRing();
 
@@ -96,6 +115,28 @@ protected:
     // These are the sender and receiving_interface for the last packet delivered by receivePacket()
     LLHost mLastSender;
     LLHost mLastReceivingIF;
+
+    // <AS:Chanayane> Batched UDP receive and send
+    // recvmmsg() and sendmmsg() are Linux only
+#if LL_LINUX
+    bool mBatchedIO { true };
+#else
+    bool mBatchedIO { false };
+#endif
+
+    // bufferInboundPacket() receives here and swaps the packet into the
+    // ring, so that the empty receive ending a drain does not clobber the
+    // oldest packet of a maxed out ring
+    LLPacketBuffer* mSparePacket { nullptr };
+
+    // outbound packets waiting for sendQueuedPackets(), NET_BUFFER_SIZE
+    // bytes of mSendSlab each
+    std::vector<char> mSendSlab;
+    S32 mQueuedSizes[NET_BATCH_SIZE];
+    LLHost mQueuedHosts[NET_BATCH_SIZE];
+    S32 mNumQueuedPackets { 0 };
+    int mQueuedSocket { -1 };
+    // </AS:Chanayane>
 };
 
 
@@ -517,6 +517,26 @@ void end_net(S32& socket_out)
 }
 
 #if LL_LINUX
+// <AS:Chanayane> Batched UDP receive and send
+static void get_pktinfo_destip(struct msghdr *msg, U32 *dstip)
+{
+    for (struct cmsghdr *cmsgptr = CMSG_FIRSTHDR(msg); cmsgptr != NULL; cmsgptr = CMSG_NXTHDR(msg, cmsgptr))
+    {
+        if( cmsgptr->cmsg_level == SOL_IP && cmsgptr->cmsg_type == IP_PKTINFO )
+        {
+            in_pktinfo *pktinfo = (in_pktinfo *)CMSG_DATA(cmsgptr);
+            if( pktinfo )
+            {
+                // Two choices. routed and specified. ipi_addr is routed, ipi_spec_dst is
+                // routed. We should stay with specified until we go to multiple
+                // interfaces
+                *dstip = pktinfo->ipi_spec_dst.s_addr;
+            }
+        }
+    }
+}
+// </AS:Chanayane>
+
 static int recvfrom_destip( int socket, void *buf, int len, struct sockaddr *from, socklen_t *fromlen, U32 *dstip )
 {
     int size;
@@ -543,23 +563,127 @@ static int recvfrom_destip( int socket, void *buf, int len, struct sockaddr *fro
         return -1;
     }
 
-    for (cmsgptr = CMSG_FIRSTHDR(&msg); cmsgptr != NULL; cmsgptr = CMSG_NXTHDR( &msg, cmsgptr))
+    // <AS:Chanayane> Batched UDP receive and send
+    // Shared with receive_packets()
+    //for (cmsgptr = CMSG_FIRSTHDR(&msg); cmsgptr != NULL; cmsgptr = CMSG_NXTHDR( &msg, cmsgptr))
+    //{
+    //    if( cmsgptr->cmsg_level == SOL_IP && cmsgptr->cmsg_type == IP_PKTINFO )
+    //    {
+    //        in_pktinfo *pktinfo = (in_pktinfo *)CMSG_DATA(cmsgptr);
+    //        if( pktinfo )
+    //        {
+    //            // Two choices. routed and specified. ipi_addr is routed, ipi_spec_dst is
+    //            // routed. We should stay with specified until we go to multiple
+    //            // interfaces
+    //            *dstip = pktinfo->ipi_spec_dst.s_addr;
+    //        }
+    //    }
+    //}
+    get_pktinfo_destip(&msg, dstip);
+    // </AS:Chanayane>
+
+    return size;
+}
+
+// <AS:Chanayane> Batched UDP receive and send
+S32 receive_packets(int hSocket, char * const * buffers, S32 * sizes, LLHost * senders, LLHost * receiving_ifs, S32 count)
+{
+    count = llclamp(count, 0, NET_BATCH_SIZE);
+    if (!count)
     {
-        if( cmsgptr->cmsg_level == SOL_IP && cmsgptr->cmsg_type == IP_PKTINFO )
+        return 0;
+    }
+
+    struct mmsghdr msgs[NET_BATCH_SIZE];
+    struct iovec iovs[NET_BATCH_SIZE];
+    struct sockaddr_in addrs[NET_BATCH_SIZE];
+    char cmsgs[NET_BATCH_SIZE][CMSG_SPACE(sizeof(struct in_pktinfo))];
+
+    memset(msgs, 0, sizeof(msgs[0]) * count);
+    for (S32 i = 0; i < count; ++i)
+    {
+        iovs[i].iov_base = buffers[i];
+        iovs[i].iov_len = NET_BUFFER_SIZE;
+        msgs[i].msg_hdr.msg_name = &addrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_control = cmsgs[i];
+        msgs[i].msg_hdr.msg_controllen = sizeof(cmsgs[i]);
+    }
+
+    int received = recvmmsg(hSocket, msgs, count, MSG_DONTWAIT, NULL);
+    if (received < 0)
+    {
+        // EAGAIN and friends just mean the socket is drained
+        return (errno == ENOSYS) ? -1 : 0;
+    }
+
+    for (S32 i = 0; i < received; ++i)
+    {
+        U32 dstip = INVALID_HOST_IP_ADDRESS;
+        get_pktinfo_destip(&msgs[i].msg_hdr, &dstip);
+        sizes[i] = (S32)msgs[i].msg_len;
+        senders[i] = LLHost(addrs[i].sin_addr.s_addr, ntohs(addrs[i].sin_port));
+        receiving_ifs[i] = LLHost(dstip, INVALID_PORT);
+    }
+    return received;
+}
+
+S32 send_packets(int hSocket, const char * const * buffers, const S32 * sizes, const LLHost * recipients, S32 count)
+{
+    static bool sendmmsg_supported = true;
+
+    struct mmsghdr msgs[NET_BATCH_SIZE];
+    struct iovec iovs[NET_BATCH_SIZE];
+    struct sockaddr_in addrs[NET_BATCH_SIZE];
+
+    S32 sent = 0;
+    while (sent < count && sendmmsg_supported)
+    {
+        const S32 batch = llmin(count - sent, NET_BATCH_SIZE);
+        memset(msgs, 0, sizeof(msgs[0]) * batch);
+        memset(addrs, 0, sizeof(addrs[0]) * batch);
+        for (S32 i = 0; i < batch; ++i)
         {
-            in_pktinfo *pktinfo = (in_pktinfo *)CMSG_DATA(cmsgptr);
-            if( pktinfo )
+            const LLHost& recipient = recipients[sent + i];
+            addrs[i].sin_family = AF_INET;
+            addrs[i].sin_addr.s_addr = recipient.getAddress();
+            addrs[i].sin_port = htons(recipient.getPort());
+            iovs[i].iov_base = const_cast<char *>(buffers[sent + i]);
+            iovs[i].iov_len = sizes[sent + i];
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int ret = sendmmsg(hSocket, msgs, batch, MSG_DONTWAIT);
+        if (ret <= 0)
+        {
+            if (ret < 0 && errno == ENOSYS)
             {
-                // Two choices. routed and specified. ipi_addr is routed, ipi_spec_dst is
-                // routed. We should stay with specified until we go to multiple
-                // interfaces
-                *dstip = pktinfo->ipi_spec_dst.s_addr;
+                LL_INFOS() << "sendmmsg() not available, sending one packet at a time" << LL_ENDL;
+                sendmmsg_supported = false;
             }
+            break;
         }
+        sent += ret;
     }
 
-    return size;
+    // The datagram sendmmsg() stopped at (full buffer, ICMP error
+    // reported on the socket, ...) and the ones after it
+    S32 succeeded = sent;
+    for (; sent < count; ++sent)
+    {
+        if (send_packet(hSocket, buffers[sent], sizes[sent], recipients[sent].getAddress(), recipients[sent].getPort()))
+        {
+            ++succeeded;
+        }
+    }
+    return succeeded;
 }
+// </AS:Chanayane>
 #endif
 
 int receive_packet(int hSocket, char * receiveBuffer)
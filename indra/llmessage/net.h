@@ -45,6 +45,26 @@ S32     receive_packet(int hSocket, char * receiveBuffer);
 
 bool    send_packet(int hSocket, const char *sendBuffer, int size, U32 recipient, int nPort);   // Returns true on success.
 
+// <AS:Chanayane> Batched UDP receive and send
+// Most datagrams moved by one recvmmsg() or sendmmsg() call
+const S32 NET_BATCH_SIZE = 64;
+
+#if LL_LINUX
+
+// Receives up to 'count' datagrams (at most NET_BATCH_SIZE) with a single
+// recvmmsg() call, each into a buffer of NET_BUFFER_SIZE bytes.  Sizes,
+// senders and receiving interfaces are returned per datagram.  Returns the
+// number of datagrams received, 0 if none were waiting, or -1 if the kernel
+// has no recvmmsg().
+S32     receive_packets(int hSocket, char * const * buffers, S32 * sizes, LLHost * senders, LLHost * receiving_ifs, S32 count);
+
+// Sends 'count' datagrams with as few sendmmsg() calls as possible.  Any the
+// kernel does not take go through send_packet() and its retries.  Returns
+// the number sent successfully.
+S32     send_packets(int hSocket, const char * const * buffers, const S32 * sizes, const LLHost * recipients, S32 count);
+#endif
+// </AS:Chanayane>
+
 //void  get_sender(char * tmp);
 LLHost  get_sender();
 U32     get_sender_port();
@@ -0,0 +1,199 @@
+/**
+ * @file llpacketring_test.cpp
+ * @brief LLPacketRing loopback tests
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+
+#include "linden_common.h"
+
+#include "../llpacketring.h"
+#include "../net.h"
+#include "lltimer.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+    // Big enough to need several recvmmsg() batches, small enough to fit
+    // the socket receive buffer
+    const S32 BURST_SIZE = 200;
+    const S32 PACKET_SIZE = 120;
+
+    struct llpacketring_data
+    {
+        S32 mReceiver { -1 };
+        S32 mSender { -1 };
+        int mReceiverPort { NET_USE_OS_ASSIGNED_PORT };
+        int mSenderPort { NET_USE_OS_ASSIGNED_PORT };
+        LLHost mReceiverHost;
+
+        llpacketring_data()
+        {
+            ensure_equals("receiver socket", start_net(mReceiver, mReceiverPort), 0);
+            ensure_equals("sender socket", start_net(mSender, mSenderPort), 0);
+            mReceiverHost = LLHost(LOOPBACK_ADDRESS_STRING, mReceiverPort);
+        }
+
+        ~llpacketring_data()
+        {
+            end_net(mReceiver);
+            end_net(mSender);
+        }
+
+        static void fillPacket(char* buffer, S32 seq)
+        {
+            memset(buffer, (char)seq, PACKET_SIZE);
+            memcpy(buffer, &seq, sizeof(seq));
+        }
+
+        void sendBurst(LLPacketRing& ring, bool queued, S32 first_seq = 0)
+        {
+            char buffer[PACKET_SIZE];
+            for (S32 seq = first_seq; seq < first_seq + BURST_SIZE; ++seq)
+            {
+                fillPacket(buffer, seq);
+                if (queued)
+                {
+                    ring.queuePacket(mSender, buffer, PACKET_SIZE, mReceiverHost);
+                }
+                else
+                {
+                    ring.sendPacket(mSender, buffer, PACKET_SIZE, mReceiverHost);
+                }
+            }
+            ring.sendQueuedPackets();
+        }
+
+        // drains the receiver and checks every packet of the burst arrived
+        // intact and in order (loopback does not reorder)
+        void receiveBurst(LLPacketRing& ring)
+        {
+            // give the kernel a moment to move the burst to the receiver
+            ms_sleep(20);
+            ensure_equals("buffered packets", ring.drainSocket(mReceiver), BURST_SIZE);
+            ensure_equals("buffered bytes", ring.getNumBufferedBytes(), BURST_SIZE * PACKET_SIZE);
+
+            char expected[PACKET_SIZE];
+            char buffer[NET_BUFFER_SIZE];
+            for (S32 seq = 0; seq < BURST_SIZE; ++seq)
+            {
+                ensure_equals("packet size", ring.receivePacket(mReceiver, buffer), PACKET_SIZE);
+                fillPacket(expected, seq);
+                ensure_memory_matches("packet data", buffer, PACKET_SIZE, expected, PACKET_SIZE);
+                ensure_equals("sender port", (S32)ring.getLastSender().getPort(), (S32)mSenderPort);
+            }
+            ensure_equals("ring empty", ring.getNumBufferedPackets(), 0);
+            ensure_equals("nothing dropped", ring.getNumDroppedPackets(), 0);
+        }
+    };
+    typedef test_group<llpacketring_data> llpacketring_test;
+    typedef llpacketring_test::object llpacketring_object;
+    tut::llpacketring_test llpacketring("LLPacketRing");
+
+    template<> template<>
+    void llpacketring_object::test<1>()
+    {
+        set_test_name("one packet per system call");
+        LLPacketRing ring;
+        ring.setBatchedIO(false);
+        sendBurst(ring, false);
+        receiveBurst(ring);
+    }
+
+    template<> template<>
+    void llpacketring_object::test<2>()
+    {
+        set_test_name("batched receive and send");
+        LLPacketRing ring;
+        sendBurst(ring, true);
+        ensure_equals("bytes out", ring.getActualOutBytes(), BURST_SIZE * PACKET_SIZE);
+        receiveBurst(ring);
+        ensure_equals("bytes in", ring.getActualInBytes(), BURST_SIZE * PACKET_SIZE);
+    }
+
+    template<> template<>
+    void llpacketring_object::test<3>()
+    {
+        set_test_name("batched and single packet drains interleave");
+        LLPacketRing ring;
+        sendBurst(ring, true);
+        ms_sleep(20);
+        ring.drainSocket(mReceiver);
+
+        // consume part of the burst so the ring wraps on the next one
+        char buffer[NET_BUFFER_SIZE];
+        for (S32 i = 0; i < BURST_SIZE / 2; ++i)
+        {
+            ring.receivePacket(mReceiver, buffer);
+        }
+        ring.setBatchedIO(false);
+        sendBurst(ring, true);
+        ms_sleep(20);
+        ensure_equals("buffered packets", ring.drainSocket(mReceiver), BURST_SIZE + BURST_SIZE / 2);
+        ensure_equals("buffered bytes", ring.getNumBufferedBytes(), (BURST_SIZE + BURST_SIZE / 2) * PACKET_SIZE);
+    }
+
+    template<> template<>
+    void llpacketring_object::test<4>()
+    {
+        set_test_name("maxed out ring drops the oldest packets");
+        // Past MAX_BUFFER_RING_SIZE packets, in bursts that each fit the
+        // socket receive buffer
+        const S32 MAX_RING_SIZE = 1024;
+        const S32 BURSTS = 6;
+        const S32 TOTAL = BURSTS * BURST_SIZE;
+        for (bool batched : { false, true })
+        {
+            const std::string mode(batched ? "batched " : "single ");
+            LLPacketRing ring;
+            ring.setBatchedIO(batched);
+            for (S32 burst = 0; burst < BURSTS; ++burst)
+            {
+                sendBurst(ring, true, burst * BURST_SIZE);
+                ms_sleep(20);
+                ring.drainSocket(mReceiver);
+            }
+            ensure_equals(mode + "buffered packets", ring.getNumBufferedPackets(), MAX_RING_SIZE);
+            ensure_equals(mode + "buffered bytes", ring.getNumBufferedBytes(), MAX_RING_SIZE * PACKET_SIZE);
+            ensure_equals(mode + "dropped packets", ring.getNumDroppedPackets(), TOTAL - MAX_RING_SIZE);
+            ensure_equals(mode + "bytes in", ring.getActualInBytes(), TOTAL * PACKET_SIZE);
+
+            // the newest packets are left, oldest first
+            char expected[PACKET_SIZE];
+            char buffer[NET_BUFFER_SIZE];
+            for (S32 seq = TOTAL - MAX_RING_SIZE; seq < TOTAL; ++seq)
+            {
+                ensure_equals(mode + "packet size", ring.receivePacket(mReceiver, buffer), PACKET_SIZE);
+                fillPacket(expected, seq);
+                ensure_memory_matches((mode + "packet data").c_str(), buffer, PACKET_SIZE, expected, PACKET_SIZE);
+            }
+            ensure_equals(mode + "ring empty", ring.getNumBufferedPackets(), 0);
+            ensure_equals(mode + "bytes left", ring.getNumBufferedBytes(), 0);
+        }
+    }
+}
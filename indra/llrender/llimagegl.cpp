@@ -41,6 +41,7 @@
 #include "llrender.h"
 #include "llwindow.h"
 #include "llframetimer.h"
+#include "llimageglupload.h" // <AS:Chanayane/> Texture upload ring
 #include <unordered_set>
 
 extern LL_COMMON_API bool on_main_thread();
@@ -1468,7 +1469,24 @@ void LLImageGL::setManualImage(U32 target, S32 miplevel, S32 intformat, S32 widt
 
         free_cur_tex_image();
         const bool use_sub_image = should_stagger_image_set(compress);
-        if (!use_sub_image)
+        // <AS:Chanayane> Texture upload ring
+        // Pixels staged in the upload ring by a decode thread are read from
+        // the mapped buffer, the driver does not copy them during the call
+        const void* staged = pixels;
+        if (pixels && LLImageGLUploadRing::instanceExists())
+        {
+            const U32 size = (U32)(width * height) * LLImageGL::dataFormatComponents(pixformat) * type_width_from_pixtype(pixtype);
+            staged = LLImageGLUploadRing::getInstance()->bindStaged(pixels, size);
+        }
+        if (staged != pixels)
+        {
+            LL_PROFILE_ZONE_NAMED("glTexImage2D from upload ring");
+            glTexImage2D(target, miplevel, intformat, width, height, 0, pixformat, pixtype, staged);
+            LLImageGLUploadRing::getInstance()->unbindStaged();
+        }
+        else if (!use_sub_image)
+        // </AS:Chanayane>
+        //if (!use_sub_image)
         {
             LL_PROFILE_ZONE_NAMED("glTexImage2D alloc + copy");
             glTexImage2D(target, miplevel, intformat, width, height, 0, pixformat, pixtype, pixels);
@@ -0,0 +1,335 @@
+/**
+ * @file llimageglupload.cpp
+ * @brief Persistent mapped pixel buffer ring for texture uploads
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+
+#include "linden_common.h"
+
+#include "llimageglupload.h"
+
+#include "llgl.h"
+#include "llglheaders.h"
+#include "llthread.h"
+
+#include <thread>
+
+// Offsets handed to glTexImage2D stay aligned for any row alignment and
+// keep separate slices off each other's cache lines
+static constexpr U32 UPLOAD_ALIGNMENT = 256;
+// Largest share of the ring a single image may take, so that one big
+// texture cannot starve the rest of the batch
+static constexpr U32 MAX_SLICE_FRACTION = 4;
+
+static U32 align_upload(U32 size)
+{
+    return (size + UPLOAD_ALIGNMENT - 1) & ~(UPLOAD_ALIGNMENT - 1);
+}
+
+LLImageGLUploadSlice::~LLImageGLUploadSlice()
+{
+    if (LLImageGLUploadRing::instanceExists())
+    {
+        LLImageGLUploadRing::getInstance()->release(mID);
+    }
+}
+
+LLImageGLUploadScope::LLImageGLUploadScope(LLImageGLUploadSlice* slice)
+{
+    // Uploads on the LLImageGL thread go through another context, they
+    // never use the ring
+    if (slice && LLImageGLUploadRing::instanceExists() && on_main_thread())
+    {
+        LLImageGLUploadRing* ring = LLImageGLUploadRing::getInstance();
+        mActive = true;
+        mPrevious = ring->mCurrent;
+        ring->mCurrent = slice;
+    }
+}
+
+LLImageGLUploadScope::~LLImageGLUploadScope()
+{
+    if (mActive && LLImageGLUploadRing::instanceExists())
+    {
+        LLImageGLUploadRing::getInstance()->mCurrent = mPrevious;
+    }
+}
+
+//static
+bool LLImageGLUploadRing::isSupported()
+{
+    return gGLManager.mGLVersion >= 4.39f && glBufferStorage != nullptr;
+}
+
+LLImageGLUploadRing::LLImageGLUploadRing(U32 size_bytes)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+    if (!isSupported() || size_bytes == 0)
+    {
+        return;
+    }
+
+    size_bytes = align_upload(size_bytes);
+
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glGenBuffers(1, &mBuffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mBuffer);
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size_bytes, nullptr, flags);
+    mMapped = (U8*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size_bytes, flags);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (!mMapped)
+    {
+        LL_WARNS("Texture") << "Could not map a " << size_bytes << " bytes texture upload ring, uploading from client memory" << LL_ENDL;
+        glDeleteBuffers(1, &mBuffer);
+        mBuffer = 0;
+        return;
+    }
+
+    mSize = size_bytes;
+    LL_INFOS("Texture") << "Texture upload ring of " << (mSize >> 20) << " MB" << LL_ENDL;
+}
+
+LLImageGLUploadRing::~LLImageGLUploadRing()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+    {
+        // No new slices, then wait for copies that are in progress
+        LLMutexLock lock(&mMutex);
+        mSize = 0;
+    }
+    while (mWriters > 0)
+    {
+        std::this_thread::yield();
+    }
+
+    for (const Fence& fence : mFences)
+    {
+        glDeleteSync((GLsync)fence.mSync);
+    }
+    mFences.clear();
+
+    if (mBuffer)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mBuffer);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glDeleteBuffers(1, &mBuffer);
+        mBuffer = 0;
+    }
+    mMapped = nullptr;
+}
+
+//static
+LLPointer<LLImageGLUploadSlice> LLImageGLUploadRing::stage(const U8* pixels, U32 size)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+    LLImageGLUploadRing* ring = getInstance();
+    if (!ring || !ring->isValid() || !pixels || !size)
+    {
+        return nullptr;
+    }
+
+    U32 offset = 0;
+    U64 id = 0;
+    {
+        LLMutexLock lock(&ring->mMutex);
+        if (!ring->allocate(size, offset))
+        {
+            ++ring->mFullCount;
+            return nullptr;
+        }
+        id = ring->mFrontID + ring->mEntries.size();
+        ring->mEntries.push_back({ offset, align_upload(size), 0, false });
+        ++ring->mWriters;
+    }
+
+    memcpy(ring->mMapped + offset, pixels, size);
+
+    --ring->mWriters;
+    ++ring->mStagedCount;
+    return new LLImageGLUploadSlice(pixels, size, offset, id);
+}
+
+// Called with mMutex held
+bool LLImageGLUploadRing::allocate(U32 size, U32& offset)
+{
+    size = align_upload(size);
+    if (size > mSize / MAX_SLICE_FRACTION)
+    {
+        return false;
+    }
+
+    if (mEntries.empty())
+    {
+        mHead = 0;
+    }
+    else
+    {
+        const U32 tail = mEntries.front().mOffset;
+        if (mHead > tail)
+        {
+            // Free space is [mHead, mSize) and [0, tail)
+            if (mHead + size > mSize)
+            {
+                if (size >= tail)
+                {
+                    return false;
+                }
+                mHead = 0;
+            }
+        }
+        else if (mHead + size >= tail)
+        {
+            // Wrapped, free space is [mHead, tail). Never let the head catch
+            // up with the tail, a full ring would look empty.
+            return false;
+        }
+    }
+
+    offset = mHead;
+    mHead += size;
+    return true;
+}
+
+// Called with mMutex held
+LLImageGLUploadRing::Entry* LLImageGLUploadRing::getEntry(U64 id)
+{
+    if (id < mFrontID || id - mFrontID >= mEntries.size())
+    {
+        return nullptr;
+    }
+    return &mEntries[(size_t)(id - mFrontID)];
+}
+
+void LLImageGLUploadRing::release(U64 id)
+{
+    LLMutexLock lock(&mMutex);
+    Entry* entry = getEntry(id);
+    if (entry)
+    {
+        entry->mReleased = true;
+        reclaim();
+    }
+}
+
+// Called with mMutex held
+void LLImageGLUploadRing::reclaim()
+{
+    while (!mEntries.empty())
+    {
+        const Entry& entry = mEntries.front();
+        if (!entry.mReleased || (entry.mSerial != 0 && entry.mSerial > mCompletedSerial))
+        {
+            break;
+        }
+        mEntries.pop_front();
+        ++mFrontID;
+    }
+}
+
+const void* LLImageGLUploadRing::bindStaged(const void* pixels, U32 size)
+{
+    if (!mCurrent || !pixels || mCurrent->getSource() != pixels || mCurrent->getSize() != size)
+    {
+        return pixels;
+    }
+
+    {
+        LLMutexLock lock(&mMutex);
+        Entry* entry = getEntry(mCurrent->mID);
+        if (!entry)
+        {
+            return pixels;
+        }
+        entry->mSerial = mBatchSerial;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mBuffer);
+    mBound = true;
+    mBatchUsed = true;
+    ++mUploadCount;
+    return (const void*)(uintptr_t)mCurrent->getOffset();
+}
+
+void LLImageGLUploadRing::unbindStaged()
+{
+    if (mBound)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        mBound = false;
+    }
+}
+
+void LLImageGLUploadRing::flush()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+    if (!isValid())
+    {
+        return;
+    }
+
+    if (mBatchUsed)
+    {
+        // One fence covers every upload of the batch
+        GLsync sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        mFences.push_back({ mBatchSerial++, (void*)sync });
+        mBatchUsed = false;
+    }
+
+    U64 completed = 0;
+    while (!mFences.empty())
+    {
+        GLenum status = glClientWaitSync((GLsync)mFences.front().mSync, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+        {
+            break;
+        }
+        completed = mFences.front().mSerial;
+        glDeleteSync((GLsync)mFences.front().mSync);
+        mFences.pop_front();
+    }
+
+    LLMutexLock lock(&mMutex);
+    if (completed)
+    {
+        mCompletedSerial = completed;
+    }
+    reclaim();
+}
+
+U32 LLImageGLUploadRing::getUsedBytes()
+{
+    LLMutexLock lock(&mMutex);
+    if (mEntries.empty())
+    {
+        return 0;
+    }
+    const U32 tail = mEntries.front().mOffset;
+    return mHead > tail ? mHead - tail : mSize - tail + mHead;
+}
@@ -0,0 +1,179 @@
+/**
+ * @file llimageglupload.h
+ * @brief Persistent mapped pixel buffer ring for texture uploads
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+
+#ifndef LL_LLIMAGEGLUPLOAD_H
+#define LL_LLIMAGEGLUPLOAD_H
+
+#include "llmutex.h"
+#include "llpointer.h"
+#include "llrefcount.h"
+#include "llsingleton.h"
+
+#include <atomic>
+#include <deque>
+
+class LLImageGLUploadRing;
+
+/**
+ * A piece of the upload ring holding a copy of one image's pixels, ready to
+ * be handed to glTexImage2D as a buffer offset. The space goes back to the
+ * ring when the last reference is dropped and the GPU is done reading it.
+ */
+class LLImageGLUploadSlice : public LLThreadSafeRefCount
+{
+public:
+    // Pixels the slice was staged from, used to match it to the upload
+    const U8* getSource() const { return mSource; }
+    U32 getSize() const { return mSize; }
+    U32 getOffset() const { return mOffset; }
+
+protected:
+    ~LLImageGLUploadSlice();
+
+private:
+    friend class LLImageGLUploadRing;
+    LLImageGLUploadSlice(const U8* source, U32 size, U32 offset, U64 id)
+        : mSource(source), mSize(size), mOffset(offset), mID(id) {}
+
+    const U8*   mSource;
+    U32         mSize;
+    U32         mOffset;
+    U64         mID;
+};
+
+/**
+ * Ring of pixel upload memory in one GL_PIXEL_UNPACK_BUFFER created with
+ * glBufferStorage and mapped persistently and coherently (GL 4.4).
+ *
+ * Decode threads copy fresh raw images into the ring with stage(), which
+ * takes the copy out of glTexImage2D on the GL thread. While an
+ * LLImageGLUploadScope is alive for a slice, LLImageGL::setManualImage
+ * uploads those pixels from the buffer offset instead of client memory,
+ * which lets the driver schedule the transfer instead of copying during
+ * the call. The GL thread fences each batch of uploads with flush() and
+ * ring space is recycled once its fence has signaled.
+ *
+ * stage() may be called from any thread; everything else, including
+ * construction and destruction, from the main GL thread only. Images that
+ * do not fit are simply not staged and upload the old way.
+ */
+class LLImageGLUploadRing : public LLSimpleton<LLImageGLUploadRing>
+{
+public:
+    LLImageGLUploadRing(U32 size_bytes);
+    ~LLImageGLUploadRing();
+
+    // True if the GL context can create a persistent mapped buffer
+    static bool isSupported();
+
+    // Copy size bytes of pixels into the ring. Returns null if the ring is
+    // not available or has no room.
+    static LLPointer<LLImageGLUploadSlice> stage(const U8* pixels, U32 size);
+
+    // Called by LLImageGL::setManualImage: if pixels/size match the slice of
+    // the current upload scope, binds the ring and returns the offset to
+    // pass to glTexImage2D, otherwise returns pixels unchanged.
+    const void* bindStaged(const void* pixels, U32 size);
+    void unbindStaged();
+
+    // Fence the uploads issued since the last flush and recycle ring space
+    // whose fence has signaled. Call once per texture creation batch.
+    void flush();
+
+    bool isValid() const { return mMapped != nullptr; }
+    U32 getSize() const { return mSize; }
+    U32 getUsedBytes();
+    U32 getStagedCount() const { return mStagedCount; }
+    U32 getUploadCount() const { return mUploadCount; }
+    U32 getFullCount() const { return mFullCount; }
+
+private:
+    friend class LLImageGLUploadSlice;
+    friend class LLImageGLUploadScope;
+
+    struct Entry
+    {
+        U32     mOffset;
+        U32     mSize;
+        U64     mSerial;    // fence batch of the upload, 0 if never uploaded
+        bool    mReleased;
+    };
+
+    struct Fence
+    {
+        U64     mSerial;
+        void*   mSync;      // GLsync
+    };
+
+    bool allocate(U32 size, U32& offset);
+    void release(U64 id);
+    void reclaim();
+    Entry* getEntry(U64 id);
+
+    U32                 mBuffer{ 0 };
+    U8*                 mMapped{ nullptr };
+    U32                 mSize{ 0 };
+
+    LLMutex             mMutex;
+    std::deque<Entry>   mEntries;       // in ring order, oldest first
+    U64                 mFrontID{ 1 };  // id of mEntries.front()
+    U32                 mHead{ 0 };     // next allocation offset
+    U64                 mCompletedSerial{ 0 };  // last batch the GPU is done with
+    std::atomic<U32>    mWriters{ 0 };  // stage() calls copying right now
+
+    // GL thread only
+    std::deque<Fence>   mFences;
+    U64                 mBatchSerial{ 1 };
+    bool                mBatchUsed{ false };
+    LLImageGLUploadSlice* mCurrent{ nullptr };
+    bool                mBound{ false };
+
+    std::atomic<U32>    mStagedCount{ 0 };
+    U32                 mUploadCount{ 0 };
+    std::atomic<U32>    mFullCount{ 0 };
+};
+
+/**
+ * Makes slice the staged copy of the uploads on the main GL thread for as
+ * long as the scope lives. Does nothing for a null slice or on other threads.
+ */
+class LLImageGLUploadScope
+{
+public:
+    LLImageGLUploadScope(LLImageGLUploadSlice* slice);
+    ~LLImageGLUploadScope();
+
+private:
+    LLImageGLUploadSlice* mPrevious{ nullptr };
+    bool mActive{ false };
+};
+
+#endif // LL_LLIMAGEGLUPLOAD_H
@@ -128,6 +128,7 @@ static const struct
 
 static void setting_changed();
 static void ssl_verification_changed();
+static void http_trace_changed(); // <AS:Chanayane/> Request phase latencies
 
 
 LLAppCoreHttp::HttpClass::HttpClass()
@@ -225,6 +226,20 @@ void LLAppCoreHttp::init()
         }
     }
 
+    // <AS:Chanayane> Request phase latencies
+    // Chrome trace of every request, can be toggled at run time
+    const std::string http_trace("ASHttpTrace");
+    if (gSavedSettings.controlExists(http_trace))
+    {
+        LLPointer<LLControlVariable> cntrl_ptr = gSavedSettings.getControl(http_trace);
+        if (cntrl_ptr.notNull())
+        {
+            mHttpTraceSignal = cntrl_ptr->getCommitSignal()->connect(boost::bind(&http_trace_changed));
+            http_trace_changed();
+        }
+    }
+    // </AS:Chanayane>
+
     // Tracing levels for library & libcurl (note that 2 & 3 are beyond spammy):
     // 0 - None
     // 1 - Basic start, stop simple transitions
@@ -324,6 +339,20 @@ void ssl_verification_changed()
     LLCore::HttpOptions::setDefaultSSLVerifyPeer(!gSavedSettings.getBOOL("NoVerifySSLCert"));
 }
 
+// <AS:Chanayane> Request phase latencies
+void http_trace_changed()
+{
+    if (gSavedSettings.getBOOL("ASHttpTrace"))
+    {
+        LLCore::HTTPStats::instance().startTrace(gDirUtilp->getExpandedFilename(LL_PATH_LOGS, "http_trace.json"));
+    }
+    else
+    {
+        LLCore::HTTPStats::instance().stopTrace();
+    }
+}
+// </AS:Chanayane>
+
 namespace
 {
     // The NoOpDeletor is used when wrapping LLAppCoreHttp in a smart pointer below for
@@ -385,6 +414,10 @@ void LLAppCoreHttp::cleanup()
     }
     mSSLNoVerifySignal.disconnect();
     mPipelinedSignal.disconnect();
+    // <AS:Chanayane> Request phase latencies
+    mHttpTraceSignal.disconnect();
+    LLCore::HTTPStats::instance().stopTrace();
+    // </AS:Chanayane>
 
     delete mRequest;
     mRequest = NULL;
@@ -460,6 +493,37 @@ void LLAppCoreHttp::refreshSettings(bool initial)
                     mHttpClasses[app_policy].mPipelined = to_pipeline;
                 }
             }
+
+            // <AS:Chanayane> HTTP/2 multiplexing
+            // The classes that may pipeline are the CDN asset fetches,
+            // which are also the ones worth multiplexing.
+            static const std::string http2_streams("ASHttp2Streams");
+            if (init_data[i].mPipelined && gSavedSettings.controlExists(http2_streams))
+            {
+                const long streams((long)gSavedSettings.getU32(http2_streams));
+                if (streams > 0)
+                {
+                    LLCore::HttpHandle handle;
+                    handle = mRequest->setPolicyOption(LLCore::HttpRequest::PO_HTTP2_STREAMS,
+                                                       mHttpClasses[app_policy].mPolicy,
+                                                       streams,
+                                                       LLCore::HttpHandler::ptr_t());
+                    if (LLCORE_HTTP_HANDLE_INVALID == handle)
+                    {
+                        status = mRequest->getStatus();
+                        LL_WARNS("Init") << "Unable to set " << init_data[i].mUsage
+                                         << " HTTP/2 streams.  Reason:  " << status.toString()
+                                         << LL_ENDL;
+                    }
+                    else
+                    {
+                        LL_INFOS("Init") << "HTTP/2 enabled for " << init_data[i].mUsage
+                                         << " with up to " << streams << " streams per connection"
+                                         << LL_ENDL;
+                    }
+                }
+            }
+            // </AS:Chanayane>
         }
 
         // Get target connection concurrency value
@@ -273,6 +273,7 @@ private:
     bool                        mPipelined;             // Global setting
     boost::signals2::connection mPipelinedSignal;       // Signal for 'HttpPipelining' setting
     boost::signals2::connection mSSLNoVerifySignal;     // Signal for 'NoVerifySSLCert' setting
+    boost::signals2::connection mHttpTraceSignal;       // <AS:Chanayane/> Signal for 'ASHttpTrace' setting
 
     static LLCore::HttpStatus   sslVerify(const std::string &uri, const LLCore::HttpHandler::ptr_t &handler, void *appdata);
 };
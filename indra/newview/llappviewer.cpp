@@ -101,6 +101,7 @@
 #include "llprogressview.h"
 #include "llvocache.h"
 #include "lldiskcache.h"
+#include "llfilesystem.h" // <AS:Chanayane/> Memory-mapped reads
 #include "llvopartgroup.h"
 // [SL:KB] - Patch: Appearance-Misc | Checked: 2013-02-12 (Catznip-3.4)
 #include "llappearancemgr.h"
@@ -762,6 +763,7 @@ LLAppViewer::LLAppViewer()
     mReportedCrash(false),
     mNumSessions(0),
     mGeneralThreadPool(nullptr),
+    mUploadEncodeThreadPool(nullptr), // <AS:Chanayane/> Parallel upload encode
     mPurgeCache(false),
     mPurgeCacheOnExit(false),
     mPurgeUserDataOnExit(false),
@@ -2475,6 +2477,12 @@ bool LLAppViewer::cleanup()
     {
         mGeneralThreadPool->close();
     }
+    // <AS:Chanayane> Parallel upload encode
+    if (mUploadEncodeThreadPool)
+    {
+        mUploadEncodeThreadPool->close();
+    }
+    // </AS:Chanayane>
 
     sTextureFetch->shutDownTextureCacheThread() ;
     LLLFSThread::sLocal->shutdown();
@@ -2536,6 +2544,10 @@ bool LLAppViewer::cleanup()
     sPurgeDiskCacheThread = NULL;
     delete mGeneralThreadPool;
     mGeneralThreadPool = NULL;
+    // <AS:Chanayane> Parallel upload encode
+    delete mUploadEncodeThreadPool;
+    mUploadEncodeThreadPool = NULL;
+    // </AS:Chanayane>
     // <FS:TJ> For CEF cache purging in a background thread
     delete mCefCachePurgeThread;
     mCefCachePurgeThread = NULL;
@@ -2648,7 +2660,10 @@ bool LLAppViewer::initThreads()
 
     LLImage::initClass(gSavedSettings.getBOOL("TextureNewByteRange"),gSavedSettings.getS32("TextureReverseByteRange"));
 
-    LLLFSThread::initClass(enable_threads && true); // TODO: fix crashes associated with this shutdo
+    // <AS:Chanayane> Batched I/O backend
+    //LLLFSThread::initClass(enable_threads && true); // TODO: fix crashes associated with this shutdo
+    LLLFSThread::initClass(enable_threads && true, gSavedSettings.getBOOL("ASFileIOUseIOURing")); // TODO: fix crashes associated with this shutdo
+    // </AS:Chanayane>
 
     //auto configure thread count
     LLSD threadCounts = gSavedSettings.getLLSD("ThreadPoolSizes");
@@ -2691,6 +2706,13 @@ bool LLAppViewer::initThreads()
     // general task background thread (LLPerfStats, etc)
     LLAppViewer::instance()->initGeneralThread();
 
+    // <AS:Chanayane> Parallel upload encode
+    // Texture uploads are encoded here, a few at a time, so bulk uploads do
+    // not stall the main loop. "UploadEncode" in ThreadPoolSizes overrides.
+    mUploadEncodeThreadPool = new LL::ThreadPool("UploadEncode", llclamp(cores / 2, 1, 4));
+    mUploadEncodeThreadPool->start();
+    // </AS:Chanayane>
+
     LLAppViewer::sPurgeDiskCacheThread = new LLPurgeDiskCacheThread();
 
     if (LLTrace::BlockTimer::sLog || LLTrace::BlockTimer::sMetricLog)
@@ -5338,6 +5360,7 @@ bool LLAppViewer::initCache()
     // LLDiskCache::initParamSingleton(cache_dir, disk_cache_size, enable_cache_debug_info);
     LLDiskCache::initParamSingleton(cache_dir, disk_cache_size, enable_cache_debug_info, gSavedSettings.getF32("FSDiskCacheHighWaterPercent"), gSavedSettings.getF32("FSDiskCacheLowWaterPercent"));
     // </FS:Beq>
+    LLFileSystem::setUseMemoryMapping(gSavedSettings.getBOOL("ASDiskCacheMemoryMappedReads")); // <AS:Chanayane/> Memory-mapped reads
 
     if (!read_only)
     {
@@ -5487,6 +5510,7 @@ void LLAppViewer::purgeCache()
     LLVOCache::getInstance()->removeCache(LL_PATH_CACHE);
     LLViewerShaderMgr::instance()->clearShaderCache();
     purgeCefStaleCaches();
+    gDirUtilp->deleteDirAndContents(gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "meshopt")); // <AS:Chanayane/> Pre-optimized mesh LOD cache
     gDirUtilp->deleteFilesInDir(gDirUtilp->getExpandedFilename(LL_PATH_CACHE, ""), "*");
 }
 
@@ -353,6 +353,7 @@ private:
     static LLTextureFetch* sTextureFetch;
     static LLPurgeDiskCacheThread* sPurgeDiskCacheThread;
     LL::ThreadPool* mGeneralThreadPool;
+    LL::ThreadPool* mUploadEncodeThreadPool; // <AS:Chanayane/> Parallel upload encode
 
     S32 mNumSessions;
 
@@ -67,6 +67,20 @@
 #include "llcorehttputil.h"
 #include "hbxxh.h"
 #include "llstartup.h"
+// <AS:Chanayane> Chunked inventory cache
+#include "llsdarena.h"
+#include "workqueue.h"
+#ifdef LL_USESYSTEMLIBS
+#include <zlib.h>
+#else
+#include "zlib-ng/zlib.h"
+#endif
+#include <atomic>
+#include <condition_variable>
+#include <iterator>
+#include <mutex>
+#include <thread>
+// </AS:Chanayane>
 // [RLVa:KB] - Checked: 2011-05-22 (RLVa-1.3.1a)
 #include "rlvhandler.h"
 #include "rlvlocks.h"
@@ -106,6 +120,7 @@ S32 LLInventoryModel::sPendingSystemFolders = 0;
 //bool decompress_file(const char* src_filename, const char* dst_filename);
 static const char PRODUCTION_CACHE_FORMAT_STRING[] = "%s.inv.llsd";
 static const char GRID_CACHE_FORMAT_STRING[] = "%s.%s.inv.llsd";
+static const char CHUNKED_CACHE_SUFFIX[] = ".chunks"; // <AS:Chanayane/> Chunked inventory cache
 static const char * const LOG_INV("Inventory");
 
 struct InventoryIDPtrLess
@@ -2567,6 +2582,21 @@ void LLInventoryModel::cache(
         can_cache);
     // Use temporary file to avoid potential conflicts with other
     // instances (even a 'read only' instance unzips into a file)
+    // <AS:Chanayane> Chunked inventory cache
+    static LLCachedControl<bool> chunked_cache(gSavedSettings, "ASInventoryCacheChunked", true);
+    std::string chunked_filename = getInvCacheAddres(agent_id) + CHUNKED_CACHE_SUFFIX;
+    if (chunked_cache)
+    {
+        if (saveToChunkedFile(chunked_filename, categories, items))
+        {
+            // Don't leave an older gzipped cache behind for the other format
+            LLFile::remove(getInvCacheAddres(agent_id) + ".gz", ENOENT);
+        }
+        return;
+    }
+    LLFile::remove(chunked_filename, ENOENT);
+    // </AS:Chanayane>
+
     std::string temp_file = gDirUtilp->getTempFilename();
     saveToFile(temp_file, categories, items);
     std::string gzip_filename = getInvCacheAddres(agent_id);
@@ -2895,6 +2925,14 @@ bool LLInventoryModel::loadSkeleton(
             LLFile::remove(inventory_filename);
         }
 
+        // <AS:Chanayane> Chunked inventory cache
+        if (LLFile::isfile(inventory_filename + CHUNKED_CACHE_SUFFIX))
+        {
+            LL_INFOS("LLInventoryModel") << "Purging inventory cache file: " << inventory_filename << CHUNKED_CACHE_SUFFIX << LL_ENDL;
+            LLFile::remove(inventory_filename + CHUNKED_CACHE_SUFFIX);
+        }
+        // </AS:Chanayane>
+
         inventory_filename.append(".gz");
         if (LLFile::isfile(inventory_filename))
         {
@@ -2914,6 +2952,14 @@ bool LLInventoryModel::loadSkeleton(
             LLFile::remove(inventory_filename);
         }
 
+        // <AS:Chanayane> Chunked inventory cache
+        if (LLFile::isfile(inventory_filename + CHUNKED_CACHE_SUFFIX))
+        {
+            LL_INFOS("LLInventoryModel") << "Purging library cache file: " << inventory_filename << CHUNKED_CACHE_SUFFIX << LL_ENDL;
+            LLFile::remove(inventory_filename + CHUNKED_CACHE_SUFFIX);
+        }
+        // </AS:Chanayane>
+
         inventory_filename.append(".gz");
         if (LLFile::isfile(inventory_filename))
         {
@@ -2983,7 +3029,15 @@ bool LLInventoryModel::loadSkeleton(
         const S32 NO_VERSION = LLViewerInventoryCategory::VERSION_UNKNOWN;
         std::string gzip_filename(inventory_filename);
         gzip_filename.append(".gz");
-        LLFILE* fp = LLFile::fopen(gzip_filename, "rb");
+        // <AS:Chanayane> Chunked inventory cache
+        //LLFILE* fp = LLFile::fopen(gzip_filename, "rb");
+        // The chunked cache is read straight into memory, so it needs neither
+        // the gunzip step nor the second instance safeguard below.
+        static LLCachedControl<bool> chunked_cache(gSavedSettings, "ASInventoryCacheChunked", true);
+        std::string chunked_filename = inventory_filename + CHUNKED_CACHE_SUFFIX;
+        bool use_chunked = chunked_cache && LLFile::isfile(chunked_filename);
+        LLFILE* fp = use_chunked ? NULL : LLFile::fopen(gzip_filename, "rb");
+        // </AS:Chanayane>
         bool remove_inventory_file = false;
         if (LLAppViewer::instance()->isSecondInstance())
         {
@@ -3013,7 +3067,13 @@ bool LLInventoryModel::loadSkeleton(
             }
         }
         bool is_cache_obsolete = false;
-        if (loadFromFile(inventory_filename, categories, items, categories_to_update, is_cache_obsolete))
+        // <AS:Chanayane> Chunked inventory cache
+        //if (loadFromFile(inventory_filename, categories, items, categories_to_update, is_cache_obsolete))
+        bool loaded = use_chunked
+            ? loadFromChunkedFile(chunked_filename, categories, items, categories_to_update, is_cache_obsolete)
+            : loadFromFile(inventory_filename, categories, items, categories_to_update, is_cache_obsolete);
+        if (loaded)
+        // </AS:Chanayane>
         {
             LL_PROFILE_ZONE_NAMED("loadFromFile");
             // We were able to find a cache of files. So, use what we
@@ -3209,6 +3269,7 @@ bool LLInventoryModel::loadSkeleton(
             // If out of date, remove the gzipped file too.
             LL_WARNS(LOG_INV) << "Inv cache out of date, removing" << LL_ENDL;
             LLFile::remove(gzip_filename);
+            LLFile::remove(chunked_filename, ENOENT); // <AS:Chanayane/> Chunked inventory cache
         }
         categories.clear(); // will unref and delete entries
     }
@@ -3648,6 +3709,67 @@ bool LLUUIDAndName::operator>(const LLUUIDAndName& rhs) const
     return (mID > rhs.mID);
 }
 
+// <AS:Chanayane> Chunked inventory cache
+namespace
+{
+    // Build categories and items from one cache document, a map with
+    // "categories" and "items" arrays. Only touches the objects it creates,
+    // so it is safe to run on a worker thread.
+    void import_inventory_cache(const LLSD& inventory,
+                                LLInventoryModel::cat_array_t& categories,
+                                LLInventoryModel::item_array_t& items,
+                                LLInventoryModel::changed_items_t& cats_to_update)
+    {
+        const LLSD& llsd_cats = inventory["categories"];
+        if (llsd_cats.isArray())
+        {
+            categories.reserve(categories.size() + llsd_cats.size());
+            LLSD::array_const_iterator iter = llsd_cats.beginArray();
+            LLSD::array_const_iterator end = llsd_cats.endArray();
+            for (; iter != end; ++iter)
+            {
+                LLPointer<LLViewerInventoryCategory> inv_cat = new LLViewerInventoryCategory(LLUUID::null);
+                if (inv_cat->importLLSDMap(*iter))
+                {
+                    categories.push_back(inv_cat);
+                }
+            }
+        }
+
+        const LLSD& llsd_items = inventory["items"];
+        if (llsd_items.isArray())
+        {
+            items.reserve(items.size() + llsd_items.size());
+            LLSD::array_const_iterator iter = llsd_items.beginArray();
+            LLSD::array_const_iterator end = llsd_items.endArray();
+            for (; iter != end; ++iter)
+            {
+                LLPointer<LLViewerInventoryItem> inv_item = new LLViewerInventoryItem;
+                if (inv_item->fromLLSD(*iter))
+                {
+                    if (inv_item->getUUID().isNull())
+                    {
+                        LL_DEBUGS(LOG_INV) << "Ignoring inventory with null item id: "
+                            << inv_item->getName() << LL_ENDL;
+                    }
+                    else
+                    {
+                        if (inv_item->getType() == LLAssetType::AT_UNKNOWN)
+                        {
+                            cats_to_update.insert(inv_item->getParentUUID());
+                        }
+                        else
+                        {
+                            items.push_back(inv_item);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+// </AS:Chanayane>
+
 // static
 bool LLInventoryModel::loadFromFile(const std::string& filename,
                                     LLInventoryModel::cat_array_t& categories,
@@ -3705,61 +3827,67 @@ bool LLInventoryModel::loadFromFile(const std::string& filename,
         }
     }
 
+    // <AS:Chanayane> Chunked inventory cache
+    //if (!is_cache_obsolete)
+    //{
+    //    const LLSD& llsd_cats = inventory["categories"];
+    //    if (llsd_cats.isArray())
+    //    {
+    //        LLSD::array_const_iterator iter = llsd_cats.beginArray();
+    //        LLSD::array_const_iterator end = llsd_cats.endArray();
+    //        for (; iter != end; ++iter)
+    //        {
+    //            LLPointer<LLViewerInventoryCategory> inv_cat = new LLViewerInventoryCategory(LLUUID::null);
+    //            if (inv_cat->importLLSDMap(*iter))
+    //            {
+    //                categories.push_back(inv_cat);
+    //            }
+    //        }
+    //    }
+    //
+    //    const LLSD& llsd_items = inventory["items"];
+    //    if (llsd_items.isArray())
+    //    {
+    //        LLSD::array_const_iterator iter = llsd_items.beginArray();
+    //        LLSD::array_const_iterator end = llsd_items.endArray();
+    //        for (; iter != end; ++iter)
+    //        {
+    //            LLPointer<LLViewerInventoryItem> inv_item = new LLViewerInventoryItem;
+    //            if (inv_item->fromLLSD(*iter))
+    //            {
+    //                if (inv_item->getUUID().isNull())
+    //                {
+    //                    LL_DEBUGS(LOG_INV) << "Ignoring inventory with null item id: "
+    //                        << inv_item->getName() << LL_ENDL;
+    //                }
+    //                else
+    //                {
+    //                    if (inv_item->getType() == LLAssetType::AT_UNKNOWN)
+    //                    {
+    //                        cats_to_update.insert(inv_item->getParentUUID());
+    //                    }
+    //                    else
+    //                    {
+    //                        items.push_back(inv_item);
+    //                    }
+    //                }
+    //            }
+    //
+    //            //      TODO(brad) - figure out how to reenable this without breaking everything else
+    //            //      static constexpr U64 BATCH_SIZE = 512U;
+    //            //      if ((++lines_count % BATCH_SIZE) == 0)
+    //            //      {
+    //            //          // SL-19968 - make sure message system code gets a chance to run every so often
+    //            //          pump_idle_startup_network();
+    //            //      }
+    //        }
+    //    }
+    //}
     if (!is_cache_obsolete)
     {
-        const LLSD& llsd_cats = inventory["categories"];
-        if (llsd_cats.isArray())
-        {
-            LLSD::array_const_iterator iter = llsd_cats.beginArray();
-            LLSD::array_const_iterator end = llsd_cats.endArray();
-            for (; iter != end; ++iter)
-            {
-                LLPointer<LLViewerInventoryCategory> inv_cat = new LLViewerInventoryCategory(LLUUID::null);
-                if (inv_cat->importLLSDMap(*iter))
-                {
-                    categories.push_back(inv_cat);
-                }
-            }
-        }
-
-        const LLSD& llsd_items = inventory["items"];
-        if (llsd_items.isArray())
-        {
-            LLSD::array_const_iterator iter = llsd_items.beginArray();
-            LLSD::array_const_iterator end = llsd_items.endArray();
-            for (; iter != end; ++iter)
-            {
-                LLPointer<LLViewerInventoryItem> inv_item = new LLViewerInventoryItem;
-                if (inv_item->fromLLSD(*iter))
-                {
-                    if (inv_item->getUUID().isNull())
-                    {
-                        LL_DEBUGS(LOG_INV) << "Ignoring inventory with null item id: "
-                            << inv_item->getName() << LL_ENDL;
-                    }
-                    else
-                    {
-                        if (inv_item->getType() == LLAssetType::AT_UNKNOWN)
-                        {
-                            cats_to_update.insert(inv_item->getParentUUID());
-                        }
-                        else
-                        {
-                            items.push_back(inv_item);
-                        }
-                    }
-                }
-
-                //      TODO(brad) - figure out how to reenable this without breaking everything else
-                //      static constexpr U64 BATCH_SIZE = 512U;
-                //      if ((++lines_count % BATCH_SIZE) == 0)
-                //      {
-                //          // SL-19968 - make sure message system code gets a chance to run every so often
-                //          pump_idle_startup_network();
-                //      }
-            }
-        }
+        import_inventory_cache(inventory, categories, items, cats_to_update);
     }
+    // </AS:Chanayane>
 
     file.close();
 
@@ -3842,6 +3970,325 @@ bool LLInventoryModel::saveToFile(const std::string& filename,
     return true;
 }
 
+// <AS:Chanayane> Chunked inventory cache
+namespace
+{
+    // Chunked cache layout, all integers in network byte order:
+    //   U32 magic, U32 cache version, U32 chunk count,
+    //   chunk count x { U32 compressed size, U32 decompressed size },
+    //   the compressed chunks back to back.
+    // Each chunk is a zlib stream holding one binary LLSD map with
+    // "categories" and "items" arrays, the same shape as the gzipped cache,
+    // so the chunks can be inflated and parsed independently.
+    const U32 INV_CHUNKED_MAGIC = 0x4c4c4943; // "LLIC"
+    const size_t INV_CHUNK_RECORDS = 2048;
+    const U32 INV_CHUNK_MAX_SIZE = 256 * 1024 * 1024;
+
+    struct InvCacheChunk
+    {
+        const U8*   mData = nullptr;
+        U32         mCompressedSize = 0;
+        U32         mSize = 0;
+
+        bool        mValid = false;
+        LLInventoryModel::cat_array_t       mCategories;
+        LLInventoryModel::item_array_t      mItems;
+        LLInventoryModel::changed_items_t   mCatsToUpdate;
+    };
+
+    void decode_inventory_chunk(InvCacheChunk& chunk)
+    {
+        LL_PROFILE_ZONE_SCOPED;
+        try
+        {
+            std::vector<U8> buffer(chunk.mSize);
+            uLongf size = chunk.mSize;
+            if (uncompress(buffer.data(), &size, chunk.mData, chunk.mCompressedSize) != Z_OK
+                || size != chunk.mSize)
+            {
+                return;
+            }
+
+            // The parsed LLSD only lives until the objects are built.
+            LLSDArena arena;
+            LLSDArena::Scope scope(arena);
+            LLSD inventory;
+            if (LLSDSerialize::fromBinary(inventory, buffer.data(), buffer.size()) == LLSDParser::PARSE_FAILURE)
+            {
+                return;
+            }
+            import_inventory_cache(inventory, chunk.mCategories, chunk.mItems, chunk.mCatsToUpdate);
+            chunk.mValid = true;
+        }
+        catch (...)
+        {
+            LOG_UNHANDLED_EXCEPTION("decode_inventory_chunk");
+            chunk.mValid = false;
+        }
+    }
+
+    // Decode every chunk, sharing the work between the calling thread and
+    // the "General" thread pool. Helpers claim chunks from a shared counter,
+    // so a helper that only gets to run after the work is done returns
+    // without touching anything but the shared state.
+    void decode_inventory_chunks(std::vector<InvCacheChunk>& chunks)
+    {
+        struct Shared
+        {
+            std::atomic<size_t>     mNext{ 0 };
+            size_t                  mDone{ 0 };
+            std::mutex              mMutex;
+            std::condition_variable mCond;
+        };
+        auto shared = std::make_shared<Shared>();
+        InvCacheChunk* first = chunks.data();
+        const size_t count = chunks.size();
+
+        auto work = [shared, first, count]()
+        {
+            size_t index;
+            while ((index = shared->mNext.fetch_add(1)) < count)
+            {
+                decode_inventory_chunk(first[index]);
+                std::lock_guard<std::mutex> lock(shared->mMutex);
+                if (++shared->mDone == count)
+                {
+                    shared->mCond.notify_all();
+                }
+            }
+        };
+
+        LL::WorkQueue::ptr_t queue = LL::WorkQueue::getInstance("General");
+        if (queue && count > 1)
+        {
+            size_t helpers = llmin(count - 1, (size_t)llmax(1U, std::thread::hardware_concurrency()));
+            for (size_t i = 0; i < helpers; ++i)
+            {
+                if (!queue->post(work))
+                {
+                    break;
+                }
+            }
+        }
+
+        work();
+
+        std::unique_lock<std::mutex> lock(shared->mMutex);
+        shared->mCond.wait(lock, [&]() { return shared->mDone == count; });
+    }
+}
+
+// static
+bool LLInventoryModel::loadFromChunkedFile(const std::string& filename,
+                                           cat_array_t& categories,
+                                           item_array_t& items,
+                                           changed_items_t& cats_to_update,
+                                           bool& is_cache_obsolete)
+{
+    LL_PROFILE_ZONE_NAMED("inventory load from chunked file");
+
+    LL_INFOS(LOG_INV) << "loading inventory from: (" << filename << ")" << LL_ENDL;
+
+    llifstream file(filename.c_str(), std::ifstream::in | std::ifstream::binary);
+    if (!file.is_open())
+    {
+        LL_INFOS(LOG_INV) << "unable to load inventory from: " << filename << LL_ENDL;
+        return false;
+    }
+
+    is_cache_obsolete = true; // Obsolete until proven current
+    std::vector<U8> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+
+    auto read_u32 = [&data](size_t offset)
+    {
+        U32 value_nbo;
+        memcpy(&value_nbo, data.data() + offset, sizeof(U32));
+        return (U32)ntohl(value_nbo);
+    };
+
+    const size_t HEADER_SIZE = 3 * sizeof(U32);
+    if (data.size() < HEADER_SIZE || read_u32(0) != INV_CHUNKED_MAGIC)
+    {
+        LL_WARNS(LOG_INV) << "Failed to read cache header. Unable to load inventory from: " << filename << LL_ENDL;
+        return false;
+    }
+    if ((S32)read_u32(4) != sCurrentInvCacheVersion)
+    {
+        LL_WARNS(LOG_INV) << "Inventory cache is out of date" << LL_ENDL;
+        return false;
+    }
+
+    size_t chunk_count = read_u32(8);
+    size_t offset = HEADER_SIZE + chunk_count * 2 * sizeof(U32);
+    if (offset > data.size())
+    {
+        LL_WARNS(LOG_INV) << "Inventory cache is truncated" << LL_ENDL;
+        return false;
+    }
+
+    std::vector<InvCacheChunk> chunks(chunk_count);
+    for (size_t i = 0; i < chunk_count; ++i)
+    {
+        InvCacheChunk& chunk = chunks[i];
+        chunk.mCompressedSize = read_u32(HEADER_SIZE + i * 2 * sizeof(U32));
+        chunk.mSize = read_u32(HEADER_SIZE + i * 2 * sizeof(U32) + sizeof(U32));
+        if (chunk.mCompressedSize > data.size() - offset || chunk.mSize > INV_CHUNK_MAX_SIZE)
+        {
+            LL_WARNS(LOG_INV) << "Inventory cache is truncated" << LL_ENDL;
+            return false;
+        }
+        chunk.mData = data.data() + offset;
+        offset += chunk.mCompressedSize;
+    }
+
+    decode_inventory_chunks(chunks);
+
+    // Merge in file order, so the result is the same as a serial load.
+    size_t cat_count = 0;
+    size_t item_count = 0;
+    for (const InvCacheChunk& chunk : chunks)
+    {
+        if (!chunk.mValid)
+        {
+            LL_WARNS(LOG_INV) << "Parsing inventory cache failed" << LL_ENDL;
+            return false;
+        }
+        cat_count += chunk.mCategories.size();
+        item_count += chunk.mItems.size();
+    }
+    categories.reserve(categories.size() + cat_count);
+    items.reserve(items.size() + item_count);
+    for (InvCacheChunk& chunk : chunks)
+    {
+        std::move(chunk.mCategories.begin(), chunk.mCategories.end(), std::back_inserter(categories));
+        std::move(chunk.mItems.begin(), chunk.mItems.end(), std::back_inserter(items));
+        cats_to_update.insert(chunk.mCatsToUpdate.begin(), chunk.mCatsToUpdate.end());
+    }
+
+    is_cache_obsolete = false;
+    return true;
+}
+
+// static
+bool LLInventoryModel::saveToChunkedFile(const std::string& filename,
+                                         const cat_array_t& categories,
+                                         const item_array_t& items)
+{
+    LL_INFOS(LOG_INV) << "saving inventory to: (" << filename << ")" << LL_ENDL;
+
+    // Categories first, then items, INV_CHUNK_RECORDS of them per chunk.
+    std::vector<std::string> chunks;
+    std::vector<U32> raw_sizes;
+    LLSD chunk_sd;
+    size_t records = 0;
+    auto flush_chunk = [&]()
+    {
+        if (!records)
+        {
+            return true;
+        }
+        std::ostringstream ostr;
+        LLSDSerialize::toBinary(chunk_sd, ostr);
+        const std::string raw = ostr.str();
+
+        uLongf size = compressBound((uLong)raw.size());
+        std::string compressed(size, '\0');
+        if (compress2((Bytef*)compressed.data(), &size, (const Bytef*)raw.data(), (uLong)raw.size(),
+                      Z_DEFAULT_COMPRESSION) != Z_OK)
+        {
+            return false;
+        }
+        compressed.resize(size);
+        chunks.push_back(std::move(compressed));
+        raw_sizes.push_back((U32)raw.size());
+        chunk_sd = LLSD();
+        records = 0;
+        return true;
+    };
+
+    S32 cat_count = 0;
+    for (auto& cat : categories)
+    {
+        if (cat->getVersion() != LLViewerInventoryCategory::VERSION_UNKNOWN)
+        {
+            LLSD sd;
+            cat->exportLLSD(sd);
+            chunk_sd["categories"].append(sd);
+            cat_count++;
+            if (++records == INV_CHUNK_RECORDS && !flush_chunk())
+            {
+                LL_WARNS(LOG_INV) << "Failed to compress cache. Unable to save inventory to: " << filename << LL_ENDL;
+                return false;
+            }
+        }
+    }
+    for (auto& item : items)
+    {
+        LLSD sd;
+        item->asLLSD(sd);
+        chunk_sd["items"].append(sd);
+        if (++records == INV_CHUNK_RECORDS && !flush_chunk())
+        {
+            LL_WARNS(LOG_INV) << "Failed to compress cache. Unable to save inventory to: " << filename << LL_ENDL;
+            return false;
+        }
+    }
+    if (!flush_chunk())
+    {
+        LL_WARNS(LOG_INV) << "Failed to compress cache. Unable to save inventory to: " << filename << LL_ENDL;
+        return false;
+    }
+
+    // Use temporary file to avoid potential conflicts with other instances
+    std::string temp_file = gDirUtilp->getTempFilename();
+    {
+        llofstream file(temp_file.c_str(), std::ios_base::out | std::ios_base::binary);
+        if (!file.is_open())
+        {
+            LL_WARNS(LOG_INV) << "Failed to open file. Unable to save inventory to: " << filename << LL_ENDL;
+            return false;
+        }
+        auto write_u32 = [&file](U32 value)
+        {
+            U32 value_nbo = htonl(value);
+            file.write((const char*)&value_nbo, sizeof(U32));
+        };
+        write_u32(INV_CHUNKED_MAGIC);
+        write_u32((U32)sCurrentInvCacheVersion);
+        write_u32((U32)chunks.size());
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            write_u32((U32)chunks[i].size());
+            write_u32(raw_sizes[i]);
+        }
+        for (const std::string& chunk : chunks)
+        {
+            file.write(chunk.data(), chunk.size());
+        }
+        file.flush();
+        if (file.fail())
+        {
+            LL_WARNS(LOG_INV) << "Failed to write cache. Unable to save inventory to: " << filename << LL_ENDL;
+            file.close();
+            LLFile::remove(temp_file);
+            return false;
+        }
+    }
+
+    if (LLFile::rename(temp_file, filename) != 0)
+    {
+        LL_WARNS(LOG_INV) << "Unable to move " << temp_file << " to " << filename << LL_ENDL;
+        LLFile::remove(temp_file);
+        return false;
+    }
+
+    LL_INFOS(LOG_INV) << "Inventory saved: " << cat_count << " categories, " << items.size() << " items in "
+                      << chunks.size() << " chunks." << LL_ENDL;
+    return true;
+}
+// </AS:Chanayane>
+
 // message handling functionality
 // static
 void LLInventoryModel::registerCallbacks(LLMessageSystem* msg)
@@ -731,6 +731,18 @@ protected:
     static bool saveToFile(const std::string& filename,
                            const cat_array_t& categories,
                            const item_array_t& items);
+    // <AS:Chanayane> Chunked inventory cache
+    // Same contents as the gzipped cache, split into independently
+    // compressed chunks that are inflated and parsed in parallel.
+    static bool loadFromChunkedFile(const std::string& filename,
+                                    cat_array_t& categories,
+                                    item_array_t& items,
+                                    changed_items_t& cats_to_update,
+                                    bool& is_cache_obsolete);
+    static bool saveToChunkedFile(const std::string& filename,
+                                  const cat_array_t& categories,
+                                  const item_array_t& items);
+    // </AS:Chanayane>
 
     //--------------------------------------------------------------------
     // Message handling functionality
@@ -0,0 +1,201 @@
+/**
+ * @file llmeshlodcache.cpp
+ * @brief Memory budgeted LRU of decoded mesh LODs
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llmeshlodcache.h"
+
+#include "lltrace.h"
+#include "llvolume.h"
+
+static LLTrace::CountStatHandle<> sMeshLODCacheHit("mesh_lod_cache_hit", "Mesh LODs reused from the decoded LOD cache");
+static LLTrace::CountStatHandle<> sMeshLODCacheMiss("mesh_lod_cache_miss", "Mesh LODs not found in the decoded LOD cache");
+static LLTrace::EventStatHandle<LLUnit<F32, LLUnits::Percent> > sMeshLODCacheHitRate("mesh_lod_cache_hits");
+static LLTrace::SampleStatHandle<F64Megabytes> sMeshLODCacheMem("mesh_lod_cache_mem", "Memory held by the decoded mesh LOD cache");
+
+LLMeshLODCache::LLMeshLODCache()
+:   mBytes(0),
+    mBudget(0)
+{
+}
+
+LLMeshLODCache::~LLMeshLODCache()
+{
+    clear();
+}
+
+void LLMeshLODCache::setBudget(U64 bytes)
+{
+    if (bytes != mBudget)
+    {
+        mBudget = bytes;
+        evict();
+    }
+}
+
+void LLMeshLODCache::update()
+{
+    // Entries whose last other reference went away since the last call
+    // become the most recently used ones, as if inserted now
+    entry_list_t released;
+    for (entry_list_t::iterator iter = mEntries.begin(); iter != mEntries.end(); )
+    {
+        entry_list_t::iterator entry = iter++;
+        bool shared = entry->mVolume->getNumRefs() > 1;
+        if (shared == entry->mShared)
+        {
+            continue;
+        }
+
+        entry->mShared = shared;
+        if (shared)
+        {
+            mBytes -= entry->mBytes;
+        }
+        else
+        {
+            mBytes += entry->mBytes;
+            released.splice(released.end(), mEntries, entry);
+        }
+    }
+    mEntries.splice(mEntries.end(), released);
+    evict();
+}
+
+LLVolume* LLMeshLODCache::find(const LLVolumeParams& mesh_params, S32 lod)
+{
+    if (!mBudget)
+    {
+        return NULL;
+    }
+
+    entry_map_t::iterator iter = mMap.find(Key{ mesh_params.getSculptID(), mesh_params.getSculptType(), lod });
+    if (iter == mMap.end())
+    {
+        add(sMeshLODCacheMiss, 1);
+        record(sMeshLODCacheHitRate, LLUnits::Ratio::fromValue(0));
+        return NULL;
+    }
+
+    add(sMeshLODCacheHit, 1);
+    record(sMeshLODCacheHitRate, LLUnits::Ratio::fromValue(1));
+    mEntries.splice(mEntries.end(), mEntries, iter->second);
+    return iter->second->mVolume;
+}
+
+void LLMeshLODCache::insert(const LLVolumeParams& mesh_params, S32 lod, LLVolume* volume)
+{
+    if (!mBudget || !volume)
+    {
+        return;
+    }
+
+    Key key{ mesh_params.getSculptID(), mesh_params.getSculptType(), lod };
+    entry_map_t::iterator iter = mMap.find(key);
+    if (iter != mMap.end())
+    {
+        erase(iter);
+    }
+
+    bool shared = volume->getNumRefs() > 0;
+    U64 bytes = getVolumeBytes(volume);
+    if (shared || bytes <= mBudget)
+    {
+        mEntries.push_back(Entry{ key, volume, bytes, shared });
+        mMap.emplace(key, std::prev(mEntries.end()));
+        if (!shared)
+        {
+            mBytes += bytes;
+        }
+    }
+    evict();
+}
+
+void LLMeshLODCache::clear()
+{
+    mMap.clear();
+    mEntries.clear();
+    mBytes = 0;
+    sample(sMeshLODCacheMem, F64Bytes(0.0));
+}
+
+void LLMeshLODCache::evict()
+{
+    if (!mBudget)
+    {
+        clear();
+        return;
+    }
+
+    // Shared volumes would stay in memory anyway, so only drop the others
+    for (entry_list_t::iterator iter = mEntries.begin(); mBytes > mBudget && iter != mEntries.end(); )
+    {
+        entry_list_t::iterator entry = iter++;
+        if (!entry->mShared)
+        {
+            erase(mMap.find(entry->mKey));
+        }
+    }
+    sample(sMeshLODCacheMem, F64Bytes((F64)mBytes));
+}
+
+void LLMeshLODCache::erase(entry_map_t::iterator iter)
+{
+    entry_list_t::iterator entry = iter->second;
+    if (!entry->mShared)
+    {
+        mBytes -= entry->mBytes;
+    }
+    mMap.erase(iter);
+    mEntries.erase(entry);
+}
+
+//static
+U64 LLMeshLODCache::getVolumeBytes(const LLVolume* volume)
+{
+    U64 bytes = sizeof(LLVolume);
+    for (S32 i = 0; i < volume->getNumVolumeFaces(); ++i)
+    {
+        const LLVolumeFace& face = volume->getVolumeFace(i);
+        // positions, normals and texture coordinates share one allocation
+        U64 vert_size = sizeof(LLVector4a) * 2 + sizeof(LLVector2);
+        if (face.mTangents)
+        {
+            vert_size += sizeof(LLVector4a);
+        }
+        if (face.mWeights)
+        {
+            vert_size += sizeof(LLVector4a);
+        }
+        bytes += sizeof(LLVolumeFace) + vert_size * face.mNumAllocatedVertices + sizeof(U16) * face.mNumIndices;
+    }
+    return bytes;
+}
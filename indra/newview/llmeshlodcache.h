@@ -0,0 +1,116 @@
+/**
+ * @file llmeshlodcache.h
+ * @brief Memory budgeted LRU of decoded mesh LODs
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+
+#ifndef LL_LLMESHLODCACHE_H
+#define LL_LLMESHLODCACHE_H
+
+#include "llpointer.h"
+#include "lluuid.h"
+
+#include <list>
+#include <unordered_map>
+
+class LLVolume;
+class LLVolumeParams;
+
+// Keeps a reference to the system volume of each loaded mesh LOD, so that
+// its unpacked faces outlive the last object using them and a mesh coming
+// back into view does not go through the disk cache, zlib and LLSD again.
+// Volumes still referenced by the volume manager cost nothing extra and
+// only count against the budget once the cache holds the last reference.
+// Main thread only.
+class LLMeshLODCache
+{
+public:
+    LLMeshLODCache();
+    ~LLMeshLODCache();
+
+    // Evicts least recently used entries until the cache fits. 0 disables
+    // the cache.
+    void setBudget(U64 bytes);
+
+    // Picks up the volumes the volume manager released since the last call
+    // and evicts until the cache fits. Call once per frame.
+    void update();
+
+    // Returns the decoded volume for the mesh and sculpt flags of
+    // mesh_params at lod and makes it the most recently used entry, or NULL.
+    // Counts a hit or a miss.
+    LLVolume* find(const LLVolumeParams& mesh_params, S32 lod);
+
+    // Keeps a reference to the system volume, replacing any previous entry.
+    void insert(const LLVolumeParams& mesh_params, S32 lod, LLVolume* volume);
+
+    void clear();
+
+    // Memory held by the volumes only the cache references
+    U64 getBytes() const { return mBytes; }
+    size_t getCount() const { return mEntries.size(); }
+
+    // Approximate memory held by the faces of volume.
+    static U64 getVolumeBytes(const LLVolume* volume);
+
+private:
+    struct Key
+    {
+        LLUUID  mID;
+        U8      mSculptType;    // mirror and invert flags change the faces
+        S32     mLOD;
+
+        bool operator==(const Key& rhs) const { return mLOD == rhs.mLOD && mSculptType == rhs.mSculptType && mID == rhs.mID; }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const { return std::hash<LLUUID>()(key.mID) ^ ((size_t)key.mSculptType << 8) ^ (size_t)key.mLOD; }
+    };
+
+    struct Entry
+    {
+        Key                 mKey;
+        LLPointer<LLVolume> mVolume;
+        U64                 mBytes;
+        bool                mShared;    // the volume manager still references mVolume
+    };
+
+    typedef std::list<Entry> entry_list_t;  // least recently used at the front
+    typedef std::unordered_map<Key, entry_list_t::iterator, KeyHash> entry_map_t;
+
+    void evict();
+    void erase(entry_map_t::iterator iter);
+
+    entry_list_t    mEntries;
+    entry_map_t     mMap;
+    U64             mBytes;     // unshared entries only
+    U64             mBudget;
+};
+
+#endif // LL_LLMESHLODCACHE_H
@@ -0,0 +1,375 @@
+/**
+ * @file llmeshoptimizedcache.cpp
+ * @brief Cache of mesh LODs in their unpacked, optimized layout
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llmeshoptimizedcache.h"
+
+#include "lldir.h"
+#include "lldiriterator.h"
+#include "llfile.h"
+#include "llmappedfile.h"
+#include "llvolume.h"
+#include "llvolumemgr.h"
+#include "workqueue.h"
+
+#include <algorithm>
+
+static const U32 FILE_MAGIC = 0x324F4D4C; // "LMO2"
+
+static const char* entry_file_mask = "*.mopt";
+static const char* temp_file_mask = "*.tmp";
+
+LLMeshOptimizedCache::LLMeshOptimizedCache(const std::string& dir, U64 max_bytes, bool read_only)
+    : mDir(dir),
+      mMaxBytes(max_bytes),
+      mReadOnly(read_only)
+{
+    if (!mReadOnly)
+    {
+        LLFile::mkdir(mDir);
+    }
+    scan();
+    LL_INFOS("MeshCache") << "Optimized mesh cache: " << getNumEntries() << " entries, "
+                          << getBytes() / (1024 * 1024) << " MB of " << mMaxBytes / (1024 * 1024)
+                          << " MB" << LL_ENDL;
+}
+
+LLMeshOptimizedCache::~LLMeshOptimizedCache()
+{
+    LL_INFOS("MeshCache") << "Optimized mesh cache hit rate " << getHitRate() * 100.f << "% ("
+                          << mHits << " hits, " << mMisses << " misses, " << mWrites << " writes, "
+                          << mEvictions << " evictions)" << LL_ENDL;
+}
+
+void LLMeshOptimizedCache::scan()
+{
+    // Rebuild the LRU order from the file times; files are never touched on
+    // access, so this is the order they were written.
+    struct Found
+    {
+        key_t   mKey;
+        U64     mSize;
+        time_t  mTime;
+    };
+    std::vector<Found> found;
+
+    std::string filename;
+    if (!mReadOnly)
+    {
+        // Left behind by writes that did not finish
+        LLDirIterator temp_iter(mDir, temp_file_mask);
+        while (temp_iter.next(filename))
+        {
+            LLFile::remove(gDirUtilp->add(mDir, filename), ENOENT);
+        }
+    }
+    LLDirIterator iter(mDir, entry_file_mask);
+    while (iter.next(filename))
+    {
+        key_t key;
+        std::string path = gDirUtilp->add(mDir, filename);
+        if (!parseFilename(filename, key))
+        {
+            // Also entries from before the sculpt flags were part of the key
+            if (!mReadOnly)
+            {
+                LLFile::remove(path, ENOENT);
+            }
+            continue;
+        }
+        llstat stat_data;
+        if (LLFile::stat(path, &stat_data) != 0)
+        {
+            continue;
+        }
+        found.push_back({ key, (U64)stat_data.st_size, stat_data.st_mtime });
+    }
+
+    std::sort(found.begin(), found.end(),
+              [](const Found& a, const Found& b) { return a.mTime < b.mTime; });
+
+    LLMutexLock lock(&mMutex);
+    for (const Found& entry : found)
+    {
+        insert(entry.mKey, entry.mSize);
+    }
+    evict();
+}
+
+//static
+LLMeshOptimizedCache::key_t LLMeshOptimizedCache::makeKey(const LLVolumeParams& mesh_params, S32 lod)
+{
+    return { mesh_params.getSculptID(), (U8)(mesh_params.getSculptType() & LL_SCULPT_FLAG_MASK), lod };
+}
+
+//static
+bool LLMeshOptimizedCache::parseFilename(const std::string& filename, key_t& key)
+{
+    size_t sep = filename.find('_');
+    if (sep != UUID_STR_LENGTH - 1 || !key.mID.set(filename.substr(0, sep), false))
+    {
+        return false;
+    }
+    S32 lod = -1;
+    U32 flags = 0;
+    if (sscanf(filename.c_str() + sep, "_%d_%u.mopt", &lod, &flags) != 2
+        || lod < 0 || lod >= LLVolumeLODGroup::NUM_LODS || (flags & ~LL_SCULPT_FLAG_MASK))
+    {
+        return false;
+    }
+    key.mLOD = lod;
+    key.mSculptFlags = (U8)flags;
+    return true;
+}
+
+std::string LLMeshOptimizedCache::getFilename(const key_t& key) const
+{
+    return gDirUtilp->add(mDir, llformat("%s_%d_%u.mopt", key.mID.asString().c_str(), key.mLOD, (U32)key.mSculptFlags));
+}
+
+bool LLMeshOptimizedCache::read(const LLVolumeParams& mesh_params, S32 lod, U32 source_size, LLVolume* volume)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+    const key_t key = makeKey(mesh_params, lod);
+    {
+        LLMutexLock lock(&mMutex);
+        if (mEntries.find(key) == mEntries.end())
+        {
+            ++mMisses;
+            return false;
+        }
+        // Keeps evict() from removing the file while it is mapped
+        mReading.insert(key);
+    }
+
+    bool ok = false;
+    bool stale = false;
+    {
+        LLMappedFile::ptr_t mapping = LLMappedFile::open(getFilename(key));
+        FileHeader header;
+        if (mapping && mapping->getSize() >= sizeof(header))
+        {
+            memcpy(&header, mapping->getData(), sizeof(header));
+            if (header.mMagic == FILE_MAGIC && header.mLOD == (U32)lod
+                && header.mSculptFlags == (U32)key.mSculptFlags
+                && header.mDataSize == mapping->getSize() - sizeof(header))
+            {
+                // An entry built from another version of the asset is
+                // rebuilt rather than reported as damaged.
+                stale = header.mSourceSize != source_size;
+                ok = !stale && volume->unpackOptimizedFaces(mapping->getData() + sizeof(header), header.mDataSize);
+            }
+        }
+    }
+
+    LLMutexLock lock(&mMutex);
+    mReading.erase(mReading.find(key));
+    if (!ok)
+    {
+        ++mMisses;
+        // Left to the last reader when another one still has it mapped
+        if (!mReadOnly && !mReading.count(key))
+        {
+            if (!stale)
+            {
+                LL_WARNS() << "Dropping unreadable optimized mesh " << key.mID << " LOD " << lod << LL_ENDL;
+            }
+            erase(key);
+            LLFile::remove(getFilename(key), ENOENT);
+        }
+        return false;
+    }
+
+    ++mHits;
+    auto iter = mEntries.find(key);
+    if (iter != mEntries.end())
+    {
+        mLRU.splice(mLRU.end(), mLRU, iter->second);
+    }
+    return true;
+}
+
+void LLMeshOptimizedCache::write(const LLVolumeParams& mesh_params, S32 lod, U32 source_size, const LLVolume* volume)
+{
+    if (mReadOnly || !volume)
+    {
+        return;
+    }
+
+    const key_t key = makeKey(mesh_params, lod);
+    {
+        LLMutexLock lock(&mMutex);
+        if (mEntries.find(key) != mEntries.end() || !mPendingWrites.insert(key).second)
+        {
+            return;
+        }
+    }
+
+    // The volume is handed to the main thread once this returns, so pack it
+    // now; this is a plain copy of the face arrays.
+    auto data = std::make_shared<std::vector<U8>>();
+    if (!volume->packOptimizedFaces(*data))
+    {
+        LLMutexLock lock(&mMutex);
+        mPendingWrites.erase(key);
+        return;
+    }
+
+    auto work = [self = shared_from_this(), key, source_size, data]()
+    {
+        self->writeFile(key, source_size, *data);
+    };
+
+    LL::WorkQueue::ptr_t queue = LL::WorkQueue::getInstance("General");
+    if (!queue || !queue->post(work))
+    {
+        work();
+    }
+}
+
+void LLMeshOptimizedCache::writeFile(const key_t& key, U32 source_size, const std::vector<U8>& data)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+    FileHeader header;
+    header.mMagic = FILE_MAGIC;
+    header.mLOD = (U32)key.mLOD;
+    header.mSculptFlags = key.mSculptFlags;
+    header.mSourceSize = source_size;
+    header.mDataSize = (U32)data.size();
+
+    // Written aside and renamed into place, so that a crash or a full disk
+    // never leaves a truncated entry under the final name.
+    bool ok = false;
+    const std::string filename = getFilename(key);
+    const std::string temp_filename = LLMappedFile::getTempFilename(filename);
+    LLFILE* file = LLFile::fopen(temp_filename, "wb");
+    if (file)
+    {
+        ok = fwrite(&header, sizeof(header), 1, file) == 1
+            && fwrite(data.data(), 1, data.size(), file) == data.size();
+        ok = (LLFile::close(file) == 0) && ok;
+    }
+    ok = ok && LLFile::rename(temp_filename, filename) == 0;
+
+    LLMutexLock lock(&mMutex);
+    mPendingWrites.erase(key);
+    if (!ok)
+    {
+        LL_WARNS() << "Unable to write optimized mesh " << filename << LL_ENDL;
+        LLFile::remove(temp_filename, ENOENT);
+        return;
+    }
+    ++mWrites;
+    insert(key, sizeof(header) + data.size());
+    evict();
+}
+
+void LLMeshOptimizedCache::clear()
+{
+    LLMutexLock lock(&mMutex);
+    mLRU.clear();
+    mEntries.clear();
+    mBytes = 0;
+    if (!mReadOnly)
+    {
+        std::string filename;
+        LLDirIterator iter(mDir, entry_file_mask);
+        while (iter.next(filename))
+        {
+            // A file being read is left for the next scan() to pick up
+            key_t key;
+            if (parseFilename(filename, key) && mReading.count(key))
+            {
+                continue;
+            }
+            LLFile::remove(gDirUtilp->add(mDir, filename));
+        }
+    }
+}
+
+F32 LLMeshOptimizedCache::getHitRate() const
+{
+    U64 hits = mHits;
+    U64 lookups = hits + mMisses;
+    return lookups ? (F32)hits / (F32)lookups : 0.f;
+}
+
+U64 LLMeshOptimizedCache::getBytes()
+{
+    LLMutexLock lock(&mMutex);
+    return mBytes;
+}
+
+U32 LLMeshOptimizedCache::getNumEntries()
+{
+    LLMutexLock lock(&mMutex);
+    return (U32)mEntries.size();
+}
+
+void LLMeshOptimizedCache::insert(const key_t& key, U64 size)
+{
+    erase(key);
+    mLRU.push_back({ key, size });
+    mEntries[key] = std::prev(mLRU.end());
+    mBytes += size;
+}
+
+void LLMeshOptimizedCache::erase(const key_t& key)
+{
+    auto iter = mEntries.find(key);
+    if (iter != mEntries.end())
+    {
+        mBytes -= iter->second->mSize;
+        mLRU.erase(iter->second);
+        mEntries.erase(iter);
+    }
+}
+
+void LLMeshOptimizedCache::evict()
+{
+    // Entries being read stay until a later eviction, as Windows refuses to
+    // delete a mapped file
+    for (lru_t::iterator iter = mLRU.begin(); mBytes > mMaxBytes && iter != mLRU.end(); )
+    {
+        key_t key = (iter++)->mKey;
+        if (mReading.count(key))
+        {
+            continue;
+        }
+        erase(key);
+        if (!mReadOnly)
+        {
+            LLFile::remove(getFilename(key), ENOENT);
+        }
+        ++mEvictions;
+    }
+}
@@ -0,0 +1,146 @@
+/**
+ * @file llmeshoptimizedcache.h
+ * @brief Cache of mesh LODs in their unpacked, optimized layout
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+#ifndef LL_LLMESHOPTIMIZEDCACHE_H
+#define LL_LLMESHOPTIMIZEDCACHE_H
+
+#include "llmutex.h"
+#include "lluuid.h"
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <tuple>
+
+class LLVolume;
+class LLVolumeParams;
+
+/**
+ * Disk cache of mesh LODs as LLVolume::unpackVolumeFaces() leaves them:
+ * dequantized, with tangents generated and cacheOptimize() applied. A LOD
+ * found here is restored by mapping its file and copying the face arrays
+ * back, skipping the inflate, LLSD parse and vertex cache optimization.
+ *
+ * Entries are keyed by mesh UUID, sculpt mirror and invert flags (applied
+ * while unpacking) and LOD, and remember the size of the asset block they
+ * were built from, so a LOD that no longer matches the asset is rebuilt
+ * rather than used.
+ *
+ * The cache is held under a size budget by evicting the least recently used
+ * entries that are not being read. Writes go to a temporary file renamed
+ * into place, are handed to the "General" thread pool and keep the cache
+ * alive until they are done, hence the shared ownership.
+ *
+ * All methods are thread safe.
+ */
+class LLMeshOptimizedCache : public std::enable_shared_from_this<LLMeshOptimizedCache>
+{
+    LOG_CLASS(LLMeshOptimizedCache);
+public:
+    LLMeshOptimizedCache(const std::string& dir, U64 max_bytes, bool read_only);
+    ~LLMeshOptimizedCache();
+
+    // Fill volume with the cached faces of the mesh of mesh_params at lod.
+    // source_size is the size of the LOD block in the mesh asset. Returns
+    // false on a miss.
+    bool read(const LLVolumeParams& mesh_params, S32 lod, U32 source_size, LLVolume* volume);
+    // Store the faces of a freshly unpacked volume. The faces are copied
+    // before this returns.
+    void write(const LLVolumeParams& mesh_params, S32 lod, U32 source_size, const LLVolume* volume);
+    // Forget everything and remove the files
+    void clear();
+
+    U64 getHits() const { return mHits; }
+    U64 getMisses() const { return mMisses; }
+    F32 getHitRate() const;
+    U64 getBytes();
+    U32 getNumEntries();
+
+private:
+    struct key_t
+    {
+        LLUUID  mID;
+        U8      mSculptFlags;
+        S32     mLOD;
+
+        bool operator<(const key_t& rhs) const
+        {
+            return std::tie(mID, mSculptFlags, mLOD) < std::tie(rhs.mID, rhs.mSculptFlags, rhs.mLOD);
+        }
+    };
+    struct Entry
+    {
+        key_t   mKey;
+        U64     mSize;
+    };
+    typedef std::list<Entry> lru_t;     // least recently used at the front
+
+    // File header, followed by the output of LLVolume::packOptimizedFaces()
+    struct FileHeader
+    {
+        U32 mMagic;
+        U32 mLOD;
+        U32 mSculptFlags;
+        U32 mSourceSize;
+        U32 mDataSize;
+    };
+
+    static key_t makeKey(const LLVolumeParams& mesh_params, S32 lod);
+    // Parses <uuid>_<lod>_<flags>.mopt
+    static bool parseFilename(const std::string& filename, key_t& key);
+    std::string getFilename(const key_t& key) const;
+    void scan();
+    void writeFile(const key_t& key, U32 source_size, const std::vector<U8>& data);
+
+    // mMutex must be locked for the following
+    void insert(const key_t& key, U64 size);
+    void erase(const key_t& key);
+    void evict();
+
+    LLMutex mMutex;
+    std::string mDir;
+    U64 mMaxBytes;
+    bool mReadOnly;
+
+    lru_t mLRU;
+    std::map<key_t, lru_t::iterator> mEntries;
+    std::set<key_t> mPendingWrites;
+    std::multiset<key_t> mReading;     // mapped by read(), not to be removed
+    U64 mBytes{ 0 };
+
+    std::atomic<U64> mHits{ 0 };
+    std::atomic<U64> mMisses{ 0 };
+    std::atomic<U64> mWrites{ 0 };
+    std::atomic<U64> mEvictions{ 0 };
+};
+
+#endif // LL_LLMESHOPTIMIZEDCACHE_H
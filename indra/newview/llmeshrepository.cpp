@@ -973,6 +973,10 @@ LLMeshRepoThread::LLMeshRepoThread()
     mHttpLargeOptions = std::make_shared<LLCore::HttpOptions>();
     mHttpLargeOptions->setTransferTimeout(LARGE_MESH_XFER_TIMEOUT);
     mHttpLargeOptions->setUseRetryAfter(gSavedSettings.getBOOL("MeshUseHttpRetryAfter"));
+    // <AS:Chanayane> Contiguous replies
+    mHttpOptions->setContiguousReply(true);
+    mHttpLargeOptions->setContiguousReply(true);
+    // </AS:Chanayane>
     mHttpHeaders = std::make_shared<LLCore::HttpHeaders>();
     mHttpHeaders->append(HTTP_OUT_HEADER_ACCEPT, HTTP_CONTENT_VND_LL_MESH);
     mHttpPolicyClass = app_core_http.getPolicy(LLAppCoreHttp::AP_MESH2);
@@ -983,6 +987,20 @@ LLMeshRepoThread::LLMeshRepoThread()
     // and a need to do expensive cacheOptimize().
     mMeshThreadPool = std::make_unique<LL::ThreadPool>("MeshLodProcessing", 2);
     mMeshThreadPool->start();
+
+    // <AS:Chanayane> Pre-optimized mesh LOD cache
+    bool read_only = LLAppViewer::instance()->isSecondInstance();
+    std::string optimized_dirname = gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "meshopt");
+    if (gSavedSettings.getBOOL("ASMeshOptimizedCache"))
+    {
+        U64 optimized_max_bytes = (U64)gSavedSettings.getU32("ASMeshOptimizedCacheSizeMB") * 1024 * 1024;
+        mOptimizedCache = std::make_shared<LLMeshOptimizedCache>(optimized_dirname, optimized_max_bytes, read_only);
+    }
+    else if (!read_only && LLFile::isdir(optimized_dirname))
+    {
+        gDirUtilp->deleteDirAndContents(optimized_dirname);
+    }
+    // </AS:Chanayane>
 }
 
 
@@ -2139,8 +2157,16 @@ bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod)
             LLFileSystem file(mesh_id, LLAssetType::AT_MESH);
             if (in_cache && (file.getSize() >= disk_ofset + size))
             {
-                U8* buffer = new(std::nothrow) U8[size]; // todo, make buffer thread local and read in thread?
-                if (!buffer)
+                // <AS:Chanayane> Memory-mapped reads
+                // The span either points into a shared mapping of the cache
+                // file or owns a heap copy; the parsing lambda keeps it alive.
+                //U8* buffer = new(std::nothrow) U8[size]; // todo, make buffer thread local and read in thread?
+                //if (!buffer)
+                LLFileSystem::ReadSpan span;
+                file.seek(disk_ofset);
+                file.readSpan(span, size);
+                if (span.allocationFailed())
+                // </AS:Chanayane>
                 {
                     LL_WARNS(LOG_MESH) << "Can't allocate memory for mesh " << mesh_id << " LOD " << lod << ", size: " << size << LL_ENDL;
 
@@ -2158,30 +2184,38 @@ bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod)
                 }
                 LLMeshRepository::sCacheBytesRead += size;
                 ++LLMeshRepository::sCacheReads;
-                file.seek(disk_ofset);
-                file.read(buffer, size);
+                // <AS:Chanayane> Memory-mapped reads
+                //file.seek(disk_ofset);
+                //file.read(buffer, size);
+                const U8* buffer = span.getData();
+                // </AS:Chanayane>
 
                 //make sure buffer isn't all 0's by checking the first 1KB (reserved block but not written)
                 bool zero = true;
-                for (S32 i = 0; i < llmin(size, 1024) && zero; ++i)
+                // <AS:Chanayane> Memory-mapped reads
+                //for (S32 i = 0; i < llmin(size, 1024) && zero; ++i)
+                for (S32 i = 0; i < llmin(span.getSize(), 1024) && zero; ++i)
+                // </AS:Chanayane>
                 {
                     zero = buffer[i] == 0;
                 }
 
-                if (!zero)
+                // <AS:Chanayane> Memory-mapped reads
+                //if (!zero)
+                if (!zero && span.getSize() == size)
+                // </AS:Chanayane>
                 {
                     //attempt to parse
                     const LLVolumeParams params(mesh_params);
                     bool posted = mMeshThreadPool->getQueue().post(
-                        [params, mesh_id, lod, buffer, size]
+                        [params, mesh_id, lod, span, size] // <AS:Chanayane/> Memory-mapped reads
                         ()
                     {
                         if (gMeshRepo.mThread->isShuttingDown())
                         {
-                            delete[] buffer;
                             return;
                         }
-                        if (gMeshRepo.mThread->lodReceived(params, lod, buffer, size) == MESH_OK)
+                        if (gMeshRepo.mThread->lodReceived(params, lod, span.getData(), size) == MESH_OK)
                         {
                             LL_DEBUGS(LOG_MESH) << "Mesh/Cache: Mesh body for ID " << mesh_id << " - was retrieved from the cache." << LL_ENDL;
                         }
@@ -2228,25 +2262,21 @@ bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod)
                                 LLMeshRepository::sLODProcessing++;
                             }
                         }
-                        delete[] buffer;
                     });
 
                     if (posted)
                     {
-                        // now lambda owns buffer
+                        // now lambda owns the span
                         return true;
                     }
                     else if (lodReceived(mesh_params, lod, buffer, size) == MESH_OK)
                     {
-                        delete[] buffer;
                         LL_DEBUGS(LOG_MESH) << "Mesh/Cache: Mesh body for ID " << mesh_id << " - was retrieved from the cache." << LL_ENDL;
 
                         return true;
                     }
 
                 }
-
-                delete[] buffer;
             }
 
             //reading from cache failed for whatever reason, fetch from sim
@@ -2321,9 +2351,13 @@ EMeshProcessingResult LLMeshRepoThread::headerReceived(const LLVolumeParams& mes
 
         data_size = (S32)dsize;
 
-        boost::iostreams::stream<boost::iostreams::array_source> stream(result_ptr, data_size);
+        // <AS:Chanayane> Zero-copy binary LLSD parsing
+        //boost::iostreams::stream<boost::iostreams::array_source> stream(result_ptr, data_size);
 
-        if (!LLSDSerialize::fromBinary(header_data, stream, data_size))
+        //if (!LLSDSerialize::fromBinary(header_data, stream, data_size))
+        size_t bytes_read = 0;
+        if (!LLSDSerialize::fromBinary(header_data, (const U8*)result_ptr, data_size, -1, &bytes_read))
+        // </AS:Chanayane>
         {
             LL_WARNS(LOG_MESH) << "Mesh header parse error.  Not a valid mesh asset!  ID:  " << mesh_id
                                << LL_ENDL;
@@ -2346,7 +2380,8 @@ EMeshProcessingResult LLMeshRepoThread::headerReceived(const LLVolumeParams& mes
         // make sure there is at least one lod, function returns -1 and marks as 404 otherwise
         else if (LLMeshRepository::getActualMeshLOD(header, 0) >= 0)
         {
-            header.mHeaderSize = (S32)stream.tellg();
+            //header.mHeaderSize = (S32)stream.tellg();
+            header.mHeaderSize = (S32)bytes_read; // <AS:Chanayane/> Zero-copy binary LLSD parsing
             header_size += header.mHeaderSize;
             skin_offset = header.mSkinOffset;
             skin_size = header.mSkinSize;
@@ -2478,7 +2513,7 @@ EMeshProcessingResult LLMeshRepoThread::headerReceived(const LLVolumeParams& mes
     return MESH_OK;
 }
 
-EMeshProcessingResult LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size)
+EMeshProcessingResult LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_params, S32 lod, const U8* data, S32 data_size)
 {
     if (data == NULL || data_size == 0)
     {
@@ -2486,7 +2521,19 @@ EMeshProcessingResult LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_p
     }
 
     LLPointer<LLVolume> volume = new LLVolume(mesh_params, LLVolumeLODGroup::getVolumeScaleFromDetail(lod));
-    if (volume->unpackVolumeFaces(data, data_size))
+    // <AS:Chanayane> Pre-optimized mesh LOD cache
+    //if (volume->unpackVolumeFaces(data, data_size))
+    bool unpacked = mOptimizedCache && mOptimizedCache->read(mesh_params, lod, (U32)data_size, volume);
+    if (!unpacked && volume->unpackVolumeFaces(data, data_size))
+    {
+        unpacked = true;
+        if (mOptimizedCache)
+        {
+            mOptimizedCache->write(mesh_params, lod, (U32)data_size, volume);
+        }
+    }
+    if (unpacked)
+    // </AS:Chanayane>
     {
         // Use LLVolume::getNumVolumeFaces() here and not LLVolume::getNumFaces(),
         // because setMeshAssetLoaded() has not yet been called for this volume
@@ -3711,8 +3758,22 @@ void LLMeshHandlerBase::onCompleted(LLCore::HttpHandle handle, LLCore::HttpRespo
             // handler, optional first that takes a body, fallback second
             // that requires a temporary allocation and data copy.
             body_offset = mOffset - offset;
-            data = new(std::nothrow) U8[data_size - body_offset];
+            // <AS:Chanayane> Contiguous replies
+            // A body that arrived in one reserved block is taken over as
+            // is.  Handler data is ll_aligned_malloc_16 memory either way.
+            //data = new(std::nothrow) U8[data_size - body_offset];
+            if (0 == body_offset)
+            {
+                size_t detached_size(0);
+                data = (U8 *) body->detachContiguous(&detached_size);
+                llassert(! data || detached_size == data_size);
+            }
             if (data)
+            {
+                LLMeshRepository::sBytesReceived += static_cast<U32>(data_size);
+            }
+            else if ((data = (U8 *) ll_aligned_malloc_16(data_size - body_offset)))
+            // </AS:Chanayane>
             {
                 body->read(body_offset, (char *) data, data_size - body_offset);
                 LLMeshRepository::sBytesReceived += static_cast<U32>(data_size);
@@ -3728,7 +3789,7 @@ void LLMeshHandlerBase::onCompleted(LLCore::HttpHandle handle, LLCore::HttpRespo
 
         if (mHasDataOwnership)
         {
-            delete [] data;
+            ll_aligned_free_16(data); // <AS:Chanayane/> Contiguous replies
         }
     }
 
@@ -3976,12 +4037,12 @@ void LLMeshLODHandler::processData(LLCore::BufferArray * /* body */, S32 /* body
         {
             if (gMeshRepo.mThread->isShuttingDown())
             {
-                delete[] data;
+                ll_aligned_free_16(data); // <AS:Chanayane/> Contiguous replies
                 return;
             }
             LLMeshLODHandler* handler = (LLMeshLODHandler * )shrd_handler.get();
             handler->processLod(data, data_size);
-            delete[] data;
+            ll_aligned_free_16(data); // <AS:Chanayane/> Contiguous replies
         });
 
         if (posted)
@@ -4094,12 +4155,12 @@ void LLMeshSkinInfoHandler::processData(LLCore::BufferArray * /* body */, S32 /*
         {
             if (gMeshRepo.mThread->isShuttingDown())
             {
-                delete[] data;
+                ll_aligned_free_16(data); // <AS:Chanayane/> Contiguous replies
                 return;
             }
             LLMeshSkinInfoHandler* handler = (LLMeshSkinInfoHandler*)shrd_handler.get();
             handler->processSkin(data, data_size);
-            delete[] data;
+            ll_aligned_free_16(data); // <AS:Chanayane/> Contiguous replies
         });
 
         if (posted)
@@ -4314,6 +4375,8 @@ void LLMeshRepository::shutdown()
 
     metrics_teleport_started_signal.disconnect();
 
+    mLODCache.clear(); // <AS:Chanayane/> Decoded mesh LOD cache
+
     for (U32 i = 0; i < mUploads.size(); ++i)
     {
         LL_INFOS(LOG_MESH) << "Discard the pending mesh uploads." << LL_ENDL;
@@ -4407,6 +4470,28 @@ S32 LLMeshRepository::loadMesh(LLVOVolume* vobj, const LLVolumeParams& mesh_para
         return new_lod;
     }
 
+    // <AS:Chanayane> Decoded mesh LOD cache
+    // Faces decoded earlier are copied back without a new fetch and decode
+    if (LLVolume* cached = mLODCache.find(mesh_params, new_lod))
+    {
+        LLVolume* sys_volume = LLPrimitive::getVolumeManager()->refVolume(mesh_params, new_lod);
+        if (sys_volume)
+        {
+            if (sys_volume != cached)
+            {
+                // The cached volume outlived its LOD group: hand its faces
+                // over to the new system volume and keep that one instead
+                sys_volume->copyVolumeFaces(cached);
+                sys_volume->setMeshAssetLoaded(true);
+                mLODCache.insert(mesh_params, new_lod, sys_volume);
+            }
+            LLPrimitive::getVolumeManager()->unrefVolume(sys_volume);
+            vobj->notifyMeshLoaded();
+            return new_lod;
+        }
+    }
+    // </AS:Chanayane>
+
     {
         LLMutexLock lock(mMeshMutex);
         //add volume to list of loading meshes
@@ -4505,6 +4590,12 @@ void LLMeshRepository::notifyLoadedMeshes()
     //                                             REQUEST2_LOW_WATER_MIN,
     //                                             REQUEST2_LOW_WATER_MAX);
 
+    // <AS:Chanayane> Decoded mesh LOD cache
+    static LLCachedControl<U32> lod_cache_mb(gSavedSettings, "ASMeshLODCacheMB");
+    mLODCache.setBudget((U64)lod_cache_mb() * 1024 * 1024);
+    mLODCache.update();
+    // </AS:Chanayane>
+
     if (mLegacyGetMeshVersion == 1)
     {
         // Legacy GetMesh operation with high connection concurrency
@@ -4899,6 +4990,8 @@ void LLMeshRepository::notifyMeshLoaded(const LLVolumeParams& mesh_params, LLVol
             {
                 sys_volume->copyVolumeFaces(volume);
                 sys_volume->setMeshAssetLoaded(true);
+                // Keep the system volume for when this LOD is needed again
+                mLODCache.insert(mesh_params, detail, sys_volume); // <AS:Chanayane/> Decoded mesh LOD cache
                 LLPrimitive::getVolumeManager()->unrefVolume(sys_volume);
             }
             else
@@ -46,6 +46,8 @@
 
 #include "llconvexdecomposition.h"
 #include "lluploadfloaterobservers.h"
+#include "llmeshlodcache.h" // <AS:Chanayane/> Decoded mesh LOD cache
+#include "llmeshoptimizedcache.h" // <AS:Chanayane/> Pre-optimized mesh LOD cache
 
 class LLVOVolume;
 class LLMutex;
@@ -559,6 +561,10 @@ public:
     LL::WorkQueue mWorkQueue;
     // lods have their own thread due to costly cacheOptimize() calls
     std::unique_ptr<LL::ThreadPool> mMeshThreadPool;
+    // <AS:Chanayane> Pre-optimized mesh LOD cache
+    // LODs in their unpacked layout, so they skip unpackVolumeFaces(); null if disabled
+    std::shared_ptr<LLMeshOptimizedCache> mOptimizedCache;
+    // </AS:Chanayane>
 
     // llcorehttp library interface objects.
     LLCore::HttpStatus                  mHttpStatus;
@@ -593,7 +599,7 @@ public:
     bool fetchMeshHeader(const LLVolumeParams& mesh_params);
     bool fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod);
     EMeshProcessingResult headerReceived(const LLVolumeParams& mesh_params, U8* data, S32 data_size, U32 flags = 0);
-    EMeshProcessingResult lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size);
+    EMeshProcessingResult lodReceived(const LLVolumeParams& mesh_params, S32 lod, const U8* data, S32 data_size); // <AS:Chanayane/> Memory-mapped reads: accept read-only data
     bool skinInfoReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
     bool decompositionReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
     EMeshProcessingResult physicsShapeReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
@@ -975,6 +981,7 @@ public:
     U32 mMeshThreadCount;
 
     LLMeshRepoThread* mThread;
+    LLMeshLODCache mLODCache; // <AS:Chanayane/> Decoded mesh LOD cache
     std::vector<LLMeshUploadThread*> mUploads;
     std::vector<LLMeshUploadThread*> mUploadWaitList;
 
@@ -0,0 +1,210 @@
+/**
+ * @file llsnapshotcompositor.cpp
+ * @brief Asynchronous read back and compositing of snapshot tiles
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llsnapshotcompositor.h"
+
+#include "llgl.h"
+#include "llglheaders.h"
+#include "llimage.h"
+#include "workqueue.h"
+
+#include <thread>
+
+// Rows below which a tile is not worth splitting between threads
+static constexpr S32 MIN_ROWS_PER_COPY = 64;
+
+LLSnapshotCompositor::LLSnapshotCompositor(LLImageRaw* raw)
+:   mRaw(raw)
+{
+}
+
+LLSnapshotCompositor::~LLSnapshotCompositor()
+{
+    finish();
+
+    for (Slot& slot : mSlots)
+    {
+        if (slot.mBuffer)
+        {
+            glDeleteBuffers(1, &slot.mBuffer);
+            slot.mBuffer = 0;
+        }
+    }
+}
+
+void LLSnapshotCompositor::readTile(S32 x, S32 y, S32 width, S32 height, U8* dst, S32 dst_stride)
+{
+    LL_PROFILE_ZONE_SCOPED;
+    if (width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    Slot& slot = mSlots[mNext];
+    Slot& previous = mSlots[mNext ^ 1];
+    mNext ^= 1;
+
+    // This slot held the tile before the previous one, its copy ran while
+    // the previous tile rendered
+    releaseSlot(slot);
+
+    const U32 size = width * height * 3;
+    if (!slot.mBuffer)
+    {
+        glGenBuffers(1, &slot.mBuffer);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.mBuffer);
+    if (slot.mSize < size)
+    {
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+        slot.mSize = size;
+    }
+
+    GLint pack_alignment = 4;
+    glGetIntegerv(GL_PACK_ALIGNMENT, &pack_alignment);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(x, y, width, height, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    glPixelStorei(GL_PACK_ALIGNMENT, pack_alignment);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.mWidth = width;
+    slot.mHeight = height;
+    slot.mDst = dst;
+    slot.mDstStride = dst_stride;
+    slot.mQueued = true;
+
+    // The previous tile's read back was queued ahead of this tile's
+    // rendering, mapping it now rarely waits
+    if (previous.mQueued)
+    {
+        startCopy(previous);
+    }
+}
+
+void LLSnapshotCompositor::finish()
+{
+    LL_PROFILE_ZONE_SCOPED;
+    // Oldest tile first
+    for (U32 i = 0; i < 2; ++i)
+    {
+        Slot& slot = mSlots[(mNext + i) & 1];
+        if (slot.mQueued)
+        {
+            startCopy(slot);
+        }
+    }
+    for (Slot& slot : mSlots)
+    {
+        releaseSlot(slot);
+    }
+}
+
+void LLSnapshotCompositor::startCopy(Slot& slot)
+{
+    LL_PROFILE_ZONE_SCOPED;
+    slot.mQueued = false;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.mBuffer);
+    const U8* src = (const U8*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, slot.mWidth * slot.mHeight * 3, GL_MAP_READ_BIT);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (!src)
+    {
+        LL_WARNS("Snapshot") << "Could not map a snapshot tile, " << slot.mWidth << "x" << slot.mHeight << " pixels lost" << LL_ENDL;
+        return;
+    }
+    slot.mMapped = true;
+
+    const S32 src_stride = slot.mWidth * 3;
+    const S32 dst_stride = slot.mDstStride;
+    U8* dst = slot.mDst;
+    auto copy_rows = [src, src_stride, dst, dst_stride](S32 begin, S32 end)
+    {
+        for (S32 row = begin; row < end; ++row)
+        {
+            memcpy(dst + row * dst_stride, src + row * src_stride, src_stride);
+        }
+    };
+
+    LL::WorkQueue::ptr_t queue = LL::WorkQueue::getInstance("General");
+    const S32 threads = llmax(1, (S32)std::thread::hardware_concurrency());
+    const S32 chunks = llclamp(slot.mHeight / MIN_ROWS_PER_COPY, 1, threads);
+    if (!queue)
+    {
+        copy_rows(0, slot.mHeight);
+        return;
+    }
+
+    const S32 rows_per_chunk = (slot.mHeight + chunks - 1) / chunks;
+    auto job = std::make_shared<CopyJob>();
+    job->mPending = (slot.mHeight + rows_per_chunk - 1) / rows_per_chunk;
+    slot.mJob = job;
+
+    for (S32 begin = 0; begin < slot.mHeight; begin += rows_per_chunk)
+    {
+        const S32 end = llmin(begin + rows_per_chunk, slot.mHeight);
+        auto work = [job, copy_rows, begin, end]()
+        {
+            copy_rows(begin, end);
+            std::lock_guard<std::mutex> lock(job->mMutex);
+            if (--job->mPending == 0)
+            {
+                job->mCond.notify_all();
+            }
+        };
+        if (!queue->post(work))
+        {
+            // Pool shutting down, do it here
+            work();
+        }
+    }
+}
+
+void LLSnapshotCompositor::releaseSlot(Slot& slot)
+{
+    if (slot.mJob)
+    {
+        LL_PROFILE_ZONE_NAMED("snapshot tile copy wait");
+        std::unique_lock<std::mutex> lock(slot.mJob->mMutex);
+        slot.mJob->mCond.wait(lock, [&slot]() { return slot.mJob->mPending == 0; });
+        lock.unlock();
+        slot.mJob.reset();
+    }
+
+    if (slot.mMapped)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.mBuffer);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        slot.mMapped = false;
+    }
+}
@@ -0,0 +1,103 @@
+/**
+ * @file llsnapshotcompositor.h
+ * @brief Asynchronous read back and compositing of snapshot tiles
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+
+#ifndef LL_LLSNAPSHOTCOMPOSITOR_H
+#define LL_LLSNAPSHOTCOMPOSITOR_H
+
+#include "llpointer.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+class LLImageRaw;
+
+/**
+ * Reads the colour tiles of a high resolution snapshot back into the
+ * output image without stalling the main thread.
+ *
+ * Each tile is read with a single glReadPixels() into one of two pixel
+ * pack buffers. The previous tile's buffer is mapped at that point and its
+ * rows are copied into the image by the "General" thread pool while the
+ * main thread renders the next tile. A buffer is only reused once the
+ * copy out of it has finished, so the extra memory is two tiles worth.
+ *
+ * Main thread only, with the GL context current.
+ */
+class LLSnapshotCompositor
+{
+public:
+    LLSnapshotCompositor(LLImageRaw* raw);
+    ~LLSnapshotCompositor();
+
+    LLSnapshotCompositor(const LLSnapshotCompositor&) = delete;
+    LLSnapshotCompositor& operator=(const LLSnapshotCompositor&) = delete;
+
+    // Queue the read back of the width x height RGB window region at (x, y)
+    // to dst, rows dst_stride bytes apart in the image
+    void readTile(S32 x, S32 y, S32 width, S32 height, U8* dst, S32 dst_stride);
+
+    // Wait until every queued tile is in the image. Called by the
+    // destructor as well.
+    void finish();
+
+private:
+    struct CopyJob
+    {
+        std::mutex              mMutex;
+        std::condition_variable mCond;
+        U32                     mPending{ 0 };
+    };
+
+    struct Slot
+    {
+        U32                         mBuffer{ 0 };
+        U32                         mSize{ 0 };
+        S32                         mWidth{ 0 };
+        S32                         mHeight{ 0 };
+        U8*                         mDst{ nullptr };
+        S32                         mDstStride{ 0 };
+        bool                        mQueued{ false };   // read back issued, not copied yet
+        bool                        mMapped{ false };
+        std::shared_ptr<CopyJob>    mJob;
+    };
+
+    // Map the slot's buffer and start copying it to the image
+    void startCopy(Slot& slot);
+    // Wait for the slot's copy and unmap its buffer
+    void releaseSlot(Slot& slot);
+
+    LLPointer<LLImageRaw>   mRaw;   // keeps the destination alive while copies run
+    Slot                    mSlots[2];
+    U32                     mNext{ 0 };
+};
+
+#endif // LL_LLSNAPSHOTCOMPOSITOR_H
@@ -72,6 +72,7 @@ constexpr S32 MAX_TEXTURE_SIZE = 2048 ; //max upload texture size 2048 * 2048
 
 std::set<LLSnapshotLivePreview*> LLSnapshotLivePreview::sList;
 LLPointer<LLImageFormatted> LLSnapshotLivePreview::sSaveLocalImage = nullptr;
+LLPointer<LLImageRaw> LLSnapshotLivePreview::sSaveLocalRaw = nullptr; // <AS:Chanayane/> Streaming encoders
 
 LLSnapshotLivePreview::LLSnapshotLivePreview (const LLSnapshotLivePreview::Params& p)
     :   LLView(p),
@@ -138,6 +139,7 @@ LLSnapshotLivePreview::~LLSnapshotLivePreview()
     //  gIdleCallbacks.deleteFunction( &LLSnapshotLivePreview::onIdle, (void*)this );
     sList.erase(this);
     sSaveLocalImage = NULL;
+    sSaveLocalRaw = NULL; // <AS:Chanayane/> Streaming encoders
 }
 
 void LLSnapshotLivePreview::setMaxImageSize(S32 size)
@@ -1011,25 +1013,28 @@ LLPointer<LLImageFormatted> LLSnapshotLivePreview::getFormattedImage()
             }
         }
 
-        // Create the new formatted image of the appropriate format.
-        LLSnapshotModel::ESnapshotFormat format = getSnapshotFormat();
-        LL_DEBUGS("Snapshot") << "Encoding new image of format " << format << LL_ENDL;
-
-        switch (format)
-        {
-            case LLSnapshotModel::SNAPSHOT_FORMAT_PNG:
-                mFormattedImage = new LLImagePNG();
-                break;
-            case LLSnapshotModel::SNAPSHOT_FORMAT_JPEG:
-                mFormattedImage = new LLImageJPEG(mSnapshotQuality);
-                break;
-            case LLSnapshotModel::SNAPSHOT_FORMAT_BMP:
-                mFormattedImage = new LLImageBMP();
-                break;
-            case LLSnapshotModel::SNAPSHOT_FORMAT_WEBP:
-                mFormattedImage = new LLImageWebP();
-                break;
-        }
+        // <AS:Chanayane> Streaming encoders
+        //// Create the new formatted image of the appropriate format.
+        //LLSnapshotModel::ESnapshotFormat format = getSnapshotFormat();
+        //LL_DEBUGS("Snapshot") << "Encoding new image of format " << format << LL_ENDL;
+        //
+        //switch (format)
+        //{
+        //    case LLSnapshotModel::SNAPSHOT_FORMAT_PNG:
+        //        mFormattedImage = new LLImagePNG();
+        //        break;
+        //    case LLSnapshotModel::SNAPSHOT_FORMAT_JPEG:
+        //        mFormattedImage = new LLImageJPEG(mSnapshotQuality);
+        //        break;
+        //    case LLSnapshotModel::SNAPSHOT_FORMAT_BMP:
+        //        mFormattedImage = new LLImageBMP();
+        //        break;
+        //    case LLSnapshotModel::SNAPSHOT_FORMAT_WEBP:
+        //        mFormattedImage = new LLImageWebP();
+        //        break;
+        //}
+        mFormattedImage = createFormattedImage();
+        // </AS:Chanayane>
         if (mFormattedImage->encode(mPreviewImage, 0))
         {
             // We can update the data size precisely at that point
@@ -1039,6 +1044,33 @@ LLPointer<LLImageFormatted> LLSnapshotLivePreview::getFormattedImage()
     return mFormattedImage;
 }
 
+// <AS:Chanayane> Streaming encoders
+LLPointer<LLImageFormatted> LLSnapshotLivePreview::createFormattedImage() const
+{
+    // Create the new formatted image of the appropriate format.
+    LLSnapshotModel::ESnapshotFormat format = getSnapshotFormat();
+    LL_DEBUGS("Snapshot") << "Encoding new image of format " << format << LL_ENDL;
+
+    LLPointer<LLImageFormatted> formatted;
+    switch (format)
+    {
+        case LLSnapshotModel::SNAPSHOT_FORMAT_PNG:
+            formatted = new LLImagePNG();
+            break;
+        case LLSnapshotModel::SNAPSHOT_FORMAT_JPEG:
+            formatted = new LLImageJPEG(mSnapshotQuality);
+            break;
+        case LLSnapshotModel::SNAPSHOT_FORMAT_BMP:
+            formatted = new LLImageBMP();
+            break;
+        case LLSnapshotModel::SNAPSHOT_FORMAT_WEBP:
+            formatted = new LLImageWebP();
+            break;
+    }
+    return formatted;
+}
+// </AS:Chanayane>
+
 void LLSnapshotLivePreview::setSize(S32 w, S32 h)
 {
     LL_DEBUGS("Snapshot") << "setSize(" << w << ", " << h << ")" << LL_ENDL;
@@ -1137,17 +1169,57 @@ void LLSnapshotLivePreview::saveTexture(bool outfit_snapshot, std::string name)
 
 void LLSnapshotLivePreview::saveLocal(const snapshot_saved_signal_t::slot_type& success_cb, const snapshot_saved_signal_t::slot_type& failure_cb)
 {
-    // Update mFormattedImage if necessary
-    getFormattedImage();
+    // <AS:Chanayane> Streaming encoders
+    // Encode straight to the file unless the freeze frame preview already holds the encoded image
+    //// Update mFormattedImage if necessary
+    //getFormattedImage();
+    //
+    //// Save the formatted image
+    //saveLocal(mFormattedImage, success_cb, failure_cb);
+    if (mFormattedImage.notNull())
+    {
+        // Save the formatted image
+        saveLocal(mFormattedImage, success_cb, failure_cb);
+        return;
+    }
 
-    // Save the formatted image
-    saveLocal(mFormattedImage, success_cb, failure_cb);
+    LLImageDataSharedLock lock(mPreviewImage);
+
+    // Filter a copy so that mPreviewImage is left as getFormattedImage() expects it
+    LLPointer<LLImageRaw> raw = new LLImageRaw(mPreviewImage->getData(),
+        mPreviewImage->getWidth(),
+        mPreviewImage->getHeight(),
+        mPreviewImage->getComponents());
+
+    if (getFilter() != "")
+    {
+        std::string filter_path = LLImageFiltersManager::getInstance()->getFilterPath(getFilter());
+        if (filter_path != "")
+        {
+            LLImageFilter filter(filter_path);
+            filter.executeFilter(raw);
+        }
+        else
+        {
+            LL_WARNS("Snapshot") << "Couldn't find a path to the following filter : " << getFilter() << LL_ENDL;
+        }
+    }
+
+    saveLocal(createFormattedImage(), success_cb, failure_cb, raw);
+    // </AS:Chanayane>
 }
 
 //Check if failed due to insufficient memory
-void LLSnapshotLivePreview::saveLocal(LLPointer<LLImageFormatted> image, const snapshot_saved_signal_t::slot_type& success_cb, const snapshot_saved_signal_t::slot_type& failure_cb)
+// <AS:Chanayane> Streaming encoders
+//void LLSnapshotLivePreview::saveLocal(LLPointer<LLImageFormatted> image, const snapshot_saved_signal_t::slot_type& success_cb, const snapshot_saved_signal_t::slot_type& failure_cb)
+void LLSnapshotLivePreview::saveLocal(LLPointer<LLImageFormatted> image, const snapshot_saved_signal_t::slot_type& success_cb, const snapshot_saved_signal_t::slot_type& failure_cb, LLPointer<LLImageRaw> raw)
+// </AS:Chanayane>
 {
     sSaveLocalImage = image;
+    // <AS:Chanayane> Streaming encoders
+    sSaveLocalRaw = raw;
 
-    gViewerWindow->saveImageNumbered(sSaveLocalImage, false, success_cb, failure_cb);
+    //gViewerWindow->saveImageNumbered(sSaveLocalImage, false, success_cb, failure_cb);
+    gViewerWindow->saveImageNumbered(sSaveLocalImage, false, success_cb, failure_cb, sSaveLocalRaw);
+    // </AS:Chanayane>
 }
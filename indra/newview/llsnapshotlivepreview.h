@@ -42,7 +42,11 @@ class LLSnapshotLivePreview : public LLView
 public:
     typedef boost::signals2::signal<void(void)> snapshot_saved_signal_t;
 
-    static void saveLocal(LLPointer<LLImageFormatted> image, const snapshot_saved_signal_t::slot_type& success_cb = snapshot_saved_signal_t(), const snapshot_saved_signal_t::slot_type& failure_cb = snapshot_saved_signal_t());
+    // <AS:Chanayane> Streaming encoders
+    // When raw is given, image is only the (empty) codec and raw is encoded straight to the file
+    //static void saveLocal(LLPointer<LLImageFormatted> image, const snapshot_saved_signal_t::slot_type& success_cb = snapshot_saved_signal_t(), const snapshot_saved_signal_t::slot_type& failure_cb = snapshot_saved_signal_t());
+    static void saveLocal(LLPointer<LLImageFormatted> image, const snapshot_saved_signal_t::slot_type& success_cb = snapshot_saved_signal_t(), const snapshot_saved_signal_t::slot_type& failure_cb = snapshot_saved_signal_t(), LLPointer<LLImageRaw> raw = nullptr);
+    // </AS:Chanayane>
     struct Params : public LLInitParam::Block<Params, LLView::Params>
     {
         Params()
@@ -108,6 +112,7 @@ public:
     void saveLocal(const snapshot_saved_signal_t::slot_type& success_cb, const snapshot_saved_signal_t::slot_type& failure_cb);
 
     LLPointer<LLImageFormatted> getFormattedImage();
+    LLPointer<LLImageFormatted> createFormattedImage() const; // <AS:Chanayane/> Streaming encoders: empty image of the snapshot format
     LLPointer<LLImageRaw>       getEncodedImage();
     bool createUploadFile(const std::string &out_file, const S32 max_image_dimentions, const S32 min_image_dimentions);
 
@@ -185,6 +190,7 @@ private:
     std::string                 mFilterName;
 
     static LLPointer<LLImageFormatted> sSaveLocalImage;
+    static LLPointer<LLImageRaw> sSaveLocalRaw; // <AS:Chanayane/> Streaming encoders
 
 public:
     static std::set<LLSnapshotLivePreview*> sList;
@@ -996,6 +996,7 @@ bool idle_startup()
 
             F32 dropPercent = gSavedSettings.getF32("PacketDropPercentage");
             msg->mPacketRing.setDropPercentage(dropPercent);
+            msg->mPacketRing.setBatchedIO(gSavedSettings.getBOOL("ASBatchedUDP")); // <AS:Chanayane/> Batched UDP receive and send
         }
 
         LL_INFOS("AppInit") << "Message System Initialized." << LL_ENDL;
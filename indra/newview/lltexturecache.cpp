@@ -34,6 +34,8 @@
 #include "llimagej2c.h" // for version control
 #include "lllfsthread.h"
 #include "llviewercontrol.h"
+#include "lltexturepackedstore.h" // <AS:Chanayane/> Packed texture storage
+#include "lltexturedecodedcache.h" // <AS:Chanayane/> Decoded texture cache
 
 // Included to allow LLTextureCache::purgeTextures() to pause watchdog timeout
 #include "llappviewer.h"
@@ -46,6 +48,10 @@
 //  First TEXTURE_CACHE_ENTRY_SIZE bytes of each texture in texture.entries in same order
 // cache/textures/[0-F]/UUID.texture
 //  Actual texture body files
+// <AS:Chanayane> Packed texture storage
+// cache/textures/slab_NNNN.bin, cache/textures/slabs.index
+//  Texture bodies when ASTextureCachePacked is set, see LLTexturePackedStore
+// </AS:Chanayane>
 
 //note: there is no good to define 1024 for TEXTURE_CACHE_ENTRY_SIZE while FIRST_PACKET_SIZE is 600 on sim side.
 const S32 TEXTURE_CACHE_ENTRY_SIZE = FIRST_PACKET_SIZE;//1024;
@@ -112,7 +118,8 @@ public:
           mResponder(responder),
           mFileHandle(LLLFSThread::nullHandle()),
           mBytesToRead(0),
-          mBytesRead(0)
+          mBytesRead(0),
+          mStartTime(LLTimer::getTotalTime()) // <AS:Chanayane/> Cache read latency percentiles
     {
     }
     ~LLTextureCacheWorker()
@@ -155,6 +162,7 @@ protected:
     LLLFSThread::handle_t mFileHandle;
     S32 mBytesToRead;
     LLAtomicS32 mBytesRead;
+    U64 mStartTime; // <AS:Chanayane/> Cache read latency percentiles
 };
 
 class LLTextureCacheLocalFileWorker : public LLTextureCacheWorker
@@ -446,7 +454,10 @@ bool LLTextureCacheRemoteWorker::doRead()
     if (!done && (mState == BODY))
     {
         std::string filename = mCache->getTextureFileName(mID);
-        S32 filesize = LLAPRFile::size(filename, mCache->getLocalAPRFilePool());
+        // <AS:Chanayane> Packed texture storage
+        //S32 filesize = LLAPRFile::size(filename, mCache->getLocalAPRFilePool());
+        S32 filesize = mCache->getBodySize(mID, filename, mCache->getLocalAPRFilePool());
+        // </AS:Chanayane>
 
         if (filesize && (filesize + TEXTURE_CACHE_ENTRY_SIZE) > mOffset)
         {
@@ -487,10 +498,16 @@ bool LLTextureCacheRemoteWorker::doRead()
                 mReadData = data;
 
                 // Read the data at last
-                S32 bytes_read = LLAPRFile::readEx(filename,
-                                                 mReadData + data_offset,
-                                                 file_offset, file_size,
-                                                 mCache->getLocalAPRFilePool());
+                // <AS:Chanayane> Packed texture storage
+                //S32 bytes_read = LLAPRFile::readEx(filename,
+                //                                 mReadData + data_offset,
+                //                                 file_offset, file_size,
+                //                                 mCache->getLocalAPRFilePool());
+                S32 bytes_read = mCache->readBody(mID, filename,
+                                                  mReadData + data_offset,
+                                                  file_offset, file_size,
+                                                  mCache->getLocalAPRFilePool());
+                // </AS:Chanayane>
                 if (bytes_read != file_size)
                 {
                     LL_WARNS() << "LLTextureCacheWorker: "  << mID
@@ -685,10 +702,16 @@ bool LLTextureCacheRemoteWorker::doWrite()
                 // build the cache file name from the UUID
                 std::string filename = mCache->getTextureFileName(mID);
                 //          LL_INFOS() << "Writing Body: " << filename << " Bytes: " << file_offset+file_size << LL_ENDL;
-                S32 bytes_written = LLAPRFile::writeEx(filename,
-                                                       mWriteData + TEXTURE_CACHE_ENTRY_SIZE,
-                                                       0, file_size,
-                                                       mCache->getLocalAPRFilePool());
+                // <AS:Chanayane> Packed texture storage
+                //S32 bytes_written = LLAPRFile::writeEx(filename,
+                //                                       mWriteData + TEXTURE_CACHE_ENTRY_SIZE,
+                //                                       0, file_size,
+                //                                       mCache->getLocalAPRFilePool());
+                S32 bytes_written = mCache->writeBody(mID, filename,
+                                                      mWriteData + TEXTURE_CACHE_ENTRY_SIZE,
+                                                      file_size,
+                                                      mCache->getLocalAPRFilePool());
+                // </AS:Chanayane>
                 if (bytes_written <= 0)
                 {
                     LL_WARNS() << "LLTextureCacheWorker: " << mID
@@ -742,6 +765,12 @@ void LLTextureCacheWorker::finishWork(S32 param, bool completed)
             // read
             if (success)
             {
+                // <AS:Chanayane> Cache read latency percentiles
+                if (!mImageLocal)
+                {
+                    mCache->mReadLatency.record(LLTimer::getTotalTime() - mStartTime);
+                }
+                // </AS:Chanayane>
                 mResponder->setData(mReadData, mDataSize, mImageSize, mImageFormat, mImageLocal);
                 mReadData = NULL; // responder owns data
                 mDataSize = 0;
@@ -812,6 +841,19 @@ LLTextureCache::~LLTextureCache()
 {
     clearDeleteList() ;
     writeUpdatedEntries() ;
+    // <AS:Chanayane> Packed texture storage
+    if (mPackedStore)
+    {
+        mPackedStore->close();
+    }
+    // </AS:Chanayane>
+    // <AS:Chanayane> Cache read latency percentiles
+    LL_INFOS("TextureCache") << "Cache read latency p50/p95/p99: "
+                             << getReadLatencyPercentile(0.5f) << "/"
+                             << getReadLatencyPercentile(0.95f) << "/"
+                             << getReadLatencyPercentile(0.99f) << " us over "
+                             << mReadLatency.getCount() << " reads" << LL_ENDL;
+    // </AS:Chanayane>
     delete mFastCachep;
     delete mFastCachePoolp;
     delete mHeaderAPRFilePoolp;
@@ -996,6 +1038,17 @@ S64 LLTextureCache::initCache(ELLPath location, S64 max_size, bool texture_cache
 {
     llassert_always(getPending() == 0) ; //should not start accessing the texture cache before initialized.
 
+    // <AS:Chanayane> Decoded texture cache
+    // The decoded tier is part of the CacheSize budget, not on top of it, and
+    // never takes more than a quarter of it.
+    S64 decoded_max_size = 0;
+    if (gSavedSettings.getBOOL("ASDecodedTextureCache"))
+    {
+        decoded_max_size = llmin((S64)gSavedSettings.getU32("ASDecodedTextureCacheSizeMB") * 1024 * 1024, max_size / 4);
+        max_size -= decoded_max_size;
+    }
+    // </AS:Chanayane>
+
     S64 entries_size = (max_size * 36) / 100; //0.36 * max_size
     S64 max_entries = entries_size / (TEXTURE_CACHE_ENTRY_SIZE + TEXTURE_FAST_CACHE_ENTRY_SIZE);
     sCacheMaxEntries = (S32)(llmin((S64)sCacheMaxEntries, max_entries));
@@ -1039,7 +1092,45 @@ S64 LLTextureCache::initCache(ELLPath location, S64 max_size, bool texture_cache
             LLFile::mkdir(dirname);
         }
     }
+    // <AS:Chanayane> Packed texture storage
+    if (gSavedSettings.getBOOL("ASTextureCachePacked"))
+    {
+        mPackedStore = std::make_unique<LLTexturePackedStore>();
+        mPackedStore->open(mTexturesDirName, mReadOnly);
+    }
+    else if (!mReadOnly)
+    {
+        // Bodies packed by an earlier session are unreachable without the store
+        LLTexturePackedStore::removeFiles(mTexturesDirName);
+    }
+    // </AS:Chanayane>
+    // <AS:Chanayane> Decoded texture cache
+    std::string decoded_dirname = gDirUtilp->add(mTexturesDirName, "decoded");
+    if (decoded_max_size > 0)
+    {
+        mDecodedCache = std::make_shared<LLTextureDecodedCache>(decoded_dirname, (U64)decoded_max_size,
+                                                                gSavedSettings.getBOOL("ASDecodedTextureCacheCompress"),
+                                                                mReadOnly);
+    }
+    else if (!mReadOnly && LLFile::isdir(decoded_dirname))
+    {
+        gDirUtilp->deleteDirAndContents(decoded_dirname);
+    }
+    // </AS:Chanayane>
     readHeaderCache();
+    // <AS:Chanayane> Packed texture storage
+    if (mPackedStore)
+    {
+        // Drop bodies whose entries are gone; removals since the store's index
+        // was last saved are only recorded in texture.entries.
+        LLMutexLock lock(&mHeaderMutex);
+        mPackedStore->prune([this](const LLUUID& id)
+            {
+                size_map_t::const_iterator iter = mTexturesSizeMap.find(id);
+                return iter != mTexturesSizeMap.end() && iter->second > 0;
+            });
+    }
+    // </AS:Chanayane>
     purgeTextures(true); // calc mTexturesSize and make some room in the texture cache if we need it
 
     llassert_always(getPending() == 0) ; //should not start accessing the texture cache before initialized.
@@ -1595,6 +1686,18 @@ void LLTextureCache::clearCorruptedCache()
 
 void LLTextureCache::purgeAllTextures(bool purge_directories)
 {
+    // <AS:Chanayane> Packed texture storage
+    if (mPackedStore)
+    {
+        mPackedStore->clear(); // closes the slabs before they are deleted below
+    }
+    // </AS:Chanayane>
+    // <AS:Chanayane> Decoded texture cache
+    if (mDecodedCache)
+    {
+        mDecodedCache->clear();
+    }
+    // </AS:Chanayane>
     if (!mReadOnly)
     {
 // <FS:ND> Windows can be really slow deleting a huge texture cache.
@@ -1830,7 +1933,10 @@ void LLTextureCache::purgeTextures(bool validate)
                 std::string filename = getTextureFileName(entries[idx].mID);
                 LL_DEBUGS("TextureCache") << "Validating: " << filename << "Size: " << entries[idx].mBodySize << LL_ENDL;
                 // mHeaderAPRFilePoolp because this is under header mutex in main thread
-                S32 bodysize = LLAPRFile::size(filename, mHeaderAPRFilePoolp);
+                // <AS:Chanayane> Packed texture storage
+                //S32 bodysize = LLAPRFile::size(filename, mHeaderAPRFilePoolp);
+                S32 bodysize = getBodySize(entries[idx].mID, filename, mHeaderAPRFilePoolp);
+                // </AS:Chanayane>
                 if (bodysize != entries[idx].mBodySize)
                 {
                     LL_WARNS("TextureCache") << "TEXTURE CACHE BODY HAS BAD SIZE: " << bodysize << " != " << entries[idx].mBodySize << filename << LL_ENDL;
@@ -2024,6 +2130,13 @@ LLTextureCache::handle_t LLTextureCache::writeToCache(const LLUUID& id,
         purgeTexturesLazy(TEXTURE_LAZY_PURGE_TIME_LIMIT);
         mDoPurge = !mPurgeEntryList.empty();
     }
+    // <AS:Chanayane> Packed texture storage
+    else if (mPackedStore && mPackedStore->needsCompaction())
+    {
+        // Reclaim space left by purged textures, a slice at a time
+        mPackedStore->compact(TEXTURE_LAZY_PURGE_TIME_LIMIT);
+    }
+    // </AS:Chanayane>
 
     // <FS:ND> There seems to be an edge case of KDU failing to decode images and then we end with null data here.
     // This should be bettered handled up where it fails, but at least this stops the crashes.
@@ -2298,6 +2411,12 @@ void LLTextureCache::removeCachedTexture(const LLUUID& id)
         mTexturesSizeMap.erase(id);
     }
     mHeaderIDMap.erase(id);
+    // <AS:Chanayane> Packed texture storage
+    if (mPackedStore)
+    {
+        mPackedStore->remove(id);
+    }
+    // </AS:Chanayane>
     // We are inside header's mutex so mHeaderAPRFilePoolp is safe to use,
     // but getLocalAPRFilePool() is not safe, it might be in use by worker
     LLAPRFile::remove(getTextureFileName(id), mHeaderAPRFilePoolp);
@@ -2308,6 +2427,15 @@ void LLTextureCache::removeEntry(S32 idx, Entry& entry, std::string& filename)
 {
     bool file_maybe_exists = true;  // Always attempt to remove when idx is invalid.
 
+    // <AS:Chanayane> Packed texture storage
+    // A body file may still exist from before packed mode was enabled; it is
+    // removed below as usual.
+    if (mPackedStore && idx >= 0)
+    {
+        mPackedStore->remove(entry.mID);
+    }
+    // </AS:Chanayane>
+
     if(idx >= 0) //valid entry
     {
         if (entry.mBodySize == 0)   // Always attempt to remove when mBodySize > 0.
@@ -2345,6 +2473,15 @@ bool LLTextureCache::removeFromCache(const LLUUID& id)
     bool ret = false ;
     if (!mReadOnly)
     {
+        // <AS:Chanayane> Decoded texture cache
+        // Called when the cached data failed to decode; drop what was
+        // decoded from it too.
+        if (mDecodedCache)
+        {
+            mDecodedCache->remove(id);
+        }
+        // </AS:Chanayane>
+
         lockHeaders() ;
 
         Entry entry;
@@ -2362,6 +2499,45 @@ bool LLTextureCache::removeFromCache(const LLUUID& id)
     return ret ;
 }
 
+// <AS:Chanayane> Packed texture storage
+// Bodies not found in the packed store are looked up as files, so a cache
+// written before packed mode was enabled stays readable until purged.
+S32 LLTextureCache::getBodySize(const LLUUID& id, const std::string& filename, LLVolatileAPRPool* pool)
+{
+    if (mPackedStore)
+    {
+        S32 size = mPackedStore->getSize(id);
+        if (size >= 0)
+        {
+            return size;
+        }
+    }
+    return LLAPRFile::size(filename, pool);
+}
+
+S32 LLTextureCache::readBody(const LLUUID& id, const std::string& filename, U8* data, S32 offset, S32 size, LLVolatileAPRPool* pool)
+{
+    if (mPackedStore)
+    {
+        S32 bytes_read = mPackedStore->read(id, data, offset, size);
+        if (bytes_read >= 0)
+        {
+            return bytes_read;
+        }
+    }
+    return LLAPRFile::readEx(filename, data, offset, size, pool);
+}
+
+S32 LLTextureCache::writeBody(const LLUUID& id, const std::string& filename, const U8* data, S32 size, LLVolatileAPRPool* pool)
+{
+    if (mPackedStore)
+    {
+        return mPackedStore->write(id, data, size);
+    }
+    return LLAPRFile::writeEx(filename, data, 0, size, pool);
+}
+// </AS:Chanayane>
+
 //////////////////////////////////////////////////////////////////////////////
 
 LLTextureCache::ReadResponder::ReadResponder()
@@ -33,10 +33,13 @@
 #include "lluuid.h"
 
 #include "llworkerthread.h"
+#include "lllatencyhistogram.h" // <AS:Chanayane/> Cache read latency percentiles
 
 class LLImageFormatted;
 class LLTextureCacheWorker;
 class LLImageRaw;
+class LLTexturePackedStore; // <AS:Chanayane/> Packed texture storage
+class LLTextureDecodedCache; // <AS:Chanayane/> Decoded texture cache
 
 class LLTextureCache : public LLWorkerThread
 {
@@ -148,6 +151,17 @@ public:
     U32 getMaxEntries() { return sCacheMaxEntries; };
     bool isInCache(const LLUUID& id) ;
     bool isInLocal(const LLUUID& id) ; //not thread safe at the moment
+    // <AS:Chanayane> Packed texture storage
+    bool isPacked() const { return mPackedStore != nullptr; }
+    // </AS:Chanayane>
+    // <AS:Chanayane> Cache read latency percentiles
+    // Time from a cache read request to its data being available, in microseconds
+    U64 getReadLatencyPercentile(F32 fraction) const { return mReadLatency.getPercentile(fraction); }
+    // </AS:Chanayane>
+    // <AS:Chanayane> Decoded texture cache
+    // Null unless ASDecodedTextureCache is set
+    LLTextureDecodedCache* getDecodedCache() const { return mDecodedCache.get(); }
+    // </AS:Chanayane>
 
 protected:
     // Accessed by LLTextureCacheWorker
@@ -155,6 +169,14 @@ protected:
     std::string getTextureFileName(const LLUUID& id);
     void addCompleted(Responder* responder, bool success);
 
+    // <AS:Chanayane> Packed texture storage
+    // Body access going to the packed store or the per texture files.
+    // filename is the texture's body file, pool the caller's APR pool.
+    S32 getBodySize(const LLUUID& id, const std::string& filename, LLVolatileAPRPool* pool);
+    S32 readBody(const LLUUID& id, const std::string& filename, U8* data, S32 offset, S32 size, LLVolatileAPRPool* pool);
+    S32 writeBody(const LLUUID& id, const std::string& filename, const U8* data, S32 size, LLVolatileAPRPool* pool);
+    // </AS:Chanayane>
+
 protected:
     //void setFileAPRPool(apr_pool_t* pool) { mFileAPRPool = pool ; }
 
@@ -244,6 +266,12 @@ private:
     typedef std::vector<std::pair<S32, Entry> > idx_entry_vector_t;
     idx_entry_vector_t mPurgeEntryList;
 
+    // <AS:Chanayane> Packed texture storage
+    std::unique_ptr<LLTexturePackedStore> mPackedStore; // null unless ASTextureCachePacked is set
+    // </AS:Chanayane>
+    LLLatencyHistogram mReadLatency; // <AS:Chanayane/> Cache read latency percentiles
+    std::shared_ptr<LLTextureDecodedCache> mDecodedCache; // <AS:Chanayane/> Decoded texture cache
+
     // Statics
     static F32 sHeaderCacheVersion;
     static U32 sHeaderCacheAddressSize;
@@ -0,0 +1,403 @@
+/**
+ * @file lltexturedecodedcache.cpp
+ * @brief Disk cache of decoded texture mip levels
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+#include "llviewerprecompiledheaders.h"
+
+#include "lltexturedecodedcache.h"
+
+#include "lldir.h"
+#include "lldiriterator.h"
+#include "llfile.h"
+#include "llmappedfile.h"
+#include "workqueue.h"
+
+#ifdef LL_USESYSTEMLIBS
+#include <zlib.h>
+#else
+#include "zlib-ng/zlib.h"
+#endif
+
+#include <algorithm>
+
+static const U32 FILE_MAGIC = 0x44435854; // "TXCD"
+// Images smaller than this decode quickly enough not to be worth a file
+static const S32 MIN_PIXELS = 64 * 64;
+
+static const char* entry_file_mask = "*.raw";
+static const char* temp_file_mask = "*.tmp";
+
+LLTextureDecodedCache::LLTextureDecodedCache(const std::string& dir, U64 max_bytes, bool compress, bool read_only)
+    : mDir(dir),
+      mMaxBytes(max_bytes),
+      mCompress(compress),
+      mReadOnly(read_only)
+{
+    if (!mReadOnly)
+    {
+        LLFile::mkdir(mDir);
+    }
+    scan();
+    LL_INFOS("TextureCache") << "Decoded texture cache: " << getNumEntries() << " entries, "
+                             << getBytes() / (1024 * 1024) << " MB of " << mMaxBytes / (1024 * 1024)
+                             << " MB" << LL_ENDL;
+}
+
+LLTextureDecodedCache::~LLTextureDecodedCache()
+{
+    LL_INFOS("TextureCache") << "Decoded texture cache hit rate " << getHitRate() * 100.f << "% ("
+                             << mHits << " hits, " << mMisses << " misses, " << mWrites << " writes, "
+                             << mEvictions << " evictions)" << LL_ENDL;
+}
+
+void LLTextureDecodedCache::scan()
+{
+    // Rebuild the LRU order from the file times; files are rewritten rather
+    // than touched on access, so this is the order they were last decoded.
+    struct Found
+    {
+        key_t   mKey;
+        U64     mSize;
+        time_t  mTime;
+    };
+    std::vector<Found> found;
+
+    std::string filename;
+    if (!mReadOnly)
+    {
+        // Left behind by writes that did not finish
+        LLDirIterator temp_iter(mDir, temp_file_mask);
+        while (temp_iter.next(filename))
+        {
+            LLFile::remove(gDirUtilp->add(mDir, filename), ENOENT);
+        }
+    }
+    LLDirIterator iter(mDir, entry_file_mask);
+    while (iter.next(filename))
+    {
+        // <uuid>_<discard>.raw
+        size_t sep = filename.find('_');
+        LLUUID id;
+        if (sep != UUID_STR_LENGTH - 1 || !id.set(filename.substr(0, sep), false))
+        {
+            continue;
+        }
+        S32 discard = atoi(filename.c_str() + sep + 1);
+        std::string path = gDirUtilp->add(mDir, filename);
+        llstat stat_data;
+        if (discard < 0 || discard > MAX_DISCARD_LEVEL || LLFile::stat(path, &stat_data) != 0)
+        {
+            continue;
+        }
+        found.push_back({ key_t(id, discard), (U64)stat_data.st_size, stat_data.st_mtime });
+    }
+
+    std::sort(found.begin(), found.end(),
+              [](const Found& a, const Found& b) { return a.mTime < b.mTime; });
+
+    LLMutexLock lock(&mMutex);
+    for (const Found& entry : found)
+    {
+        insert(entry.mKey, entry.mSize);
+    }
+    evict();
+}
+
+std::string LLTextureDecodedCache::getFilename(const key_t& key) const
+{
+    return gDirUtilp->add(mDir, llformat("%s_%d.raw", key.first.asString().c_str(), key.second));
+}
+
+LLPointer<LLImageRaw> LLTextureDecodedCache::read(const LLUUID& id, S32 discard, S32& decoded_discard)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+    const key_t key(id, discard);
+    {
+        LLMutexLock lock(&mMutex);
+        if (mEntries.find(key) == mEntries.end())
+        {
+            ++mMisses;
+            return NULL;
+        }
+    }
+
+    LLPointer<LLImageRaw> raw;
+    LLFILE* file = LLFile::fopen(getFilename(key), "rb");
+    if (file)
+    {
+        FileHeader header;
+        if (fread(&header, sizeof(header), 1, file) == 1
+            && header.mMagic == FILE_MAGIC
+            && header.mComponents >= 1 && header.mComponents <= 4
+            && header.mDataSize == (U32)header.mWidth * header.mHeight * header.mComponents)
+        {
+            raw = new LLImageRaw(header.mWidth, header.mHeight, header.mComponents);
+            U8* data = raw->getData();
+            bool ok = data != NULL;
+            if (ok && header.mCompressed)
+            {
+                std::vector<U8> stored(header.mStoredSize);
+                uLongf size = header.mDataSize;
+                ok = fread(stored.data(), 1, stored.size(), file) == stored.size()
+                    && uncompress(data, &size, stored.data(), (uLong)stored.size()) == Z_OK
+                    && size == header.mDataSize;
+            }
+            else if (ok)
+            {
+                ok = header.mStoredSize == header.mDataSize
+                    && fread(data, 1, header.mDataSize, file) == header.mDataSize;
+            }
+            if (ok)
+            {
+                decoded_discard = header.mDecodedDiscard;
+            }
+            else
+            {
+                raw = NULL;
+            }
+        }
+        LLFile::close(file);
+    }
+
+    LLMutexLock lock(&mMutex);
+    if (raw.isNull())
+    {
+        ++mMisses;
+        if (!mReadOnly)
+        {
+            LL_WARNS() << "Dropping unreadable decoded texture " << id << " discard " << discard << LL_ENDL;
+            erase(key);
+            LLFile::remove(getFilename(key), ENOENT);
+        }
+        return NULL;
+    }
+
+    ++mHits;
+    auto iter = mEntries.find(key);
+    if (iter != mEntries.end())
+    {
+        mLRU.splice(mLRU.end(), mLRU, iter->second);
+    }
+    return raw;
+}
+
+void LLTextureDecodedCache::write(const LLUUID& id, S32 discard, S32 decoded_discard, const LLImageRaw* raw)
+{
+    if (mReadOnly || !raw || !raw->getData())
+    {
+        return;
+    }
+    S32 width = raw->getWidth();
+    S32 height = raw->getHeight();
+    S32 components = raw->getComponents();
+    if (width * height < MIN_PIXELS || width > U16_MAX || height > U16_MAX
+        || components < 1 || components > 4)
+    {
+        return;
+    }
+
+    const key_t key(id, discard);
+    {
+        LLMutexLock lock(&mMutex);
+        if (mEntries.find(key) != mEntries.end() || !mPendingWrites.insert(key).second)
+        {
+            return;
+        }
+    }
+
+    // The fetcher hands the image on once this returns, so take a copy.
+    auto pixels = std::make_shared<std::vector<U8>>(raw->getData(), raw->getData() + raw->getDataSize());
+    auto work = [self = shared_from_this(), key, decoded_discard, width, height, components, pixels]()
+    {
+        self->writeFile(key, (S8)decoded_discard, (U16)width, (U16)height, (U8)components, *pixels);
+    };
+
+    LL::WorkQueue::ptr_t queue = LL::WorkQueue::getInstance("General");
+    if (!queue || !queue->post(work))
+    {
+        work();
+    }
+}
+
+void LLTextureDecodedCache::writeFile(const key_t& key, S8 decoded_discard, U16 width, U16 height, U8 components,
+                                      const std::vector<U8>& pixels)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+    FileHeader header;
+    header.mMagic = FILE_MAGIC;
+    header.mWidth = width;
+    header.mHeight = height;
+    header.mComponents = components;
+    header.mDecodedDiscard = decoded_discard;
+    header.mCompressed = 0;
+    header.mPad = 0;
+    header.mDataSize = (U32)pixels.size();
+    header.mStoredSize = header.mDataSize;
+
+    const U8* stored = pixels.data();
+    std::vector<U8> compressed;
+    if (mCompress)
+    {
+        // Favour speed: reading this back must stay far cheaper than a decode
+        uLongf size = compressBound((uLong)pixels.size());
+        compressed.resize(size);
+        if (compress2(compressed.data(), &size, pixels.data(), (uLong)pixels.size(), Z_BEST_SPEED) == Z_OK
+            && size < pixels.size())
+        {
+            header.mCompressed = 1;
+            header.mStoredSize = (U32)size;
+            stored = compressed.data();
+        }
+    }
+
+    // Written aside and renamed into place, so that a crash or a full disk
+    // never leaves a truncated entry under the final name.
+    bool ok = false;
+    const std::string filename = getFilename(key);
+    const std::string temp_filename = LLMappedFile::getTempFilename(filename);
+    LLFILE* file = LLFile::fopen(temp_filename, "wb");
+    if (file)
+    {
+        ok = fwrite(&header, sizeof(header), 1, file) == 1
+            && fwrite(stored, 1, header.mStoredSize, file) == header.mStoredSize;
+        ok = (LLFile::close(file) == 0) && ok;
+    }
+
+    // Renamed under the lock, so that a remove() or clear() issued while
+    // this was being written cannot be undone by it
+    LLMutexLock lock(&mMutex);
+    mPendingWrites.erase(key);
+    if (mCancelledWrites.erase(key))
+    {
+        LLFile::remove(temp_filename, ENOENT);
+        return;
+    }
+    ok = ok && LLFile::rename(temp_filename, filename) == 0;
+    if (!ok)
+    {
+        LL_WARNS() << "Unable to write decoded texture " << filename << LL_ENDL;
+        LLFile::remove(temp_filename, ENOENT);
+        return;
+    }
+    ++mWrites;
+    insert(key, sizeof(header) + header.mStoredSize);
+    evict();
+}
+
+void LLTextureDecodedCache::remove(const LLUUID& id)
+{
+    if (mReadOnly)
+    {
+        return;
+    }
+    LLMutexLock lock(&mMutex);
+    auto iter = mEntries.lower_bound(key_t(id, 0));
+    while (iter != mEntries.end() && iter->first.first == id)
+    {
+        key_t key = iter->first;
+        ++iter;
+        erase(key);
+        LLFile::remove(getFilename(key), ENOENT);
+    }
+    for (auto pending = mPendingWrites.lower_bound(key_t(id, 0));
+         pending != mPendingWrites.end() && pending->first == id; ++pending)
+    {
+        mCancelledWrites.insert(*pending);
+    }
+}
+
+void LLTextureDecodedCache::clear()
+{
+    LLMutexLock lock(&mMutex);
+    mLRU.clear();
+    mEntries.clear();
+    mBytes = 0;
+    mCancelledWrites = mPendingWrites;
+    if (!mReadOnly)
+    {
+        std::string filename;
+        LLDirIterator iter(mDir, entry_file_mask);
+        while (iter.next(filename))
+        {
+            LLFile::remove(gDirUtilp->add(mDir, filename));
+        }
+    }
+}
+
+F32 LLTextureDecodedCache::getHitRate() const
+{
+    U64 hits = mHits;
+    U64 lookups = hits + mMisses;
+    return lookups ? (F32)hits / (F32)lookups : 0.f;
+}
+
+U64 LLTextureDecodedCache::getBytes()
+{
+    LLMutexLock lock(&mMutex);
+    return mBytes;
+}
+
+U32 LLTextureDecodedCache::getNumEntries()
+{
+    LLMutexLock lock(&mMutex);
+    return (U32)mEntries.size();
+}
+
+void LLTextureDecodedCache::insert(const key_t& key, U64 size)
+{
+    erase(key);
+    mLRU.push_back({ key, size });
+    mEntries[key] = std::prev(mLRU.end());
+    mBytes += size;
+}
+
+void LLTextureDecodedCache::erase(const key_t& key)
+{
+    auto iter = mEntries.find(key);
+    if (iter != mEntries.end())
+    {
+        mBytes -= iter->second->mSize;
+        mLRU.erase(iter->second);
+        mEntries.erase(iter);
+    }
+}
+
+void LLTextureDecodedCache::evict()
+{
+    while (mBytes > mMaxBytes && !mLRU.empty())
+    {
+        key_t key = mLRU.front().mKey;
+        erase(key);
+        if (!mReadOnly)
+        {
+            LLFile::remove(getFilename(key), ENOENT);
+        }
+        ++mEvictions;
+    }
+}
@@ -0,0 +1,137 @@
+/**
+ * @file lltexturedecodedcache.h
+ * @brief Disk cache of decoded texture mip levels
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+#ifndef LL_LLTEXTUREDECODEDCACHE_H
+#define LL_LLTEXTUREDECODEDCACHE_H
+
+#include "llimage.h"
+#include "llmutex.h"
+#include "lluuid.h"
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+
+/**
+ * Second texture cache tier holding decoded images, so a texture read from
+ * the cache does not have to go through the JPEG2000 decoder again in the
+ * next session.
+ *
+ * Each entry is one file holding a small header followed by the pixels of
+ * an LLImageRaw, in the layout LLImageGL uploads, optionally deflated. It
+ * is keyed by texture UUID and by the discard level that was asked of the
+ * decoder, and remembers the discard level the decoder actually produced.
+ *
+ * The cache is held under a size budget by evicting the least recently used
+ * entries. Writes are handed to the "General" thread pool and keep the
+ * cache alive until they are done, hence the shared ownership.
+ *
+ * All methods are thread safe.
+ */
+class LLTextureDecodedCache : public std::enable_shared_from_this<LLTextureDecodedCache>
+{
+    LOG_CLASS(LLTextureDecodedCache);
+public:
+    LLTextureDecodedCache(const std::string& dir, U64 max_bytes, bool compress, bool read_only);
+    ~LLTextureDecodedCache();
+
+    // Decoded image of id for a decode at discard, or null. decoded_discard
+    // receives the discard level of the returned image.
+    LLPointer<LLImageRaw> read(const LLUUID& id, S32 discard, S32& decoded_discard);
+    // Store the result of decoding id at discard. The pixels are copied
+    // before this returns.
+    void write(const LLUUID& id, S32 discard, S32 decoded_discard, const LLImageRaw* raw);
+    // Forget every level of id
+    void remove(const LLUUID& id);
+    // Forget everything and remove the files
+    void clear();
+
+    U64 getHits() const { return mHits; }
+    U64 getMisses() const { return mMisses; }
+    U64 getWrites() const { return mWrites; }
+    U64 getEvictions() const { return mEvictions; }
+    F32 getHitRate() const;
+    U64 getBytes();
+    U32 getNumEntries();
+
+private:
+    typedef std::pair<LLUUID, S32> key_t;
+    struct Entry
+    {
+        key_t   mKey;
+        U64     mSize;
+    };
+    typedef std::list<Entry> lru_t;     // least recently used at the front
+
+    // File header, followed by the (possibly deflated) pixels
+    struct FileHeader
+    {
+        U32 mMagic;
+        U16 mWidth;
+        U16 mHeight;
+        U8  mComponents;
+        S8  mDecodedDiscard;
+        U8  mCompressed;
+        U8  mPad;
+        U32 mDataSize;      // of the pixels
+        U32 mStoredSize;    // bytes following the header
+    };
+
+    std::string getFilename(const key_t& key) const;
+    void scan();
+    void writeFile(const key_t& key, S8 decoded_discard, U16 width, U16 height, U8 components,
+                   const std::vector<U8>& pixels);
+
+    // mMutex must be locked for the following
+    void insert(const key_t& key, U64 size);
+    void erase(const key_t& key);
+    void evict();
+
+    LLMutex mMutex;
+    std::string mDir;
+    U64 mMaxBytes;
+    bool mCompress;
+    bool mReadOnly;
+
+    lru_t mLRU;
+    std::map<key_t, lru_t::iterator> mEntries;
+    std::set<key_t> mPendingWrites;
+    std::set<key_t> mCancelledWrites;  // pending writes to drop, see remove()
+    U64 mBytes{ 0 };
+
+    std::atomic<U64> mHits{ 0 };
+    std::atomic<U64> mMisses{ 0 };
+    std::atomic<U64> mWrites{ 0 };
+    std::atomic<U64> mEvictions{ 0 };
+};
+
+#endif // LL_LLTEXTUREDECODEDCACHE_H
@@ -43,6 +43,8 @@
 
 #include "llagent.h"
 #include "lltexturecache.h"
+#include "lltexturedecodedcache.h" // <AS:Chanayane/> Decoded texture cache
+#include "llimageglupload.h" // <AS:Chanayane/> Texture upload ring
 #include "llviewercontrol.h"
 #include "llviewertexturelist.h"
 #include "llviewertexture.h"
@@ -469,7 +471,10 @@ private:
     F32 getImagePriority() const;
 
     // Locks:  Mw
-    void setImagePriority(F32 priority);
+    // <AS:Chanayane> Texture fetch scheduler
+    //void setImagePriority(F32 priority);
+    void setImagePriority(F32 priority, U32 needed_by_frame);
+    // </AS:Chanayane>
 
     // Locks:  Mw (ctor invokes without lock)
     void setDesiredDiscard(S32 discard, S32 size);
@@ -489,6 +494,21 @@ private:
     // Locks:  Mw
     void removeFromCache();
 
+    // <AS:Chanayane> Decoded texture cache
+    // Threads:  Ttf
+    // Locks:  Mw
+    // The decoded cache if this texture may use it, or null
+    LLTextureDecodedCache* getDecodedCache() const;
+    // Use the decoded cache's copy of a decode at discard if it has one
+    bool readFromDecodedCache(S32 discard);
+    // </AS:Chanayane>
+
+    // <AS:Chanayane> Texture upload ring
+    // Threads:  Ttf, decode threads
+    // Copy of raw in the texture upload ring, or null
+    LLPointer<LLImageGLUploadSlice> stageUpload(const LLImageRaw* raw) const;
+    // </AS:Chanayane>
+
     // Threads:  Ttf
     // <FS:Ansariel> OpenSim compatibility
     // Locks:  Mw
@@ -560,12 +580,18 @@ private:
     std::string mUrl;
     U8 mType;
     F32 mImagePriority; // should map to max virtual size
+    U32 mNeededByFrame{ LLTextureFetchScheduler::NO_DEADLINE }; // <AS:Chanayane/> Texture fetch scheduler
     F32 mRequestedPriority;
     S32 mDesiredDiscard;
     S32 mSimRequestedDiscard; // <FS:Ansariel> OpenSim compatibility
     S32 mRequestedDiscard;
     S32 mLoadedDiscard;
     S32 mDecodedDiscard;
+    // <AS:Chanayane> Decoded texture cache
+    S32 mDecodeDiscard{ -1 };       // discard level handed to the decoder
+    bool mDecodedFromCache{ false };
+    // </AS:Chanayane>
+    LLPointer<LLImageGLUploadSlice> mUploadSlice; // <AS:Chanayane/> Texture upload ring, staged copy of mRawImage
     LLFrameTimer mRequestedDeltaTimer;
     LLFrameTimer mFetchDeltaTimer;
     LLTimer mCacheReadTimer;
@@ -1098,9 +1124,21 @@ void LLTextureFetchWorker::setDesiredDiscard(S32 discard, S32 size)
 }
 
 // Locks:  Mw
-void LLTextureFetchWorker::setImagePriority(F32 priority)
+// <AS:Chanayane> Texture fetch scheduler
+//void LLTextureFetchWorker::setImagePriority(F32 priority)
+void LLTextureFetchWorker::setImagePriority(F32 priority, U32 needed_by_frame)
+// </AS:Chanayane>
 {
     mImagePriority = priority; //should map to max virtual size, abort if zero
+    // <AS:Chanayane> Texture fetch scheduler
+    mNeededByFrame = needed_by_frame;
+    if (mState == WAIT_HTTP_RESOURCE2)
+    {
+        // Reorder the wait queue right away. A zero priority drops the
+        // request from it, doWork() then aborts the worker.
+        mFetcher->updateHttpWaiter(mID, mImagePriority, mNeededByFrame);
+    }
+    // </AS:Chanayane>
 }
 
 // Locks:  Mw
@@ -1165,6 +1203,16 @@ bool LLTextureFetchWorker::doWork(S32 param)
             LL_DEBUGS(LOG_TXT) << mID << " abort: mImagePriority < F_ALMOST_ZERO" << LL_ENDL;
             return true; // abort
         }
+        // <AS:Chanayane> Texture fetch scheduler
+        // Nothing was sent yet, cancel rather than wait for a slot
+        if (mState == WAIT_HTTP_RESOURCE || mState == WAIT_HTTP_RESOURCE2)
+        {
+            LL_PROFILE_ZONE_NAMED_CATEGORY_TEXTURE("tfwdw - cancel http wait");
+            LL_DEBUGS(LOG_TXT) << mID << " abort: cancelled while waiting for an HTTP slot" << LL_ENDL;
+            mFetcher->removeHttpWaiter(mID);
+            return true; // abort
+        }
+        // </AS:Chanayane>
     }
     if (mState > CACHE_POST && !mCanUseCapability && mCanUseHTTP)
     {
@@ -1224,6 +1272,7 @@ bool LLTextureFetchWorker::doWork(S32 param)
         }
         mSkippedStatesTime = 0;
         mRawImage = NULL ;
+        mUploadSlice = NULL; // <AS:Chanayane/> Texture upload ring
         mRequestedDiscard = -1;
         mLoadedDiscard = -1;
         mDecodedDiscard = -1;
@@ -1548,7 +1597,8 @@ bool LLTextureFetchWorker::doWork(S32 param)
             (mFetcher->getHttpWaitersCount() || ! acquireHttpSemaphore()))
         {
             setState(WAIT_HTTP_RESOURCE2);
-            mFetcher->addHttpWaiter(this->mID);
+            //mFetcher->addHttpWaiter(this->mID);
+            mFetcher->addHttpWaiter(this->mID, mImagePriority, mNeededByFrame); // <AS:Chanayane/> Texture fetch scheduler
             ++mResourceWaitCount;
             return false;
         }
@@ -1861,7 +1911,23 @@ bool LLTextureFetchWorker::doWork(S32 param)
                 mRequestedOffset += src_offset;
             }
 
-            U8 * buffer = (U8 *)ll_aligned_malloc_16(total_size);
+            // <AS:Chanayane> Contiguous replies
+            // A first fetch received in one reserved block is taken over
+            // as is instead of being copied into a fresh allocation.
+            //U8 * buffer = (U8 *)ll_aligned_malloc_16(total_size);
+            U8 * buffer(NULL);
+            if (0 == cur_size && 0 == src_offset)
+            {
+                size_t detached_size(0);
+                buffer = (U8 *) mHttpBufferArray->detachContiguous(&detached_size);
+                llassert(! buffer || (S32) detached_size == total_size);
+            }
+            const bool detached(NULL != buffer);
+            if (! detached)
+            {
+                buffer = (U8 *) ll_aligned_malloc_16(total_size);
+            }
+            // </AS:Chanayane>
             if (!buffer)
             {
                 // abort. If we have no space for packet, we have not enough space to decode image
@@ -1898,7 +1964,13 @@ bool LLTextureFetchWorker::doWork(S32 param)
                 // Copy previously collected data into buffer
                 memcpy(buffer, mFormattedImage->getData(), cur_size);
             }
-            mHttpBufferArray->read(src_offset, (char *) buffer + cur_size, append_size);
+            // <AS:Chanayane> Contiguous replies
+            //mHttpBufferArray->read(src_offset, (char *) buffer + cur_size, append_size);
+            if (! detached)
+            {
+                mHttpBufferArray->read(src_offset, (char *) buffer + cur_size, append_size);
+            }
+            // </AS:Chanayane>
 
             // NOTE: setData releases current data and owns new data (buffer)
             mFormattedImage->setData(buffer, total_size);
@@ -1993,6 +2065,7 @@ bool LLTextureFetchWorker::doWork(S32 param)
         mDecodeTimer.reset();
         mRawImage = NULL;
         mAuxImage = NULL;
+        mUploadSlice = NULL; // <AS:Chanayane/> Texture upload ring
 
         // if we have the entire image data (and the image is not J2C), decode the full res image
         // DO NOT decode a higher res j2c than was requested.  This is a waste of time and memory.
@@ -2001,6 +2074,15 @@ bool LLTextureFetchWorker::doWork(S32 param)
         LL_DEBUGS(LOG_TXT) << mID << ": Decoding. Bytes: " << mFormattedImage->getDataSize() << " Discard: " << discard
                            << " All Data: " << mHaveAllData << LL_ENDL;
 
+        // <AS:Chanayane> Decoded texture cache
+        mDecodeDiscard = discard;
+        if (readFromDecodedCache(discard))
+        {
+            // mDecoded is set, DECODE_IMAGE_UPDATE picks the image up
+            return doWork(param);
+        }
+        // </AS:Chanayane>
+
         // In case worked manages to request decode, be shut down,
         // then init and request decode again with first decode
         // still in progress, assign a sufficiently unique id
@@ -2050,6 +2132,13 @@ bool LLTextureFetchWorker::doWork(S32 param)
                 llassert_always(mRawImage.notNull());
                 LL_DEBUGS(LOG_TXT) << mID << ": Decoded. Discard: " << mDecodedDiscard
                                    << " Raw Image: " << llformat("%dx%d",mRawImage->getWidth(),mRawImage->getHeight()) << LL_ENDL;
+                // <AS:Chanayane> Decoded texture cache
+                LLTextureDecodedCache* decoded_cache = mDecodedFromCache ? nullptr : getDecodedCache();
+                if (decoded_cache)
+                {
+                    decoded_cache->write(mID, mDecodeDiscard, mDecodedDiscard, mRawImage);
+                }
+                // </AS:Chanayane>
                 setState(WRITE_TO_CACHE);
             }
             // fall through
@@ -2366,6 +2455,68 @@ void LLTextureFetchWorker::removeFromCache()
     }
 }
 
+// <AS:Chanayane> Decoded texture cache
+// Threads:  Ttf
+// Locks:  Mw
+LLTextureDecodedCache* LLTextureFetchWorker::getDecodedCache() const
+{
+    // Only plain asset textures: their data never changes for a given id.
+    if (mFTType != FTT_DEFAULT || mNeedsAux || mInLocalCache
+        || mFormattedImage.isNull() || mFormattedImage->getCodec() != IMG_CODEC_J2C
+        || mUrl.compare(0, 7, "file://") == 0)
+    {
+        return nullptr;
+    }
+    return mFetcher->mTextureCache->getDecodedCache();
+}
+
+// Threads:  Ttf
+// Locks:  Mw
+bool LLTextureFetchWorker::readFromDecodedCache(S32 discard)
+{
+    mDecodedFromCache = false;
+    LLTextureDecodedCache* decoded_cache = getDecodedCache();
+    if (!decoded_cache)
+    {
+        return false;
+    }
+
+    S32 decoded_discard = -1;
+    LLPointer<LLImageRaw> raw = decoded_cache->read(mID, discard, decoded_discard);
+    if (raw.isNull())
+    {
+        return false;
+    }
+
+    // Same results as callbackDecoded() would have produced
+    mFormattedImage->setDiscardLevel(decoded_discard);
+    mRawImage = raw;
+    mAuxImage = NULL;
+    mUploadSlice = stageUpload(raw); // <AS:Chanayane/> Texture upload ring
+    mDecodedDiscard = decoded_discard;
+    mDecodedFromCache = true;
+    mDecoded = true;
+    LL_DEBUGS(LOG_TXT) << mID << ": Read from decoded cache. Discard: " << mDecodedDiscard
+                       << " Raw Image: " << llformat("%dx%d", mRawImage->getWidth(), mRawImage->getHeight()) << LL_ENDL;
+    return true;
+}
+// </AS:Chanayane>
+
+// <AS:Chanayane> Texture upload ring
+// Threads:  Ttf, decode threads
+LLPointer<LLImageGLUploadSlice> LLTextureFetchWorker::stageUpload(const LLImageRaw* raw) const
+{
+    // Only worth it when the GL texture is created on the main thread, and
+    // local images are rescaled before upload anyway
+    if (!raw || !LLImageGLUploadRing::instanceExists() || LLImageGLThread::sEnabledTextures
+        || mUrl.compare(0, 7, "file://") == 0)
+    {
+        return nullptr;
+    }
+    return LLImageGLUploadRing::stage(raw->getData(), (U32)raw->getDataSize());
+}
+// </AS:Chanayane>
+
 // <FS:Ansariel> OpenSim compatibility
 //////////////////////////////////////////////////////////////////////////////
 
@@ -2588,6 +2739,11 @@ void LLTextureFetchWorker::callbackCacheWrite(bool success)
 // Threads:  Tid
 void LLTextureFetchWorker::callbackDecoded(bool success, const std::string &error_message, LLImageRaw* raw, LLImageRaw* aux, S32 decode_id)
 {
+    // <AS:Chanayane> Texture upload ring
+    // Copy the pixels into upload memory here on the decode thread, before
+    // taking the work mutex
+    LLPointer<LLImageGLUploadSlice> upload_slice = success ? stageUpload(raw) : nullptr;
+    // </AS:Chanayane>
     LLMutexLock lock(&mWorkMutex);                                      // +Mw
     if (mDecodeHandle == 0)
     {
@@ -2615,6 +2771,7 @@ void LLTextureFetchWorker::callbackDecoded(bool success, const std::string &erro
         llassert_always(raw);
         mRawImage = raw;
         mAuxImage = aux;
+        mUploadSlice = upload_slice; // <AS:Chanayane/> Texture upload ring
         mDecodedDiscard = mFormattedImage->getDiscardLevel();
         if (mDecodedDiscard < mDesiredDiscard)
         {
@@ -2738,6 +2895,10 @@ LLTextureFetch::LLTextureFetch(LLTextureCache* cache, bool threaded, bool qa_mod
     mHttpOptions  = std::make_shared<LLCore::HttpOptions>();
     mHttpOptionsWithHeaders = std::make_shared<LLCore::HttpOptions>();
     mHttpOptionsWithHeaders->setWantHeaders(true);
+    // <AS:Chanayane> Contiguous replies
+    mHttpOptions->setContiguousReply(true);
+    mHttpOptionsWithHeaders->setContiguousReply(true);
+    // </AS:Chanayane>
     mHttpHeaders = std::make_shared<LLCore::HttpHeaders>();
     mHttpHeaders->append(HTTP_OUT_HEADER_ACCEPT, HTTP_CONTENT_IMAGE_X_J2C);
     mHttpPolicyClass = app_core_http.getPolicy(LLAppCoreHttp::AP_TEXTURE);
@@ -2779,8 +2940,12 @@ LLTextureFetch::~LLTextureFetch()
     // ~LLQueuedThread() called here
 }
 
+// <AS:Chanayane> Texture fetch scheduler
+//S32 LLTextureFetch::createRequest(FTType f_type, const std::string& url, const LLUUID& id, const LLHost& host, F32 priority,
+//    S32 w, S32 h, S32 c, S32 desired_discard, bool needs_aux, bool can_use_http)
 S32 LLTextureFetch::createRequest(FTType f_type, const std::string& url, const LLUUID& id, const LLHost& host, F32 priority,
-    S32 w, S32 h, S32 c, S32 desired_discard, bool needs_aux, bool can_use_http)
+    S32 w, S32 h, S32 c, S32 desired_discard, bool needs_aux, bool can_use_http, U32 needed_by_frame)
+// </AS:Chanayane>
 {
     LL_PROFILE_ZONE_SCOPED;
     if (mDebugPause)
@@ -2864,7 +3029,8 @@ S32 LLTextureFetch::createRequest(FTType f_type, const std::string& url, const L
         }
         worker->mActiveCount++;
         worker->mNeedsAux = needs_aux;
-        worker->setImagePriority(priority);
+        //worker->setImagePriority(priority);
+        worker->setImagePriority(priority, needed_by_frame); // <AS:Chanayane/> Texture fetch scheduler
         worker->setDesiredDiscard(desired_discard, desired_size);
         worker->setCanUseHTTP(can_use_http);
 
@@ -2893,6 +3059,7 @@ S32 LLTextureFetch::createRequest(FTType f_type, const std::string& url, const L
         worker->mActiveCount++;
         worker->mNeedsAux = needs_aux;
         worker->setCanUseHTTP(can_use_http);
+        worker->mNeededByFrame = needed_by_frame; // <AS:Chanayane/> Texture fetch scheduler
         worker->unlockWorkMutex();                                      // -Mw
     }
 
@@ -3086,7 +3253,8 @@ LLTextureFetchWorker* LLTextureFetch::getWorker(const LLUUID& id)
 // Threads:  T*
 bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level, S32& worker_state,
                                         LLPointer<LLImageRaw>& raw, LLPointer<LLImageRaw>& aux,
-                                        LLCore::HttpStatus& last_http_get_status)
+                                        LLCore::HttpStatus& last_http_get_status,
+                                        LLPointer<LLImageGLUploadSlice>* upload_slice) // <AS:Chanayane/> Texture upload ring
 {
     LL_PROFILE_ZONE_SCOPED;
     bool res = false;
@@ -3121,6 +3289,14 @@ bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level, S3
             discard_level = worker->mDecodedDiscard;
             raw = worker->mRawImage;
             aux = worker->mAuxImage;
+            // <AS:Chanayane> Texture upload ring
+            if (upload_slice && worker->mUploadSlice.notNull())
+            {
+                // The staged copy belongs to whoever uploads the raw image now
+                *upload_slice = worker->mUploadSlice;
+                worker->mUploadSlice = NULL;
+            }
+            // </AS:Chanayane>
 
             decode_time = worker->mDecodeTime;
             fetch_time = worker->mFetchTime;
@@ -3166,6 +3342,13 @@ bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level, S3
                 discard_level = worker->mDecodedDiscard;
                 raw = worker->mRawImage;
                 aux = worker->mAuxImage;
+                // <AS:Chanayane> Texture upload ring
+                if (upload_slice && worker->mUploadSlice.notNull())
+                {
+                    *upload_slice = worker->mUploadSlice;
+                    worker->mUploadSlice = NULL;
+                }
+                // </AS:Chanayane>
             }
             worker->unlockWorkMutex();                                  // -Mw
         }
@@ -3179,7 +3362,10 @@ bool LLTextureFetch::getRequestFinished(const LLUUID& id, S32& discard_level, S3
 }
 
 // Threads:  T*
-bool LLTextureFetch::updateRequestPriority(const LLUUID& id, F32 priority)
+// <AS:Chanayane> Texture fetch scheduler
+//bool LLTextureFetch::updateRequestPriority(const LLUUID& id, F32 priority)
+bool LLTextureFetch::updateRequestPriority(const LLUUID& id, F32 priority, U32 needed_by_frame)
+// </AS:Chanayane>
 {
     LL_PROFILE_ZONE_SCOPED;
     mRequestQueue.tryPost([=, this]()
@@ -3188,7 +3374,8 @@ bool LLTextureFetch::updateRequestPriority(const LLUUID& id, F32 priority)
             if (worker)
             {
                 worker->lockWorkMutex();                                        // +Mw
-                worker->setImagePriority(priority);
+                //worker->setImagePriority(priority);
+                worker->setImagePriority(priority, needed_by_frame); // <AS:Chanayane/> Texture fetch scheduler
                 worker->unlockWorkMutex();                                      // -Mw
             }
         });
@@ -3932,12 +4119,22 @@ void LLTextureFetch::dump()
     }
 
     LL_INFOS(LOG_TXT) << "LLTextureFetch WAIT_HTTP_RESOURCE:" << LL_ENDL;
-    for (wait_http_res_queue_t::const_iterator iter(mHttpWaitResource.begin());
-         mHttpWaitResource.end() != iter;
-         ++iter)
+    // <AS:Chanayane> Texture fetch scheduler
+    //for (wait_http_res_queue_t::const_iterator iter(mHttpWaitResource.begin());
+    //     mHttpWaitResource.end() != iter;
+    //     ++iter)
+    //{
+    //    LL_INFOS(LOG_TXT) << " ID: " << (*iter) << LL_ENDL;
+    //}
+    uuid_vec_t waiters;
+    mNetworkQueueMutex.lock();                                          // +Mfnq
+    mHttpWaitResource.getIDs(waiters);
+    mNetworkQueueMutex.unlock();                                        // -Mfnq
+    for (const LLUUID& id : waiters)
     {
-        LL_INFOS(LOG_TXT) << " ID: " << (*iter) << LL_ENDL;
+        LL_INFOS(LOG_TXT) << " ID: " << id << LL_ENDL;
     }
+    // </AS:Chanayane>
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -3945,22 +4142,38 @@ void LLTextureFetch::dump()
 // HTTP Resource Waiting Methods
 
 // Threads:  Ttf
-void LLTextureFetch::addHttpWaiter(const LLUUID & tid)
+// <AS:Chanayane> Texture fetch scheduler
+//void LLTextureFetch::addHttpWaiter(const LLUUID & tid)
+void LLTextureFetch::addHttpWaiter(const LLUUID & tid, F32 priority, U32 needed_by_frame)
+// </AS:Chanayane>
 {
     mNetworkQueueMutex.lock();                                          // +Mfnq
-    mHttpWaitResource.insert(tid);
+    //mHttpWaitResource.insert(tid);
+    mHttpWaitResource.update(tid, priority, needed_by_frame); // <AS:Chanayane/> Texture fetch scheduler
     mNetworkQueueMutex.unlock();                                        // -Mfnq
 }
 
+// <AS:Chanayane> Texture fetch scheduler
+// Threads:  T*
+bool LLTextureFetch::updateHttpWaiter(const LLUUID & tid, F32 priority, U32 needed_by_frame)
+{
+    LLMutexLock lock(&mNetworkQueueMutex);                              // +Mfnq
+    return mHttpWaitResource.update(tid, priority, needed_by_frame);
+}                                                                       // -Mfnq
+// </AS:Chanayane>
+
 // Threads:  Ttf
 void LLTextureFetch::removeHttpWaiter(const LLUUID & tid)
 {
     mNetworkQueueMutex.lock();                                          // +Mfnq
-    wait_http_res_queue_t::iterator iter(mHttpWaitResource.find(tid));
-    if (mHttpWaitResource.end() != iter)
-    {
-        mHttpWaitResource.erase(iter);
-    }
+    // <AS:Chanayane> Texture fetch scheduler
+    //wait_http_res_queue_t::iterator iter(mHttpWaitResource.find(tid));
+    //if (mHttpWaitResource.end() != iter)
+    //{
+    //    mHttpWaitResource.erase(iter);
+    //}
+    mHttpWaitResource.remove(tid);
+    // </AS:Chanayane>
     mNetworkQueueMutex.unlock();                                        // -Mfnq
 }
 
@@ -3968,8 +4181,11 @@ void LLTextureFetch::removeHttpWaiter(const LLUUID & tid)
 bool LLTextureFetch::isHttpWaiter(const LLUUID & tid)
 {
     mNetworkQueueMutex.lock();                                          // +Mfnq
-    wait_http_res_queue_t::iterator iter(mHttpWaitResource.find(tid));
-    const bool ret(mHttpWaitResource.end() != iter);
+    // <AS:Chanayane> Texture fetch scheduler
+    //wait_http_res_queue_t::iterator iter(mHttpWaitResource.find(tid));
+    //const bool ret(mHttpWaitResource.end() != iter);
+    const bool ret(mHttpWaitResource.contains(tid));
+    // </AS:Chanayane>
     mNetworkQueueMutex.unlock();                                        // -Mfnq
     return ret;
 }
@@ -4003,78 +4219,45 @@ void LLTextureFetch::releaseHttpWaiters()
         return;
     }
 
-    // Quickly make a copy of all the LLUIDs.  Get off the
-    // mutex as early as possible.
-    typedef std::vector<LLUUID> uuid_vec_t;
-    uuid_vec_t tids;
-
-    {
-        LLMutexLock lock(&mNetworkQueueMutex);                          // +Mfnq
-
-        if (mHttpWaitResource.empty())
-            return;
-        tids.reserve(mHttpWaitResource.size());
-        tids.assign(mHttpWaitResource.begin(), mHttpWaitResource.end());
-    }                                                                   // -Mfnq
-
-    // Now lookup the UUUIDs to find valid requests and sort
-    // them in priority order, highest to lowest.  We're going
-    // to modify priority later as a side-effect of releasing
-    // these objects.  That, in turn, would violate the partial
-    // ordering assumption of std::set, std::map, etc. so we
-    // don't use those containers.  We use a vector and an explicit
-    // sort to keep the containers valid later.
-    typedef std::vector<LLTextureFetchWorker *> worker_list_t;
-    worker_list_t tids2;
-
-    tids2.reserve(tids.size());
-    for (uuid_vec_t::iterator iter(tids.begin());
-         tids.end() != iter;
-         ++iter)
+    // <AS:Chanayane> Texture fetch scheduler
+    // The waiters are kept in an indexed heap that is reordered as
+    // priorities change, so rather than copying and sorting all of them,
+    // look at the most urgent one until we run out of slots.  A waiter
+    // stays in the queue until its worker has been moved on, that keeps
+    // deleteOK() from deleting it under us.
+    while (true)
     {
-        LLTextureFetchWorker * worker(getWorker(* iter));
-        if (worker)
+        LLUUID tid;
         {
-            tids2.push_back(worker);
-        }
-        else
+            LLMutexLock lock(&mNetworkQueueMutex);                      // +Mfnq
+            if (!mHttpWaitResource.top(tid))
+            {
+                break;
+            }
+        }                                                               // -Mfnq
+
+        LLTextureFetchWorker * worker(getWorker(tid));
+        if (!worker)
         {
             // If worker isn't found, this should be due to a request
             // for deletion.  We signal our recognition that this
             // uuid shouldn't be used for resource waiting anymore by
             // erasing it from the resource waiter list.  That allows
             // deleteOK to do final deletion on the worker.
-            removeHttpWaiter(* iter);
+            removeHttpWaiter(tid);
+            continue;
         }
-    }
-    tids.clear();
-
-    // Sort into priority order, if necessary and only as much as needed
-    if (tids2.size() > needed)
-    {
-        LLTextureFetchWorker::Compare compare;
-        std::partial_sort(tids2.begin(), tids2.begin() + needed, tids2.end(), compare);
-    }
-
-    // Release workers up to the high water mark.  Since we aren't
-    // holding any locks at this point, we can be in competition
-    // with other callers.  Do defensive things like getting
-    // refreshed counts of requests and checking if someone else
-    // has moved any worker state around....
-    for (worker_list_t::iterator iter2(tids2.begin()); tids2.end() != iter2; ++iter2)
-    {
-        LLTextureFetchWorker * worker(* iter2);
 
         worker->lockWorkMutex();                                        // +Mw
         if (LLTextureFetchWorker::WAIT_HTTP_RESOURCE2 != worker->mState)
         {
             // Not in expected state, remove it, try the next one
             worker->unlockWorkMutex();                                  // -Mw
-            LL_WARNS(LOG_TXT) << "Resource-waited texture " << worker->mID
+            LL_WARNS(LOG_TXT) << "Resource-waited texture " << tid
                               << " in unexpected state:  " << worker->mState
                               << ".  Removing from wait list."
                               << LL_ENDL;
-            removeHttpWaiter(worker->mID);
+            removeHttpWaiter(tid);
             continue;
         }
 
@@ -4088,8 +4271,9 @@ void LLTextureFetch::releaseHttpWaiters()
         worker->setState(LLTextureFetchWorker::SEND_HTTP_REQ);
         worker->unlockWorkMutex();                                      // -Mw
 
-        removeHttpWaiter(worker->mID);
+        removeHttpWaiter(tid);
     }
+    // </AS:Chanayane>
 }
 
 // Threads:  T*
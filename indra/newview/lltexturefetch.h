@@ -35,6 +35,7 @@
 #include "lluuid.h"
 #include "llworkerthread.h"
 #include "lltextureinfo.h"
+#include "lltexturefetchscheduler.h" // <AS:Chanayane/> Texture fetch scheduler
 #include "llimageworker.h"
 #include "httprequest.h"
 #include "httpoptions.h"
@@ -45,6 +46,7 @@
 
 class LLViewerTexture;
 class LLTextureFetchWorker;
+class LLImageGLUploadSlice; // <AS:Chanayane/> Texture upload ring
 class LLImageDecodeThread;
 class LLHost;
 class LLViewerAssetStats;
@@ -86,8 +88,15 @@ public:
 
     // Threads:  T* (but Tmain mostly)
     // returns discard on success, fail code otherwise
+    // <AS:Chanayane> Texture fetch scheduler
+    // needed_by_frame is the frame the texture is needed on screen by, see
+    // LLTextureFetchScheduler
+    //S32 createRequest(FTType f_type, const std::string& url, const LLUUID& id, const LLHost& host, F32 priority,
+    //                   S32 w, S32 h, S32 c, S32 discard, bool needs_aux, bool can_use_http);
     S32 createRequest(FTType f_type, const std::string& url, const LLUUID& id, const LLHost& host, F32 priority,
-                       S32 w, S32 h, S32 c, S32 discard, bool needs_aux, bool can_use_http);
+                       S32 w, S32 h, S32 c, S32 discard, bool needs_aux, bool can_use_http,
+                       U32 needed_by_frame = LLTextureFetchScheduler::NO_DEADLINE);
+    // </AS:Chanayane>
 
     // Requests that a fetch operation be deleted from the queue.
     // If @cancel is true, also stops any I/O operations pending.
@@ -106,10 +115,16 @@ public:
     // keep in mind that if fetcher isn't done, it still might need original raw image
     bool getRequestFinished(const LLUUID& id, S32& discard_level, S32& worker_state,
                             LLPointer<LLImageRaw>& raw, LLPointer<LLImageRaw>& aux,
-                            LLCore::HttpStatus& last_http_get_status);
+                            LLCore::HttpStatus& last_http_get_status,
+                            LLPointer<LLImageGLUploadSlice>* upload_slice = nullptr); // <AS:Chanayane/> Texture upload ring
 
     // Threads:  T*
-    bool updateRequestPriority(const LLUUID& id, F32 priority);
+    // <AS:Chanayane> Texture fetch scheduler
+    // A priority of zero cancels the request if it has not reached the
+    // network yet.
+    //bool updateRequestPriority(const LLUUID& id, F32 priority);
+    bool updateRequestPriority(const LLUUID& id, F32 priority, U32 needed_by_frame = LLTextureFetchScheduler::NO_DEADLINE);
+    // </AS:Chanayane>
 
     // <FS:Ansariel> OpenSim compatibility
     // Threads:  T*
@@ -209,7 +224,15 @@ public:
     // HTTP resource waiting methods
 
     // Threads:  T*
-    void addHttpWaiter(const LLUUID & tid);
+    // <AS:Chanayane> Texture fetch scheduler
+    //void addHttpWaiter(const LLUUID & tid);
+    void addHttpWaiter(const LLUUID & tid, F32 priority, U32 needed_by_frame);
+
+    // Move a waiter to its new place in the queue, or drop it if the
+    // priority is zero. Returns false if tid is not waiting on return.
+    // Threads:  T*
+    bool updateHttpWaiter(const LLUUID & tid, F32 priority, U32 needed_by_frame);
+    // </AS:Chanayane>
 
     // Threads:  T*
     void removeHttpWaiter(const LLUUID & tid);
@@ -408,7 +431,10 @@ private:
     // exceed the high water level (but not go below zero).
     LLAtomicS32                         mHttpSemaphore;                 // Ttf
 
-    typedef std::set<LLUUID> wait_http_res_queue_t;
+    // <AS:Chanayane> Texture fetch scheduler
+    //typedef std::set<LLUUID> wait_http_res_queue_t;
+    typedef LLTextureFetchScheduler wait_http_res_queue_t;
+    // </AS:Chanayane>
     wait_http_res_queue_t               mHttpWaitResource;              // Mfnq
 
     // Cumulative stats on the states/requests issued by
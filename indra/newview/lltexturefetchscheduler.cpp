@@ -0,0 +1,195 @@
+/**
+ * @file lltexturefetchscheduler.cpp
+ * @brief Indexed priority heap ordering texture fetches waiting for an HTTP slot
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+
+#include "llviewerprecompiledheaders.h"
+
+#include "lltexturefetchscheduler.h"
+
+bool LLTextureFetchScheduler::update(const LLUUID& id, F32 priority, U32 needed_by_frame)
+{
+    auto it = mIndex.find(id);
+    if (priority < F_ALMOST_ZERO)
+    {
+        if (it != mIndex.end())
+        {
+            erase(it->second);
+            ++mCancelCount;
+        }
+        return false;
+    }
+
+    if (it == mIndex.end())
+    {
+        mIndex.emplace(id, mHeap.size());
+        mHeap.push_back({ id, priority, needed_by_frame });
+        siftUp(mHeap.size() - 1);
+        return true;
+    }
+
+    size_t pos = it->second;
+    Entry entry{ id, priority, needed_by_frame };
+    bool up = before(entry, mHeap[pos]);
+    mHeap[pos] = entry;
+    if (up)
+    {
+        siftUp(pos);
+    }
+    else
+    {
+        siftDown(pos);
+    }
+    return true;
+}
+
+bool LLTextureFetchScheduler::reprioritize(const LLUUID& id, F32 priority, U32 needed_by_frame)
+{
+    return contains(id) && update(id, priority, needed_by_frame);
+}
+
+bool LLTextureFetchScheduler::remove(const LLUUID& id)
+{
+    auto it = mIndex.find(id);
+    if (it == mIndex.end())
+    {
+        return false;
+    }
+    erase(it->second);
+    return true;
+}
+
+void LLTextureFetchScheduler::clear()
+{
+    mHeap.clear();
+    mIndex.clear();
+}
+
+bool LLTextureFetchScheduler::top(LLUUID& id) const
+{
+    if (mHeap.empty())
+    {
+        return false;
+    }
+    id = mHeap.front().mID;
+    return true;
+}
+
+bool LLTextureFetchScheduler::pop(LLUUID& id)
+{
+    if (!top(id))
+    {
+        return false;
+    }
+    erase(0);
+    return true;
+}
+
+void LLTextureFetchScheduler::getIDs(uuid_vec_t& ids) const
+{
+    ids.clear();
+    ids.reserve(mHeap.size());
+    for (const Entry& entry : mHeap)
+    {
+        ids.push_back(entry.mID);
+    }
+}
+
+void LLTextureFetchScheduler::set(const Entry& entry, size_t pos)
+{
+    mHeap[pos] = entry;
+    mIndex[entry.mID] = pos;
+}
+
+void LLTextureFetchScheduler::erase(size_t pos)
+{
+    mIndex.erase(mHeap[pos].mID);
+    size_t last = mHeap.size() - 1;
+    if (pos != last)
+    {
+        // Move the last entry into the hole and restore the heap around it
+        Entry moved = mHeap[last];
+        bool up = before(moved, mHeap[pos]);
+        mHeap.pop_back();
+        set(moved, pos);
+        if (up)
+        {
+            siftUp(pos);
+        }
+        else
+        {
+            siftDown(pos);
+        }
+    }
+    else
+    {
+        mHeap.pop_back();
+    }
+}
+
+void LLTextureFetchScheduler::siftUp(size_t pos)
+{
+    Entry entry = mHeap[pos];
+    while (pos > 0)
+    {
+        size_t parent = (pos - 1) / 2;
+        if (!before(entry, mHeap[parent]))
+        {
+            break;
+        }
+        set(mHeap[parent], pos);
+        pos = parent;
+    }
+    set(entry, pos);
+}
+
+void LLTextureFetchScheduler::siftDown(size_t pos)
+{
+    Entry entry = mHeap[pos];
+    size_t count = mHeap.size();
+    while (true)
+    {
+        size_t child = 2 * pos + 1;
+        if (child >= count)
+        {
+            break;
+        }
+        if (child + 1 < count && before(mHeap[child + 1], mHeap[child]))
+        {
+            ++child;
+        }
+        if (!before(mHeap[child], entry))
+        {
+            break;
+        }
+        set(mHeap[child], pos);
+        pos = child;
+    }
+    set(entry, pos);
+}
@@ -0,0 +1,115 @@
+/**
+ * @file lltexturefetchscheduler.h
+ * @brief Indexed priority heap ordering texture fetches waiting for an HTTP slot
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+
+#ifndef LL_LLTEXTUREFETCHSCHEDULER_H
+#define LL_LLTEXTUREFETCHSCHEDULER_H
+
+#include "lluuid.h"
+
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Queue of texture fetches waiting for an HTTP slot, most urgent first.
+ *
+ * Fetches are bucketed coarsely by deadline: the ones needed on screen now
+ * (any deadline) go before the ones needed later (NO_DEADLINE). Within a
+ * bucket the priority decides (largest first), and only equal priorities
+ * fall back to the earliest deadline. Entries are kept in a binary heap indexed by
+ * texture UUID, so a priority or deadline change is an O(log n) update of
+ * one entry instead of a re-sort of every waiter, and the next fetch to
+ * release is always at the top.
+ *
+ * A fetch whose priority drops to zero is cancelled, i.e. removed from the
+ * queue; update() reports it so the caller can stop the worker.
+ *
+ * Not thread safe, LLTextureFetch guards it with its network queue mutex.
+ */
+class LLTextureFetchScheduler
+{
+public:
+    static constexpr U32 NO_DEADLINE = U32_MAX;
+
+    // Queue id or, if it is queued already, move it to its new place. A
+    // priority of (almost) zero cancels the fetch. Returns false if id is
+    // not queued on return, i.e. it was cancelled.
+    bool update(const LLUUID& id, F32 priority, U32 needed_by_frame);
+    // Same as update() for an id that is queued, does nothing otherwise
+    bool reprioritize(const LLUUID& id, F32 priority, U32 needed_by_frame);
+    bool remove(const LLUUID& id);
+    void clear();
+
+    bool contains(const LLUUID& id) const { return mIndex.find(id) != mIndex.end(); }
+    // Most urgent fetch, false if the queue is empty
+    bool top(LLUUID& id) const;
+    bool pop(LLUUID& id);
+
+    size_t size() const { return mHeap.size(); }
+    bool empty() const { return mHeap.empty(); }
+    // Fetches cancelled by a zero priority so far
+    U32 getCancelCount() const { return mCancelCount; }
+    // Snapshot of the queued ids, in no particular order
+    void getIDs(uuid_vec_t& ids) const;
+
+private:
+    struct Entry
+    {
+        LLUUID  mID;
+        F32     mPriority;
+        U32     mNeededByFrame;
+    };
+
+    static bool before(const Entry& lhs, const Entry& rhs)
+    {
+        bool lhs_now = lhs.mNeededByFrame != NO_DEADLINE;
+        bool rhs_now = rhs.mNeededByFrame != NO_DEADLINE;
+        if (lhs_now != rhs_now)
+        {
+            return lhs_now;
+        }
+        if (lhs.mPriority != rhs.mPriority)
+        {
+            return lhs.mPriority > rhs.mPriority;
+        }
+        return lhs.mNeededByFrame < rhs.mNeededByFrame;
+    }
+
+    void set(const Entry& entry, size_t pos);
+    void erase(size_t pos);
+    void siftUp(size_t pos);
+    void siftDown(size_t pos);
+
+    std::vector<Entry> mHeap;
+    std::unordered_map<LLUUID, size_t> mIndex;  // position of each id in mHeap
+    U32 mCancelCount{ 0 };
+};
+
+#endif // LL_LLTEXTUREFETCHSCHEDULER_H
@@ -0,0 +1,844 @@
+/**
+ * @file lltexturepackedstore.cpp
+ * @brief Packed storage of texture cache bodies in large slab files
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+#include "llviewerprecompiledheaders.h"
+
+#include "lltexturepackedstore.h"
+
+#include "lldir.h"
+#include "lldiriterator.h"
+#include "llfile.h"
+#include "lltimer.h"
+
+#include <unordered_map>
+
+// Slab files are capped so they can be addressed with 32 bit offsets and
+// a failed compaction never has to move more than this.
+static const U32 SLAB_MAX_SIZE = 128 * 1024 * 1024;
+// Compact a slab once at least this fraction of it is dead space
+static const F32 SLAB_COMPACT_DEAD_RATIO = 0.5f;
+
+static const U32 RECORD_MAGIC = 0x32535854; // "TXS2"
+static const U32 INDEX_MAGIC = 0x49505854; // "TXPI"
+static const U32 INDEX_VERSION = 2;
+
+static const U32 SLOT_EMPTY = U32_MAX;
+static const U32 SLOT_TOMBSTONE = U32_MAX - 1;
+static const U32 MIN_CAPACITY = 1024;
+
+static const char* slab_file_mask = "slab_*.bin";
+static const char* index_filename = "slabs.index";
+
+struct IndexHeader
+{
+    U32 mMagic;
+    U32 mVersion;
+    U32 mSlabs;
+    U32 mEntries;
+    U64 mNextSequence;
+};
+
+struct IndexRecord
+{
+    U8  mID[UUID_BYTES];
+    U32 mSlab;
+    U32 mOffset;
+    U32 mSize;
+};
+
+LLTexturePackedStore::LLTexturePackedStore()
+{
+}
+
+LLTexturePackedStore::~LLTexturePackedStore()
+{
+    close();
+}
+
+void LLTexturePackedStore::open(const std::string& dir, bool read_only)
+{
+    LLMutexLock lock(&mMutex);
+    closeFiles();
+    mDir = dir;
+    mReadOnly = read_only;
+    resetIndex();
+
+    if (!loadIndex())
+    {
+        LL_INFOS("TextureCache") << "Rebuilding packed texture index" << LL_ENDL;
+        resetIndex();
+        rebuildIndex();
+        mDirty = true;
+    }
+    LL_INFOS("TextureCache") << "Packed texture store: " << mCount << " entries in "
+                             << getNumSlabs() << " slabs" << LL_ENDL;
+}
+
+void LLTexturePackedStore::close()
+{
+    saveIndex();
+    LLMutexLock lock(&mMutex);
+    closeFiles();
+}
+
+void LLTexturePackedStore::clear()
+{
+    LLMutexLock lock(&mMutex);
+    closeFiles();
+    if (!mReadOnly && !mDir.empty())
+    {
+        removeFiles(mDir);
+    }
+    resetIndex();
+}
+
+//static
+void LLTexturePackedStore::removeFiles(const std::string& dir)
+{
+    std::string filename;
+    LLDirIterator iter(dir, slab_file_mask);
+    while (iter.next(filename))
+    {
+        LLFile::remove(gDirUtilp->add(dir, filename));
+    }
+    LLFile::remove(gDirUtilp->add(dir, index_filename), ENOENT);
+}
+
+S32 LLTexturePackedStore::getSize(const LLUUID& id)
+{
+    LLMutexLock lock(&mMutex);
+    Slot* slot = findSlot(id);
+    return slot ? (S32)slot->mSize : -1;
+}
+
+S32 LLTexturePackedStore::read(const LLUUID& id, U8* data, S32 offset, S32 size)
+{
+    LLMutexLock lock(&mMutex);
+    Slot* slot = findSlot(id);
+    if (!slot)
+    {
+        return -1;
+    }
+    if (offset < 0 || (U32)offset >= slot->mSize || size <= 0)
+    {
+        return 0;
+    }
+    LLFILE* file = getSlabFile(slot->mSlab);
+    if (!file || fseek(file, slot->mOffset, SEEK_SET) != 0)
+    {
+        return 0;
+    }
+
+    // The index may be older than the slabs after a crash; never hand out
+    // another texture's data.
+    RecordHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1
+        || header.mMagic != RECORD_MAGIC
+        || header.mSize != slot->mSize
+        || memcmp(header.mID, id.mData, UUID_BYTES) != 0)
+    {
+        LL_WARNS("TextureCache") << "Packed texture record mismatch for " << id << LL_ENDL;
+        mSlabs[slot->mSlab].mLive -= sizeof(RecordHeader) + slot->mSize;
+        eraseSlot(slot);
+        return -1;
+    }
+
+    size = llmin(size, (S32)slot->mSize - offset);
+    if (offset && fseek(file, offset, SEEK_CUR) != 0)
+    {
+        return 0;
+    }
+    return (S32)fread(data, 1, size, file);
+}
+
+S32 LLTexturePackedStore::write(const LLUUID& id, const U8* data, S32 size)
+{
+    if (size <= 0 || id.isNull())
+    {
+        return 0;
+    }
+    LLMutexLock lock(&mMutex);
+    if (mReadOnly)
+    {
+        return 0;
+    }
+
+    Slot* slot = findSlot(id);
+    if (slot)
+    {
+        // The old record becomes dead space
+        mSlabs[slot->mSlab].mLive -= sizeof(RecordHeader) + slot->mSize;
+        eraseSlot(slot);
+    }
+
+    U32 slab, offset;
+    if (!append(id, data, (U32)size, slab, offset))
+    {
+        LL_WARNS("TextureCache") << "Unable to write packed texture " << id << LL_ENDL;
+        return 0;
+    }
+    slot = insertSlot(id);
+    slot->mSlab = slab;
+    slot->mOffset = offset;
+    slot->mSize = (U32)size;
+    return size;
+}
+
+bool LLTexturePackedStore::remove(const LLUUID& id)
+{
+    LLMutexLock lock(&mMutex);
+    Slot* slot = findSlot(id);
+    if (!slot)
+    {
+        return false;
+    }
+    U32 slab = slot->mSlab;
+    mSlabs[slab].mLive -= sizeof(RecordHeader) + slot->mSize;
+    eraseSlot(slot);
+    if (!mSlabs[slab].mLive && slab != mActiveSlab && !mReadOnly)
+    {
+        releaseSlab(slab);
+    }
+    return true;
+}
+
+void LLTexturePackedStore::prune(const std::function<bool(const LLUUID&)>& keep)
+{
+    LLMutexLock lock(&mMutex);
+    U32 pruned = 0;
+    for (Slot& slot : mSlots)
+    {
+        if (slot.mSlab < SLOT_TOMBSTONE && !keep(slot.mID))
+        {
+            mSlabs[slot.mSlab].mLive -= sizeof(RecordHeader) + slot.mSize;
+            eraseSlot(&slot);
+            ++pruned;
+        }
+    }
+    if (!mReadOnly)
+    {
+        for (U32 i = 0; i < mSlabs.size(); ++i)
+        {
+            if (mSlabs[i].mInUse && !mSlabs[i].mLive && i != mActiveSlab)
+            {
+                releaseSlab(i);
+            }
+        }
+    }
+    if (pruned)
+    {
+        LL_INFOS("TextureCache") << "Pruned " << pruned << " packed textures without cache entry" << LL_ENDL;
+    }
+}
+
+bool LLTexturePackedStore::needsCompaction()
+{
+    LLMutexLock lock(&mMutex);
+    if (mReadOnly)
+    {
+        return false;
+    }
+    if (mCompactSlab >= 0)
+    {
+        return true;
+    }
+    for (U32 i = 0; i < mSlabs.size(); ++i)
+    {
+        const Slab& slab = mSlabs[i];
+        if (slab.mInUse && i != mActiveSlab
+            && (F32)(slab.mSize - slab.mLive) > (F32)slab.mSize * SLAB_COMPACT_DEAD_RATIO)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void LLTexturePackedStore::compact(F32 time_limit_sec)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+    LLMutexLock lock(&mMutex);
+    if (mReadOnly)
+    {
+        return;
+    }
+
+    if (mCompactSlab < 0)
+    {
+        // Pick the slab with the most dead space
+        U32 most_dead = 0;
+        for (U32 i = 0; i < mSlabs.size(); ++i)
+        {
+            const Slab& slab = mSlabs[i];
+            U32 dead = slab.mSize - slab.mLive;
+            if (slab.mInUse && i != mActiveSlab && dead > most_dead
+                && (F32)dead > (F32)slab.mSize * SLAB_COMPACT_DEAD_RATIO)
+            {
+                most_dead = dead;
+                mCompactSlab = (S32)i;
+            }
+        }
+        if (mCompactSlab < 0)
+        {
+            return;
+        }
+        mCompactQueue.clear();
+        for (const Slot& slot : mSlots)
+        {
+            if (slot.mSlab == (U32)mCompactSlab)
+            {
+                mCompactQueue.push_back(slot.mID);
+            }
+        }
+        LL_DEBUGS("TextureCache") << "Compacting slab " << mCompactSlab << ": moving "
+                                  << mCompactQueue.size() << " records" << LL_ENDL;
+    }
+
+    LLTimer timer;
+    std::vector<U8> buffer;
+    while (!mCompactQueue.empty() && timer.getElapsedTimeF32() < time_limit_sec)
+    {
+        LLUUID id = mCompactQueue.back();
+        mCompactQueue.pop_back();
+        Slot* slot = findSlot(id);
+        if (!slot || slot->mSlab != (U32)mCompactSlab)
+        {
+            continue; // removed or rewritten since
+        }
+
+        U32 size = slot->mSize;
+        buffer.resize(size);
+        LLFILE* file = getSlabFile(slot->mSlab);
+        U32 new_slab, new_offset;
+        bool moved = file
+            && fseek(file, slot->mOffset + sizeof(RecordHeader), SEEK_SET) == 0
+            && fread(buffer.data(), 1, size, file) == size
+            && append(id, buffer.data(), size, new_slab, new_offset);
+
+        // append() may add a slab but never moves the slots, so slot is still valid
+        mSlabs[mCompactSlab].mLive -= sizeof(RecordHeader) + size;
+        if (moved)
+        {
+            slot->mSlab = new_slab;
+            slot->mOffset = new_offset;
+        }
+        else
+        {
+            eraseSlot(slot);
+        }
+    }
+
+    if (mCompactQueue.empty())
+    {
+        releaseSlab(mCompactSlab);
+        mCompactSlab = -1;
+    }
+}
+
+void LLTexturePackedStore::saveIndex()
+{
+    LLMutexLock lock(&mMutex);
+    if (mReadOnly || !mDirty || mDir.empty())
+    {
+        return;
+    }
+
+    // Sizes in the index must match the files for it to be trusted again
+    for (Slab& slab : mSlabs)
+    {
+        if (slab.mFile)
+        {
+            fflush(slab.mFile);
+        }
+    }
+
+    std::string filename = getIndexFilename();
+    std::string tmp_filename = filename + ".tmp";
+    LLFILE* file = LLFile::fopen(tmp_filename, "wb");
+    if (!file)
+    {
+        LL_WARNS("TextureCache") << "Unable to write " << tmp_filename << LL_ENDL;
+        return;
+    }
+
+    IndexHeader header{ INDEX_MAGIC, INDEX_VERSION, (U32)mSlabs.size(), mCount, mNextSequence };
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (const Slab& slab : mSlabs)
+    {
+        U32 size = slab.mInUse ? slab.mSize : 0;
+        ok = ok && fwrite(&size, sizeof(size), 1, file) == 1;
+    }
+    for (const Slot& slot : mSlots)
+    {
+        if (ok && slot.mSlab < SLOT_TOMBSTONE)
+        {
+            IndexRecord record;
+            memcpy(record.mID, slot.mID.mData, UUID_BYTES);
+            record.mSlab = slot.mSlab;
+            record.mOffset = slot.mOffset;
+            record.mSize = slot.mSize;
+            ok = fwrite(&record, sizeof(record), 1, file) == 1;
+        }
+    }
+    LLFile::close(file);
+
+    if (ok && LLFile::rename(tmp_filename, filename) == 0)
+    {
+        mDirty = false;
+    }
+    else
+    {
+        LL_WARNS("TextureCache") << "Unable to save packed texture index" << LL_ENDL;
+        LLFile::remove(tmp_filename);
+    }
+}
+
+U32 LLTexturePackedStore::getNumEntries()
+{
+    LLMutexLock lock(&mMutex);
+    return mCount;
+}
+
+U32 LLTexturePackedStore::getNumSlabs()
+{
+    LLMutexLock lock(&mMutex);
+    U32 count = 0;
+    for (const Slab& slab : mSlabs)
+    {
+        count += slab.mInUse ? 1 : 0;
+    }
+    return count;
+}
+
+//----------------------------------------------------------------------------
+// mMutex must be locked for the following functions!
+
+LLTexturePackedStore::Slot* LLTexturePackedStore::findSlot(const LLUUID& id)
+{
+    if (!mCount)
+    {
+        return nullptr;
+    }
+    U32 mask = (U32)mSlots.size() - 1;
+    for (U32 i = (U32)id.getDigest64() & mask; ; i = (i + 1) & mask)
+    {
+        Slot& slot = mSlots[i];
+        if (slot.mSlab == SLOT_EMPTY)
+        {
+            return nullptr;
+        }
+        if (slot.mSlab != SLOT_TOMBSTONE && slot.mID == id)
+        {
+            return &slot;
+        }
+    }
+}
+
+LLTexturePackedStore::Slot* LLTexturePackedStore::insertSlot(const LLUUID& id)
+{
+    // Keep the load factor, tombstones included, under 70%
+    if ((mCount + mTombstones + 1) * 10 > (U32)mSlots.size() * 7)
+    {
+        U32 capacity = MIN_CAPACITY;
+        while (capacity < (mCount + 1) * 2)
+        {
+            capacity *= 2;
+        }
+        rehash(capacity);
+    }
+
+    U32 mask = (U32)mSlots.size() - 1;
+    Slot* tombstone = nullptr;
+    for (U32 i = (U32)id.getDigest64() & mask; ; i = (i + 1) & mask)
+    {
+        Slot& slot = mSlots[i];
+        if (slot.mSlab == SLOT_EMPTY)
+        {
+            Slot* found = &slot;
+            if (tombstone)
+            {
+                found = tombstone;
+                --mTombstones;
+            }
+            found->mID = id;
+            found->mSlab = 0;
+            found->mOffset = 0;
+            found->mSize = 0;
+            ++mCount;
+            mDirty = true;
+            return found;
+        }
+        if (slot.mSlab == SLOT_TOMBSTONE)
+        {
+            if (!tombstone)
+            {
+                tombstone = &slot;
+            }
+        }
+        else if (slot.mID == id)
+        {
+            return &slot;
+        }
+    }
+}
+
+void LLTexturePackedStore::eraseSlot(Slot* slot)
+{
+    slot->mID.setNull();
+    slot->mSlab = SLOT_TOMBSTONE;
+    --mCount;
+    ++mTombstones;
+    mDirty = true;
+}
+
+void LLTexturePackedStore::rehash(U32 capacity)
+{
+    std::vector<Slot> old_slots;
+    old_slots.swap(mSlots);
+    mSlots.assign(capacity, Slot{ LLUUID::null, SLOT_EMPTY, 0, 0 });
+    mCount = 0;
+    mTombstones = 0;
+    for (const Slot& slot : old_slots)
+    {
+        if (slot.mSlab < SLOT_TOMBSTONE)
+        {
+            *insertSlot(slot.mID) = slot;
+        }
+    }
+}
+
+std::string LLTexturePackedStore::getSlabFilename(U32 slab) const
+{
+    return gDirUtilp->add(mDir, llformat("slab_%04u.bin", slab));
+}
+
+std::string LLTexturePackedStore::getIndexFilename() const
+{
+    return gDirUtilp->add(mDir, index_filename);
+}
+
+LLFILE* LLTexturePackedStore::getSlabFile(U32 slab)
+{
+    if (slab >= mSlabs.size())
+    {
+        return nullptr;
+    }
+    Slab& info = mSlabs[slab];
+    if (!info.mFile)
+    {
+        std::string filename = getSlabFilename(slab);
+        info.mFile = LLFile::fopen(filename, mReadOnly ? "rb" : "r+b");
+        if (!info.mFile && !mReadOnly && !info.mSize)
+        {
+            info.mFile = LLFile::fopen(filename, "w+b");
+        }
+    }
+    return info.mFile;
+}
+
+bool LLTexturePackedStore::loadIndex()
+{
+    LLFILE* file = LLFile::fopen(getIndexFilename(), "rb");
+    if (!file)
+    {
+        return false;
+    }
+
+    bool ok = true;
+    IndexHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1
+        || header.mMagic != INDEX_MAGIC
+        || header.mVersion != INDEX_VERSION)
+    {
+        ok = false;
+    }
+
+    // Every slab must be exactly as the index left it
+    if (ok)
+    {
+        mSlabs.resize(header.mSlabs);
+        for (U32 i = 0; ok && i < header.mSlabs; ++i)
+        {
+            U32 size = 0;
+            ok = fread(&size, sizeof(size), 1, file) == 1;
+            llstat stat_data;
+            bool exists = LLFile::stat(getSlabFilename(i), &stat_data) == 0;
+            if (ok && size)
+            {
+                ok = exists && (U64)stat_data.st_size == size;
+                mSlabs[i].mInUse = true;
+                mSlabs[i].mSize = size;
+            }
+            else if (ok && exists)
+            {
+                ok = false;
+            }
+        }
+        // Slab files the index does not know about
+        std::string filename;
+        LLDirIterator iter(mDir, slab_file_mask);
+        while (ok && iter.next(filename))
+        {
+            U32 slab = 0;
+            ok = sscanf(filename.c_str(), "slab_%u.bin", &slab) == 1 && slab < header.mSlabs;
+        }
+    }
+
+    for (U32 i = 0; ok && i < header.mEntries; ++i)
+    {
+        IndexRecord record;
+        ok = fread(&record, sizeof(record), 1, file) == 1
+            && record.mSlab < mSlabs.size()
+            && mSlabs[record.mSlab].mInUse
+            && (U64)record.mOffset + sizeof(RecordHeader) + record.mSize <= mSlabs[record.mSlab].mSize;
+        if (ok)
+        {
+            LLUUID id;
+            memcpy(id.mData, record.mID, UUID_BYTES);
+            Slot* slot = insertSlot(id);
+            slot->mSlab = record.mSlab;
+            slot->mOffset = record.mOffset;
+            slot->mSize = record.mSize;
+            mSlabs[record.mSlab].mLive += sizeof(RecordHeader) + record.mSize;
+        }
+    }
+    LLFile::close(file);
+
+    if (ok)
+    {
+        mNextSequence = header.mNextSequence;
+        pickActiveSlab();
+        mDirty = false;
+    }
+    return ok;
+}
+
+void LLTexturePackedStore::rebuildIndex()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+    // Sequence number of the record each slot points at. Slabs come in
+    // directory order and their numbers are reused, so neither tells
+    // which copy of a texture is the newest.
+    std::unordered_map<LLUUID, U64> sequences;
+    U64 max_sequence = 0;
+
+    std::string filename;
+    LLDirIterator iter(mDir, slab_file_mask);
+    while (iter.next(filename))
+    {
+        U32 slab_idx = 0;
+        if (sscanf(filename.c_str(), "slab_%u.bin", &slab_idx) != 1 || slab_idx > 0xffff)
+        {
+            continue;
+        }
+        if (slab_idx >= mSlabs.size())
+        {
+            mSlabs.resize(slab_idx + 1);
+        }
+        Slab& slab = mSlabs[slab_idx];
+        slab.mInUse = true;
+
+        LLFILE* file = getSlabFile(slab_idx);
+        llstat stat_data;
+        if (!file || LLFile::stat(getSlabFilename(slab_idx), &stat_data) != 0)
+        {
+            continue;
+        }
+        U64 file_size = (U64)stat_data.st_size;
+
+        // The record with the highest sequence number of a texture wins;
+        // stop at the first incomplete record, it was being written during
+        // a crash.
+        U32 offset = 0;
+        RecordHeader header;
+        while (fseek(file, offset, SEEK_SET) == 0
+               && fread(&header, sizeof(header), 1, file) == 1
+               && header.mMagic == RECORD_MAGIC
+               && (U64)offset + sizeof(header) + header.mSize <= file_size)
+        {
+            U32 record_size = sizeof(header) + header.mSize;
+            max_sequence = llmax(max_sequence, header.mSequence);
+
+            LLUUID id;
+            memcpy(id.mData, header.mID, UUID_BYTES);
+            Slot* slot = findSlot(id);
+            U64& sequence = sequences[id];
+            if (!slot || header.mSequence > sequence)
+            {
+                if (slot)
+                {
+                    mSlabs[slot->mSlab].mLive -= sizeof(RecordHeader) + slot->mSize;
+                }
+                else
+                {
+                    slot = insertSlot(id);
+                }
+                slot->mSlab = slab_idx;
+                slot->mOffset = offset;
+                slot->mSize = header.mSize;
+                sequence = header.mSequence;
+                slab.mLive += record_size;
+            }
+            offset += record_size;
+        }
+        slab.mSize = offset;
+        if (offset < file_size)
+        {
+            LL_WARNS("TextureCache") << "Discarding " << (file_size - offset) << " trailing bytes of "
+                                     << filename << LL_ENDL;
+        }
+    }
+
+    mNextSequence = max_sequence + 1;
+
+    // Slabs left with nothing live can go right away
+    for (U32 i = 0; i < mSlabs.size(); ++i)
+    {
+        if (mSlabs[i].mInUse && !mSlabs[i].mLive && !mReadOnly)
+        {
+            releaseSlab(i);
+        }
+    }
+    pickActiveSlab();
+}
+
+void LLTexturePackedStore::pickActiveSlab()
+{
+    // Keep appending to the emptiest slab; getWriteSlab() starts a new one
+    // if there is none or it is full.
+    mActiveSlab = U32_MAX;
+    for (U32 i = 0; i < mSlabs.size(); ++i)
+    {
+        if (mSlabs[i].mInUse
+            && (mActiveSlab == U32_MAX || mSlabs[i].mSize < mSlabs[mActiveSlab].mSize))
+        {
+            mActiveSlab = i;
+        }
+    }
+}
+
+void LLTexturePackedStore::closeFiles()
+{
+    for (Slab& slab : mSlabs)
+    {
+        if (slab.mFile)
+        {
+            LLFile::close(slab.mFile);
+            slab.mFile = nullptr;
+        }
+    }
+}
+
+U32 LLTexturePackedStore::getWriteSlab(U32 bytes)
+{
+    if (mActiveSlab < mSlabs.size() && mSlabs[mActiveSlab].mInUse
+        && (S32)mActiveSlab != mCompactSlab
+        && (!mSlabs[mActiveSlab].mSize || mSlabs[mActiveSlab].mSize + bytes <= SLAB_MAX_SIZE))
+    {
+        return mActiveSlab;
+    }
+
+    // Start a new slab, reusing the number of a released one if possible
+    U32 slab = 0;
+    while (slab < mSlabs.size() && (mSlabs[slab].mInUse || (S32)slab == mCompactSlab))
+    {
+        ++slab;
+    }
+    if (slab == mSlabs.size())
+    {
+        mSlabs.emplace_back();
+    }
+    mSlabs[slab] = Slab();
+    mSlabs[slab].mInUse = true;
+    mActiveSlab = slab;
+    mDirty = true;
+    return slab;
+}
+
+bool LLTexturePackedStore::append(const LLUUID& id, const U8* data, U32 size, U32& slab_out, U32& offset_out)
+{
+    U32 record_size = sizeof(RecordHeader) + size;
+    U32 slab = getWriteSlab(record_size);
+    LLFILE* file = getSlabFile(slab);
+    Slab& info = mSlabs[slab];
+    if (!file || fseek(file, info.mSize, SEEK_SET) != 0)
+    {
+        return false;
+    }
+
+    RecordHeader header;
+    memcpy(header.mID, id.mData, UUID_BYTES);
+    header.mSize = size;
+    header.mMagic = RECORD_MAGIC;
+    header.mSequence = mNextSequence;
+    if (fwrite(&header, sizeof(header), 1, file) != 1
+        || fwrite(data, 1, size, file) != size)
+    {
+        // Leave mSize where it was, the next record overwrites the partial one
+        return false;
+    }
+
+    ++mNextSequence;
+    slab_out = slab;
+    offset_out = info.mSize;
+    info.mSize += record_size;
+    info.mLive += record_size;
+    mDirty = true;
+    return true;
+}
+
+void LLTexturePackedStore::releaseSlab(U32 slab)
+{
+    Slab& info = mSlabs[slab];
+    if (info.mFile)
+    {
+        LLFile::close(info.mFile);
+    }
+    LLFile::remove(getSlabFilename(slab), ENOENT);
+    info = Slab();
+    if ((S32)slab == mCompactSlab)
+    {
+        mCompactSlab = -1;
+        mCompactQueue.clear();
+    }
+    mDirty = true;
+}
+
+void LLTexturePackedStore::resetIndex()
+{
+    mSlots.assign(MIN_CAPACITY, Slot{ LLUUID::null, SLOT_EMPTY, 0, 0 });
+    mCount = 0;
+    mTombstones = 0;
+    mNextSequence = 1;
+    mSlabs.clear();
+    mActiveSlab = U32_MAX;
+    mCompactSlab = -1;
+    mCompactQueue.clear();
+    mDirty = false;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file lltexturepackedstore.h
+ * @brief Packed storage of texture cache bodies in large slab files
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+#ifndef LL_LLTEXTUREPACKEDSTORE_H
+#define LL_LLTEXTUREPACKEDSTORE_H
+
+#include "llmutex.h"
+#include "lluuid.h"
+
+#include <functional>
+
+/**
+ * Stores the bodies of cached textures (everything after the part kept in
+ * texture.cache) as records appended to a handful of large slab files,
+ * instead of one file per texture. This keeps the number of files in the
+ * texture cache in the tens rather than the hundreds of thousands.
+ *
+ * Records are located through an open-addressed hash table keyed on the
+ * texture UUID. The table is saved next to the slabs on shutdown and loaded
+ * on startup; if it does not match the slabs (crash, or a viewer that does
+ * not use packed mode removed files) it is rebuilt by scanning them, as
+ * every record starts with its UUID and size.
+ *
+ * Rewriting or removing a texture leaves dead space behind in its slab.
+ * compact() reclaims it a little at a time by moving the live records of
+ * the emptiest slab to the end of the active one and deleting it.
+ *
+ * All methods are thread safe.
+ */
+class LLTexturePackedStore
+{
+    LOG_CLASS(LLTexturePackedStore);
+public:
+    LLTexturePackedStore();
+    ~LLTexturePackedStore();
+
+    // Load or rebuild the index of the slabs in dir
+    void open(const std::string& dir, bool read_only);
+    // Save the index and close the slab files
+    void close();
+
+    // Forget every record and remove the slab files
+    void clear();
+    // Remove packed store files from a cache directory not using packed mode
+    static void removeFiles(const std::string& dir);
+
+    // Body size of id, or -1 if it is not stored
+    S32 getSize(const LLUUID& id);
+    // Returns the number of bytes read, or -1 if id is not stored
+    S32 read(const LLUUID& id, U8* data, S32 offset, S32 size);
+    // Store (or replace) the body of id. Returns the number of bytes written.
+    S32 write(const LLUUID& id, const U8* data, S32 size);
+    bool remove(const LLUUID& id);
+    // Remove every record for which keep() returns false
+    void prune(const std::function<bool(const LLUUID&)>& keep);
+
+    bool needsCompaction();
+    void compact(F32 time_limit_sec);
+
+    void saveIndex();
+
+    U32 getNumEntries();
+    U32 getNumSlabs();
+
+private:
+    struct Slot
+    {
+        LLUUID  mID;
+        U32     mSlab;
+        U32     mOffset;    // of the record header in the slab
+        U32     mSize;      // of the body
+    };
+
+    struct Slab
+    {
+        LLFILE* mFile{ nullptr };
+        U32     mSize{ 0 };     // end of the last complete record
+        U32     mLive{ 0 };     // bytes used by records still in the index
+        bool    mInUse{ false };
+    };
+
+    // Record header written before every body in a slab. mSequence grows
+    // with every record written so the newest copy of a texture can be told
+    // apart when slabs are scanned in no particular order.
+    struct RecordHeader
+    {
+        U8  mID[UUID_BYTES];
+        U32 mSize;
+        U32 mMagic;
+        U64 mSequence;
+    };
+
+    // mMutex must be locked for the following
+    Slot* findSlot(const LLUUID& id);
+    Slot* insertSlot(const LLUUID& id);
+    void eraseSlot(Slot* slot);
+    void rehash(U32 capacity);
+
+    LLFILE* getSlabFile(U32 slab);
+    std::string getSlabFilename(U32 slab) const;
+    std::string getIndexFilename() const;
+    bool loadIndex();
+    void rebuildIndex();
+    void closeFiles();
+    void pickActiveSlab();
+    U32 getWriteSlab(U32 bytes);
+    bool append(const LLUUID& id, const U8* data, U32 size, U32& slab_out, U32& offset_out);
+    void releaseSlab(U32 slab);
+    void resetIndex();
+
+    LLMutex mMutex;
+    std::string mDir;
+    bool mReadOnly{ true };
+    bool mDirty{ false };
+
+    std::vector<Slot> mSlots;       // capacity is a power of two
+    U32 mCount{ 0 };
+    U32 mTombstones{ 0 };
+    U64 mNextSequence{ 1 };         // for the next RecordHeader written
+
+    std::vector<Slab> mSlabs;
+    U32 mActiveSlab{ U32_MAX };     // slab new records are appended to
+
+    // Incremental compaction state
+    S32 mCompactSlab{ -1 };
+    std::vector<LLUUID> mCompactQueue;
+};
+
+#endif // LL_LLTEXTUREPACKEDSTORE_H
@@ -43,7 +43,9 @@
 #include "llselectmgr.h"
 #include "llviewertexlayer.h"
 #include "lltexturecache.h"
+#include "lltexturedecodedcache.h" // <AS:Chanayane/> Decoded texture cache
 #include "lltexturefetch.h"
+#include "httpstats.h" // <AS:Chanayane/> Request phase latencies
 #include "llviewercontrol.h"
 #include "llviewerobject.h"
 #include "llviewerobjectlist.h"
@@ -693,11 +695,20 @@ void LLGLTexMemBar::draw()
     LLFontGL::getFontMonospace()->renderUTF8(text, 0, 0, v_offset + line_height*5,
                                              text_color, LLFontGL::LEFT, LLFontGL::TOP);
 
-    text = llformat("CacheHitRate: %3.2f Read: %d/%d/%d Decode: %d/%d/%d Fetch: %d/%d/%d",
+    // <AS:Chanayane> Cache read latency percentiles
+    //text = llformat("CacheHitRate: %3.2f Read: %d/%d/%d Decode: %d/%d/%d Fetch: %d/%d/%d",
+    LLTextureCache* texture_cache = LLAppViewer::getTextureCache();
+    text = llformat("CacheHitRate: %3.2f Read: %d/%d/%d p50/95/99: %d/%d/%d Decode: %d/%d/%d Fetch: %d/%d/%d",
+    // </AS:Chanayane>
                     cacheHitRate,
                     cacheReadLatMin,
                     cacheReadLatMed,
                     cacheReadLatMax,
+                    // <AS:Chanayane> Cache read latency percentiles
+                    (S32)(texture_cache->getReadLatencyPercentile(0.5f) / 1000),
+                    (S32)(texture_cache->getReadLatencyPercentile(0.95f) / 1000),
+                    (S32)(texture_cache->getReadLatencyPercentile(0.99f) / 1000),
+                    // </AS:Chanayane>
                     texDecodeLatMin,
                     texDecodeLatMed,
                     texDecodeLatMax,
@@ -705,6 +716,25 @@ void LLGLTexMemBar::draw()
                     texFetchLatMed,
                     texFetchLatMax);
 
+    // <AS:Chanayane> Decoded texture cache
+    if (LLTextureDecodedCache* decoded_cache = texture_cache->getDecodedCache())
+    {
+        text += llformat(" DecCache: %3.1f%% %dMB/%d",
+                         decoded_cache->getHitRate() * 100.f,
+                         (S32)(decoded_cache->getBytes() / (1024 * 1024)),
+                         (S32)decoded_cache->getNumEntries());
+    }
+    // </AS:Chanayane>
+    // <AS:Chanayane> Request phase latencies
+    {
+        const int texture_policy(LLAppViewer::instance()->getAppCoreHttp().getPolicy(LLAppCoreHttp::AP_TEXTURE));
+        const LLCore::HTTPStats & http_stats(LLCore::HTTPStats::instance());
+        text += llformat(" HttpTTFB p50/95/99: %d/%d/%d",
+                         (S32)(http_stats.getPhasePercentile(texture_policy, LLCore::HTTPStats::PHASE_FIRST_BYTE, 0.5f) / 1000),
+                         (S32)(http_stats.getPhasePercentile(texture_policy, LLCore::HTTPStats::PHASE_FIRST_BYTE, 0.95f) / 1000),
+                         (S32)(http_stats.getPhasePercentile(texture_policy, LLCore::HTTPStats::PHASE_FIRST_BYTE, 0.99f) / 1000));
+    }
+    // </AS:Chanayane>
     LLFontGL::getFontMonospace()->renderUTF8(text, 0, 0, v_offset + line_height*4,
                                              text_color, LLFontGL::LEFT, LLFontGL::TOP);
 
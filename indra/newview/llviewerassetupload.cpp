@@ -374,6 +374,16 @@ bool LLResourceUploadInfo::findAssetTypeAndCodecOfExtension(const std::string& e
 }
 
 //=========================================================================
+// <AS:Chanayane> Parallel upload encode
+// Result of an image encode started by startPrepareUpload(). The promise is
+// fulfilled on the main loop, where the upload coroutine waits for it.
+struct LLNewFileResourceUploadInfo::TextureEncode
+{
+    std::string                                         mTempFile;
+    LLCoros::Promise<std::pair<bool, std::string> >     mPromise;
+};
+// </AS:Chanayane>
+
 LLNewFileResourceUploadInfo::LLNewFileResourceUploadInfo(
     std::string fileName,
     std::string name,
@@ -408,6 +418,34 @@ LLSD LLNewFileResourceUploadInfo::prepareUpload()
     return LLResourceUploadInfo::prepareUpload();
 }
 
+// <AS:Chanayane> Parallel upload encode
+void LLNewFileResourceUploadInfo::startPrepareUpload()
+{
+    if (mTextureEncode)
+    {
+        return;
+    }
+
+    LLAssetType::EType assetType = LLAssetType::AT_NONE;
+    U32 codec = IMG_CODEC_INVALID;
+    if (!findAssetTypeAndCodecOfExtension(gDirUtilp->getExtension(getFileName()), assetType, codec)
+        || assetType != LLAssetType::AT_TEXTURE)
+    {
+        return;
+    }
+
+    std::shared_ptr<TextureEncode> encode = std::make_shared<TextureEncode>();
+    encode->mTempFile = gDirUtilp->getTempFilename();
+    mTextureEncode = encode;
+
+    LLViewerTextureList::createUploadFileAsync(getFileName(), encode->mTempFile, (U8)codec, mMaxImageSize, 0, false,
+        [encode](bool success, const std::string& error)
+        {
+            encode->mPromise.set_value(std::make_pair(success, error));
+        });
+}
+// </AS:Chanayane>
+
 LLSD LLNewFileResourceUploadInfo::exportTempFile()
 {
     std::string filename = gDirUtilp->getTempFilename();
@@ -446,12 +484,32 @@ LLSD LLNewFileResourceUploadInfo::exportTempFile()
     else if (assetType == LLAssetType::AT_TEXTURE)
     {
         // It's an image file, the upload procedure is the same for all
-        if (!LLViewerTextureList::createUploadFile(getFileName(), filename, codec, mMaxImageSize))
+        // <AS:Chanayane> Parallel upload encode
+        //if (!LLViewerTextureList::createUploadFile(getFileName(), filename, codec, mMaxImageSize))
+        bool encoded = false;
+        std::string encode_error;
+        if (mTextureEncode && !LLCoros::on_main_thread_main_coro())
+        {
+            // Encoded on the upload encode pool, only this coroutine waits
+            std::pair<bool, std::string> result = LLCoros::getFuture(mTextureEncode->mPromise).get();
+            filename = mTextureEncode->mTempFile;
+            encoded = result.first;
+            encode_error = result.second;
+            mTextureEncode.reset();
+        }
+        else
+        {
+            encoded = LLViewerTextureList::createUploadFile(getFileName(), filename, codec, mMaxImageSize);
+            encode_error = LLImage::getLastThreadError();
+        }
+        if (!encoded)
+        // </AS:Chanayane>
         {
             // <FS:Ansariel> Duplicate error message output
             //errorMessage = llformat("Problem with file %s:\n\n%s\n",
             //    getFileName().c_str(), LLImage::getLastThreadError().c_str());
-            errorMessage = LLImage::getLastThreadError();
+            //errorMessage = LLImage::getLastThreadError();
+            errorMessage = encode_error; // <AS:Chanayane/> Parallel upload encode
             // </FS:Ansariel>
             errorLabel = "ProblemWithFile";
             error = true;
@@ -884,6 +942,10 @@ LLUUID LLViewerAssetUpload::EnqueueInventoryUpload(const std::string &url, const
 {
     std::string procName("LLViewerAssetUpload::AssetInventoryUploadCoproc(");
 
+    // Uploads run one at a time in the coprocedure, but their images can be
+    // encoded several at a time meanwhile.
+    uploadInfo->startPrepareUpload(); // <AS:Chanayane/> Parallel upload encode
+
     LLUUID queueId = LLCoprocedureManager::instance().enqueueCoprocedure("Upload",
         procName + LLAssetType::lookup(uploadInfo->getAssetType()) + ")",
         boost::bind(&LLViewerAssetUpload::AssetInventoryUploadCoproc, _1, _2, url, uploadInfo));
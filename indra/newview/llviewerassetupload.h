@@ -63,6 +63,12 @@ public:
     virtual LLSD        prepareUpload();
     virtual LLSD        generatePostBody();
     virtual void        logPreparedUpload();
+    // <AS:Chanayane> Parallel upload encode
+    // Start expensive preparation (image encoding) in the background as soon
+    // as the upload is queued, prepareUpload() then waits for it. Only call
+    // this when prepareUpload() will run in a coroutine.
+    virtual void        startPrepareUpload() { }
+    // </AS:Chanayane>
     virtual LLUUID      finishUpload(LLSD &result);
 
     // return true if no further action is need
@@ -161,6 +167,7 @@ public:
         bool show_inventory = true);
 
     virtual LLSD        prepareUpload();
+    virtual void        startPrepareUpload(); // <AS:Chanayane/> Parallel upload encode
 
     std::string         getFileName() const { return mFileName; };
 
@@ -173,6 +180,11 @@ protected:
 private:
     std::string         mFileName;
     S32                 mMaxImageSize;
+
+    // <AS:Chanayane> Parallel upload encode
+    struct TextureEncode;
+    std::shared_ptr<TextureEncode> mTextureEncode;
+    // </AS:Chanayane>
 };
 
 //-------------------------------------------------------------------------
@@ -108,6 +108,7 @@
 #include "fsradar.h"
 #include "llavataractions.h"
 #include "lldiskcache.h"
+#include "llfilesystem.h" // <AS:Chanayane/> Memory-mapped reads
 #include "llfloaterreg.h"
 #include "llfloatersidepanelcontainer.h"
 #include "llhudtext.h"
@@ -1140,6 +1141,13 @@ void handleDiskCacheLowWaterPctChanged(const LLSD& newValue)
 }
 // </FS:Beq>
 
+// <AS:Chanayane> Memory-mapped reads
+void handleDiskCacheMemoryMappedReadsChanged(const LLSD& newValue)
+{
+    LLFileSystem::setUseMemoryMapping(newValue.asBoolean());
+}
+// </AS:Chanayane>
+
 void handleTargetFPSChanged(const LLSD& newValue)
 {
     const auto targetFPS = gSavedSettings.getU32("TargetFPS");
@@ -1583,6 +1591,7 @@ void settings_setup_listeners()
     setting_setup_signal_listener(gSavedSettings, "FSDiskCacheHighWaterPercent", handleDiskCacheHighWaterPctChanged);
     setting_setup_signal_listener(gSavedSettings, "FSDiskCacheLowWaterPercent", handleDiskCacheLowWaterPctChanged);
     // </FS:Beq>
+    setting_setup_signal_listener(gSavedSettings, "ASDiskCacheMemoryMappedReads", handleDiskCacheMemoryMappedReadsChanged); // <AS:Chanayane/> Memory-mapped reads
 
     // <FS:Zi> Handle IME text input getting enabled or disabled
 #if LL_SDL2
@@ -1203,10 +1203,15 @@ class LLFileTakeSnapshotToDisk : public view_listener_t
                 formatted = new LLImageWebP;
                 break;
             }
-            formatted->enableOverSize() ;
-            formatted->encode(raw, 0);
-            formatted->disableOverSize() ;
-            LLSnapshotLivePreview::saveLocal(formatted);
+            // <AS:Chanayane> Streaming encoders
+            // The raw snapshot is encoded straight to the file once its name is known
+            //formatted->enableOverSize() ;
+            //formatted->encode(raw, 0);
+            //formatted->disableOverSize() ;
+            //LLSnapshotLivePreview::saveLocal(formatted);
+            formatted->enableOverSize();
+            LLSnapshotLivePreview::saveLocal(formatted, LLSnapshotLivePreview::snapshot_saved_signal_t(), LLSnapshotLivePreview::snapshot_saved_signal_t(), raw);
+            // </AS:Chanayane>
         }
         return true;
     }
@@ -1643,6 +1643,7 @@ bool LLViewerFetchedTexture::createTexture(S32 usename/*= 0*/)
         return false;
     }
 
+    LLImageGLUploadScope upload_scope(mUploadSlice); // <AS:Chanayane/> Texture upload ring
     bool res = mGLTexturep->createGLTexture(mRawDiscardLevel, mRawImage, usename, true, mBoostLevel);
 
     return res;
@@ -2072,6 +2073,22 @@ bool LLViewerFetchedTexture::processFetchResults(S32& desired_discard, S32 curre
     return true;
 }
 
+// <AS:Chanayane> Texture fetch scheduler
+void LLViewerFetchedTexture::setOnScreen(bool on_screen)
+{
+    if (!on_screen)
+    {
+        mNeededByFrame = LLTextureFetchScheduler::NO_DEADLINE;
+    }
+    else if (mNeededByFrame == LLTextureFetchScheduler::NO_DEADLINE)
+    {
+        // Keep the frame it came on screen: among the textures on screen,
+        // the ones waited for the longest go first.
+        mNeededByFrame = gFrameCount;
+    }
+}
+// </AS:Chanayane>
+
 bool LLViewerFetchedTexture::updateFetch()
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
@@ -2137,7 +2154,7 @@ bool LLViewerFetchedTexture::updateFetch()
         if (mAuxRawImage.notNull()) sAuxCount--;
         // keep in mind that fetcher still might need raw image, don't modify original
         bool finished = LLAppViewer::getTextureFetch()->getRequestFinished(getID(), fetch_discard, mFetchState, mRawImage, mAuxRawImage,
-                                                                           mLastHttpGetStatus);
+                                                                           mLastHttpGetStatus, &mUploadSlice); // <AS:Chanayane/> Texture upload ring
         if (mRawImage.notNull()) sRawCount++;
         if (mAuxRawImage.notNull())
         {
@@ -2167,7 +2184,19 @@ bool LLViewerFetchedTexture::updateFetch()
             if(decode_priority > 0.0f || mStopFetchingTimer.getElapsedTimeF32() > MAX_HOLD_TIME)
             {
                 mStopFetchingTimer.reset();
-                LLAppViewer::getTextureFetch()->updateRequestPriority(mID, decode_priority);
+                // <AS:Chanayane> Texture fetch scheduler
+                // Only post the changes that can reorder the fetch queue
+                //LLAppViewer::getTextureFetch()->updateRequestPriority(mID, decode_priority);
+                constexpr F32 FETCH_PRIORITY_CHANGE = 0.1f;
+                if (mNeededByFrame != mSentNeededByFrame
+                    || (decode_priority > 0.f) != (mSentFetchPriority > 0.f)
+                    || llabs(decode_priority - mSentFetchPriority) > FETCH_PRIORITY_CHANGE * mSentFetchPriority)
+                {
+                    mSentFetchPriority = decode_priority;
+                    mSentNeededByFrame = mNeededByFrame;
+                    LLAppViewer::getTextureFetch()->updateRequestPriority(mID, decode_priority, mNeededByFrame);
+                }
+                // </AS:Chanayane>
             }
         }
     }
@@ -2242,8 +2271,14 @@ bool LLViewerFetchedTexture::updateFetch()
         // bypass texturefetch directly by pulling from LLTextureCache
         S32 fetch_request_response = -1;
         S32 worker_discard = -1;
+        // <AS:Chanayane> Texture fetch scheduler
+        //fetch_request_response = LLAppViewer::getTextureFetch()->createRequest(mFTType, mUrl, getID(), getTargetHost(), decode_priority,
+        //                                                                      w, h, c, desired_discard, needsAux(), mCanUseHTTP);
         fetch_request_response = LLAppViewer::getTextureFetch()->createRequest(mFTType, mUrl, getID(), getTargetHost(), decode_priority,
-                                                                              w, h, c, desired_discard, needsAux(), mCanUseHTTP);
+                                                                              w, h, c, desired_discard, needsAux(), mCanUseHTTP, mNeededByFrame);
+        mSentFetchPriority = decode_priority;
+        mSentNeededByFrame = mNeededByFrame;
+        // </AS:Chanayane>
 
         if (fetch_request_response >= 0) // positive values and 0 are discard values
         {
@@ -2885,6 +2920,7 @@ void LLViewerFetchedTexture::destroyRawImage()
         }
 
         mRawImage = nullptr;
+        mUploadSlice = nullptr; // <AS:Chanayane/> Texture upload ring
 
         mIsRawImageValid = false;
         mRawDiscardLevel = INVALID_DISCARD_LEVEL;
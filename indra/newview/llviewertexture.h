@@ -29,6 +29,7 @@
 
 #include "llatomic.h"
 #include "llgltexture.h"
+#include "llimageglupload.h" // <AS:Chanayane/> Texture upload ring
 #include "lltimer.h"
 #include "llframetimer.h"
 #include "llhost.h"
@@ -398,6 +399,11 @@ public:
     LLFrameTimer* getLastPacketTimer() {return &mLastPacketTimer;}
 
     U32 getFetchPriority() const { return mFetchPriority ;}
+    // <AS:Chanayane> Texture fetch scheduler
+    // Whether the texture is on screen this frame. Keeps the frame it has
+    // been needed on screen since, fetches are scheduled by it.
+    void setOnScreen(bool on_screen);
+    // </AS:Chanayane>
     F32 getDownloadProgress() const {return mDownloadProgress ;}
 
     void destroyRawImage();
@@ -514,6 +520,7 @@ protected:
 
     LLPointer<LLImageRaw> mRawImage;
     S32 mRawDiscardLevel = -1;
+    LLPointer<LLImageGLUploadSlice> mUploadSlice; // <AS:Chanayane/> Texture upload ring, staged copy of mRawImage
 
     // Used ONLY for cloth meshes right now.  Make SURE you know what you're
     // doing if you use it for anything else! - djs
@@ -535,6 +542,12 @@ protected:
     LLFrameTimer mLastPacketTimer;      // Time since last packet.
     LLFrameTimer mStopFetchingTimer;    // Time since mDecodePriority == 0.f.
 
+    // <AS:Chanayane> Texture fetch scheduler
+    U32 mNeededByFrame{ U32_MAX };      // Frame needed on screen by, LLTextureFetchScheduler::NO_DEADLINE if off screen
+    F32 mSentFetchPriority{ 0.f };      // Priority and deadline last given to the fetcher
+    U32 mSentNeededByFrame{ U32_MAX };
+    // </AS:Chanayane>
+
     bool  mInImageList;             // true if image is in list (in which case don't reset priority!)
     // This needs to be atomic, since it is written both in the main thread
     // and in the GL image worker thread... HB
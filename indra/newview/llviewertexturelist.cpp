@@ -33,6 +33,7 @@
 #include "llagent.h"
 #include "llgl.h" // fot gathering stats from GL
 #include "llimagegl.h"
+#include "llimageglupload.h" // <AS:Chanayane/> Texture upload ring
 #include "llimagebmp.h"
 #include "llimagej2c.h"
 #include "llimagetga.h"
@@ -1042,8 +1043,16 @@ void LLViewerTextureList::updateImageDecodePriority(LLViewerFetchedTexture* imag
             }
         }
 
+        imagep->setOnScreen(on_screen); // <AS:Chanayane/> Texture fetch scheduler
         imagep->addTextureStats(max_vsize);
     }
+    // <AS:Chanayane> Texture fetch scheduler
+    else
+    {
+        // Boosted textures (UI, avatars, ...) are always wanted right away
+        imagep->setOnScreen(true);
+    }
+    // </AS:Chanayane>
 
 #if 0
     imagep->setDebugText(llformat("%d/%d - %d/%d -- %d/%d",
@@ -1159,6 +1168,15 @@ F32 LLViewerTextureList::updateImagesCreateTextures(F32 max_time)
         }
     }
 
+    // <AS:Chanayane> Texture upload ring
+    // One fence for the batch of uploads above, and recycle the ring space
+    // of earlier batches the GPU is done with
+    if (LLImageGLUploadRing::instanceExists())
+    {
+        LLImageGLUploadRing::getInstance()->flush();
+    }
+    // </AS:Chanayane>
+
     if (!mDownScaleQueue.empty() && gPipeline.mDownResMap.isComplete())
     {
         LLGLDisable blend(GL_BLEND);
@@ -1464,6 +1482,19 @@ bool LLViewerTextureList::createUploadFile(const std::string& filename,
                                          const S32 max_image_dimentions,
                                          const S32 min_image_dimentions,
                                          bool force_square)
+// <AS:Chanayane> Parallel upload encode
+{
+    return createUploadFile(filename, out_filename, codec, max_image_dimentions, min_image_dimentions, force_square, getUploadEncodeSettings());
+}
+
+bool LLViewerTextureList::createUploadFile(const std::string& filename,
+                                         const std::string& out_filename,
+                                         const U8 codec,
+                                         const S32 max_image_dimentions,
+                                         const S32 min_image_dimentions,
+                                         bool force_square,
+                                         const UploadEncodeSettings& settings)
+// </AS:Chanayane>
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
     try
@@ -1517,7 +1548,10 @@ bool LLViewerTextureList::createUploadFile(const std::string& filename,
     /*
     LLPointer<LLImageJ2C> compressedImage = convertToUploadFile(raw_image, max_image_dimentions, force_square);
     */
-    LLPointer<LLImageJ2C> compressedImage = convertToUploadFile(raw_image, max_image_dimentions, force_square, true);
+    // <AS:Chanayane> Parallel upload encode
+    //LLPointer<LLImageJ2C> compressedImage = convertToUploadFile(raw_image, max_image_dimentions, force_square, true);
+    LLPointer<LLImageJ2C> compressedImage = convertToUploadFile(raw_image, max_image_dimentions, force_square, true, settings);
+    // </AS:Chanayane>
 // </AS:Chanayane>
     if (compressedImage.isNull())
     {
@@ -1548,8 +1582,76 @@ bool LLViewerTextureList::createUploadFile(const std::string& filename,
     return true;
 }
 
+// <AS:Chanayane> Parallel upload encode
+//static
+void LLViewerTextureList::createUploadFileAsync(const std::string& filename,
+                                                const std::string& out_filename,
+                                                const U8 codec,
+                                                const S32 max_image_dimentions,
+                                                const S32 min_image_dimentions,
+                                                bool force_square,
+                                                const upload_file_callback_t& callback)
+{
+    // gSavedSettings is only read on the main thread
+    const UploadEncodeSettings settings = getUploadEncodeSettings();
+    LL::WorkQueue::ptr_t main_queue = LL::WorkQueue::getInstance("mainloop");
+    LL::WorkQueue::ptr_t encode_queue = LL::WorkQueue::getInstance("UploadEncode");
+    if (main_queue && encode_queue)
+    {
+        bool posted = main_queue->postTo(
+            encode_queue,
+            [=]() // Work done on the upload encode pool
+            {
+                // Image errors are kept per thread, carry the text back
+                bool success = createUploadFile(filename, out_filename, codec, max_image_dimentions, min_image_dimentions, force_square, settings);
+                if (!success)
+                {
+                    // Do not leave a partly written file behind
+                    LLFile::remove(out_filename, ENOENT);
+                }
+                return std::make_pair(success, success ? std::string() : LLImage::getLastThreadError());
+            },
+            [callback](std::pair<bool, std::string> result) // Callback to main thread
+            {
+                callback(result.first, result.second);
+            });
+        if (posted)
+        {
+            return;
+        }
+    }
+
+    bool success = createUploadFile(filename, out_filename, codec, max_image_dimentions, min_image_dimentions, force_square, settings);
+    if (!success)
+    {
+        LLFile::remove(out_filename, ENOENT);
+    }
+    callback(success, success ? std::string() : LLImage::getLastThreadError());
+}
+
+//static
+LLViewerTextureList::UploadEncodeSettings LLViewerTextureList::getUploadEncodeSettings()
+{
+    UploadEncodeSettings settings;
+    settings.mLossless = gSavedSettings.getBOOL("LosslessJ2CUpload");
+    settings.mAdvancedCompression = gSavedSettings.getBOOL("Jpeg2000AdvancedCompression");
+    settings.mBlockSize = gSavedSettings.getS32("Jpeg2000BlocksSize");
+    settings.mPrecinctSize = gSavedSettings.getS32("Jpeg2000PrecinctsSize");
+    return settings;
+}
+// </AS:Chanayane>
+
 // note: modifies the argument raw_image!!!!
 LLPointer<LLImageJ2C> LLViewerTextureList::convertToUploadFile(LLPointer<LLImageRaw> raw_image, const S32 max_image_dimentions, bool force_square, bool force_lossless)
+// <AS:Chanayane> Parallel upload encode
+{
+    return convertToUploadFile(raw_image, max_image_dimentions, force_square, force_lossless, getUploadEncodeSettings());
+}
+
+// note: modifies the argument raw_image!!!!
+LLPointer<LLImageJ2C> LLViewerTextureList::convertToUploadFile(LLPointer<LLImageRaw> raw_image, const S32 max_image_dimentions, bool force_square, bool force_lossless,
+                                                               const UploadEncodeSettings& settings)
+// </AS:Chanayane>
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
     LLImageDataLock lock(raw_image);
@@ -1567,22 +1669,33 @@ LLPointer<LLImageJ2C> LLViewerTextureList::convertToUploadFile(LLPointer<LLImage
     }
     LLPointer<LLImageJ2C> compressedImage = new LLImageJ2C();
 
+    // <AS:Chanayane> Parallel upload encode
+    //if (force_lossless ||
+    //    (gSavedSettings.getBOOL("LosslessJ2CUpload") &&
     if (force_lossless ||
-        (gSavedSettings.getBOOL("LosslessJ2CUpload") &&
+        (settings.mLossless &&
+    // </AS:Chanayane>
             (raw_image->getWidth() * raw_image->getHeight() <= LL_IMAGE_REZ_LOSSLESS_CUTOFF * LL_IMAGE_REZ_LOSSLESS_CUTOFF)))
     {
         compressedImage->setReversible(true);
     }
 
 
-    if (gSavedSettings.getBOOL("Jpeg2000AdvancedCompression"))
+    // <AS:Chanayane> Parallel upload encode
+    //if (gSavedSettings.getBOOL("Jpeg2000AdvancedCompression"))
+    if (settings.mAdvancedCompression)
+    // </AS:Chanayane>
     {
         // This test option will create jpeg2000 images with precincts for each level, RPCL ordering
         // and PLT markers. The block size is also optionally modifiable.
         // Note: the images hence created are compatible with older versions of the viewer.
         // Read the blocks and precincts size settings
-        S32 block_size = gSavedSettings.getS32("Jpeg2000BlocksSize");
-        S32 precinct_size = gSavedSettings.getS32("Jpeg2000PrecinctsSize");
+        // <AS:Chanayane> Parallel upload encode
+        //S32 block_size = gSavedSettings.getS32("Jpeg2000BlocksSize");
+        //S32 precinct_size = gSavedSettings.getS32("Jpeg2000PrecinctsSize");
+        S32 block_size = settings.mBlockSize;
+        S32 precinct_size = settings.mPrecinctSize;
+        // </AS:Chanayane>
         LL_INFOS() << "Advanced JPEG2000 Compression: precinct = " << precinct_size << ", block = " << block_size << LL_ENDL;
         compressedImage->initEncode(*raw_image, block_size, precinct_size, 0);
     }
@@ -106,6 +106,40 @@ public:
                                                      const S32 max_image_dimentions = LLViewerFetchedTexture::MAX_IMAGE_SIZE_DEFAULT,
                                                      bool force_square = false,
                                                      bool force_lossless = false);
+    // <AS:Chanayane> Parallel upload encode
+    // J2C encoder settings, read on the main thread for encodes done elsewhere
+    struct UploadEncodeSettings
+    {
+        bool    mLossless;
+        bool    mAdvancedCompression;
+        S32     mBlockSize;
+        S32     mPrecinctSize;
+    };
+    static UploadEncodeSettings getUploadEncodeSettings();
+    static bool createUploadFile(const std::string& filename,
+                                 const std::string& out_filename,
+                                 const U8 codec,
+                                 const S32 max_image_dimentions,
+                                 const S32 min_image_dimentions,
+                                 bool force_square,
+                                 const UploadEncodeSettings& settings);
+    static LLPointer<LLImageJ2C> convertToUploadFile(LLPointer<LLImageRaw> raw_image,
+                                                     const S32 max_image_dimentions,
+                                                     bool force_square,
+                                                     bool force_lossless,
+                                                     const UploadEncodeSettings& settings);
+
+    typedef std::function<void(bool success, const std::string& error)> upload_file_callback_t;
+    // Run createUploadFile() on the "UploadEncode" thread pool and call back
+    // on the main loop. Encodes right away when there is no such pool.
+    static void createUploadFileAsync(const std::string& filename,
+                                      const std::string& out_filename,
+                                      const U8 codec,
+                                      const S32 max_image_dimentions,
+                                      const S32 min_image_dimentions,
+                                      bool force_square,
+                                      const upload_file_callback_t& callback);
+    // </AS:Chanayane>
     static void processImageNotInDatabase( LLMessageSystem *msg, void **user_data );
     // <FS:Ansariel> OpenSim compatibility
     static void receiveImageHeader(LLMessageSystem *msg, void **user_data);
@@ -127,6 +127,8 @@
 #include "llhudobject.h"
 #include "llhudview.h"
 #include "llimage.h"
+#include "llimageglupload.h" // <AS:Chanayane/> Texture upload ring
+#include "llsnapshotcompositor.h" // <AS:Chanayane/> Asynchronous snapshot tile read back
 #include "llimagej2c.h"
 #include "llimageworker.h"
 #include "llkeyboard.h"
@@ -2157,6 +2159,12 @@ LLViewerWindow::LLViewerWindow(const Params& p)
     // Init the image list.  Must happen after GL is initialized and before the images that
     // LLViewerWindow needs are requested, as well as before LLViewerMedia starts updating images.
     LLImageGL::initClass(mWindow, LLViewerTexture::MAX_GL_IMAGE_CATEGORY, false, gSavedSettings.getBOOL("RenderGLMultiThreadedTextures"), gSavedSettings.getBOOL("RenderGLMultiThreadedMedia"));
+    // <AS:Chanayane> Texture upload ring
+    if (gSavedSettings.getBOOL("ASTextureUploadRing") && !LLImageGLThread::sEnabledTextures && LLImageGLUploadRing::isSupported())
+    {
+        LLImageGLUploadRing::createInstance(gSavedSettings.getU32("ASTextureUploadRingSizeMB") << 20);
+    }
+    // </AS:Chanayane>
     gTextureList.init();
     LLViewerTextureManager::init() ;
     gBumpImageList.init();
@@ -2660,6 +2668,7 @@ void LLViewerWindow::shutdownGL()
     LLWorldMapView::cleanupTextures();
 
     LLViewerTextureManager::cleanup() ;
+    LLImageGLUploadRing::deleteSingleton(); // <AS:Chanayane/> Texture upload ring
     SUBSYSTEM_CLEANUP(LLImageGL) ;
 
     LL_INFOS() << "All textures and llimagegl images are destroyed!" << LL_ENDL ;
@@ -5842,7 +5851,10 @@ bool LLViewerWindow::mousePointOnLandGlobal(const S32 x, const S32 y, LLVector3d
 }
 
 // Saves an image to the harddrive as "SnapshotX" where X >= 1.
-void LLViewerWindow::saveImageNumbered(LLImageFormatted *image, bool force_picker, const snapshot_saved_signal_t::slot_type& success_cb, const snapshot_saved_signal_t::slot_type& failure_cb)
+// <AS:Chanayane> Streaming encoders
+//void LLViewerWindow::saveImageNumbered(LLImageFormatted *image, bool force_picker, const snapshot_saved_signal_t::slot_type& success_cb, const snapshot_saved_signal_t::slot_type& failure_cb)
+void LLViewerWindow::saveImageNumbered(LLImageFormatted *image, bool force_picker, const snapshot_saved_signal_t::slot_type& success_cb, const snapshot_saved_signal_t::slot_type& failure_cb, LLImageRaw* raw)
+// </AS:Chanayane>
 {
     if (!image)
     {
@@ -5875,23 +5887,35 @@ void LLViewerWindow::saveImageNumbered(LLImageFormatted *image, bool force_picke
         else
             pick_type = LLFilePicker::FFSAVE_ALL;
 
-        LLFilePickerReplyThread::startPicker(boost::bind(&LLViewerWindow::onDirectorySelected, this, _1, formatted_image, success_cb, failure_cb), pick_type, proposed_name,
+        // <AS:Chanayane> Streaming encoders
+        //LLFilePickerReplyThread::startPicker(boost::bind(&LLViewerWindow::onDirectorySelected, this, _1, formatted_image, success_cb, failure_cb), pick_type, proposed_name,
+        LLFilePickerReplyThread::startPicker(boost::bind(&LLViewerWindow::onDirectorySelected, this, _1, formatted_image, success_cb, failure_cb, LLPointer<LLImageRaw>(raw)), pick_type, proposed_name,
+        // </AS:Chanayane>
                                         boost::bind(&LLViewerWindow::onSelectionFailure, this, failure_cb));
     }
     else
     {
-        saveImageLocal(formatted_image, success_cb, failure_cb);
+        // <AS:Chanayane> Streaming encoders
+        //saveImageLocal(formatted_image, success_cb, failure_cb);
+        saveImageLocal(formatted_image, success_cb, failure_cb, raw);
+        // </AS:Chanayane>
     }
 }
 
-void LLViewerWindow::onDirectorySelected(const std::vector<std::string>& filenames, LLImageFormatted *image, const snapshot_saved_signal_t::slot_type& success_cb, const snapshot_saved_signal_t::slot_type& failure_cb)
+// <AS:Chanayane> Streaming encoders
+//void LLViewerWindow::onDirectorySelected(const std::vector<std::string>& filenames, LLImageFormatted *image, const snapshot_saved_signal_t::slot_type& success_cb, const snapshot_saved_signal_t::slot_type& failure_cb)
+void LLViewerWindow::onDirectorySelected(const std::vector<std::string>& filenames, LLImageFormatted *image, const snapshot_saved_signal_t::slot_type& success_cb, const snapshot_saved_signal_t::slot_type& failure_cb, LLPointer<LLImageRaw> raw)
+// </AS:Chanayane>
 {
     // Copy the directory + file name
     std::string filepath = filenames[0];
 
     gSavedPerAccountSettings.setString("SnapshotBaseName", gDirUtilp->getBaseFileName(filepath, true));
     gSavedPerAccountSettings.setString("SnapshotBaseDir", gDirUtilp->getDirName(filepath));
-    saveImageLocal(image, success_cb, failure_cb);
+    // <AS:Chanayane> Streaming encoders
+    //saveImageLocal(image, success_cb, failure_cb);
+    saveImageLocal(image, success_cb, failure_cb, raw);
+    // </AS:Chanayane>
 }
 
 void LLViewerWindow::onSelectionFailure(const snapshot_saved_signal_t::slot_type& failure_cb)
@@ -5900,7 +5924,10 @@ void LLViewerWindow::onSelectionFailure(const snapshot_saved_signal_t::slot_type
 }
 
 
-void LLViewerWindow::saveImageLocal(LLImageFormatted *image, const snapshot_saved_signal_t::slot_type& success_cb, const snapshot_saved_signal_t::slot_type& failure_cb)
+// <AS:Chanayane> Streaming encoders
+//void LLViewerWindow::saveImageLocal(LLImageFormatted *image, const snapshot_saved_signal_t::slot_type& success_cb, const snapshot_saved_signal_t::slot_type& failure_cb)
+void LLViewerWindow::saveImageLocal(LLImageFormatted *image, const snapshot_saved_signal_t::slot_type& success_cb, const snapshot_saved_signal_t::slot_type& failure_cb, LLImageRaw* raw)
+// </AS:Chanayane>
 {
     std::string lastSnapshotDir = LLViewerWindow::getLastSnapshotDir();
     if (lastSnapshotDir.empty())
@@ -5935,13 +5962,21 @@ void LLViewerWindow::saveImageLocal(LLImageFormatted *image, const snapshot_save
         failure_cb();
         return;
     }
-    if (b_space.free < image->getDataSize())
+    // <AS:Chanayane> Streaming encoders
+    // Nothing is encoded yet when streaming: the raw size is the worst case
+    //if (b_space.free < image->getDataSize())
+    S32 needed_size = raw ? raw->getDataSize() : image->getDataSize();
+    if (b_space.free < (U64)needed_size)
+    // </AS:Chanayane>
     {
         LLSD args;
         args["PATH"] = lastSnapshotDir;
 
         std::string needM_bytes_string;
-        LLResMgr::getInstance()->getIntegerString(needM_bytes_string, (image->getDataSize()) >> 10);
+        // <AS:Chanayane> Streaming encoders
+        //LLResMgr::getInstance()->getIntegerString(needM_bytes_string, (image->getDataSize()) >> 10);
+        LLResMgr::getInstance()->getIntegerString(needM_bytes_string, needed_size >> 10);
+        // </AS:Chanayane>
         args["NEED_MEMORY"] = needM_bytes_string;
 
         std::string freeM_bytes_string;
@@ -5989,7 +6024,10 @@ void LLViewerWindow::saveImageLocal(LLImageFormatted *image, const snapshot_save
             && is_snapshot_name_loc_set); // Or stop if we are rewriting.
 
     LL_INFOS() << "Saving snapshot to " << filepath << LL_ENDL;
-    if (image->save(filepath))
+    // <AS:Chanayane> Streaming encoders
+    //if (image->save(filepath))
+    if (raw ? image->encodeToFile(raw, filepath) : image->save(filepath))
+    // </AS:Chanayane>
     {
         playSnapshotAnimAndSound();
         if (gSavedSettings.getBOOL("FSLogSnapshotsToLocal"))
@@ -6063,12 +6101,17 @@ bool LLViewerWindow::saveSnapshot(const std::string& filepath, S32 image_width,
         }
 
         LLPointer<LLImageFormatted> formated_image = LLImageFormatted::createFromType(image_codec);
-        success = formated_image->encode(raw, 0.0f);
-        if (success)
-        {
-            success = formated_image->save(filepath);
-        }
-        else
+        // <AS:Chanayane> Streaming encoders
+        // Write the file as it is encoded rather than holding it all in memory
+        //success = formated_image->encode(raw, 0.0f);
+        //if (success)
+        //{
+        //    success = formated_image->save(filepath);
+        //}
+        //else
+        success = formated_image->encodeToFile(raw, filepath);
+        if (!success)
+        // </AS:Chanayane>
         {
             LL_WARNS() << "Unable to encode snapshot of format " << format << LL_ENDL;
         }
@@ -6281,6 +6324,16 @@ bool LLViewerWindow::rawSnapshot(LLImageRaw *raw, S32 image_width, S32 image_hei
     F32 depth_conversion_factor_1 = (LLViewerCamera::getInstance()->getFar() + LLViewerCamera::getInstance()->getNear()) / (2.f * LLViewerCamera::getInstance()->getFar() * LLViewerCamera::getInstance()->getNear());
     F32 depth_conversion_factor_2 = (LLViewerCamera::getInstance()->getFar() - LLViewerCamera::getInstance()->getNear()) / (2.f * LLViewerCamera::getInstance()->getFar() * LLViewerCamera::getInstance()->getNear());
 
+    // <AS:Chanayane> Asynchronous snapshot tile read back
+    // Colour tiles are read whole into pixel buffers and copied into raw by
+    // worker threads while the next tile renders
+    std::unique_ptr<LLSnapshotCompositor> compositor;
+    if (type == LLSnapshotModel::SNAPSHOT_TYPE_COLOR && !LLRender::sNsightDebugSupport && gSavedSettings.getBOOL("ASSnapshotAsyncReadback"))
+    {
+        compositor = std::make_unique<LLSnapshotCompositor>(raw);
+    }
+    // </AS:Chanayane>
+
     // Subimages are in fact partial rendering of the final view. This happens when the final view is bigger than the screen.
     // In most common cases, scale_factor is 1 and there's no more than 1 iteration on x and y
     for (int subimage_y = 0; subimage_y < scale_factor; ++subimage_y)
@@ -6315,6 +6368,22 @@ bool LLViewerWindow::rawSnapshot(LLImageRaw *raw, S32 image_width, S32 image_hei
                     swap();
                 }
 
+                // <AS:Chanayane> Asynchronous snapshot tile read back
+                if (compositor)
+                {
+                    S32 output_buffer_offset = (
+                                                (window_width * subimage_x) // ...subimage start in x...
+                                                + (raw->getWidth() * window_height * subimage_y) // ...plus subimage start in y...
+                                                - output_buffer_offset_x // ...minus buffer padding x...
+                                                - (output_buffer_offset_y * (raw->getWidth()))  // ...minus buffer padding y...
+                                                ) * raw->getComponents();
+
+                    LLAppViewer::instance()->pingMainloopTimeout("LLViewerWindow::rawSnapshot");
+                    compositor->readTile(subimage_x_offset, subimage_y_offset, read_width, read_height,
+                                         raw->getData() + output_buffer_offset, raw->getWidth() * raw->getComponents());
+                }
+                else
+                // </AS:Chanayane>
                 for (U32 out_y = 0; out_y < read_height ; out_y++)
                 {
                     S32 output_buffer_offset = (
@@ -6409,6 +6478,14 @@ bool LLViewerWindow::rawSnapshot(LLImageRaw *raw, S32 image_width, S32 image_hei
         output_buffer_offset_y += subimage_y_offset;
     }
 
+    // <AS:Chanayane> Asynchronous snapshot tile read back
+    if (compositor)
+    {
+        compositor->finish();
+        compositor.reset();
+    }
+    // </AS:Chanayane>
+
     gDisplaySwapBuffers = false;
     gSnapshotNoPost = false;
     gDepthDirty = true;
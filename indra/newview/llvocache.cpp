@@ -261,6 +261,30 @@ LLVOCacheEntry::LLVOCacheEntry(LLAPRFile* apr_file)
     }
 }
 
+// <AS:Chanayane> Columnar object cache
+LLVOCacheEntry::LLVOCacheEntry(U32 local_id, U32 crc, S32 hit_count, S32 dupe_count, S32 crc_change_count,
+                               const LLMappedFile::ptr_t& mapping, U32 offset, U32 size)
+:   LLViewerOctreeEntryData(LLViewerOctreeEntry::LLVOCACHEENTRY),
+    mLocalID(local_id),
+    mCRC(crc),
+    mUpdateFlags(-1),
+    mHitCount(hit_count),
+    mDupeCount(dupe_count),
+    mCRCChangeCount(crc_change_count),
+    mBuffer(NULL),
+    mMappedFile(mapping),
+    mMappedOffset(offset),
+    mMappedSize(size),
+    mState(INACTIVE),
+    mSceneContrib(0.f),
+    mValid(false),
+    mParentID(0),
+    mBSphereRadius(-1.0f)
+{
+    mDP.assignBuffer(mBuffer, 0);
+}
+// </AS:Chanayane>
+
 LLVOCacheEntry::~LLVOCacheEntry()
 {
     mDP.freeBuffer();
@@ -275,6 +299,7 @@ void LLVOCacheEntry::updateEntry(U32 crc, LLDataPackerBinaryBuffer &dp)
     }
 
     mDP.freeBuffer();
+    mMappedFile.reset(); // <AS:Chanayane/> Columnar object cache: no longer matches the cache file
 
     llassert_always(dp.getBufferSize() > 0);
     mBuffer = new U8[dp.getBufferSize()];
@@ -310,7 +335,9 @@ void LLVOCacheEntry::removeAllChildren()
 //virtual
 void LLVOCacheEntry::setOctreeEntry(LLViewerOctreeEntry* entry)
 {
-    if(!entry && mDP.getBufferSize() > 0)
+    // <AS:Chanayane/> Columnar object cache: getDP() materializes mapped data
+    //if(!entry && mDP.getBufferSize() > 0)
+    if(!entry && getDP())
     {
         LLUUID fullid;
         LLViewerObject::unpackUUID(&mDP, fullid, "ID");
@@ -407,6 +434,12 @@ LLVOCacheEntry* LLVOCacheEntry::getChild()
 
 LLDataPackerBinaryBuffer *LLVOCacheEntry::getDP()
 {
+    // <AS:Chanayane> Columnar object cache
+    if (mDP.getBufferSize() == 0 && mMappedFile)
+    {
+        materialize();
+    }
+    // </AS:Chanayane>
     if (mDP.getBufferSize() == 0)
     {
         //LL_INFOS() << "Not getting cache entry, invalid!" << LL_ENDL;
@@ -432,9 +465,44 @@ void LLVOCacheEntry::dump() const
         << LL_ENDL;
 }
 
+// <AS:Chanayane> Columnar object cache
+void LLVOCacheEntry::materialize()
+{
+    // Copy rather than point the data packer into the mapping: the packer
+    // owns its buffer and frees it when reassigned.
+    mBuffer = new U8[mMappedSize];
+    memcpy(mBuffer, mMappedFile->getData() + mMappedOffset, mMappedSize);
+    mDP.assignBuffer(mBuffer, mMappedSize);
+}
+
+const U8* LLVOCacheEntry::getBodyData(S32& size) const
+{
+    if (mDP.getBufferSize() > 0)
+    {
+        size = mDP.getBufferSize();
+        return mBuffer;
+    }
+    if (mMappedFile)
+    {
+        size = mMappedSize;
+        return mMappedFile->getData() + mMappedOffset;
+    }
+    size = 0;
+    return NULL;
+}
+
+bool LLVOCacheEntry::isBackedBy(const LLMappedFile* mapping, U32 offset, U32 size) const
+{
+    return mapping && mMappedFile.get() == mapping && mMappedOffset == offset && mMappedSize == size;
+}
+// </AS:Chanayane>
+
 S32 LLVOCacheEntry::writeToBuffer(U8 *data_buffer) const
 {
-    S32 size = mDP.getBufferSize();
+    // <AS:Chanayane/> Columnar object cache: the data may not be materialized
+    //S32 size = mDP.getBufferSize();
+    S32 size = 0;
+    const U8* body = getBodyData(size);
 
     if (size > MAX_ENTRY_BODY_SIZE)
     {
@@ -448,7 +516,8 @@ S32 LLVOCacheEntry::writeToBuffer(U8 *data_buffer) const
     memcpy(data_buffer + (3 * sizeof(U32)), &mDupeCount, sizeof(S32));
     memcpy(data_buffer + (4 * sizeof(U32)), &mCRCChangeCount, sizeof(S32));
     memcpy(data_buffer + (5 * sizeof(U32)), &size, sizeof(S32));
-    memcpy(data_buffer + ENTRY_HEADER_SIZE, (void*)mBuffer, size);
+    //memcpy(data_buffer + ENTRY_HEADER_SIZE, (void*)mBuffer, size);
+    memcpy(data_buffer + ENTRY_HEADER_SIZE, (const void*)body, size); // <AS:Chanayane/> Columnar object cache
 
     return ENTRY_HEADER_SIZE + size;
 }
@@ -1171,6 +1240,7 @@ void LLVOCachePartition::removeOccluder(LLVOCacheGroup* group)
 // Format strings used to construct filename for the object cache
 static const char OBJECT_CACHE_FILENAME[] = "objects_%d_%d.slc";
 static const char OBJECT_CACHE_EXTRAS_FILENAME[] = "objects_%d_%d_extras.slec";
+static const char OBJECT_CACHE_COLUMNAR_FILENAME[] = "objects_%d_%d.slm"; // <AS:Chanayane/> Columnar object cache
 
 const U32 MAX_NUM_OBJECT_ENTRIES = 128 ;
 const U32 MIN_ENTRIES_TO_PURGE = 16 ;
@@ -1178,6 +1248,71 @@ const U32 INVALID_TIME = 0 ;
 const char* object_cache_dirname = "objectcache";
 const char* header_filename = "object.cache";
 
+// <AS:Chanayane> Columnar object cache
+// Layout of a columnar region file:
+//   ColumnarHeader
+//   ColumnarRecord[mCapacity]     one per object, mLocalID 0 marks a free slot
+//   blob area                     packed object data, up to mBlobEnd
+// Object data is only ever appended to the blob area, so data a live mapping
+// points at is never overwritten; the file is rewritten from scratch when
+// the stale part of the blob area grows too large.
+const U32 COLUMNAR_MAGIC = 0x43434f56; // 'VOCC'
+const U32 COLUMNAR_VERSION = 1;
+const U32 COLUMNAR_MAX_CAPACITY = 1 << 20;
+const U32 COLUMNAR_MIN_SPARE = 64;
+
+struct ColumnarHeader
+{
+    U32 mMagic;
+    U32 mVersion;
+    U8  mCacheID[UUID_BYTES];
+    U32 mCapacity;      // number of record slots
+    U32 mNumEntries;    // number of used record slots
+    U32 mBlobEnd;       // file offset of the end of the blob area
+    U32 mGarbage;       // bytes of the blob area no record refers to
+};
+
+struct ColumnarRecord
+{
+    U32 mLocalID;
+    U32 mCRC;
+    S32 mHitCount;
+    S32 mDupeCount;
+    S32 mCRCChangeCount;
+    U32 mBlobOffset;
+    U32 mBlobSize;
+    U32 mReserved;
+};
+
+static_assert(sizeof(ColumnarHeader) == 40, "ColumnarHeader must not be padded");
+static_assert(sizeof(ColumnarRecord) == 32, "ColumnarRecord must not be padded");
+
+static size_t columnar_record_offset(U32 slot)
+{
+    return sizeof(ColumnarHeader) + (size_t)slot * sizeof(ColumnarRecord);
+}
+
+static bool columnar_header_valid(const ColumnarHeader& header, size_t file_size)
+{
+    return header.mMagic == COLUMNAR_MAGIC
+        && header.mVersion == COLUMNAR_VERSION
+        && header.mCapacity <= COLUMNAR_MAX_CAPACITY
+        && header.mNumEntries <= header.mCapacity
+        && columnar_record_offset(header.mCapacity) <= header.mBlobEnd
+        && header.mBlobEnd <= file_size;
+}
+
+static void columnar_fill_record(ColumnarRecord& record, const LLVOCacheEntry* entry)
+{
+    memset(&record, 0, sizeof(ColumnarRecord));
+    record.mLocalID = entry->getLocalID();
+    record.mCRC = entry->getCRC();
+    record.mHitCount = entry->getHitCount();
+    record.mDupeCount = entry->getDupeCount();
+    record.mCRCChangeCount = entry->getCRCChangeCount();
+}
+// </AS:Chanayane>
+
 
 LLVOCache::LLVOCache(bool read_only) :
     mInitialized(false),
@@ -1186,8 +1321,10 @@ LLVOCache::LLVOCache(bool read_only) :
     mCacheSize(1),
     mEnabled(true)
 {
+    mColumnar = false; // <AS:Chanayane/> Columnar object cache
 #ifndef LL_TEST
     mEnabled = gSavedSettings.getBOOL("ObjectCacheEnabled");
+    mColumnar = gSavedSettings.getBOOL("ASObjectCacheColumnar"); // <AS:Chanayane/> Columnar object cache
 #endif
     mLocalAPRFilePoolp = new LLVolatileAPRPool() ;
 }
@@ -1388,6 +1525,17 @@ std::string LLVOCache::getObjectCacheExtrasFilename(U64 handle)
                llformat(OBJECT_CACHE_EXTRAS_FILENAME, region_x, region_y));
 }
 
+// <AS:Chanayane> Columnar object cache
+std::string LLVOCache::getObjectCacheColumnarFilename(U64 handle)
+{
+    U32 region_x, region_y;
+
+    grid_from_region_handle(handle, &region_x, &region_y);
+    return gDirUtilp->getExpandedFilename(LL_PATH_CACHE, object_cache_dirname,
+               llformat(OBJECT_CACHE_COLUMNAR_FILENAME, region_x, region_y));
+}
+// </AS:Chanayane>
+
 void LLVOCache::removeFromCache(HeaderEntryInfo* entry)
 {
     if(mReadOnly)
@@ -1400,6 +1548,7 @@ void LLVOCache::removeFromCache(HeaderEntryInfo* entry)
     getObjectCacheFilename(entry->mHandle, filename);
     LL_WARNS("GLTF", "VOCache") << "Removing object cache for handle " << entry->mHandle << "Filename: " << filename << LL_ENDL;
     LLAPRFile::remove(filename, mLocalAPRFilePoolp);
+    LLFile::remove(getObjectCacheColumnarFilename(entry->mHandle), ENOENT); // <AS:Chanayane/> Columnar object cache
 
     // Note: `removeFromCache` should take responsibility for cleaning up all cache artefacts specfic to the handle/entry.
     // as such this now includes the generic extras
@@ -1575,6 +1724,28 @@ bool LLVOCache::readFromCache(U64 handle, const LLUUID& id, LLVOCacheEntry::voca
         return false; // arguably no a problem, but we'll mark this as dirty anyway.
     }
 
+    // <AS:Chanayane> Columnar object cache
+    bool migrate = false;
+    if (mColumnar)
+    {
+        bool found = false;
+        std::string columnar_filename = getObjectCacheColumnarFilename(handle);
+        bool success = readColumnarCache(columnar_filename, id, cache_entry_map, found);
+        if (found)
+        {
+            if (!success && cache_entry_map.empty())
+            {
+                removeEntry(iter->second);
+            }
+            LL_DEBUGS("VOCache") << "Read " << cache_entry_map.size() << " entries from columnar object cache " << columnar_filename << ", success=" << (success ? "True" : "False") << LL_ENDL;
+            return success;
+        }
+        // No columnar file yet: read the legacy file and report the cache as
+        // dirty so that the region writes it back in the columnar format.
+        migrate = true;
+    }
+    // </AS:Chanayane>
+
     bool success = true ;
     S32 num_entries = 0 ; // lifted out of inner loop.
     std::string filename; // lifted out of loop
@@ -1626,9 +1797,70 @@ bool LLVOCache::readFromCache(U64 handle, const LLUUID& id, LLVOCacheEntry::voca
     }
 
     LL_DEBUGS("GLTF", "VOCache") << "Read " << cache_entry_map.size() << " entries from object cache " << filename << ", expected " << num_entries << ", success=" << (success?"True":"False") << LL_ENDL;
-    return success;
+    //return success;
+    return success && !migrate; // <AS:Chanayane/> Columnar object cache
 }
 
+// <AS:Chanayane> Columnar object cache
+bool LLVOCache::readColumnarCache(const std::string& filename, const LLUUID& id, LLVOCacheEntry::vocache_entry_map_t& cache_entry_map, bool& found)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_NETWORK;
+    found = false;
+
+    LLMappedFile::ptr_t mapping = LLMappedFile::open(filename);
+    if (!mapping)
+    {
+        return false;
+    }
+    found = true;
+
+    const U8* data = mapping->getData();
+    ColumnarHeader header;
+    if (mapping->getSize() < sizeof(ColumnarHeader))
+    {
+        LL_WARNS() << "Truncated object cache file " << filename << LL_ENDL;
+        return false;
+    }
+    memcpy(&header, data, sizeof(ColumnarHeader));
+    if (!columnar_header_valid(header, mapping->getSize()))
+    {
+        LL_WARNS() << "Bogus object cache file header in " << filename << LL_ENDL;
+        return false;
+    }
+    if (memcmp(header.mCacheID, id.mData, UUID_BYTES) != 0)
+    {
+        LL_INFOS() << "Cache ID doesn't match for this region, discarding" << LL_ENDL;
+        return false;
+    }
+
+    // Only the record table is read here, the object data stays in the
+    // mapping until the region actually uses the entry.
+    const U32 blob_start = (U32)columnar_record_offset(header.mCapacity);
+    for (U32 slot = 0; slot < header.mCapacity; ++slot)
+    {
+        ColumnarRecord record;
+        memcpy(&record, data + columnar_record_offset(slot), sizeof(ColumnarRecord));
+        if (!record.mLocalID)
+        {
+            continue;
+        }
+
+        if (record.mBlobSize < 1 || record.mBlobSize > (U32)MAX_ENTRY_BODY_SIZE
+            || record.mBlobOffset < blob_start || record.mBlobOffset > header.mBlobEnd - record.mBlobSize)
+        {
+            LL_WARNS() << "Aborting cache file load for " << filename << ", cache file corruption!" << LL_ENDL;
+            return false;
+        }
+
+        cache_entry_map[record.mLocalID] = new LLVOCacheEntry(record.mLocalID, record.mCRC,
+            record.mHitCount, record.mDupeCount, record.mCRCChangeCount,
+            mapping, record.mBlobOffset, record.mBlobSize);
+    }
+
+    return true;
+}
+// </AS:Chanayane>
+
 // We now pass in the cache entry map, so that we can remove entries from extras that are no longer in the primary cache.
 void LLVOCache::readGenericExtrasFromCache(U64 handle, const LLUUID& id, LLVOCacheEntry::vocache_gltf_overrides_map_t& cache_extras_entry_map, const LLVOCacheEntry::vocache_entry_map_t& cache_entry_map)
 {
@@ -1845,6 +2077,23 @@ void LLVOCache::writeToCache(U64 handle, const LLUUID& id, const LLVOCacheEntry:
         return ; //nothing changed, no need to update.
     }
 
+    // <AS:Chanayane> Columnar object cache
+    if (mColumnar)
+    {
+        if (writeColumnarCache(getObjectCacheColumnarFilename(handle), id, cache_entry_map, removal_enabled))
+        {
+            LLFile::remove(filename, ENOENT); // migrated from the legacy format
+        }
+        else
+        {
+            removeEntry(entry);
+        }
+        return;
+    }
+    // Do not let a columnar file go stale in case the format is turned back on
+    LLFile::remove(getObjectCacheColumnarFilename(handle), ENOENT);
+    // </AS:Chanayane>
+
     //write to cache file
     bool success = true ;
     {
@@ -1919,6 +2168,270 @@ void LLVOCache::writeToCache(U64 handle, const LLUUID& id, const LLVOCacheEntry:
     return ;
 }
 
+// <AS:Chanayane> Columnar object cache
+bool LLVOCache::writeColumnarCache(const std::string& filename, const LLUUID& id, const LLVOCacheEntry::vocache_entry_map_t& cache_entry_map, bool removal_enabled)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_NETWORK;
+
+    // Usually the same mapping the region's entries were created from, as
+    // long as the file did not change since they were read.
+    LLMappedFile::ptr_t mapping = LLMappedFile::open(filename);
+    ColumnarHeader header;
+    if (!mapping || mapping->getSize() < sizeof(ColumnarHeader))
+    {
+        return rewriteColumnarCache(filename, id, cache_entry_map, removal_enabled);
+    }
+    memcpy(&header, mapping->getData(), sizeof(ColumnarHeader));
+    if (!columnar_header_valid(header, mapping->getSize()) || memcmp(header.mCacheID, id.mData, UUID_BYTES) != 0)
+    {
+        return rewriteColumnarCache(filename, id, cache_entry_map, removal_enabled);
+    }
+
+    std::vector<ColumnarRecord> records(header.mCapacity);
+    if (header.mCapacity)
+    {
+        memcpy(records.data(), mapping->getData() + sizeof(ColumnarHeader), header.mCapacity * sizeof(ColumnarRecord));
+    }
+
+    std::unordered_map<U32, U32> slots;
+    std::vector<U32> free_slots;
+    for (U32 slot = header.mCapacity; slot-- > 0; )
+    {
+        if (records[slot].mLocalID)
+        {
+            slots[records[slot].mLocalID] = slot;
+        }
+        else
+        {
+            free_slots.push_back(slot); // lowest slot at the back
+        }
+    }
+
+    // Work out which records change and which object data has to be appended
+    // before touching the file, so that a full table or a mostly stale blob
+    // area can still fall back to rewriting it.
+    const U32 blob_start = (U32)columnar_record_offset(header.mCapacity);
+    U32 blob_end = header.mBlobEnd;
+    U32 garbage = header.mGarbage;
+    std::vector<bool> used(header.mCapacity, false);
+    std::vector<bool> dirty(header.mCapacity, false);
+    std::vector<U8> blobs;
+    U32 num_entries = 0;
+
+    for (LLVOCacheEntry::vocache_entry_map_t::const_iterator iter = cache_entry_map.begin(); iter != cache_entry_map.end(); ++iter)
+    {
+        const LLVOCacheEntry* entry = iter->second;
+        if (removal_enabled && !entry->isValid())
+        {
+            continue;
+        }
+
+        ColumnarRecord record;
+        columnar_fill_record(record, entry);
+
+        U32 slot;
+        std::unordered_map<U32, U32>::iterator slot_iter = slots.find(record.mLocalID);
+        if (slot_iter != slots.end())
+        {
+            slot = slot_iter->second;
+            const ColumnarRecord& old_record = records[slot];
+            if (entry->isBackedBy(mapping.get(), old_record.mBlobOffset, old_record.mBlobSize))
+            {
+                // Object data unchanged, at most the counters moved
+                record.mBlobOffset = old_record.mBlobOffset;
+                record.mBlobSize = old_record.mBlobSize;
+                used[slot] = true;
+                ++num_entries;
+                if (memcmp(&record, &old_record, sizeof(ColumnarRecord)) != 0)
+                {
+                    records[slot] = record;
+                    dirty[slot] = true;
+                }
+                continue;
+            }
+            garbage += old_record.mBlobSize;
+        }
+        else if (!free_slots.empty())
+        {
+            slot = free_slots.back();
+            free_slots.pop_back();
+        }
+        else
+        {
+            return rewriteColumnarCache(filename, id, cache_entry_map, removal_enabled);
+        }
+
+        S32 size = 0;
+        const U8* body = entry->getBodyData(size);
+        if (!body || size < 1 || size > MAX_ENTRY_BODY_SIZE)
+        {
+            LL_WARNS() << "Failed to write cache entry for " << filename << ", entry number " << record.mLocalID << LL_ENDL;
+            return false;
+        }
+
+        record.mBlobOffset = blob_end;
+        record.mBlobSize = size;
+        blob_end += size;
+        blobs.insert(blobs.end(), body, body + size);
+
+        records[slot] = record;
+        used[slot] = true;
+        dirty[slot] = true;
+        ++num_entries;
+    }
+
+    for (U32 slot = 0; slot < header.mCapacity; ++slot)
+    {
+        if (records[slot].mLocalID && !used[slot])
+        {
+            garbage += records[slot].mBlobSize;
+            memset(&records[slot], 0, sizeof(ColumnarRecord));
+            dirty[slot] = true;
+        }
+    }
+
+    if (garbage > (blob_end - blob_start) / 2)
+    {
+        return rewriteColumnarCache(filename, id, cache_entry_map, removal_enabled);
+    }
+
+    // The object data goes first and the header last, so that the records
+    // never refer to data that is not on disk and a torn write is caught by
+    // the blob bounds check when reading.
+    LLFILE* fp = LLFile::fopen(filename, "r+b");
+    if (!fp)
+    {
+        return rewriteColumnarCache(filename, id, cache_entry_map, removal_enabled);
+    }
+
+    bool success = true;
+    if (!blobs.empty())
+    {
+        success = fseek(fp, header.mBlobEnd, SEEK_SET) == 0
+            && fwrite(blobs.data(), 1, blobs.size(), fp) == blobs.size();
+    }
+
+    U32 num_dirty = 0;
+    for (U32 slot = 0; success && slot < header.mCapacity; )
+    {
+        if (!dirty[slot])
+        {
+            ++slot;
+            continue;
+        }
+        U32 run_end = slot + 1;
+        while (run_end < header.mCapacity && dirty[run_end])
+        {
+            ++run_end;
+        }
+        success = fseek(fp, (long)columnar_record_offset(slot), SEEK_SET) == 0
+            && fwrite(&records[slot], sizeof(ColumnarRecord), run_end - slot, fp) == run_end - slot;
+        num_dirty += run_end - slot;
+        slot = run_end;
+    }
+
+    if (success)
+    {
+        header.mNumEntries = num_entries;
+        header.mBlobEnd = blob_end;
+        header.mGarbage = garbage;
+        success = fseek(fp, 0, SEEK_SET) == 0
+            && fwrite(&header, sizeof(ColumnarHeader), 1, fp) == 1;
+    }
+    success = (fclose(fp) == 0) && success;
+
+    if (!success)
+    {
+        LL_WARNS() << "Failed to update object cache file " << filename << LL_ENDL;
+    }
+    LL_DEBUGS("VOCache") << "Updated " << num_dirty << " of " << num_entries << " records in " << filename
+                         << ", appended " << blobs.size() << " bytes. success = " << (success ? "True" : "False") << LL_ENDL;
+    return success;
+}
+
+bool LLVOCache::rewriteColumnarCache(const std::string& filename, const LLUUID& id, const LLVOCacheEntry::vocache_entry_map_t& cache_entry_map, bool removal_enabled)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_NETWORK;
+
+    U32 num_entries = 0;
+    for (LLVOCacheEntry::vocache_entry_map_t::const_iterator iter = cache_entry_map.begin(); iter != cache_entry_map.end(); ++iter)
+    {
+        if (!removal_enabled || iter->second->isValid())
+        {
+            ++num_entries;
+        }
+    }
+
+    // Leave room for new objects so the next writes can stay incremental
+    const U32 capacity = llmin(num_entries + llmax(num_entries / 4, COLUMNAR_MIN_SPARE), COLUMNAR_MAX_CAPACITY);
+    if (num_entries > capacity)
+    {
+        LL_WARNS() << "Too many objects to cache in " << filename << ": " << num_entries << LL_ENDL;
+        return false;
+    }
+
+    std::vector<U8> buffer(columnar_record_offset(capacity), 0);
+    U32 slot = 0;
+    for (LLVOCacheEntry::vocache_entry_map_t::const_iterator iter = cache_entry_map.begin(); iter != cache_entry_map.end(); ++iter)
+    {
+        const LLVOCacheEntry* entry = iter->second;
+        if (removal_enabled && !entry->isValid())
+        {
+            continue;
+        }
+
+        S32 size = 0;
+        const U8* body = entry->getBodyData(size);
+        if (!body || size < 1 || size > MAX_ENTRY_BODY_SIZE)
+        {
+            LL_WARNS() << "Failed to write cache entry for " << filename << ", entry number " << entry->getLocalID() << LL_ENDL;
+            return false;
+        }
+
+        ColumnarRecord record;
+        columnar_fill_record(record, entry);
+        record.mBlobOffset = (U32)buffer.size();
+        record.mBlobSize = size;
+        memcpy(buffer.data() + columnar_record_offset(slot++), &record, sizeof(ColumnarRecord));
+        buffer.insert(buffer.end(), body, body + size);
+    }
+
+    ColumnarHeader header;
+    header.mMagic = COLUMNAR_MAGIC;
+    header.mVersion = COLUMNAR_VERSION;
+    memcpy(header.mCacheID, id.mData, UUID_BYTES);
+    header.mCapacity = capacity;
+    header.mNumEntries = num_entries;
+    header.mBlobEnd = (U32)buffer.size();
+    header.mGarbage = 0;
+    memcpy(buffer.data(), &header, sizeof(ColumnarHeader));
+
+    // Cache entries may still point into a mapping of the current file, so
+    // it is replaced rather than truncated. A plain rename fails on Windows
+    // while the file is mapped, which would lose the region's cache.
+    const std::string temp_filename = LLMappedFile::getTempFilename(filename);
+    bool success = false;
+    LLFILE* fp = LLFile::fopen(temp_filename, "wb");
+    if (fp)
+    {
+        success = fwrite(buffer.data(), 1, buffer.size(), fp) == buffer.size();
+        success = (fclose(fp) == 0) && success;
+    }
+    if (success && !LLMappedFile::replaceFile(temp_filename, filename))
+    {
+        success = false;
+    }
+    if (!success)
+    {
+        LL_WARNS() << "Failed to write object cache file " << filename << LL_ENDL;
+        LLFile::remove(temp_filename, ENOENT);
+    }
+
+    LL_DEBUGS("VOCache") << "Wrote " << num_entries << " entries to the columnar VOCache file " << filename << ". success = " << (success ? "True" : "False") << LL_ENDL;
+    return success;
+}
+// </AS:Chanayane>
+
 void LLVOCache::removeGenericExtrasForHandle(U64 handle)
 {
     if(mReadOnly)
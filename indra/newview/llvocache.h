@@ -33,6 +33,7 @@
 #include "llvieweroctree.h"
 #include "llapr.h"
 #include "llgltfmaterial.h"
+#include "llmappedfile.h" // <AS:Chanayane/> Columnar object cache
 
 #include <unordered_map>
 
@@ -111,6 +112,12 @@ public:
     LLVOCacheEntry(U32 local_id, U32 crc, LLDataPackerBinaryBuffer &dp);
     LLVOCacheEntry(LLAPRFile* apr_file);
     LLVOCacheEntry();
+    // <AS:Chanayane> Columnar object cache
+    // Entry whose object data stays in the region cache file mapping until
+    // getDP() is first called.
+    LLVOCacheEntry(U32 local_id, U32 crc, S32 hit_count, S32 dupe_count, S32 crc_change_count,
+                   const LLMappedFile::ptr_t& mapping, U32 offset, U32 size);
+    // </AS:Chanayane>
 
     void updateEntry(U32 crc, LLDataPackerBinaryBuffer &dp);
 
@@ -126,6 +133,14 @@ public:
     U32 getCRC() const              { return mCRC; }
     S32 getHitCount() const         { return mHitCount; }
     S32 getCRCChangeCount() const   { return mCRCChangeCount; }
+    // <AS:Chanayane> Columnar object cache
+    S32 getDupeCount() const        { return mDupeCount; }
+
+    // Object data without materializing it; NULL if there is none
+    const U8* getBodyData(S32& size) const;
+    // True if the object data is still the given range of the given mapping
+    bool isBackedBy(const LLMappedFile* mapping, U32 offset, U32 size) const;
+    // </AS:Chanayane>
 
     void calcSceneContribution(const LLVector4a& camera_origin, bool needs_update, U32 last_update, F32 dist_threshold);
     void setSceneContribution(F32 scene_contrib) {mSceneContrib = scene_contrib;}
@@ -164,6 +179,7 @@ public:
 
 private:
     void updateParentBoundingInfo(const LLVOCacheEntry* child);
+    void materialize(); // <AS:Chanayane/> Columnar object cache
 
 public:
     typedef std::map<U32, LLPointer<LLVOCacheEntry> >      vocache_entry_map_t;
@@ -183,6 +199,11 @@ protected:
     S32                         mCRCChangeCount;
     LLDataPackerBinaryBuffer    mDP;
     U8                          *mBuffer;
+    // <AS:Chanayane> Columnar object cache
+    LLMappedFile::ptr_t         mMappedFile; //region cache file the object data was loaded from, if any
+    U32                         mMappedOffset{ 0 };
+    U32                         mMappedSize{ 0 };
+    // </AS:Chanayane>
 
     F32                         mSceneContrib; //projected scene contributuion of this object.
     U32                         mState; //high 16 bits reserved for special use.
@@ -317,8 +338,21 @@ private:
     void purgeEntries(U32 size);
     bool updateEntry(const HeaderEntryInfo* entry);
 
+    // <AS:Chanayane> Columnar object cache
+    // Region files made of a fixed-size record table followed by a blob area
+    // holding the packed object data. Reading maps the file and creates the
+    // entries from the record table only; writing patches the records that
+    // changed and appends new object data, rewriting the file only when the
+    // record table is full or too much of the blob area is stale.
+    std::string getObjectCacheColumnarFilename(U64 handle);
+    bool readColumnarCache(const std::string& filename, const LLUUID& id, LLVOCacheEntry::vocache_entry_map_t& cache_entry_map, bool& found);
+    bool writeColumnarCache(const std::string& filename, const LLUUID& id, const LLVOCacheEntry::vocache_entry_map_t& cache_entry_map, bool removal_enabled);
+    bool rewriteColumnarCache(const std::string& filename, const LLUUID& id, const LLVOCacheEntry::vocache_entry_map_t& cache_entry_map, bool removal_enabled);
+    // </AS:Chanayane>
+
 private:
     bool                 mEnabled;
+    bool                 mColumnar; // <AS:Chanayane/> Columnar object cache
     bool                 mInitialized ;
     bool                 mReadOnly ;
     HeaderMetaInfo       mMetaInfo;
@@ -0,0 +1,343 @@
+/**
+ * @file lltexturefetchscheduler_test.cpp
+ * @brief Tests for the texture fetch scheduler, including a replay of a login.
+ *
+ * $LicenseInfo:firstyear=2026&license=fsviewerlgpl$
+ * Phoenix Firestorm Viewer Source Code
+ * Copyright (C) 2026, The Phoenix Firestorm Project, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * The Phoenix Firestorm Project, Inc., 1831 Oakwood Drive, Fairmont, Minnesota 56031-3225 USA
+ * http://www.firestormviewer.org
+ * $/LicenseInfo$
+ */
+
+
+
+
+
+// Precompiled header: almost always required for newview cpp files
+#include "../llviewerprecompiledheaders.h"
+// Class to test
+#include "../lltexturefetchscheduler.h"
+// Tut header
+#include "../test/lltut.h"
+
+#include <algorithm>
+#include <random>
+
+namespace tut
+{
+    struct fetchscheduler_test
+    {
+        typedef LLTextureFetchScheduler sched_t;
+
+        // Ids 1..count, in a stable order
+        static std::vector<LLUUID> makeIds(U32 count)
+        {
+            std::vector<LLUUID> ids(count);
+            for (U32 i = 0; i < count; ++i)
+            {
+                ids[i].mData[0] = U8(i + 1);
+                ids[i].mData[1] = U8((i + 1) >> 8);
+                ids[i].mData[2] = U8((i + 1) >> 16);
+            }
+            return ids;
+        }
+
+        // The id pop() order must match sorting the same entries
+        struct Ref
+        {
+            LLUUID  mID;
+            F32     mPriority;
+            U32     mNeededBy;
+        };
+
+        static bool refBefore(const Ref& lhs, const Ref& rhs)
+        {
+            bool lhs_now = lhs.mNeededBy != sched_t::NO_DEADLINE;
+            bool rhs_now = rhs.mNeededBy != sched_t::NO_DEADLINE;
+            if (lhs_now != rhs_now)
+            {
+                return lhs_now;
+            }
+            if (lhs.mPriority != rhs.mPriority)
+            {
+                return lhs.mPriority > rhs.mPriority;
+            }
+            return lhs.mNeededBy < rhs.mNeededBy;
+        }
+
+        // One texture of the replay
+        struct Texture
+        {
+            F32     mArea;          // decode priority, the on screen pixel area
+            S32     mCost;          // frames the download takes
+            bool    mOnScreen;
+            bool    mWanted;        // priority not dropped to zero
+            bool    mDone;
+            bool    mInFlight;
+            U32     mNeededBy;
+        };
+
+        struct ReplayResult
+        {
+            S32 mComplete;          // frames until the last view was complete
+            U32 mCancelled;
+        };
+
+        // Replays a login, optionally followed by a camera turn at
+        // turn_frame, against a fixed number of HTTP slots. With
+        // use_deadlines false the scheduler degenerates to the previous
+        // priority-only ordering.
+        static ReplayResult replay(bool use_deadlines, S32 turn_frame)
+        {
+            const U32 TEXTURES = 3000;
+            const S32 SLOTS = 16;               // HTTP_NONPIPE_REQUESTS_HIGH_WATER
+            const S32 MAX_FRAMES = 20000;
+
+            std::mt19937 rng(4242);
+            std::uniform_real_distribution<F32> side(4.f, 10.f);
+            std::uniform_real_distribution<F32> unit(0.f, 1.f);
+
+            std::vector<LLUUID> ids = makeIds(TEXTURES);
+            std::vector<Texture> textures(TEXTURES);
+            for (Texture& tex : textures)
+            {
+                F32 size = powf(2.f, side(rng));   // 16 to 1024 pixels across
+                tex.mArea = size * size;
+                tex.mCost = 1 + S32(size / 128.f);
+                tex.mOnScreen = unit(rng) < 0.3f;
+                // Big off screen textures (nearby, behind the camera)
+                // compete with the on screen ones in the priority order
+                if (!tex.mOnScreen)
+                {
+                    tex.mArea *= 2.f;
+                }
+                tex.mWanted = true;
+                tex.mDone = false;
+                tex.mInFlight = false;
+                tex.mNeededBy = sched_t::NO_DEADLINE;
+            }
+
+            sched_t sched;
+            auto push = [&](U32 i, U32 frame)
+            {
+                Texture& tex = textures[i];
+                if (tex.mDone || tex.mInFlight)
+                {
+                    return;
+                }
+                if (!tex.mOnScreen)
+                {
+                    tex.mNeededBy = sched_t::NO_DEADLINE;
+                }
+                else if (tex.mNeededBy == sched_t::NO_DEADLINE)
+                {
+                    tex.mNeededBy = frame;
+                }
+                sched.update(ids[i], tex.mWanted ? tex.mArea : 0.f,
+                             use_deadlines ? tex.mNeededBy : sched_t::NO_DEADLINE);
+            };
+            for (U32 i = 0; i < TEXTURES; ++i)
+            {
+                push(i, 0);
+            }
+
+            std::vector<std::pair<S32, U32> > in_flight;    // finish frame, texture
+            std::unordered_map<LLUUID, U32> index;
+            for (U32 i = 0; i < TEXTURES; ++i)
+            {
+                index[ids[i]] = i;
+            }
+
+            ReplayResult result{ -1, 0 };
+            S32 view_frame = 0;
+            for (S32 frame = 0; frame < MAX_FRAMES; ++frame)
+            {
+                if (frame == turn_frame)
+                {
+                    // The camera turns: a quarter of the view changes and
+                    // some far away textures are no longer wanted at all
+                    for (U32 i = 0; i < TEXTURES; ++i)
+                    {
+                        Texture& tex = textures[i];
+                        F32 roll = unit(rng);
+                        if (roll < 0.25f)
+                        {
+                            tex.mOnScreen = !tex.mOnScreen;
+                        }
+                        else if (roll < 0.30f && !tex.mOnScreen)
+                        {
+                            tex.mWanted = false;
+                        }
+                        push(i, frame);
+                    }
+                    view_frame = frame;
+                }
+
+                // Downloads finishing this frame
+                for (size_t j = 0; j < in_flight.size();)
+                {
+                    if (in_flight[j].first <= frame)
+                    {
+                        textures[in_flight[j].second].mDone = true;
+                        textures[in_flight[j].second].mInFlight = false;
+                        in_flight[j] = in_flight.back();
+                        in_flight.pop_back();
+                    }
+                    else
+                    {
+                        ++j;
+                    }
+                }
+
+                // Visual completeness of the current view
+                bool complete = true;
+                for (const Texture& tex : textures)
+                {
+                    if (tex.mOnScreen && !tex.mDone)
+                    {
+                        complete = false;
+                        break;
+                    }
+                }
+                if (complete && frame >= turn_frame)
+                {
+                    result.mComplete = frame - view_frame;
+                    break;
+                }
+
+                // Release waiters into the free slots
+                LLUUID id;
+                while ((S32)in_flight.size() < SLOTS && sched.pop(id))
+                {
+                    U32 i = index[id];
+                    textures[i].mInFlight = true;
+                    in_flight.emplace_back(frame + textures[i].mCost, i);
+                }
+            }
+            result.mCancelled = sched.getCancelCount();
+            return result;
+        }
+    };
+
+    typedef test_group<fetchscheduler_test> fetchscheduler_t;
+    typedef fetchscheduler_t::object fetchscheduler_object_t;
+    tut::fetchscheduler_t tut_fetchscheduler("LLTextureFetchScheduler");
+
+    template<> template<>
+    void fetchscheduler_object_t::test<1>()
+    {
+        set_test_name("on screen first, then priority");
+        std::vector<LLUUID> ids = makeIds(5);
+        sched_t sched;
+        sched.update(ids[0], 1000.f, sched_t::NO_DEADLINE);   // large but off screen
+        sched.update(ids[1], 10.f, 20);
+        sched.update(ids[2], 50.f, 20);
+        sched.update(ids[3], 1.f, 10);                        // on screen the longest
+        sched.update(ids[4], 10.f, 5);                        // same priority, older
+
+        LLUUID id;
+        ensure("pop 1", sched.pop(id) && id == ids[2]);
+        ensure("pop 2", sched.pop(id) && id == ids[4]);
+        ensure("pop 3", sched.pop(id) && id == ids[1]);
+        ensure("pop 4", sched.pop(id) && id == ids[3]);
+        ensure("pop 5", sched.pop(id) && id == ids[0]);
+        ensure("empty", sched.empty() && !sched.pop(id));
+    }
+
+    template<> template<>
+    void fetchscheduler_object_t::test<2>()
+    {
+        set_test_name("updates keep the heap ordered");
+        const U32 COUNT = 500;
+        std::vector<LLUUID> ids = makeIds(COUNT);
+        std::mt19937 rng(17);
+        std::uniform_real_distribution<F32> prio(1.f, 1000.f);
+        std::uniform_int_distribution<U32> frame(0, 8);
+
+        sched_t sched;
+        std::unordered_map<LLUUID, Ref> ref;
+        for (U32 round = 0; round < 5000; ++round)
+        {
+            const LLUUID& id = ids[rng() % COUNT];
+            U32 op = rng() % 4;
+            if (op == 0)
+            {
+                ensure_equals("remove", sched.remove(id), ref.erase(id) != 0);
+            }
+            else
+            {
+                U32 needed_by = frame(rng);
+                Ref entry{ id, prio(rng), needed_by == 8 ? sched_t::NO_DEADLINE : needed_by };
+                sched.update(id, entry.mPriority, entry.mNeededBy);
+                ref[id] = entry;
+            }
+            ensure_equals("size", sched.size(), ref.size());
+        }
+
+        std::vector<Ref> expected;
+        for (const auto& entry : ref)
+        {
+            expected.push_back(entry.second);
+        }
+        std::sort(expected.begin(), expected.end(), refBefore);
+        for (const Ref& entry : expected)
+        {
+            LLUUID id;
+            ensure("pop", sched.pop(id));
+            ensure("order", id == entry.mID);
+        }
+        ensure("drained", sched.empty());
+    }
+
+    template<> template<>
+    void fetchscheduler_object_t::test<3>()
+    {
+        set_test_name("zero priority cancels");
+        std::vector<LLUUID> ids = makeIds(3);
+        sched_t sched;
+        sched.update(ids[0], 10.f, 5);
+        sched.update(ids[1], 20.f, 5);
+        ensure("reprioritize unknown", !sched.reprioritize(ids[2], 5.f, 1));
+        ensure("not added", !sched.contains(ids[2]));
+        ensure("cancel", !sched.update(ids[1], 0.f, 5));
+        ensure("cancelled", !sched.contains(ids[1]));
+        ensure_equals("cancel count", sched.getCancelCount(), 1U);
+        ensure("cancel unknown", !sched.update(ids[2], 0.f, 5));
+        ensure_equals("cancel count unchanged", sched.getCancelCount(), 1U);
+        LLUUID id;
+        ensure("left", sched.pop(id) && id == ids[0] && sched.empty());
+    }
+
+    template<> template<>
+    void fetchscheduler_object_t::test<4>()
+    {
+        set_test_name("replay: time to visual completeness");
+        const S32 TURN_FRAME = 200;
+        ReplayResult login_priority = replay(false, -1);
+        ReplayResult login_deadlines = replay(true, -1);
+        ReplayResult turn_priority = replay(false, TURN_FRAME);
+        ReplayResult turn_deadlines = replay(true, TURN_FRAME);
+
+        ensure("completed", login_priority.mComplete >= 0 && login_deadlines.mComplete >= 0
+                            && turn_priority.mComplete >= 0 && turn_deadlines.mComplete >= 0);
+        ensure("login no slower", login_deadlines.mComplete <= login_priority.mComplete);
+        ensure("turn no slower", turn_deadlines.mComplete <= turn_priority.mComplete);
+        ensure("cancelled", turn_deadlines.mCancelled > 0);
+    }
+}